@@ -27,6 +27,9 @@
 #define MAX_NB_QCONFS	1024
 #define MAX_NB_ROUTE	32
 
+ODP_STATIC_ASSERT(MAX_PKT_BURST <= ODPH_FLOW_TABLE_BULK_MAX,
+		  "Too large burst size for flow table bulk lookup");
+
 #define INVALID_ID	(-1)
 #define PRINT_INTERVAL	10	/* interval seconds of printing stats */
 
@@ -93,7 +96,7 @@ typedef struct {
 	odp_atomic_u32_t exit_threads;
 
 	/* forward func, hash or lpm */
-	int (*fwd_func)(odp_packet_t pkt, int sif);
+	void (*fwd_func)(odp_packet_t pkt[], int num, int sif, int dif[]);
 } global_data_t;
 
 static global_data_t *global;
@@ -186,68 +189,75 @@ static inline void ipv4_dec_ttl_csum_update(odph_ipv4hdr_t *ip)
 		ip->chksum += odp_cpu_to_be_16(1 << 8);
 }
 
-static inline int l3fwd_pkt_hash(odp_packet_t pkt, int sif)
+static inline void l3fwd_pkt_hash(odp_packet_t pkt[], int num, int sif,
+				  int dif[])
 {
-	fwd_db_entry_t *entry;
-	ipv4_tuple5_t key;
+	fwd_db_entry_t *entry[num];
+	ipv4_tuple5_t key[num];
 	odph_ethhdr_t *eth;
 	odph_udphdr_t  *udp;
 	odph_ipv4hdr_t *ip;
-	int dif;
-
-	ip = odp_packet_l3_ptr(pkt, NULL);
-	key.dst_ip = odp_be_to_cpu_32(ip->dst_addr);
-	key.src_ip = odp_be_to_cpu_32(ip->src_addr);
-	key.proto = ip->proto;
-
-	if (odp_packet_has_udp(pkt) ||
-	    odp_packet_has_tcp(pkt)) {
-		/* UDP or TCP*/
-		void *ptr = odp_packet_l4_ptr(pkt, NULL);
-
-		udp = (odph_udphdr_t *)ptr;
-		key.src_port = odp_be_to_cpu_16(udp->src_port);
-		key.dst_port = odp_be_to_cpu_16(udp->dst_port);
-	} else {
-		key.src_port = 0;
-		key.dst_port = 0;
-	}
-	entry = find_fwd_db_entry(&key);
-	ipv4_dec_ttl_csum_update(ip);
-	eth = odp_packet_l2_ptr(pkt, NULL);
-	if (entry) {
-		eth->src = entry->src_mac;
-		eth->dst = entry->dst_mac;
-		dif = entry->oif_id;
-	} else {
-		/* no route, send by src port */
-		eth->dst = eth->src;
-		dif = sif;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		ip = odp_packet_l3_ptr(pkt[i], NULL);
+		key[i].dst_ip = odp_be_to_cpu_32(ip->dst_addr);
+		key[i].src_ip = odp_be_to_cpu_32(ip->src_addr);
+		key[i].proto = ip->proto;
+
+		if (odp_packet_has_udp(pkt[i]) ||
+		    odp_packet_has_tcp(pkt[i])) {
+			/* UDP or TCP*/
+			void *ptr = odp_packet_l4_ptr(pkt[i], NULL);
+
+			udp = (odph_udphdr_t *)ptr;
+			key[i].src_port = odp_be_to_cpu_16(udp->src_port);
+			key[i].dst_port = odp_be_to_cpu_16(udp->dst_port);
+		} else {
+			key[i].src_port = 0;
+			key[i].dst_port = 0;
+		}
 	}
 
-	return dif;
+	/* Bulk lookup of the whole burst */
+	find_fwd_db_entry_multi(key, entry, num);
+
+	for (i = 0; i < num; i++) {
+		ip = odp_packet_l3_ptr(pkt[i], NULL);
+		ipv4_dec_ttl_csum_update(ip);
+		eth = odp_packet_l2_ptr(pkt[i], NULL);
+		if (entry[i]) {
+			eth->src = entry[i]->src_mac;
+			eth->dst = entry[i]->dst_mac;
+			dif[i] = entry[i]->oif_id;
+		} else {
+			/* no route, send by src port */
+			eth->dst = eth->src;
+			dif[i] = sif;
+		}
+	}
 }
 
-static inline int l3fwd_pkt_lpm(odp_packet_t pkt, int sif)
+static inline void l3fwd_pkt_lpm(odp_packet_t pkt[], int num, int sif,
+				 int dif[])
 {
 	odph_ipv4hdr_t *ip;
 	odph_ethhdr_t *eth;
-	int dif;
-	int ret;
-
-	ip = odp_packet_l3_ptr(pkt, NULL);
-	ipv4_dec_ttl_csum_update(ip);
-	eth = odp_packet_l2_ptr(pkt, NULL);
+	int ret, i;
 
-	/* network byte order maybe different from host */
-	ret = fib_tbl_lookup(odp_be_to_cpu_32(ip->dst_addr), &dif);
-	if (ret)
-		dif = sif;
+	for (i = 0; i < num; i++) {
+		ip = odp_packet_l3_ptr(pkt[i], NULL);
+		ipv4_dec_ttl_csum_update(ip);
+		eth = odp_packet_l2_ptr(pkt[i], NULL);
 
-	eth->dst = global->eth_dest_mac[dif];
-	eth->src = global->l3fwd_pktios[dif].mac_addr;
+		/* network byte order maybe different from host */
+		ret = fib_tbl_lookup(odp_be_to_cpu_32(ip->dst_addr), &dif[i]);
+		if (ret)
+			dif[i] = sif;
 
-	return dif;
+		eth->dst = global->eth_dest_mac[dif[i]];
+		eth->src = global->l3fwd_pktios[dif[i]].mac_addr;
+	}
 }
 
 /**
@@ -295,9 +305,11 @@ static int run_worker(void *arg)
 	odp_pktin_queue_t input_queues[thr_arg->nb_pktio];
 	odp_pktout_queue_t output_queues[global->cmd_args.if_count];
 	odp_packet_t pkt_tbl[MAX_PKT_BURST];
+	int dif_tbl[MAX_PKT_BURST];
 	odp_packet_t *tbl;
+	int *dif;
 	int pkts, drop, sent;
-	int dst_port, dif;
+	int dst_port;
 	int i, j;
 	int pktio = 0;
 	int num_pktio = 0;
@@ -347,13 +359,13 @@ static int run_worker(void *arg)
 		if (odp_unlikely(pkts < 1))
 			continue;
 
-		dif = global->fwd_func(pkt_tbl[0], if_idx);
+		global->fwd_func(pkt_tbl, pkts, if_idx, dif_tbl);
 		tbl = &pkt_tbl[0];
+		dif = &dif_tbl[0];
 		while (pkts) {
-			dst_port = dif;
+			dst_port = dif[0];
 			for (i = 1; i < pkts; i++) {
-				dif = global->fwd_func(tbl[i], if_idx);
-				if (dif != dst_port)
+				if (dif[i] != dst_port)
 					break;
 			}
 			sent = odp_pktout_send(output_queues[dst_port], tbl, i);
@@ -363,8 +375,10 @@ static int run_worker(void *arg)
 				thr_arg->tx_drops += i - sent;
 			}
 
-			if (i < pkts)
+			if (i < pkts) {
 				tbl += i;
+				dif += i;
+			}
 
 			pkts -= i;
 		}
@@ -1144,11 +1158,8 @@ int main(int argc, char **argv)
 	for (i = 0; i < MAX_NB_ROUTE; i++)
 		free(args->route_str[i]);
 
-	shm = odp_shm_lookup("flow_table");
-	if (shm != ODP_SHM_INVALID && odp_shm_free(shm) != 0) {
-		printf("Error: shm free flow_table\n");
-		exit(EXIT_FAILURE);
-	}
+	term_fwd_hash_cache();
+
 	shm = odp_shm_lookup("shm_fwd_db");
 	if (shm != ODP_SHM_INVALID && odp_shm_free(shm) != 0) {
 		printf("Error: shm free shm_fwd_db\n");
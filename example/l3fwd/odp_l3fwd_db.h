@@ -23,11 +23,6 @@ extern "C" {
  */
 #define FWD_MAX_FLOW_COUNT	(1 << 22)
 
-/**
- * Default hash entries in a bucket
- */
-#define FWD_DEF_BUCKET_ENTRIES	4
-
 /**
  * IP address range (subnet)
  */
@@ -91,6 +86,11 @@ void init_fwd_db(void);
  */
 void init_fwd_hash_cache(void);
 
+/**
+ * Destroy forward lookup cache
+ */
+void term_fwd_hash_cache(void);
+
 /**
  * Create a forwarding database entry
  *
@@ -134,6 +134,18 @@ void dump_fwd_db(void);
  */
 fwd_db_entry_t *find_fwd_db_entry(ipv4_tuple5_t *key);
 
+/**
+ * Find matching forwarding database entries of multiple packets
+ *
+ * Maximum number of keys is ODPH_FLOW_TABLE_BULK_MAX.
+ *
+ * @param      key    Array of ipv4 tuples
+ * @param[out] entry  Array of forwarding DB entry pointers (or NULL) for output
+ * @param      num    Number of keys
+ */
+void find_fwd_db_entry_multi(ipv4_tuple5_t key[], fwd_db_entry_t *entry[],
+			     int num);
+
 #ifdef __cplusplus
 }
 #endif
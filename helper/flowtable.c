@@ -0,0 +1,763 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp_api.h>
+#include <odp/helper/odph_debug.h>
+#include <odp/helper/odph_flowtable.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Number of entries per bucket */
+#define BUCKET_SLOTS  8
+
+/* Number of timer wheel slots */
+#define WHEEL_SIZE    256
+#define WHEEL_MASK    (WHEEL_SIZE - 1)
+
+/* Idle timeout in timer wheel ticks. Must be less than WHEEL_SIZE - 1. */
+#define TMO_TICKS     128
+
+#define NULL_IDX      UINT32_MAX
+
+ODP_STATIC_ASSERT(sizeof(odph_flow_key_t) == 16, "Flow key size must be 16");
+
+/* Bucket slot is (signature << 32 | (entry index + 1)), or zero when free. A
+ * bucket fits into a cache line, when 64-bit atomics are lock-free. */
+typedef struct ODP_ALIGNED_CACHE {
+	odp_atomic_u64_t slot[BUCKET_SLOTS];
+
+} bucket_t;
+
+typedef struct {
+	/* Odd while the entry is being modified */
+	odp_atomic_u32_t ver;
+
+	/* Timer wheel tick of the latest lookup or insert */
+	odp_atomic_u32_t tick;
+
+	/* Timer wheel list, protected by the table lock */
+	uint32_t wheel_next;
+	uint32_t wheel_prev;
+	uint32_t wheel_slot;
+
+	odph_flow_key_t key;
+	uint64_t value;
+
+} entry_t;
+
+/* Per thread insert buffer */
+typedef struct ODP_ALIGNED_CACHE {
+	uint32_t num;
+	odph_flow_key_t key[ODPH_FLOW_TABLE_BATCH];
+	uint64_t value[ODPH_FLOW_TABLE_BATCH];
+
+} batch_t;
+
+typedef struct ODP_ALIGNED_CACHE {
+	/* Read-mostly data */
+	bucket_t *bucket;
+	entry_t *entry;
+	uint32_t bucket_mask;
+	uint32_t max_flows;
+	uint64_t tick_ns;
+	odp_shm_t shm;
+	char name[ODPH_FLOW_TABLE_NAME_LEN];
+
+	/* Odd while an entry is being moved between buckets. Lookups that
+	 * miss retry when the value changes. */
+	odp_atomic_u32_t ODP_ALIGNED_CACHE move_seq;
+
+	/* Writer data, protected by the lock */
+	odp_spinlock_t ODP_ALIGNED_CACHE lock;
+	odp_atomic_u32_t count;
+	uint32_t num_free;
+	uint32_t *free_idx;
+	uint32_t wheel_tick;
+	uint32_t wheel[WHEEL_SIZE];
+
+	batch_t batch[ODP_THREAD_COUNT_MAX];
+
+} flow_table_t;
+
+static inline flow_table_t *flow_table(odph_flow_table_t table)
+{
+	return (flow_table_t *)(uintptr_t)table;
+}
+
+static inline uint64_t fmix64(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+
+	return h;
+}
+
+static inline void key_read(const odph_flow_key_t *key, uint64_t k[2])
+{
+	memcpy(k, key, sizeof(odph_flow_key_t));
+}
+
+static inline uint64_t flow_hash(const uint64_t k[2])
+{
+	return fmix64(k[0] ^ fmix64(k[1] ^ 0x9e3779b97f4a7c15ULL));
+}
+
+/* Primary bucket is selected with the low and the secondary bucket with the
+ * high half of the hash. Signature mixes both halves, so that it is not
+ * constant for entries of the same bucket. */
+static inline uint32_t bucket_1(flow_table_t *tbl, uint64_t hash)
+{
+	return (uint32_t)hash & tbl->bucket_mask;
+}
+
+static inline uint32_t bucket_2(flow_table_t *tbl, uint64_t hash)
+{
+	return (uint32_t)(hash >> 32) & tbl->bucket_mask;
+}
+
+static inline uint32_t signature(uint64_t hash)
+{
+	return ((uint32_t)hash ^ (uint32_t)(hash >> 32)) | 1;
+}
+
+static inline uint64_t slot_val(uint32_t sig, uint32_t idx)
+{
+	return ((uint64_t)sig << 32) | (idx + 1);
+}
+
+static inline uint32_t cur_tick(flow_table_t *tbl)
+{
+	if (tbl->tick_ns == 0)
+		return 0;
+
+	return (uint32_t)(odp_time_global_ns() / tbl->tick_ns);
+}
+
+/* Lock-free read of an entry. Retries while the entry is being modified,
+ * fails when it has a different key. */
+static inline int entry_read(flow_table_t *tbl, uint32_t idx, const uint64_t k[2],
+			     uint64_t *value, uint32_t tick)
+{
+	entry_t *e = &tbl->entry[idx];
+	uint32_t ver;
+	uint64_t ek[2];
+	uint64_t val;
+
+	do {
+		ver = odp_atomic_load_acq_u32(&e->ver);
+
+		if (odp_unlikely(ver & 1)) {
+			odp_cpu_pause();
+			continue;
+		}
+
+		key_read(&e->key, ek);
+		val = e->value;
+
+		odp_mb_acquire();
+
+	} while (odp_unlikely((ver & 1) || odp_atomic_load_u32(&e->ver) != ver));
+
+	if (ek[0] != k[0] || ek[1] != k[1])
+		return -1;
+
+	*value = val;
+
+	/* Avoid writing into the cache line when the tick is up to date */
+	if (tbl->tick_ns && odp_atomic_load_u32(&e->tick) != tick)
+		odp_atomic_store_u32(&e->tick, tick);
+
+	return 0;
+}
+
+static inline int bucket_read(flow_table_t *tbl, uint32_t bkt, uint32_t sig,
+			      const uint64_t k[2], uint64_t *value, uint32_t tick)
+{
+	bucket_t *bucket = &tbl->bucket[bkt];
+	uint64_t slot;
+	int i;
+
+	for (i = 0; i < BUCKET_SLOTS; i++) {
+		slot = odp_atomic_load_acq_u64(&bucket->slot[i]);
+
+		if ((uint32_t)(slot >> 32) != sig)
+			continue;
+
+		if (entry_read(tbl, (uint32_t)slot - 1, k, value, tick) == 0)
+			return 0;
+	}
+
+	return -1;
+}
+
+static inline int lookup_hashed(flow_table_t *tbl, uint64_t hash, const uint64_t k[2],
+				uint64_t *value, uint32_t tick)
+{
+	uint32_t sig = signature(hash);
+	uint32_t seq;
+
+	/* A flow that is moved between its buckets during the scan may be
+	 * missed, in which case the lookup is repeated */
+	do {
+		seq = odp_atomic_load_acq_u32(&tbl->move_seq);
+
+		if (odp_unlikely(seq & 1)) {
+			odp_cpu_pause();
+			continue;
+		}
+
+		if (bucket_read(tbl, bucket_1(tbl, hash), sig, k, value, tick) == 0)
+			return 0;
+
+		if (bucket_read(tbl, bucket_2(tbl, hash), sig, k, value, tick) == 0)
+			return 0;
+
+		odp_mb_acquire();
+
+	} while (odp_unlikely((seq & 1) || odp_atomic_load_u32(&tbl->move_seq) != seq));
+
+	return -1;
+}
+
+/* Entry modifications are bracketed by odd version number */
+static inline void write_begin(entry_t *e)
+{
+	odp_atomic_store_u32(&e->ver, odp_atomic_load_u32(&e->ver) + 1);
+	odp_mb_release();
+}
+
+static inline void write_end(entry_t *e)
+{
+	odp_atomic_store_rel_u32(&e->ver, odp_atomic_load_u32(&e->ver) + 1);
+}
+
+static void wheel_add(flow_table_t *tbl, uint32_t idx, uint32_t tick)
+{
+	entry_t *e = &tbl->entry[idx];
+	uint32_t slot = (tick + TMO_TICKS + 1) & WHEEL_MASK;
+	uint32_t next = tbl->wheel[slot];
+
+	e->wheel_slot = slot;
+	e->wheel_prev = NULL_IDX;
+	e->wheel_next = next;
+
+	if (next != NULL_IDX)
+		tbl->entry[next].wheel_prev = idx;
+
+	tbl->wheel[slot] = idx;
+}
+
+static void wheel_remove(flow_table_t *tbl, uint32_t idx)
+{
+	entry_t *e = &tbl->entry[idx];
+
+	if (e->wheel_prev != NULL_IDX)
+		tbl->entry[e->wheel_prev].wheel_next = e->wheel_next;
+	else
+		tbl->wheel[e->wheel_slot] = e->wheel_next;
+
+	if (e->wheel_next != NULL_IDX)
+		tbl->entry[e->wheel_next].wheel_prev = e->wheel_prev;
+}
+
+/* Find bucket slot of a key. Table lock must be held. */
+static odp_atomic_u64_t *find_slot(flow_table_t *tbl, uint64_t hash, const uint64_t k[2])
+{
+	uint32_t bkt[2] = {bucket_1(tbl, hash), bucket_2(tbl, hash)};
+	uint32_t sig = signature(hash);
+	odp_atomic_u64_t *slot;
+	uint64_t ek[2];
+	uint64_t val;
+	int i, j;
+
+	for (i = 0; i < 2; i++) {
+		for (j = 0; j < BUCKET_SLOTS; j++) {
+			slot = &tbl->bucket[bkt[i]].slot[j];
+			val = odp_atomic_load_u64(slot);
+
+			if ((uint32_t)(val >> 32) != sig)
+				continue;
+
+			key_read(&tbl->entry[(uint32_t)val - 1].key, ek);
+
+			if (ek[0] == k[0] && ek[1] == k[1])
+				return slot;
+		}
+	}
+
+	return NULL;
+}
+
+static odp_atomic_u64_t *free_slot_of(bucket_t *bucket)
+{
+	int i;
+
+	for (i = 0; i < BUCKET_SLOTS; i++) {
+		if (odp_atomic_load_u64(&bucket->slot[i]) == 0)
+			return &bucket->slot[i];
+	}
+
+	return NULL;
+}
+
+/* Move an entry of the bucket into its alternative bucket. The entry is
+ * added into the new slot before it is removed from the old one. A
+ * concurrent lookup that scans the buckets in the opposite order than the
+ * entry moves may miss it, and retries as the move sequence number has
+ * changed. */
+static odp_atomic_u64_t *make_room(flow_table_t *tbl, uint32_t bkt)
+{
+	bucket_t *bucket = &tbl->bucket[bkt];
+	odp_atomic_u64_t *free_slot;
+	uint64_t val, hash;
+	uint64_t k[2];
+	uint32_t alt;
+	int i;
+
+	for (i = 0; i < BUCKET_SLOTS; i++) {
+		val = odp_atomic_load_u64(&bucket->slot[i]);
+		key_read(&tbl->entry[(uint32_t)val - 1].key, k);
+		hash = flow_hash(k);
+
+		alt = bucket_1(tbl, hash);
+		if (alt == bkt)
+			alt = bucket_2(tbl, hash);
+
+		if (alt == bkt)
+			continue;
+
+		free_slot = free_slot_of(&tbl->bucket[alt]);
+		if (free_slot == NULL)
+			continue;
+
+		odp_atomic_store_u32(&tbl->move_seq, odp_atomic_load_u32(&tbl->move_seq) + 1);
+		odp_mb_release();
+
+		odp_atomic_store_rel_u64(free_slot, val);
+		odp_atomic_store_rel_u64(&bucket->slot[i], 0);
+
+		odp_atomic_store_rel_u32(&tbl->move_seq, odp_atomic_load_u32(&tbl->move_seq) + 1);
+		return &bucket->slot[i];
+	}
+
+	return NULL;
+}
+
+static odp_atomic_u64_t *find_free_slot(flow_table_t *tbl, uint64_t hash)
+{
+	uint32_t bkt_1 = bucket_1(tbl, hash);
+	uint32_t bkt_2 = bucket_2(tbl, hash);
+	odp_atomic_u64_t *slot;
+
+	slot = free_slot_of(&tbl->bucket[bkt_1]);
+	if (slot)
+		return slot;
+
+	slot = free_slot_of(&tbl->bucket[bkt_2]);
+	if (slot)
+		return slot;
+
+	/* Both buckets are full, try to move one entry out of the way */
+	slot = make_room(tbl, bkt_1);
+	if (slot)
+		return slot;
+
+	return make_room(tbl, bkt_2);
+}
+
+/* Table lock must be held */
+static int insert_locked(flow_table_t *tbl, const odph_flow_key_t *key, uint64_t value,
+			 uint32_t tick)
+{
+	odp_atomic_u64_t *slot;
+	entry_t *e;
+	uint64_t k[2];
+	uint64_t hash;
+	uint32_t idx;
+
+	key_read(key, k);
+	hash = flow_hash(k);
+	slot = find_slot(tbl, hash, k);
+
+	if (slot) {
+		/* Update value of an existing flow */
+		e = &tbl->entry[(uint32_t)odp_atomic_load_u64(slot) - 1];
+		write_begin(e);
+		e->value = value;
+		write_end(e);
+		odp_atomic_store_u32(&e->tick, tick);
+		return 0;
+	}
+
+	if (tbl->num_free == 0)
+		return -1;
+
+	/* Buckets have room for twice the max number of flows, so both
+	 * buckets are rarely full */
+	slot = find_free_slot(tbl, hash);
+	if (slot == NULL)
+		return -1;
+
+	idx = tbl->free_idx[--tbl->num_free];
+	e = &tbl->entry[idx];
+
+	write_begin(e);
+	e->key = *key;
+	e->value = value;
+	write_end(e);
+	odp_atomic_store_u32(&e->tick, tick);
+
+	if (tbl->tick_ns)
+		wheel_add(tbl, idx, tick);
+
+	/* Publish the entry */
+	odp_atomic_store_rel_u64(slot, slot_val(signature(hash), idx));
+	odp_atomic_store_u32(&tbl->count, odp_atomic_load_u32(&tbl->count) + 1);
+
+	return 0;
+}
+
+/* Table lock must be held */
+static void delete_locked(flow_table_t *tbl, odp_atomic_u64_t *slot)
+{
+	uint32_t idx = (uint32_t)odp_atomic_load_u64(slot) - 1;
+	entry_t *e = &tbl->entry[idx];
+
+	odp_atomic_store_rel_u64(slot, 0);
+
+	/* Fail concurrent reads of the entry */
+	write_begin(e);
+	write_end(e);
+
+	if (tbl->tick_ns)
+		wheel_remove(tbl, idx);
+
+	tbl->free_idx[tbl->num_free++] = idx;
+	odp_atomic_store_u32(&tbl->count, odp_atomic_load_u32(&tbl->count) - 1);
+}
+
+void odph_flow_table_param_init(odph_flow_table_param_t *param)
+{
+	memset(param, 0, sizeof(odph_flow_table_param_t));
+	param->max_flows = 1024 * 1024;
+}
+
+odph_flow_table_t odph_flow_table_create(const char *name,
+					 const odph_flow_table_param_t *param)
+{
+	odp_shm_t shm;
+	flow_table_t *tbl;
+	uint64_t size, hdr_size, bkt_size, entry_size;
+	uint32_t i, num_bkt;
+	uint32_t max_flows = param->max_flows;
+
+	if (name == NULL || strlen(name) >= ODPH_FLOW_TABLE_NAME_LEN) {
+		ODPH_ERR("Bad table name\n");
+		return ODPH_FLOW_TABLE_INVALID;
+	}
+
+	if (max_flows == 0 || max_flows > (UINT32_MAX / 2)) {
+		ODPH_ERR("Bad max_flows %u\n", max_flows);
+		return ODPH_FLOW_TABLE_INVALID;
+	}
+
+	/* Power of two buckets with room for at least 2 * max_flows */
+	num_bkt = 1;
+	while (num_bkt * BUCKET_SLOTS < 2 * (uint64_t)max_flows)
+		num_bkt *= 2;
+
+	hdr_size   = (sizeof(flow_table_t) + ODP_CACHE_LINE_SIZE - 1) &
+		     ~(uint64_t)(ODP_CACHE_LINE_SIZE - 1);
+	bkt_size   = (uint64_t)num_bkt * sizeof(bucket_t);
+	entry_size = (uint64_t)max_flows * sizeof(entry_t);
+	size = hdr_size + bkt_size + entry_size + (uint64_t)max_flows * sizeof(uint32_t);
+
+	shm = odp_shm_reserve(name, size, ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		ODPH_ERR("Shm reserve of %" PRIu64 " bytes failed\n", size);
+		return ODPH_FLOW_TABLE_INVALID;
+	}
+
+	tbl = odp_shm_addr(shm);
+	memset(tbl, 0, sizeof(flow_table_t));
+
+	tbl->shm = shm;
+	strcpy(tbl->name, name);
+	tbl->max_flows = max_flows;
+	tbl->bucket_mask = num_bkt - 1;
+	tbl->bucket = (bucket_t *)(uintptr_t)((uint8_t *)tbl + hdr_size);
+	tbl->entry = (entry_t *)(uintptr_t)((uint8_t *)tbl->bucket + bkt_size);
+	tbl->free_idx = (uint32_t *)(uintptr_t)((uint8_t *)tbl->entry + entry_size);
+
+	if (param->idle_timeout_ns) {
+		tbl->tick_ns = param->idle_timeout_ns / TMO_TICKS;
+		if (tbl->tick_ns == 0)
+			tbl->tick_ns = 1;
+	}
+
+	odp_spinlock_init(&tbl->lock);
+	odp_atomic_init_u32(&tbl->count, 0);
+	odp_atomic_init_u32(&tbl->move_seq, 0);
+
+	for (i = 0; i < num_bkt; i++) {
+		int j;
+
+		for (j = 0; j < BUCKET_SLOTS; j++)
+			odp_atomic_init_u64(&tbl->bucket[i].slot[j], 0);
+	}
+
+	/* Entries are allocated from the beginning of the array */
+	for (i = 0; i < max_flows; i++) {
+		odp_atomic_init_u32(&tbl->entry[i].ver, 0);
+		odp_atomic_init_u32(&tbl->entry[i].tick, 0);
+		tbl->free_idx[i] = max_flows - 1 - i;
+	}
+
+	tbl->num_free = max_flows;
+
+	for (i = 0; i < WHEEL_SIZE; i++)
+		tbl->wheel[i] = NULL_IDX;
+
+	tbl->wheel_tick = cur_tick(tbl);
+
+	return (odph_flow_table_t)(uintptr_t)tbl;
+}
+
+int odph_flow_table_destroy(odph_flow_table_t table)
+{
+	flow_table_t *tbl = flow_table(table);
+
+	if (tbl == NULL)
+		return -1;
+
+	return odp_shm_free(tbl->shm);
+}
+
+int odph_flow_table_lookup(odph_flow_table_t table, const odph_flow_key_t *key,
+			   uint64_t *value)
+{
+	flow_table_t *tbl = flow_table(table);
+	uint64_t k[2];
+
+	key_read(key, k);
+
+	return lookup_hashed(tbl, flow_hash(k), k, value, cur_tick(tbl));
+}
+
+int odph_flow_table_lookup_bulk(odph_flow_table_t table,
+				const odph_flow_key_t key[], uint64_t value[],
+				int num, uint64_t *hit_mask)
+{
+	flow_table_t *tbl = flow_table(table);
+	uint64_t k[ODPH_FLOW_TABLE_BULK_MAX][2];
+	uint64_t hash[ODPH_FLOW_TABLE_BULK_MAX];
+	uint32_t cand[ODPH_FLOW_TABLE_BULK_MAX];
+	uint32_t tick = cur_tick(tbl);
+	uint64_t mask = 0;
+	int i, j, found = 0;
+
+	if (odp_unlikely(num > ODPH_FLOW_TABLE_BULK_MAX))
+		num = ODPH_FLOW_TABLE_BULK_MAX;
+
+	/* Hash all keys and prefetch primary buckets */
+	for (i = 0; i < num; i++) {
+		key_read(&key[i], k[i]);
+		hash[i] = flow_hash(k[i]);
+		odp_prefetch(&tbl->bucket[bucket_1(tbl, hash[i])]);
+	}
+
+	/* Find the first signature match of each primary bucket and prefetch
+	 * its entry */
+	for (i = 0; i < num; i++) {
+		bucket_t *bucket = &tbl->bucket[bucket_1(tbl, hash[i])];
+		uint32_t sig = signature(hash[i]);
+
+		cand[i] = NULL_IDX;
+
+		for (j = 0; j < BUCKET_SLOTS; j++) {
+			uint64_t slot = odp_atomic_load_acq_u64(&bucket->slot[j]);
+
+			if ((uint32_t)(slot >> 32) == sig) {
+				cand[i] = (uint32_t)slot - 1;
+				odp_prefetch(&tbl->entry[cand[i]]);
+				break;
+			}
+		}
+	}
+
+	/* Compare keys. Signature collisions and flows in secondary buckets
+	 * are handled by the full lookup. */
+	for (i = 0; i < num; i++) {
+		if (odp_likely(cand[i] != NULL_IDX) &&
+		    entry_read(tbl, cand[i], k[i], &value[i], tick) == 0) {
+			mask |= 1ULL << i;
+			found++;
+			continue;
+		}
+
+		if (lookup_hashed(tbl, hash[i], k[i], &value[i], tick) == 0) {
+			mask |= 1ULL << i;
+			found++;
+		}
+	}
+
+	if (hit_mask)
+		*hit_mask = mask;
+
+	return found;
+}
+
+static int flush_batch(flow_table_t *tbl, batch_t *batch)
+{
+	uint32_t i, tick;
+	uint64_t k[2];
+	int failed = 0;
+
+	/* Prefetch buckets before taking the lock */
+	for (i = 0; i < batch->num; i++) {
+		key_read(&batch->key[i], k);
+		odp_prefetch_store(&tbl->bucket[bucket_1(tbl, flow_hash(k))]);
+	}
+
+	tick = cur_tick(tbl);
+
+	odp_spinlock_lock(&tbl->lock);
+
+	for (i = 0; i < batch->num; i++) {
+		if (insert_locked(tbl, &batch->key[i], batch->value[i], tick))
+			failed++;
+	}
+
+	odp_spinlock_unlock(&tbl->lock);
+
+	batch->num = 0;
+
+	return failed;
+}
+
+int odph_flow_table_insert(odph_flow_table_t table, const odph_flow_key_t *key,
+			   uint64_t value)
+{
+	flow_table_t *tbl = flow_table(table);
+	int thr = odp_thread_id();
+	batch_t *batch;
+
+	if (odp_unlikely(thr < 0 || thr >= ODP_THREAD_COUNT_MAX))
+		return -1;
+
+	batch = &tbl->batch[thr];
+	batch->key[batch->num] = *key;
+	batch->value[batch->num] = value;
+	batch->num++;
+
+	if (batch->num < ODPH_FLOW_TABLE_BATCH)
+		return 0;
+
+	return flush_batch(tbl, batch) ? -1 : 0;
+}
+
+int odph_flow_table_flush(odph_flow_table_t table)
+{
+	flow_table_t *tbl = flow_table(table);
+	int thr = odp_thread_id();
+	batch_t *batch;
+
+	if (odp_unlikely(thr < 0 || thr >= ODP_THREAD_COUNT_MAX))
+		return -1;
+
+	batch = &tbl->batch[thr];
+
+	if (batch->num == 0)
+		return 0;
+
+	return flush_batch(tbl, batch);
+}
+
+int odph_flow_table_delete(odph_flow_table_t table, const odph_flow_key_t *key)
+{
+	flow_table_t *tbl = flow_table(table);
+	odp_atomic_u64_t *slot;
+	uint64_t k[2];
+	uint64_t hash;
+
+	key_read(key, k);
+	hash = flow_hash(k);
+
+	odp_spinlock_lock(&tbl->lock);
+
+	slot = find_slot(tbl, hash, k);
+	if (slot)
+		delete_locked(tbl, slot);
+
+	odp_spinlock_unlock(&tbl->lock);
+
+	return slot ? 0 : -1;
+}
+
+int odph_flow_table_age(odph_flow_table_t table, odph_flow_key_t key[],
+			uint64_t value[], int num)
+{
+	flow_table_t *tbl = flow_table(table);
+	uint32_t now, t, idx, next, last;
+	uint64_t k[2];
+	entry_t *e;
+	int n = 0;
+
+	if (tbl->tick_ns == 0 || num <= 0)
+		return 0;
+
+	now = cur_tick(tbl);
+
+	/* Aging is skipped when another thread is already doing it */
+	if (odp_spinlock_trylock(&tbl->lock) == 0)
+		return 0;
+
+	while ((int32_t)(now - tbl->wheel_tick) > 0) {
+		t = tbl->wheel_tick + 1;
+		idx = tbl->wheel[t & WHEEL_MASK];
+
+		while (idx != NULL_IDX && n < num) {
+			e = &tbl->entry[idx];
+			next = e->wheel_next;
+			last = odp_atomic_load_u32(&e->tick);
+
+			if ((int32_t)(now - last) > TMO_TICKS) {
+				key[n] = e->key;
+				value[n] = e->value;
+				n++;
+
+				key_read(&e->key, k);
+				delete_locked(tbl, find_slot(tbl, flow_hash(k), k));
+			} else {
+				/* Used after it was added into the wheel */
+				wheel_remove(tbl, idx);
+				wheel_add(tbl, idx, last);
+			}
+
+			idx = next;
+		}
+
+		/* Continue from the same slot on the next call */
+		if (idx != NULL_IDX)
+			break;
+
+		tbl->wheel_tick = t;
+	}
+
+	odp_spinlock_unlock(&tbl->lock);
+
+	return n;
+}
+
+uint32_t odph_flow_table_count(odph_flow_table_t table)
+{
+	return odp_atomic_load_u32(&flow_table(table)->count);
+}
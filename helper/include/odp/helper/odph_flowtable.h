@@ -0,0 +1,242 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP flow table helper
+ *
+ * Hash table for large numbers (tens of millions) of IPv4 5-tuple flows,
+ * designed for per-packet lookup. Lookups are lock-free and may be done
+ * concurrently with inserts, deletes and aging. A lookup finds a flow that
+ * was in the table when the lookup started and was not deleted during it.
+ * Inserts are buffered per thread and written into the table in batches,
+ * which amortizes the cost of writer synchronization. Idle entries are
+ * removed incrementally with a timer wheel: the cost of an aging call
+ * depends on the number of entries whose idle timeout has expired, not on
+ * the table size.
+ */
+
+#ifndef ODPH_FLOWTABLE_H_
+#define ODPH_FLOWTABLE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp_api.h>
+#include <odp/helper/strong_types.h>
+
+#include <stdint.h>
+
+/**
+ * @addtogroup odph_flowtable ODPH FLOW TABLE
+ * @{
+ */
+
+/** Flow table handle */
+typedef ODPH_HANDLE_T(odph_flow_table_t);
+
+/** Invalid flow table handle */
+#define ODPH_FLOW_TABLE_INVALID _odph_cast_scalar(odph_flow_table_t, 0)
+
+/** Max length of flow table name */
+#define ODPH_FLOW_TABLE_NAME_LEN 32
+
+/** Maximum number of keys in a bulk lookup call */
+#define ODPH_FLOW_TABLE_BULK_MAX 64
+
+/** Number of inserts buffered per thread before those are written into
+ *  the table */
+#define ODPH_FLOW_TABLE_BATCH    32
+
+/**
+ * Flow key
+ *
+ * All fields are in the same byte order, which is selected by the user. Key
+ * is compared as a whole, so all unused fields and the padding must be set
+ * to zero.
+ */
+typedef struct odph_flow_key_t {
+	/** Source IPv4 address */
+	uint32_t src_ip;
+
+	/** Destination IPv4 address */
+	uint32_t dst_ip;
+
+	/** Source port */
+	uint16_t src_port;
+
+	/** Destination port */
+	uint16_t dst_port;
+
+	/** IP protocol */
+	uint8_t proto;
+
+	/** Padding, must be zero */
+	uint8_t pad[3];
+
+} odph_flow_key_t;
+
+/** Flow table parameters */
+typedef struct odph_flow_table_param_t {
+	/** Maximum number of flows in the table. Default is 1M. */
+	uint32_t max_flows;
+
+	/** Idle timeout in nanoseconds
+	 *
+	 *  Entries that have not been looked up or inserted during this time
+	 *  are removed by odph_flow_table_age(). Zero disables aging. The
+	 *  default value is zero. */
+	uint64_t idle_timeout_ns;
+
+} odph_flow_table_param_t;
+
+/**
+ * Initialize flow table parameters to their default values
+ *
+ * @param[out] param  Pointer to parameter structure
+ */
+void odph_flow_table_param_init(odph_flow_table_param_t *param);
+
+/**
+ * Create a flow table
+ *
+ * Table memory is reserved from shared memory with the given name.
+ *
+ * @param name   Name of the table, max ODPH_FLOW_TABLE_NAME_LEN - 1 chars
+ * @param param  Table parameters
+ *
+ * @return Flow table handle
+ * @retval ODPH_FLOW_TABLE_INVALID on failure
+ */
+odph_flow_table_t odph_flow_table_create(const char *name,
+					 const odph_flow_table_param_t *param);
+
+/**
+ * Destroy a flow table
+ *
+ * Buffered inserts of all threads are discarded.
+ *
+ * @param table  Flow table handle
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_flow_table_destroy(odph_flow_table_t table);
+
+/**
+ * Look up a flow
+ *
+ * @param      table  Flow table handle
+ * @param      key    Flow key
+ * @param[out] value  Value of the flow when found
+ *
+ * @retval 0 when the flow was found
+ * @retval <0 when the flow was not found
+ */
+int odph_flow_table_lookup(odph_flow_table_t table, const odph_flow_key_t *key,
+			   uint64_t *value);
+
+/**
+ * Look up multiple flows
+ *
+ * Looks up 'num' keys in stages, prefetching table buckets and entries of
+ * all keys before accessing those. Bit N of 'hit_mask' is set when key[N]
+ * was found, in which case value[N] contains the value of the flow. Values
+ * of not found keys are not modified.
+ *
+ * @param      table     Flow table handle
+ * @param      key       Array of keys
+ * @param[out] value     Array of values for output
+ * @param      num       Number of keys, max ODPH_FLOW_TABLE_BULK_MAX
+ * @param[out] hit_mask  Bit mask of found keys for output
+ *
+ * @return Number of keys found
+ */
+int odph_flow_table_lookup_bulk(odph_flow_table_t table,
+				const odph_flow_key_t key[], uint64_t value[],
+				int num, uint64_t *hit_mask);
+
+/**
+ * Insert a flow
+ *
+ * The flow is added into the insert buffer of the calling thread. When the
+ * buffer is full, it is written into the table. Lookups do not see the flow
+ * before the buffer has been written (see also odph_flow_table_flush()). When
+ * a flow with the same key exists already, its value is updated.
+ *
+ * @param table  Flow table handle
+ * @param key    Flow key
+ * @param value  Flow value
+ *
+ * @retval 0 on success
+ * @retval <0 on failure. The table was full and some of the buffered flows
+ *            were not inserted.
+ */
+int odph_flow_table_insert(odph_flow_table_t table, const odph_flow_key_t *key,
+			   uint64_t value);
+
+/**
+ * Write buffered inserts of the calling thread into the table
+ *
+ * @param table  Flow table handle
+ *
+ * @return Number of flows that were not inserted as the table was full
+ * @retval <0 on failure
+ */
+int odph_flow_table_flush(odph_flow_table_t table);
+
+/**
+ * Delete a flow
+ *
+ * @param table  Flow table handle
+ * @param key    Flow key
+ *
+ * @retval 0 on success
+ * @retval <0 when the flow was not found
+ */
+int odph_flow_table_delete(odph_flow_table_t table, const odph_flow_key_t *key);
+
+/**
+ * Remove idle flows
+ *
+ * Removes flows whose idle timeout has expired, and outputs keys and values
+ * of the removed flows. Processing stops after 'num' flows have been
+ * removed, the rest are removed by subsequent calls. The call is intended to
+ * be called periodically, e.g. every few milliseconds, from one or more
+ * threads. Does nothing when aging is disabled.
+ *
+ * @param      table  Flow table handle
+ * @param[out] key    Array of keys for output
+ * @param[out] value  Array of values for output
+ * @param      num    Maximum number of flows to remove
+ *
+ * @return Number of flows removed
+ */
+int odph_flow_table_age(odph_flow_table_t table, odph_flow_key_t key[],
+			uint64_t value[], int num);
+
+/**
+ * Number of flows in a table
+ *
+ * Buffered inserts are not included.
+ *
+ * @param table  Flow table handle
+ *
+ * @return Number of flows
+ */
+uint32_t odph_flow_table_count(odph_flow_table_t table);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
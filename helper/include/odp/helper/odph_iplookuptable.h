@@ -10,15 +10,23 @@
  * ODP IP Lookup Table
  *
  * This is an implementation of the IP lookup table. The key of
- * this table is IPv4 address (32 bits), and the value can be
- * defined by user. This table uses the 16,8,8 ip lookup (longest
- * prefix matching) algorithm.
+ * this table is an IPv4 address (32 bits) or an IPv6 address (128 bits),
+ * and the value can be defined by user. This table uses the 16,8,8 ip lookup
+ * (longest prefix matching) algorithm, which is extended with additional
+ * 8 bit levels for IPv6 addresses (16,8,8,...,8).
+ *
+ * By default, table updates must not be done concurrently with lookups.
+ * A table created in concurrent mode allows lookups to run in parallel with
+ * updates. Lookups never block in this mode, and subtree memory released by
+ * updates is reused only after all reader threads have reported a quiescent
+ * state.
  */
 
 #ifndef ODPH_IPLOOKUP_TABLE_H_
 #define ODPH_IPLOOKUP_TABLE_H_
 
 #include <odp/helper/table.h>
+#include <odp/helper/ip.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +45,58 @@ typedef struct {
 	uint8_t cidr; /**< CIDR value for prefix matching */
 } odph_iplookup_prefix_t;
 
+/**
+ * IPv6 Lookup Prefix
+ */
+typedef struct {
+	uint8_t ip[ODPH_IPV6ADDR_LEN]; /**< IPv6 address in network byte order */
+	uint8_t cidr;                  /**< CIDR value for prefix matching */
+} odph_iplookup_prefix6_t;
+
+/**
+ * IP lookup table address type
+ */
+typedef enum {
+	/** IPv4 addresses. Keys are odph_iplookup_prefix_t (put/remove) and
+	 *  uint32_t addresses in CPU byte order (get). */
+	ODPH_IPLOOKUP_IPV4 = 0,
+
+	/** IPv6 addresses. Keys are odph_iplookup_prefix6_t (put/remove) and
+	 *  16 byte addresses in network byte order (get). */
+	ODPH_IPLOOKUP_IPV6
+} odph_iplookup_type_t;
+
+/**
+ * IP lookup table parameters
+ */
+typedef struct {
+	/** Address type of the table. The default value is
+	 *  ODPH_IPLOOKUP_IPV4. */
+	odph_iplookup_type_t type;
+
+	/** Concurrent update mode
+	 *
+	 *  When 0, the application must not call put or remove functions
+	 *  concurrently with any other operation on the table. When 1, put and
+	 *  remove calls are serialized internally and may be done while other
+	 *  threads are doing lookups. In this mode, every thread doing
+	 *  lookups must call odph_iplookup_table_quiescent() regularly
+	 *  outside of lookups, and odph_iplookup_table_offline() before it
+	 *  stops doing lookups. The default value is 0.
+	 */
+	odp_bool_t concurrent;
+} odph_iplookup_table_param_t;
+
+/**
+ * Initialize IP lookup table parameters
+ *
+ * Initialize an odph_iplookup_table_param_t to its default values for all
+ * fields.
+ *
+ * @param param Address of the odph_iplookup_table_param_t to be initialized
+ */
+void odph_iplookup_table_param_init(odph_iplookup_table_param_t *param);
+
 /**
  * Create an IP lookup table
  *
@@ -53,6 +113,21 @@ odph_table_t odph_iplookup_table_create(const char *name,
 					uint32_t ODP_IGNORED_2,
 					uint32_t value_size);
 
+/**
+ * Create an IP lookup table with parameters
+ *
+ * @param name Name of the table to be created
+ * @param value_size Byte size of each entry in the table
+ * @param param Table parameters
+ *
+ * @return Handle of the created ip lookup table
+ * @retval NULL If table create failed
+ */
+odph_table_t odph_iplookup_table_create_param(const char *name,
+					      uint32_t value_size,
+					      const odph_iplookup_table_param_t
+					      *param);
+
 /**
  * Lookup an IP lookup table by name
  *
@@ -76,8 +151,12 @@ int odph_iplookup_table_destroy(odph_table_t table);
 /**
  * Insert a key/value pair into an ip lookup table
  *
+ * Values are stored as odp_buffer_t handles. The most significant bit of
+ * a value is reserved for the implementation and must be zero.
+ *
  * @param table Table into which value is to be stored
- * @param key   Address of an odph_iplookup_prefix_t to be used as key
+ * @param key   Address of an odph_iplookup_prefix_t (or
+ *              odph_iplookup_prefix6_t) to be used as key
  * @param value Value to be associated with specified key
  *
  * @retval >= 0 Success
@@ -89,7 +168,7 @@ int odph_iplookup_table_put_value(odph_table_t table, void *key, void *value);
  * Retrieve a value from an iplookup table
  *
  * @param table Table from which value is to be retrieved
- * @param key   Address of an odph_iplookup_prefix_t to be used as key
+ * @param key   Address of an IP address to be used as key
  * @param[out] buffer Address of buffer to receive resulting value
  * @param buffer_size Size of supplied buffer
  *
@@ -100,11 +179,32 @@ int odph_iplookup_table_put_value(odph_table_t table, void *key, void *value);
 int odph_iplookup_table_get_value(odph_table_t table, void *key,
 				  void *buffer, uint32_t buffer_size);
 
+/**
+ * Retrieve multiple values from an iplookup table
+ *
+ * Looks up 'num' addresses at once. Memory accesses of the lookups are
+ * pipelined, so that the latency of each table level is overlapped across
+ * the addresses. Addresses that do not match any prefix result in
+ * ODP_BUFFER_INVALID.
+ *
+ * @param table Table from which values are to be retrieved
+ * @param key   Array of 'num' IP addresses (uint32_t for IPv4 tables,
+ *              16 byte addresses for IPv6 tables)
+ * @param[out] buffer Array of 'num' odp_buffer_t to receive resulting values
+ * @param num   Number of addresses to look up
+ *
+ * @return Number of addresses looked up
+ * @retval < 0 Failure
+ */
+int odph_iplookup_table_get_value_multi(odph_table_t table, const void *key,
+					void *buffer, int num);
+
 /**
  * Remove a value from an iplookup table
  *
  * @param table Table from which value is to be removed
- * @param key   Address of odph_iplookup_prefix_t to be used as key
+ * @param key   Address of odph_iplookup_prefix_t (or odph_iplookup_prefix6_t)
+ *              to be used as key
  *
  * @retval >= 0 Success
  * @retval < 0  Failure
@@ -112,6 +212,33 @@ int odph_iplookup_table_get_value(odph_table_t table, void *key,
  */
 int odph_iplookup_table_remove_value(odph_table_t table, void *key);
 
+/**
+ * Report a quiescent state of the calling thread
+ *
+ * In concurrent mode, threads doing lookups call this function regularly
+ * (e.g. once per packet burst) when they do not hold any values or
+ * references obtained from earlier lookups. Subtree memory released by table
+ * updates is reused after all online threads have reported a quiescent state.
+ * The first call brings the thread online. The function does nothing when
+ * the table is not in concurrent mode.
+ *
+ * @param table Table handle
+ */
+void odph_iplookup_table_quiescent(odph_table_t table);
+
+/**
+ * Take the calling thread offline
+ *
+ * In concurrent mode, a thread calls this function before it stops doing
+ * lookups for a longer period of time, so that it does not delay reclamation
+ * of table memory. The thread must call odph_iplookup_table_quiescent()
+ * before its next lookup. The function does nothing when the table is not in
+ * concurrent mode.
+ *
+ * @param table Table handle
+ */
+void odph_iplookup_table_offline(odph_table_t table);
+
 extern odph_table_ops_t odph_iplookup_table_ops; /**< @internal */
 
 /**
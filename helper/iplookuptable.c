@@ -20,49 +20,73 @@
 #define ODPH_IP_LOOKUP_TABLE_MAGIC_WORD 0xCFCFFCFC
 
 /* The length(bit) of the IPv4 address */
-#define IP_LENGTH 32
+#define IPV4_LENGTH 32
+/* The length(bit) of the IPv6 address */
+#define IPV6_LENGTH 128
+/* The length(bit) of the L1 index */
+#define L1_LENGTH 16
+/* The length(bit) of the L2\L3\... subtree index */
+#define SUBTREE_LENGTH 8
 
 /* The number of L1 entries */
-#define ENTRY_NUM_L1		(1 << 16)
+#define ENTRY_NUM_L1		(1 << L1_LENGTH)
 /* The size of one L2\L3 subtree */
-#define ENTRY_NUM_SUBTREE	(1 << 8)
+#define ENTRY_NUM_SUBTREE	(1 << SUBTREE_LENGTH)
 
-#define WHICH_CHILD(ip, cidr) ((ip >> (IP_LENGTH - cidr)) & 0x00000001)
+/* Maximum number of lookups pipelined together */
+#define LOOKUP_BURST 32
+
+/* Address bit at a prefix level (1 is the most significant bit) */
+#define WHICH_CHILD(ip, level) \
+	(((ip)[((level) - 1) >> 3] >> (7 - (((level) - 1) & 7))) & 0x1)
+/* Index of an address into the L1 entries */
+#define L1_INDEX(ip) (((uint32_t)(ip)[0] << 8) | (ip)[1])
+/* Index of an address into a subtree, which entries are at 'level' */
+#define SUBTREE_INDEX(ip, level) ((ip)[((level) >> 3) - 1])
+
+/* Entry word flag: the entry points to a subtree */
+#define ENTRY_CHILD 0x1
 
 /** @internal entry struct
  *   Structure store an entry of the ip prefix table.
  *   Because of the leaf pushing, each entry of the table must have
- *   either a child entry, or a nexthop info.
- *   If child == 0 and index != ODP_BUFFER_INVALID, this entry has
- *		a nexthop info, index indicates the buffer that stores the
- *		nexthop value, and ptr points to the address of the buffer.
- *   If child == 1, this entry has a subtree, index indicates
- *		the buffer that stores the subtree, and ptr points to the
- *		address of the buffer.
+ *   either a child entry, or a nexthop info. Both are stored in a single
+ *   word, so that lookups see either the old or the new entry content
+ *   while the table is being updated.
+ *   If word has ENTRY_CHILD set, the rest of the word is the address of
+ *		the subtree. The buffer that stores the subtree is found from
+ *		the buffer array (ENTRY_BUFF_ARR) of the entry table.
+ *   Otherwise, word stores the nexthop value shifted left by one bit.
+ *   cidr is the prefix length of the route the entry was derived from.
+ *		It is used only by table updates.
  */
 typedef struct {
-	union {
-		odp_buffer_t nexthop;
-		void *ptr;
-	};
-	union {
-		uint8_t u8;
-		struct {
-#if ODP_BYTE_ORDER == ODP_BIG_ENDIAN
-			uint8_t child : 1;
-			uint8_t cidr  : 7;
-#else
-			uint8_t cidr  : 7;
-			uint8_t child : 1;
-#endif
-		};
-	};
+	odp_atomic_u64_t word;
+	uint8_t cidr;
 } prefix_entry_t;
 
 #define ENTRY_SIZE (sizeof(prefix_entry_t) + sizeof(odp_buffer_t))
 #define ENTRY_BUFF_ARR(x) ((odp_buffer_t *)(void *)((char *)x \
 			+ sizeof(prefix_entry_t) * ENTRY_NUM_SUBTREE))
 
+/** @internal retired subtree
+ *   A subtree released in concurrent mode waits for a grace period in
+ *   a FIFO list. Retired subtrees do not have children, so the list
+ *   information is stored in place of the subtree buffer array.
+ */
+typedef struct {
+	/* Next retired subtree */
+	odp_buffer_t next;
+	/* Update epoch when the subtree was released */
+	uint64_t epoch;
+} retired_subtree_t;
+
+/** @internal per thread reader state */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Last update epoch observed by the thread, or 0 when offline */
+	odp_atomic_u64_t epoch;
+} reader_state_t;
+
 /** @internal trie node struct
  *  In this IP lookup algorithm, we use a
  *  binary tire to detect the overlap prefix.
@@ -105,6 +129,10 @@ typedef struct ODP_ALIGNED_CACHE {
 	trie_node_t *trie;
 	/** Length of value. */
 	uint32_t nexthop_len;
+	/** Length of the address in bits */
+	uint8_t ip_len;
+	/** Concurrent update mode */
+	uint8_t concurrent;
 	/** Queues of free slots (caches)
 	 *  There are two queues:
 	 *  - free_slots[CACHE_TYPE_SUBTREE] is used for L2 and
@@ -116,8 +144,73 @@ typedef struct ODP_ALIGNED_CACHE {
 	odp_queue_t free_slots[2];
 	/** The number of pool used by each queue. */
 	uint32_t cache_count[2];
+	/** Serializes table updates in concurrent mode */
+	odp_spinlock_t lock;
+	/** Current update epoch */
+	odp_atomic_u64_t epoch;
+	/** Subtrees waiting for a grace period (oldest first) */
+	odp_buffer_t retired_head;
+	odp_buffer_t retired_tail;
+	/** Reader thread states (concurrent mode only) */
+	reader_state_t *reader;
 } odph_iplookup_table_impl;
 
+/***********************************************************
+ ********************   Entry access   *********************
+ ***********************************************************/
+
+static inline uint64_t entry_word(prefix_entry_t *e)
+{
+	return odp_atomic_load_acq_u64(&e->word);
+}
+
+static inline int word_is_child(uint64_t word)
+{
+	return (word & ENTRY_CHILD) != 0;
+}
+
+static inline prefix_entry_t *word_subtree(uint64_t word)
+{
+	return (prefix_entry_t *)(uintptr_t)(word & ~(uint64_t)ENTRY_CHILD);
+}
+
+static inline odp_buffer_t word_nexthop(uint64_t word)
+{
+	return (odp_buffer_t)(uintptr_t)(word >> 1);
+}
+
+static inline int entry_is_child(prefix_entry_t *e)
+{
+	return word_is_child(entry_word(e));
+}
+
+static inline prefix_entry_t *entry_subtree(prefix_entry_t *e)
+{
+	return word_subtree(entry_word(e));
+}
+
+static inline odp_buffer_t entry_nexthop(prefix_entry_t *e)
+{
+	return word_nexthop(entry_word(e));
+}
+
+static inline void
+entry_set_leaf(prefix_entry_t *e, uint8_t cidr, odp_buffer_t nexthop)
+{
+	e->cidr = cidr;
+	odp_atomic_store_rel_u64(&e->word,
+				 (uint64_t)(uintptr_t)nexthop << 1);
+}
+
+/* Link a subtree to an entry. The subtree must be fully initialized, as
+ * lookups may follow the link immediately. */
+static inline void
+entry_set_child(prefix_entry_t *e, prefix_entry_t *subtree)
+{
+	odp_atomic_store_rel_u64(&e->word,
+				 (uint64_t)(uintptr_t)subtree | ENTRY_CHILD);
+}
+
 /***********************************************************
  *****************   Cache management   ********************
  ***********************************************************/
@@ -168,8 +261,10 @@ cache_init_buffer(odp_buffer_t buffer, cache_type_t type, uint32_t size)
 	if (type == CACHE_TYPE_SUBTREE) {
 		prefix_entry_t *entry = (prefix_entry_t *)addr;
 
-		for (i = 0; i < ENTRY_NUM_SUBTREE; i++, entry++)
-			entry->nexthop = ODP_BUFFER_INVALID;
+		for (i = 0; i < ENTRY_NUM_SUBTREE; i++, entry++) {
+			odp_atomic_init_u64(&entry->word, 0);
+			entry_set_leaf(entry, 0, ODP_BUFFER_INVALID);
+		}
 	} else if (type == CACHE_TYPE_TRIE) {
 		trie_node_t *node = (trie_node_t *)addr;
 
@@ -277,6 +372,121 @@ cache_get_buffer(odph_iplookup_table_impl *tbl, cache_type_t type)
 	return buffer;
 }
 
+/***********************************************************
+ ****************   Subtree reclamation   ******************
+ ***********************************************************/
+
+/* Return a subtree buffer into the free queue */
+static void
+subtree_put_buffer(odph_iplookup_table_impl *tbl, odp_buffer_t buffer)
+{
+	cache_init_buffer(
+			buffer, CACHE_TYPE_SUBTREE,
+			ENTRY_SIZE * ENTRY_NUM_SUBTREE);
+	odp_queue_enq(
+			tbl->free_slots[CACHE_TYPE_SUBTREE],
+			odp_buffer_to_event(buffer));
+}
+
+/* Release a subtree that has been unlinked from the table. In concurrent
+ * mode, lookups may still be reading the subtree, so it is queued until
+ * all readers have passed a quiescent state.
+ */
+static void
+subtree_free(odph_iplookup_table_impl *tbl, odp_buffer_t buffer)
+{
+	retired_subtree_t *retired;
+
+	if (!tbl->concurrent) {
+		subtree_put_buffer(tbl, buffer);
+		return;
+	}
+
+	retired = (retired_subtree_t *)(void *)
+		ENTRY_BUFF_ARR(odp_buffer_addr(buffer));
+	retired->next = ODP_BUFFER_INVALID;
+	retired->epoch = odp_atomic_load_u64(&tbl->epoch);
+
+	if (tbl->retired_head == ODP_BUFFER_INVALID) {
+		tbl->retired_head = buffer;
+	} else {
+		retired_subtree_t *tail = (retired_subtree_t *)(void *)
+			ENTRY_BUFF_ARR(odp_buffer_addr(tbl->retired_tail));
+
+		tail->next = buffer;
+	}
+	tbl->retired_tail = buffer;
+}
+
+/* Start a new update epoch and recycle subtrees which all online readers
+ * have stopped using. Called at the end of each update in concurrent mode.
+ */
+static void
+subtree_reclaim(odph_iplookup_table_impl *tbl)
+{
+	uint64_t min_epoch = UINT64_MAX;
+	int i, num_thr = odp_thread_count_max();
+
+	if (tbl->retired_head == ODP_BUFFER_INVALID)
+		return;
+
+	/* Readers observing the new epoch cannot see subtrees unlinked
+	 * before it. */
+	odp_atomic_inc_u64(&tbl->epoch);
+	odp_mb_full();
+
+	for (i = 0; i < num_thr; i++) {
+		uint64_t epoch = odp_atomic_load_acq_u64(&tbl->reader[i].epoch);
+
+		if (epoch && epoch < min_epoch)
+			min_epoch = epoch;
+	}
+
+	while (tbl->retired_head != ODP_BUFFER_INVALID) {
+		odp_buffer_t buffer = tbl->retired_head;
+		retired_subtree_t *retired = (retired_subtree_t *)(void *)
+			ENTRY_BUFF_ARR(odp_buffer_addr(buffer));
+
+		if (retired->epoch >= min_epoch)
+			break;
+
+		tbl->retired_head = retired->next;
+		subtree_put_buffer(tbl, buffer);
+	}
+}
+
+/* Recycle all retired subtrees, without waiting for readers */
+static void
+subtree_reclaim_all(odph_iplookup_table_impl *tbl)
+{
+	while (tbl->retired_head != ODP_BUFFER_INVALID) {
+		odp_buffer_t buffer = tbl->retired_head;
+		retired_subtree_t *retired = (retired_subtree_t *)(void *)
+			ENTRY_BUFF_ARR(odp_buffer_addr(buffer));
+
+		tbl->retired_head = retired->next;
+		subtree_put_buffer(tbl, buffer);
+	}
+}
+
+/* Recycle a subtree and all its child subtrees (no concurrent readers) */
+static void
+subtree_destroy(odph_iplookup_table_impl *tbl, prefix_entry_t *subtree)
+{
+	odp_buffer_t *buff = ENTRY_BUFF_ARR(subtree);
+	int i;
+
+	for (i = 0; i < ENTRY_NUM_SUBTREE; i++) {
+		if (!entry_is_child(&subtree[i]))
+			continue;
+
+		subtree_destroy(tbl, entry_subtree(&subtree[i]));
+		odp_queue_enq(
+				tbl->free_slots[CACHE_TYPE_SUBTREE],
+				odp_buffer_to_event(buff[i]));
+	}
+}
+
 /***********************************************************
  ******************     Binary trie     ********************
  ***********************************************************/
@@ -325,9 +535,10 @@ trie_destroy(odph_iplookup_table_impl *tbl, trie_node_t *trie)
 static int
 trie_insert_node(
 		odph_iplookup_table_impl *tbl, trie_node_t *root,
-		uint32_t ip, uint8_t cidr, odp_buffer_t nexthop)
+		const uint8_t *ip, uint8_t cidr, odp_buffer_t nexthop)
 {
-	uint8_t level = 0, child;
+	uint32_t level = 0;
+	uint8_t child;
 	odp_buffer_t buf;
 	trie_node_t *node = root, *prev = root;
 
@@ -360,11 +571,27 @@ trie_insert_node(
 	return 0;
 }
 
+/* Find the node of a prefix. Return NULL if the prefix does not exist. */
+static trie_node_t *
+trie_find_node(trie_node_t *root, const uint8_t *ip, uint8_t cidr)
+{
+	trie_node_t *node = root;
+	uint32_t level;
+
+	for (level = 1; level <= cidr && node != NULL; level++)
+		node = WHICH_CHILD(ip, level) == 0 ? node->left : node->right;
+
+	if (node == NULL || node->nexthop == ODP_BUFFER_INVALID)
+		return NULL;
+
+	return node;
+}
+
 /* Delete a node */
 static int
 trie_delete_node(
 		odph_iplookup_table_impl *tbl,
-		trie_node_t *root, uint32_t ip, uint8_t cidr)
+		trie_node_t *root, const uint8_t *ip, uint8_t cidr)
 {
 	if (root == NULL)
 		return -1;
@@ -374,7 +601,8 @@ trie_delete_node(
 		return -1;
 
 	trie_node_t *node = root, *prev = NULL;
-	uint8_t level = 1, child = 0;
+	uint32_t level = 1;
+	uint8_t child = 0;
 	odp_buffer_t tmp;
 
 	/* Find the target node. */
@@ -419,7 +647,7 @@ trie_delete_node(
 /* Detect the longest overlapping prefix. */
 static int
 trie_detect_overlap(
-		trie_node_t *trie, uint32_t ip, uint8_t cidr,
+		trie_node_t *trie, const uint8_t *ip, uint8_t cidr,
 		uint8_t leaf_push, uint8_t *over_cidr,
 		odp_buffer_t *over_nexthop)
 {
@@ -430,6 +658,8 @@ trie_detect_overlap(
 	for (level = 1; level < limit; level++) {
 		child = WHICH_CHILD(ip, level);
 		node = (child == 0) ? node->left : node->right;
+		if (node == NULL)
+			break;
 		if (node->nexthop != ODP_BUFFER_INVALID)
 			longest = node;
 	}
@@ -443,6 +673,38 @@ trie_detect_overlap(
  ***************   IP prefix lookup table   ****************
  ***********************************************************/
 
+/* Copy a prefix key into a masked address */
+static int
+prefix_key_parse(
+		const odph_iplookup_table_impl *tbl, const void *key,
+		uint8_t ip[IPV6_LENGTH / 8], uint8_t *cidr)
+{
+	uint32_t i;
+	odp_u32be_t ip4;
+
+	if (tbl->ip_len == IPV4_LENGTH) {
+		const odph_iplookup_prefix_t *prefix = key;
+
+		*cidr = prefix->cidr;
+		ip4 = odp_cpu_to_be_32(prefix->ip);
+		memcpy(ip, &ip4, sizeof(ip4));
+	} else {
+		const odph_iplookup_prefix6_t *prefix = key;
+
+		*cidr = prefix->cidr;
+		memcpy(ip, prefix->ip, ODPH_IPV6ADDR_LEN);
+	}
+
+	if (*cidr == 0 || *cidr > tbl->ip_len)
+		return -1;
+
+	/* mask out host bits */
+	for (i = *cidr; i < tbl->ip_len; i++)
+		ip[i >> 3] &= ~(0x80 >> (i & 7));
+
+	return 0;
+}
+
 odph_table_t
 odph_iplookup_table_lookup(const char *name)
 {
@@ -465,10 +727,27 @@ odph_iplookup_table_lookup(const char *name)
 	return NULL;
 }
 
+void odph_iplookup_table_param_init(odph_iplookup_table_param_t *param)
+{
+	memset(param, 0, sizeof(odph_iplookup_table_param_t));
+	param->type = ODPH_IPLOOKUP_IPV4;
+}
+
 odph_table_t odph_iplookup_table_create(const char *name,
 					uint32_t p1 ODP_UNUSED,
 					uint32_t p2 ODP_UNUSED,
 					uint32_t value_size)
+{
+	odph_iplookup_table_param_t param;
+
+	odph_iplookup_table_param_init(&param);
+
+	return odph_iplookup_table_create_param(name, value_size, &param);
+}
+
+odph_table_t
+odph_iplookup_table_create_param(const char *name, uint32_t value_size,
+				 const odph_iplookup_table_param_t *param)
 {
 	odph_iplookup_table_impl *tbl;
 	odp_shm_t shm_tbl;
@@ -476,7 +755,7 @@ odph_table_t odph_iplookup_table_create(const char *name,
 	odp_queue_param_t qparam;
 	odp_queue_capability_t queue_capa;
 	unsigned i;
-	uint32_t impl_size, l1_size, queue_size;
+	uint32_t impl_size, l1_size, reader_size, queue_size;
 	char queue_name[ODPH_TABLE_NAME_LEN + 2];
 
 	if (odp_queue_capability(&queue_capa)) {
@@ -497,7 +776,9 @@ odph_table_t odph_iplookup_table_create(const char *name,
 		queue_size = CACHE_NUM_SUBTREE;
 
 	/* Check for valid parameters */
-	if (strlen(name) == 0) {
+	if (param == NULL || strlen(name) == 0 ||
+	    (param->type != ODPH_IPLOOKUP_IPV4 &&
+	     param->type != ODPH_IPLOOKUP_IPV6)) {
 		ODPH_DBG("invalid parameters\n");
 		return NULL;
 	}
@@ -512,9 +793,12 @@ odph_table_t odph_iplookup_table_create(const char *name,
 	/* Calculate the sizes of different parts of IP prefix table */
 	impl_size = sizeof(odph_iplookup_table_impl);
 	l1_size = ENTRY_SIZE * ENTRY_NUM_L1;
+	reader_size = 0;
+	if (param->concurrent)
+		reader_size = sizeof(reader_state_t) * ODP_THREAD_COUNT_MAX;
 
 	shm_tbl = odp_shm_reserve(
-				name, impl_size + l1_size,
+				name, impl_size + l1_size + reader_size,
 				ODP_CACHE_LINE_SIZE, ODP_SHM_SW_ONLY);
 
 	if (shm_tbl == ODP_SHM_INVALID) {
@@ -525,19 +809,36 @@ odph_table_t odph_iplookup_table_create(const char *name,
 	}
 
 	tbl = (odph_iplookup_table_impl *)odp_shm_addr(shm_tbl);
-	memset(tbl, 0, impl_size + l1_size);
+	memset(tbl, 0, impl_size + l1_size + reader_size);
 
 	/* header of this mem block is the table impl struct,
-	 * then the l1 entries array.
+	 * then the l1 entries array and the reader states.
 	 */
 	tbl->l1e = (prefix_entry_t *)(void *)((char *)tbl + impl_size);
-	for (i = 0; i < ENTRY_NUM_L1; i++)
-		tbl->l1e[i].nexthop = ODP_BUFFER_INVALID;
+	for (i = 0; i < ENTRY_NUM_L1; i++) {
+		odp_atomic_init_u64(&tbl->l1e[i].word, 0);
+		entry_set_leaf(&tbl->l1e[i], 0, ODP_BUFFER_INVALID);
+	}
+
+	tbl->reader = NULL;
+	if (param->concurrent) {
+		tbl->reader = (reader_state_t *)(void *)
+			((char *)tbl + impl_size + l1_size);
+		for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+			odp_atomic_init_u64(&tbl->reader[i].epoch, 0);
+	}
 
 	/* Setup table context. */
 	snprintf(tbl->name, sizeof(tbl->name), "%s", name);
 	tbl->magicword = ODPH_IP_LOOKUP_TABLE_MAGIC_WORD;
 	tbl->nexthop_len = value_size;
+	tbl->ip_len = param->type == ODPH_IPLOOKUP_IPV6 ?
+			IPV6_LENGTH : IPV4_LENGTH;
+	tbl->concurrent = !!param->concurrent;
+	odp_spinlock_init(&tbl->lock);
+	odp_atomic_init_u64(&tbl->epoch, 1);
+	tbl->retired_head = ODP_BUFFER_INVALID;
+	tbl->retired_tail = ODP_BUFFER_INVALID;
 
 	/* Initialize cache */
 	for (i = 0; i < 2; i++) {
@@ -569,10 +870,9 @@ odph_table_t odph_iplookup_table_create(const char *name,
 int
 odph_iplookup_table_destroy(odph_table_t tbl)
 {
-	int i, j;
+	int i;
 	odph_iplookup_table_impl *impl = NULL;
-	prefix_entry_t *subtree = NULL;
-	odp_buffer_t *buff1 = NULL, *buff2 = NULL;
+	odp_buffer_t *buff1 = NULL;
 
 	if (tbl == NULL)
 		return -1;
@@ -588,27 +888,18 @@ odph_iplookup_table_destroy(odph_table_t tbl)
 	/* destroy trie */
 	trie_destroy(impl, impl->trie);
 
-	/* free all L2 and L3 entries */
+	/* free all subtrees */
 	buff1 = ENTRY_BUFF_ARR(impl->l1e);
 	for (i = 0; i < ENTRY_NUM_L1; i++) {
-		if ((impl->l1e[i]).child == 0)
+		if (!entry_is_child(&impl->l1e[i]))
 			continue;
 
-		subtree = (prefix_entry_t *)impl->l1e[i].ptr;
-		buff2 = ENTRY_BUFF_ARR(subtree);
-		/* destroy all l3 subtrees of this l2 subtree */
-		for (j = 0; j < ENTRY_NUM_SUBTREE; j++) {
-			if (subtree[j].child == 0)
-				continue;
-			odp_queue_enq(
-					impl->free_slots[CACHE_TYPE_TRIE],
-					odp_buffer_to_event(buff2[j]));
-		}
-		/* destroy this l2 subtree */
+		subtree_destroy(impl, entry_subtree(&impl->l1e[i]));
 		odp_queue_enq(
-				impl->free_slots[CACHE_TYPE_TRIE],
+				impl->free_slots[CACHE_TYPE_SUBTREE],
 				odp_buffer_to_event(buff1[i]));
 	}
+	subtree_reclaim_all(impl);
 
 	/* destroy all cache */
 	cache_destroy(impl);
@@ -618,62 +909,57 @@ odph_iplookup_table_destroy(odph_table_t tbl)
 	return 0;
 }
 
-/* Insert the prefix into level x
+/* Insert the prefix into 'num' consecutive entries of a level
  * Return:
- *   -1	error
  *   0	the table is unmodified
  *   1	the table is modified
  */
 static int
 prefix_insert_into_lx(
 		odph_iplookup_table_impl *tbl, prefix_entry_t *entry,
-		uint8_t cidr, odp_buffer_t nexthop, uint8_t level)
+		uint32_t num, uint8_t cidr, odp_buffer_t nexthop)
 {
 	int ret = 0;
-	uint32_t i = 0, limit = (1 << (level - cidr));
-	prefix_entry_t *e = entry, *ne = NULL;
+	uint32_t i = 0;
+	prefix_entry_t *e = entry;
 
-	for (i = 0; i < limit; i++, e++) {
+	for (i = 0; i < num; i++, e++) {
 		if (e->cidr > cidr)
 			continue;
 
-		if (e->child == 1) {
+		if (entry_is_child(e)) {
 			e->cidr = cidr;
 			/* push to next level */
-			ne = (prefix_entry_t *)e->ptr;
-			ret = prefix_insert_into_lx(
-					tbl, ne, cidr, nexthop, cidr + 8);
-			if (ret == -1)
-				return -1;
-			if (ret == 0)
-				return ret;
+			if (prefix_insert_into_lx(
+					tbl, entry_subtree(e),
+					ENTRY_NUM_SUBTREE, cidr, nexthop))
+				ret = 1;
 		} else {
-			e->child = 0;
-			e->cidr = cidr;
-			e->nexthop = nexthop;
+			entry_set_leaf(e, cidr, nexthop);
 			ret = 1;
 		}
 	}
 	return ret;
 }
 
+/* Insert a prefix longer than 'level' below an entry of 'level' */
 static int
 prefix_insert_iter(
 		odph_iplookup_table_impl *tbl, prefix_entry_t *entry,
-		odp_buffer_t *buff, uint32_t ip, uint8_t cidr,
-		odp_buffer_t nexthop, uint8_t level, uint8_t depth)
+		odp_buffer_t *buff, const uint8_t *ip, uint8_t cidr,
+		odp_buffer_t nexthop, uint32_t level)
 {
-	uint8_t state = 0;
 	prefix_entry_t *ne = NULL;
 	odp_buffer_t *nbuff = NULL;
+	uint32_t next = level + SUBTREE_LENGTH;
 
 	/* If child subtree is existed, get it. */
-	if (entry->child) {
-		ne = (prefix_entry_t *)entry->ptr;
+	if (entry_is_child(entry)) {
+		ne = entry_subtree(entry);
 		nbuff = ENTRY_BUFF_ARR(ne);
 	} else {
 		/* If the child is not existed, create a new subtree. */
-		odp_buffer_t buf, push = entry->nexthop;
+		odp_buffer_t buf;
 
 		buf = cache_get_buffer(tbl, CACHE_TYPE_SUBTREE);
 		if (buf == ODP_BUFFER_INVALID) {
@@ -683,39 +969,34 @@ prefix_insert_iter(
 		ne = (prefix_entry_t *)odp_buffer_addr(buf);
 		nbuff = ENTRY_BUFF_ARR(ne);
 
-		entry->child = 1;
-		entry->ptr = ne;
-		*buff = buf;
-
 		/* If this entry contains a nexthop and a small cidr,
-		 * push it to the next level.
+		 * push it to the next level before linking the subtree.
 		 */
 		if (entry->cidr > 0)
-			(void)prefix_insert_into_lx(tbl, ne, entry->cidr,
-						    push, entry->cidr + 8);
-	}
+			(void)prefix_insert_into_lx(tbl, ne, ENTRY_NUM_SUBTREE,
+						    entry->cidr,
+						    entry_nexthop(entry));
 
-	ne += (ip >> 24);
-	nbuff += (ip >> 24);
-	if (cidr <= 8) {
-		state = prefix_insert_into_lx(
-				tbl, ne, cidr + depth * 8, nexthop, level);
-	} else {
-		state = prefix_insert_iter(
-				tbl, ne, nbuff, ip << 8, cidr - 8,
-				nexthop, level + 8, depth + 1);
+		*buff = buf;
+		entry_set_child(entry, ne);
 	}
 
-	return state;
+	ne += SUBTREE_INDEX(ip, next);
+	nbuff += SUBTREE_INDEX(ip, next);
+	if (cidr <= next)
+		return prefix_insert_into_lx(
+				tbl, ne, 1 << (next - cidr), cidr, nexthop);
+
+	return prefix_insert_iter(tbl, ne, nbuff, ip, cidr, nexthop, next);
 }
 
 int
 odph_iplookup_table_put_value(odph_table_t tbl, void *key, void *value)
 {
 	odph_iplookup_table_impl *impl = (void *)tbl;
-	odph_iplookup_prefix_t *prefix = (odph_iplookup_prefix_t *)key;
 	prefix_entry_t *l1e = NULL;
-	odp_buffer_t nexthop;
+	odp_buffer_t nexthop, *buff;
+	uint8_t ip[IPV6_LENGTH / 8], cidr;
 	int ret = 0;
 
 	if ((tbl == NULL) || (key == NULL) || (value == NULL))
@@ -723,102 +1004,195 @@ odph_iplookup_table_put_value(odph_table_t tbl, void *key, void *value)
 
 	nexthop = *((odp_buffer_t *)value);
 
-	if (prefix->cidr == 0 || prefix->cidr > 32)
+	/* The most significant bit is not stored into entries */
+	if (((uint64_t)(uintptr_t)nexthop << 1) >> 1 !=
+	    (uint64_t)(uintptr_t)nexthop)
 		return -1;
 
-	prefix->ip = prefix->ip & (0xffffffff << (IP_LENGTH - prefix->cidr));
+	if (prefix_key_parse(impl, key, ip, &cidr))
+		return -1;
+
+	if (impl->concurrent)
+		odp_spinlock_lock(&impl->lock);
 
 	/* insert into trie */
 	ret = trie_insert_node(
 				impl, impl->trie,
-				prefix->ip, prefix->cidr, nexthop);
+				ip, cidr, nexthop);
 
 	if (ret < 0) {
 		ODPH_DBG("failed to insert into trie\n");
-		return -1;
+		goto out;
 	}
 
 	/* get L1 entry */
-	l1e = &impl->l1e[prefix->ip >> 16];
-	odp_buffer_t *buff = ENTRY_BUFF_ARR(impl->l1e) + (prefix->ip >> 16);
+	l1e = &impl->l1e[L1_INDEX(ip)];
+	buff = ENTRY_BUFF_ARR(impl->l1e) + L1_INDEX(ip);
 
-	if (prefix->cidr <= 16) {
+	if (cidr <= L1_LENGTH) {
 		ret = prefix_insert_into_lx(
-				impl, l1e, prefix->cidr, nexthop, 16);
+				impl, l1e, 1 << (L1_LENGTH - cidr),
+				cidr, nexthop);
 	} else {
 		ret = prefix_insert_iter(
-				impl, l1e, buff,
-				((prefix->ip) << 16), prefix->cidr - 16,
-				nexthop, 24, 2);
+				impl, l1e, buff, ip, cidr,
+				nexthop, L1_LENGTH);
+	}
+
+out:
+	if (impl->concurrent) {
+		subtree_reclaim(impl);
+		odp_spinlock_unlock(&impl->lock);
 	}
 
 	return ret;
 }
 
+/* Find the nexthop of an address */
+static inline odp_buffer_t
+prefix_lookup(odph_iplookup_table_impl *tbl, const uint8_t *ip)
+{
+	uint64_t word = entry_word(&tbl->l1e[L1_INDEX(ip)]);
+	uint32_t level = L1_LENGTH + SUBTREE_LENGTH;
+
+	while (word_is_child(word)) {
+		word = entry_word(word_subtree(word) +
+				  SUBTREE_INDEX(ip, level));
+		level += SUBTREE_LENGTH;
+	}
+
+	return word_nexthop(word);
+}
+
+/* Find nexthops of a burst of addresses. Each round loads one level of
+ * entries for all unresolved addresses, and prefetches their next level
+ * entries for the following round.
+ */
+static void
+prefix_lookup_burst(
+		odph_iplookup_table_impl *tbl, const uint8_t *ip[],
+		odp_buffer_t nexthop[], int num)
+{
+	prefix_entry_t *entry[LOOKUP_BURST];
+	uint8_t active[LOOKUP_BURST];
+	uint32_t level = L1_LENGTH + SUBTREE_LENGTH;
+	int i, num_active = num;
+
+	for (i = 0; i < num; i++) {
+		entry[i] = &tbl->l1e[L1_INDEX(ip[i])];
+		odp_prefetch(entry[i]);
+		active[i] = i;
+	}
+
+	while (num_active) {
+		int num_next = 0;
+
+		for (i = 0; i < num_active; i++) {
+			int idx = active[i];
+			uint64_t word = entry_word(entry[idx]);
+
+			if (word_is_child(word)) {
+				entry[idx] = word_subtree(word) +
+					     SUBTREE_INDEX(ip[idx], level);
+				odp_prefetch(entry[idx]);
+				active[num_next++] = idx;
+			} else {
+				nexthop[idx] = word_nexthop(word);
+			}
+		}
+
+		num_active = num_next;
+		level += SUBTREE_LENGTH;
+	}
+}
+
 int odph_iplookup_table_get_value(odph_table_t tbl, void *key,
 				  void *buffer ODP_UNUSED,
 				  uint32_t buffer_size ODP_UNUSED)
 {
 	odph_iplookup_table_impl *impl = (void *)tbl;
-	uint32_t ip;
-	prefix_entry_t *entry;
 	odp_buffer_t *buff = (odp_buffer_t *)buffer;
+	odp_u32be_t ip;
 
 	if ((tbl == NULL) || (key == NULL) || (buffer == NULL))
 		return -EINVAL;
 
-	ip = *((uint32_t *)key);
-	entry = &impl->l1e[ip >> 16];
-
-	if (entry == NULL) {
-		ODPH_DBG("failed to get L1 entry.\n");
-		return -1;
+	if (impl->ip_len == IPV4_LENGTH) {
+		ip = odp_cpu_to_be_32(*((uint32_t *)key));
+		*buff = prefix_lookup(impl, (uint8_t *)&ip);
+	} else {
+		*buff = prefix_lookup(impl, key);
 	}
 
-	ip <<= 16;
-	while (entry->child) {
-		entry = (prefix_entry_t *)entry->ptr;
-		entry += ip >> 24;
-		ip <<= 8;
-	}
+	/* ONLY match the default prefix */
+	if (*buff == ODP_BUFFER_INVALID)
+		ODPH_DBG("only match the default prefix\n");
 
-	/* copy data */
-	if (entry->nexthop == ODP_BUFFER_INVALID) {
-		/* ONLY match the default prefix */
-		printf("only match the default prefix\n");
-		*buff = ODP_BUFFER_INVALID;
-	} else {
-		*buff = entry->nexthop;
+	return 0;
+}
+
+int odph_iplookup_table_get_value_multi(odph_table_t tbl, const void *key,
+					void *buffer, int num)
+{
+	odph_iplookup_table_impl *impl = (void *)tbl;
+	odp_buffer_t *buff = (odp_buffer_t *)buffer;
+	const uint8_t *ip[LOOKUP_BURST];
+	odp_u32be_t ip4[LOOKUP_BURST];
+	int i, j, burst;
+
+	if ((tbl == NULL) || (key == NULL) || (buffer == NULL) || num < 0)
+		return -EINVAL;
+
+	for (i = 0; i < num; i += burst) {
+		burst = num - i;
+		if (burst > LOOKUP_BURST)
+			burst = LOOKUP_BURST;
+
+		for (j = 0; j < burst; j++) {
+			if (impl->ip_len == IPV4_LENGTH) {
+				ip4[j] = odp_cpu_to_be_32(
+						((const uint32_t *)key)[i + j]);
+				ip[j] = (const uint8_t *)&ip4[j];
+			} else {
+				ip[j] = (const uint8_t *)key +
+					(i + j) * ODPH_IPV6ADDR_LEN;
+			}
+		}
+
+		prefix_lookup_burst(impl, ip, &buff[i], burst);
 	}
 
-	return 0;
+	return num;
 }
 
-static int
+/* Replace a deleted prefix in 'num' consecutive entries of a level.
+ * Return 1 if all the entries were replaced.
+ */
+static uint8_t
 prefix_delete_lx(
 		odph_iplookup_table_impl *tbl, prefix_entry_t *l1e,
-		odp_buffer_t *buff, uint8_t cidr, uint8_t over_cidr,
-		odp_buffer_t over_nexthop, uint8_t level)
+		odp_buffer_t *buff, uint32_t num, uint8_t cidr,
+		uint8_t over_cidr, odp_buffer_t over_nexthop)
 {
 	uint8_t ret, flag = 1;
 	prefix_entry_t *e = l1e;
 	odp_buffer_t *b = buff;
-	uint32_t i = 0, limit = 1 << (level - cidr);
+	uint32_t i = 0;
 
-	for (i = 0; i < limit; i++, e++, b++) {
-		if (e->child == 1) {
-			if (e->cidr > cidr) {
-				flag = 0;
-				continue;
-			}
+	for (i = 0; i < num; i++, e++, b++) {
+		if (e->cidr > cidr) {
+			flag = 0;
+			continue;
+		}
 
-			prefix_entry_t *ne = (prefix_entry_t *)e->ptr;
+		if (entry_is_child(e)) {
+			prefix_entry_t *ne = entry_subtree(e);
 			odp_buffer_t *nbuff = ENTRY_BUFF_ARR(ne);
 
 			e->cidr = over_cidr;
 			ret = prefix_delete_lx(
-					tbl, ne, nbuff, cidr, over_cidr,
-					over_nexthop, cidr + 8);
+					tbl, ne, nbuff, ENTRY_NUM_SUBTREE,
+					cidr, over_cidr, over_nexthop);
 
 			/* If ret == 1, the next 2^8 entries equal to
 			 * (over_cidr, over_nexthop). In this case, we
@@ -827,26 +1201,14 @@ prefix_delete_lx(
 			 * the next 2^8 entries.
 			 */
 			if (ret) {
-				/* destroy subtree */
-				cache_init_buffer(
-					*b, CACHE_TYPE_SUBTREE,
-					ENTRY_SIZE * ENTRY_NUM_SUBTREE);
-				odp_queue_enq(
-					tbl->free_slots[CACHE_TYPE_SUBTREE],
-					odp_buffer_to_event(*b));
-				e->child = 0;
-				e->nexthop = over_nexthop;
+				/* unlink and destroy subtree */
+				entry_set_leaf(e, over_cidr, over_nexthop);
+				subtree_free(tbl, *b);
 			} else {
 				flag = 0;
 			}
 		} else {
-			if (e->cidr > cidr) {
-				flag = 0;
-				continue;
-			} else {
-				e->cidr = over_cidr;
-				e->nexthop = over_nexthop;
-			}
+			entry_set_leaf(e, over_cidr, over_nexthop);
 		}
 	}
 	return flag;
@@ -863,22 +1225,20 @@ can_recycle(prefix_entry_t *e, uint32_t level)
 {
 	uint8_t recycle = 1;
 	int i = 1;
-	prefix_entry_t *ne = (prefix_entry_t *)e->ptr;
+	prefix_entry_t *ne = entry_subtree(e);
+	uint64_t word = entry_word(ne);
 
-	if (ne->child)
+	if (word_is_child(word))
 		return 0;
 
 	uint8_t cidr = ne->cidr;
-	odp_buffer_t index = ne->nexthop;
 
 	if (cidr > level)
 		return 0;
 
 	ne++;
-	for (; i < 256; i++, ne++) {
-		if (
-				ne->child != 0 || ne->cidr != cidr ||
-				ne->nexthop != index) {
+	for (; i < ENTRY_NUM_SUBTREE; i++, ne++) {
+		if (ne->cidr != cidr || entry_word(ne) != word) {
 			recycle = 0;
 			break;
 		}
@@ -886,102 +1246,130 @@ can_recycle(prefix_entry_t *e, uint32_t level)
 	return recycle;
 }
 
+/* Delete a prefix longer than 'level' below an entry of 'level'.
+ * Return 1 if the subtree of the entry was recycled.
+ */
 static uint8_t
 prefix_delete_iter(
 		odph_iplookup_table_impl *tbl, prefix_entry_t *e,
-		odp_buffer_t *buff, uint32_t ip, uint8_t cidr,
-		uint8_t level, uint8_t depth)
+		odp_buffer_t *buff, const uint8_t *ip, uint8_t cidr,
+		uint32_t level)
 {
 	uint8_t ret = 0, over_cidr;
 	odp_buffer_t over_nexthop;
+	uint32_t next = level + SUBTREE_LENGTH;
+	prefix_entry_t *ne;
+	odp_buffer_t *nbuff;
 
-	trie_detect_overlap(
-			tbl->trie, ip, cidr + 8 * depth, level,
-			&over_cidr, &over_nexthop);
-	if (cidr > 8) {
-		prefix_entry_t *ne =
-			(prefix_entry_t *)e->ptr;
-		odp_buffer_t *nbuff = ENTRY_BUFF_ARR(ne);
-
-		ne += ((uint32_t)(ip << level) >> 24);
-		nbuff += ((uint32_t)(ip << level) >> 24);
-		ret = prefix_delete_iter(
-				tbl, ne, nbuff, ip, cidr - 8,
-				level + 8, depth + 1);
-
-		if (ret && can_recycle(e, level)) {
-			/* destroy subtree */
-			cache_init_buffer(
-				*buff, CACHE_TYPE_SUBTREE,
-				ENTRY_SIZE * ENTRY_NUM_SUBTREE);
-			odp_queue_enq(
-				tbl->free_slots[CACHE_TYPE_SUBTREE],
-				odp_buffer_to_event(*buff));
-			e->child = 0;
-			e->nexthop = over_nexthop;
-			e->cidr = over_cidr;
-			return 1;
-		}
+	if (!entry_is_child(e))
 		return 0;
+
+	ne = entry_subtree(e);
+	nbuff = ENTRY_BUFF_ARR(ne);
+	ne += SUBTREE_INDEX(ip, next);
+	nbuff += SUBTREE_INDEX(ip, next);
+
+	if (cidr > next) {
+		ret = prefix_delete_iter(tbl, ne, nbuff, ip, cidr, next);
+	} else {
+		trie_detect_overlap(
+				tbl->trie, ip, cidr, next,
+				&over_cidr, &over_nexthop);
+		ret = prefix_delete_lx(
+				tbl, ne, nbuff, 1 << (next - cidr), cidr,
+				over_cidr, over_nexthop);
 	}
 
-	ret = prefix_delete_lx(
-			tbl, e, buff, cidr + 8 * depth,
-			over_cidr, over_nexthop, level);
-	return ret;
+	if (ret && can_recycle(e, level)) {
+		trie_detect_overlap(
+				tbl->trie, ip, cidr, level,
+				&over_cidr, &over_nexthop);
+		/* unlink and destroy subtree */
+		entry_set_leaf(e, over_cidr, over_nexthop);
+		subtree_free(tbl, *buff);
+		return 1;
+	}
+	return 0;
 }
 
 int
 odph_iplookup_table_remove_value(odph_table_t tbl, void *key)
 {
 	odph_iplookup_table_impl *impl = (void *)tbl;
-	odph_iplookup_prefix_t *prefix = (odph_iplookup_prefix_t *)key;
-	uint32_t ip;
-	uint8_t cidr;
+	uint8_t ip[IPV6_LENGTH / 8], cidr;
+	uint8_t over_cidr;
+	odp_buffer_t over_nexthop;
+	int ret;
 
 	if ((tbl == NULL) || (key == NULL))
 		return -EINVAL;
 
-	ip   = prefix->ip;
-	cidr = prefix->cidr;
-
-	if (cidr == 0 || cidr > 32)
+	if (prefix_key_parse(impl, key, ip, &cidr))
 		return -EINVAL;
 
-	prefix_entry_t *entry = &impl->l1e[ip >> 16];
-	odp_buffer_t *buff = ENTRY_BUFF_ARR(impl->l1e) + (ip >> 16);
-	uint8_t over_cidr, ret;
-	odp_buffer_t over_nexthop;
+	if (impl->concurrent)
+		odp_spinlock_lock(&impl->lock);
+
+	if (trie_find_node(impl->trie, ip, cidr) == NULL) {
+		ODPH_DBG("Prefix is not existed\n");
+		ret = -1;
+		goto out;
+	}
 
-	trie_detect_overlap(
-			impl->trie, ip, cidr, 16, &over_cidr, &over_nexthop);
+	prefix_entry_t *entry = &impl->l1e[L1_INDEX(ip)];
+	odp_buffer_t *buff = ENTRY_BUFF_ARR(impl->l1e) + L1_INDEX(ip);
 
-	if (cidr <= 16) {
+	if (cidr <= L1_LENGTH) {
+		trie_detect_overlap(
+				impl->trie, ip, cidr, L1_LENGTH,
+				&over_cidr, &over_nexthop);
 		prefix_delete_lx(
-			impl, entry, buff, cidr, over_cidr, over_nexthop, 16);
+			impl, entry, buff, 1 << (L1_LENGTH - cidr), cidr,
+			over_cidr, over_nexthop);
 	} else {
-		prefix_entry_t *ne = (prefix_entry_t *)entry->ptr;
-		odp_buffer_t *nbuff = ENTRY_BUFF_ARR(ne);
-
-		ne += ((uint32_t)(ip << 16) >> 24);
-		nbuff += ((uint32_t)(ip << 16) >> 24);
-		ret = prefix_delete_iter(impl, ne, nbuff, ip, cidr - 16, 24, 2);
-
-		if (ret && can_recycle(entry, 16)) {
-			/* destroy subtree */
-			cache_init_buffer(
-				*buff, CACHE_TYPE_SUBTREE,
-				sizeof(prefix_entry_t) * ENTRY_NUM_SUBTREE);
-			odp_queue_enq(
-				impl->free_slots[CACHE_TYPE_SUBTREE],
-				odp_buffer_to_event(*buff));
-			entry->child = 0;
-			entry->cidr = over_cidr;
-			entry->nexthop = over_nexthop;
-		}
+		prefix_delete_iter(impl, entry, buff, ip, cidr, L1_LENGTH);
 	}
 
-	return trie_delete_node(impl, impl->trie, ip, cidr);
+	ret = trie_delete_node(impl, impl->trie, ip, cidr);
+
+out:
+	if (impl->concurrent) {
+		subtree_reclaim(impl);
+		odp_spinlock_unlock(&impl->lock);
+	}
+
+	return ret;
+}
+
+void odph_iplookup_table_quiescent(odph_table_t tbl)
+{
+	odph_iplookup_table_impl *impl = (void *)tbl;
+	odp_atomic_u64_t *reader;
+	uint64_t old;
+
+	if (!impl->concurrent)
+		return;
+
+	reader = &impl->reader[odp_thread_id()].epoch;
+	old = odp_atomic_load_u64(reader);
+
+	/* Previous lookups are done before the new epoch is visible */
+	odp_atomic_store_rel_u64(reader, odp_atomic_load_acq_u64(&impl->epoch));
+
+	/* When coming online, the writer must see the epoch before any
+	 * entries are read. */
+	if (old == 0)
+		odp_mb_full();
+}
+
+void odph_iplookup_table_offline(odph_table_t tbl)
+{
+	odph_iplookup_table_impl *impl = (void *)tbl;
+
+	if (!impl->concurrent)
+		return;
+
+	odp_atomic_store_rel_u64(&impl->reader[odp_thread_id()].epoch, 0);
 }
 
 odph_table_ops_t odph_iplookup_table_ops = {
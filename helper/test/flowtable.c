@@ -0,0 +1,256 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp_api.h>
+#include <odp/helper/odph_api.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_FLOWS   (64 * 1024)
+#define IDLE_TMO_NS (20 * ODP_TIME_MSEC_IN_NS)
+#define NUM_ACTIVE  100
+
+static void make_key(odph_flow_key_t *key, uint32_t i)
+{
+	memset(key, 0, sizeof(odph_flow_key_t));
+	key->src_ip   = 0x0a000000 + i;
+	key->dst_ip   = 0xc0a80000 + (i * 7);
+	key->src_port = 1024 + (i & 0xfff);
+	key->dst_port = 80;
+	key->proto    = 6;
+}
+
+static int test_insert_lookup(odph_flow_table_t table)
+{
+	odph_flow_key_t key[ODPH_FLOW_TABLE_BULK_MAX];
+	uint64_t value[ODPH_FLOW_TABLE_BULK_MAX];
+	uint64_t val, mask;
+	uint32_t i, j;
+
+	for (i = 0; i < NUM_FLOWS; i++) {
+		make_key(&key[0], i);
+		if (odph_flow_table_insert(table, &key[0], i)) {
+			printf("insert %u failed\n", i);
+			return -1;
+		}
+	}
+
+	if (odph_flow_table_flush(table)) {
+		printf("flush failed\n");
+		return -1;
+	}
+
+	if (odph_flow_table_count(table) != NUM_FLOWS) {
+		printf("bad count %u\n", odph_flow_table_count(table));
+		return -1;
+	}
+
+	for (i = 0; i < NUM_FLOWS; i++) {
+		make_key(&key[0], i);
+		if (odph_flow_table_lookup(table, &key[0], &val) || val != i) {
+			printf("lookup %u failed\n", i);
+			return -1;
+		}
+	}
+
+	/* Every other key of the bulk does not exist */
+	for (i = 0; i < NUM_FLOWS; i += ODPH_FLOW_TABLE_BULK_MAX / 2) {
+		for (j = 0; j < ODPH_FLOW_TABLE_BULK_MAX; j++)
+			make_key(&key[j], (j & 1) ? NUM_FLOWS + i + j : i + j / 2);
+
+		if (odph_flow_table_lookup_bulk(table, key, value, ODPH_FLOW_TABLE_BULK_MAX,
+						&mask) != ODPH_FLOW_TABLE_BULK_MAX / 2) {
+			printf("bulk lookup %u failed\n", i);
+			return -1;
+		}
+
+		for (j = 0; j < ODPH_FLOW_TABLE_BULK_MAX; j += 2) {
+			if (!(mask & (1ULL << j)) || value[j] != i + j / 2) {
+				printf("bulk lookup %u: bad value %u\n", i, j);
+				return -1;
+			}
+		}
+
+		if (mask & 0xaaaaaaaaaaaaaaaaULL) {
+			printf("bulk lookup %u: bad mask 0x%" PRIx64 "\n", i, mask);
+			return -1;
+		}
+	}
+
+	printf("\tinsert and lookup success\n");
+	return 0;
+}
+
+static int test_update_delete(odph_flow_table_t table)
+{
+	odph_flow_key_t key;
+	uint64_t val;
+	uint32_t i;
+
+	/* Table is full, updates of existing flows must succeed */
+	make_key(&key, 1);
+	if (odph_flow_table_insert(table, &key, 12345) || odph_flow_table_flush(table)) {
+		printf("update failed\n");
+		return -1;
+	}
+
+	if (odph_flow_table_lookup(table, &key, &val) || val != 12345) {
+		printf("lookup of updated flow failed\n");
+		return -1;
+	}
+
+	make_key(&key, NUM_FLOWS);
+	if (odph_flow_table_insert(table, &key, 0) || odph_flow_table_flush(table) != 1) {
+		printf("insert into full table did not fail\n");
+		return -1;
+	}
+
+	for (i = 0; i < NUM_FLOWS; i++) {
+		make_key(&key, i);
+		if (odph_flow_table_delete(table, &key)) {
+			printf("delete %u failed\n", i);
+			return -1;
+		}
+	}
+
+	make_key(&key, 0);
+	if (odph_flow_table_lookup(table, &key, &val) == 0 ||
+	    odph_flow_table_delete(table, &key) == 0) {
+		printf("deleted flow found\n");
+		return -1;
+	}
+
+	if (odph_flow_table_count(table) != 0) {
+		printf("bad count %u after delete\n", odph_flow_table_count(table));
+		return -1;
+	}
+
+	printf("\tupdate and delete success\n");
+	return 0;
+}
+
+static int test_aging(void)
+{
+	odph_flow_table_param_t param;
+	odph_flow_table_t table;
+	odph_flow_key_t key[NUM_ACTIVE];
+	uint64_t value[NUM_ACTIVE];
+	uint64_t val;
+	odp_time_t end;
+	uint32_t i;
+	int num = 0;
+	int ret = 0;
+
+	odph_flow_table_param_init(&param);
+	param.max_flows = 4 * NUM_ACTIVE;
+	param.idle_timeout_ns = IDLE_TMO_NS;
+
+	table = odph_flow_table_create("flowtable_test_aging", &param);
+	if (table == ODPH_FLOW_TABLE_INVALID) {
+		printf("table create failed\n");
+		return -1;
+	}
+
+	for (i = 0; i < 2 * NUM_ACTIVE; i++) {
+		make_key(&key[0], i);
+		odph_flow_table_insert(table, &key[0], i);
+	}
+
+	if (odph_flow_table_flush(table)) {
+		printf("flush failed\n");
+		odph_flow_table_destroy(table);
+		return -1;
+	}
+
+	/* Keep the first half of flows active */
+	end = odp_time_sum(odp_time_global(), odp_time_global_from_ns(3 * IDLE_TMO_NS));
+
+	while (odp_time_cmp(end, odp_time_global()) > 0) {
+		for (i = 0; i < NUM_ACTIVE; i++) {
+			make_key(&key[0], i);
+			if (odph_flow_table_lookup(table, &key[0], &val)) {
+				printf("active flow %u aged\n", i);
+				ret = -1;
+			}
+		}
+
+		num += odph_flow_table_age(table, key, value, NUM_ACTIVE);
+		odp_time_wait_ns(IDLE_TMO_NS / 10);
+	}
+
+	if (num != NUM_ACTIVE || odph_flow_table_count(table) != NUM_ACTIVE) {
+		printf("aged %i flows, %u left\n", num, odph_flow_table_count(table));
+		ret = -1;
+	}
+
+	if (odph_flow_table_destroy(table)) {
+		printf("table destroy failed\n");
+		ret = -1;
+	}
+
+	if (ret == 0)
+		printf("\taging success\n");
+
+	return ret;
+}
+
+int main(int argc ODP_UNUSED, char *argv[] ODP_UNUSED)
+{
+	odp_instance_t instance;
+	odph_flow_table_param_t param;
+	odph_flow_table_t table;
+	int ret = 0;
+
+	if (odp_init_global(&instance, NULL, NULL)) {
+		ODPH_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(instance, ODP_THREAD_WORKER)) {
+		ODPH_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("flow table test:\n");
+
+	odph_flow_table_param_init(&param);
+	param.max_flows = NUM_FLOWS;
+
+	table = odph_flow_table_create("flowtable_test", &param);
+	if (table == ODPH_FLOW_TABLE_INVALID) {
+		printf("table create failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (test_insert_lookup(table) || test_update_delete(table))
+		ret = -1;
+
+	if (odph_flow_table_destroy(table)) {
+		printf("table destroy failed\n");
+		ret = -1;
+	}
+
+	if (ret == 0 && test_aging())
+		ret = -1;
+
+	if (ret == 0)
+		printf("all tests passed\n");
+
+	if (odp_term_local()) {
+		ODPH_ERR("Error: ODP local term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		ODPH_ERR("Error: ODP global term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -136,6 +136,185 @@ static int test_ip_lookup_table(void)
 	return 0;
 }
 
+/*
+ * IPv6 prefixes with subtrees below the 16,8,8 levels:
+ *	- put short and long prefixes
+ *	- get (hit long prefix, hit short prefix, miss)
+ *	- remove long prefix
+ *	- get (hit short prefix)
+ */
+static int test_ip6_lookup_table(void)
+{
+	odph_iplookup_table_param_t param;
+	odph_iplookup_prefix6_t prefix1, prefix2;
+	odph_table_t table;
+	uint64_t value1 = 1, value2 = 2, result = 0;
+	uint8_t lkp_ip[ODPH_IPV6ADDR_LEN] = {
+		0x20, 0x01, 0x0d, 0xb8, 0x00, 0x01, 0x00, 0x02,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 };
+	uint8_t miss_ip[ODPH_IPV6ADDR_LEN] = { 0x30, 0x01 };
+	int ret = -1;
+
+	odph_iplookup_table_param_init(&param);
+	param.type = ODPH_IPLOOKUP_IPV6;
+
+	table = odph_iplookup_table_create_param("prefix6_test",
+						 sizeof(uint64_t), &param);
+	if (table == NULL) {
+		printf("IPv6 prefix lookup table creation failed\n");
+		return -1;
+	}
+
+	/* 2001:db8::/32 and 2001:db8:1:2::/64 */
+	memset(&prefix1, 0, sizeof(prefix1));
+	memcpy(prefix1.ip, lkp_ip, 4);
+	prefix1.cidr = 32;
+	memset(&prefix2, 0, sizeof(prefix2));
+	memcpy(prefix2.ip, lkp_ip, 8);
+	prefix2.cidr = 64;
+
+	if (odph_iplookup_table_put_value(table, &prefix1, &value1) < 0 ||
+	    odph_iplookup_table_put_value(table, &prefix2, &value2) < 0) {
+		printf("Failed to add IPv6 prefix\n");
+		goto out;
+	}
+
+	if (odph_iplookup_table_get_value(table, lkp_ip, &result, 0) < 0 ||
+	    result != value2) {
+		printf("Failed to find longest IPv6 prefix\n");
+		goto out;
+	}
+
+	lkp_ip[7] = 0x03;
+	if (odph_iplookup_table_get_value(table, lkp_ip, &result, 0) < 0 ||
+	    result != value1) {
+		printf("Failed to find shorter IPv6 prefix\n");
+		goto out;
+	}
+	lkp_ip[7] = 0x02;
+
+	if (odph_iplookup_table_get_value(table, miss_ip, &result, 0) < 0 ||
+	    result != (uint64_t)(uintptr_t)ODP_BUFFER_INVALID) {
+		printf("Error: found result for unknown IPv6 prefix\n");
+		goto out;
+	}
+
+	if (odph_iplookup_table_remove_value(table, &prefix2) < 0) {
+		printf("Failed to delete IPv6 prefix\n");
+		goto out;
+	}
+
+	if (odph_iplookup_table_get_value(table, lkp_ip, &result, 0) < 0 ||
+	    result != value1) {
+		printf("Error: found result after deleting IPv6 prefix\n");
+		goto out;
+	}
+
+	if (odph_iplookup_table_remove_value(table, &prefix2) >= 0) {
+		printf("Error: deleted a non-existing IPv6 prefix\n");
+		goto out;
+	}
+
+	if (odph_iplookup_table_remove_value(table, &prefix1) < 0) {
+		printf("Failed to delete IPv6 prefix\n");
+		goto out;
+	}
+
+	ret = 0;
+out:
+	odph_iplookup_table_destroy(table);
+	return ret;
+}
+
+/*
+ * Bulk lookups in concurrent mode:
+ *	- put /8, /16, /24 and /32 prefixes
+ *	- get multi and compare against get
+ *	- remove prefixes while the thread is online, then report
+ *	  quiescent states so that subtrees are recycled
+ */
+static int test_ip_lookup_multi_concurrent(void)
+{
+	odph_iplookup_table_param_t param;
+	odph_iplookup_prefix_t prefix[4];
+	odph_table_t table;
+	uint64_t value[4] = { 8, 16, 24, 32 };
+	uint64_t expect[4] = { 32, 24, 16, 8 };
+	uint32_t flip[5] = { 0, 0x1, 0x100, 0x10000, 0x80000000 };
+	uint64_t result[40], single;
+	uint32_t lkp_ip[40], base;
+	int i, round, ret = -1;
+
+	odph_iplookup_table_param_init(&param);
+	param.concurrent = 1;
+
+	table = odph_iplookup_table_create_param("prefix_multi_test",
+						 sizeof(uint64_t), &param);
+	if (table == NULL) {
+		printf("Concurrent IP prefix lookup table creation failed\n");
+		return -1;
+	}
+
+	odph_ipv4_addr_parse(&base, "10.1.2.3");
+	odph_iplookup_table_quiescent(table);
+
+	for (round = 0; round < 2; round++) {
+		for (i = 0; i < 4; i++) {
+			prefix[i].ip = base;
+			prefix[i].cidr = 8 * (i + 1);
+			if (odph_iplookup_table_put_value(table, &prefix[i],
+							  &value[i]) < 0) {
+				printf("Failed to add ip prefix\n");
+				goto out;
+			}
+		}
+
+		/* 10.1.2.3, 10.1.2.2, 10.1.3.3, 10.0.2.3 and a miss */
+		for (i = 0; i < 40; i++)
+			lkp_ip[i] = base ^ flip[i % 5];
+
+		if (odph_iplookup_table_get_value_multi(table, lkp_ip, result,
+							40) != 40) {
+			printf("Failed to do bulk lookup\n");
+			goto out;
+		}
+
+		for (i = 0; i < 40; i++) {
+			uint64_t exp = i % 5 == 4 ?
+				(uint64_t)(uintptr_t)ODP_BUFFER_INVALID :
+				expect[i % 5];
+
+			odph_iplookup_table_get_value(table, &lkp_ip[i],
+						      &single, 0);
+			if (result[i] != exp || single != exp) {
+				printf("Bulk lookup mismatch at %i\n", i);
+				goto out;
+			}
+		}
+
+		for (i = 3; i >= 0; i--) {
+			if (odph_iplookup_table_remove_value(table,
+							     &prefix[i]) < 0) {
+				printf("Failed to delete ip prefix\n");
+				goto out;
+			}
+			odph_iplookup_table_quiescent(table);
+		}
+
+		odph_iplookup_table_get_value(table, &base, &single, 0);
+		if (single != (uint64_t)(uintptr_t)ODP_BUFFER_INVALID) {
+			printf("Error: found result after deleting\n");
+			goto out;
+		}
+	}
+
+	odph_iplookup_table_offline(table);
+	ret = 0;
+out:
+	odph_iplookup_table_destroy(table);
+	return ret;
+}
+
 int main(int argc ODP_UNUSED, char *argv[] ODP_UNUSED)
 {
 	odp_instance_t instance;
@@ -153,10 +332,13 @@ int main(int argc ODP_UNUSED, char *argv[] ODP_UNUSED)
 		exit(EXIT_FAILURE);
 	}
 
-	if (test_ip_lookup_table() < 0)
+	if (test_ip_lookup_table() < 0 || test_ip6_lookup_table() < 0 ||
+	    test_ip_lookup_multi_concurrent() < 0) {
 		printf("Test failed\n");
-	else
+		ret = -1;
+	} else {
 		printf("All tests passed\n");
+	}
 
 	if (odp_term_local()) {
 		fprintf(stderr, "Error: ODP local term failed.\n");
@@ -221,6 +221,27 @@ typedef struct odp_cls_capability_t {
 	/** Maximum value of odp_pmr_create_opt_t::mark */
 	uint64_t max_mark;
 
+	/** Class-of-service meter capabilities */
+	struct {
+		/** Single rate three color marker support */
+		odp_support_t srtcm;
+
+		/** Two rate three color marker support */
+		odp_support_t trtcm;
+
+		/** Maximum number of meters a packet passes through, including
+		 *  the meter of the CoS and the meters of its parents. Value of
+		 *  one means that hierarchical metering is not supported. */
+		uint32_t max_levels;
+
+		/** Minimum rate in bytes per second */
+		uint64_t min_rate;
+
+		/** Maximum burst size in bytes */
+		uint64_t max_burst;
+
+	} meter;
+
 } odp_cls_capability_t;
 
 /**
@@ -252,6 +273,84 @@ typedef enum {
 	ODP_COS_FHDR_USER	/**< Application-specific header field(s) */
 } odp_cos_hdr_flow_fields_t;
 
+/**
+ * Class-of-service meter algorithm
+ */
+typedef enum {
+	/** Meter disabled */
+	ODP_CLS_METER_NONE = 0,
+
+	/** Single rate three color marker (RFC 2697). Packets are metered
+	 *  against committed information rate (CIR), committed burst size (CBS)
+	 *  and excess burst size (EBS). */
+	ODP_CLS_METER_SRTCM,
+
+	/** Two rate three color marker (RFC 2698). Packets are metered against
+	 *  committed information rate (CIR), committed burst size (CBS), peak
+	 *  information rate (PIR) and peak burst size (PBS). */
+	ODP_CLS_METER_TRTCM
+
+} odp_cls_meter_mode_t;
+
+/**
+ * Action for packets of a meter color
+ */
+typedef enum {
+	/** Mark packet color (see odp_packet_color()) and pass the packet */
+	ODP_CLS_METER_MARK = 0,
+
+	/** Drop the packet */
+	ODP_CLS_METER_DROP
+
+} odp_cls_meter_action_t;
+
+/**
+ * Class-of-service meter parameters
+ *
+ * Meter is evaluated on packet input after the packet has been classified
+ * into the CoS, and before the packet is enqueued into a CoS queue. Packets
+ * dropped by a meter are not delivered to the application. Packet length
+ * is the length of the received frame.
+ */
+typedef struct odp_cls_meter_param_t {
+	/** Meter algorithm. The default value is ODP_CLS_METER_NONE. */
+	odp_cls_meter_mode_t mode;
+
+	/** Committed information rate in bytes per second */
+	uint64_t cir;
+
+	/** Committed burst size in bytes */
+	uint64_t cbs;
+
+	/** Excess burst size in bytes. Used with ODP_CLS_METER_SRTCM. */
+	uint64_t ebs;
+
+	/** Peak information rate in bytes per second. Used with
+	 *  ODP_CLS_METER_TRTCM, must not be less than 'cir'. */
+	uint64_t pir;
+
+	/** Peak burst size in bytes. Used with ODP_CLS_METER_TRTCM. */
+	uint64_t pbs;
+
+	/** Action for yellow packets. The default value is
+	 *  ODP_CLS_METER_MARK. */
+	odp_cls_meter_action_t yellow;
+
+	/** Action for red packets. The default value is ODP_CLS_METER_DROP. */
+	odp_cls_meter_action_t red;
+
+	/** Parent CoS
+	 *
+	 *  When set, packets that pass the meter are metered also by the meter
+	 *  of the parent CoS. The parent meter is color-aware: it may only
+	 *  downgrade packet color and it uses its own actions. Multiple CoSes
+	 *  may share a parent, which then limits their aggregate rate. Parent
+	 *  CoS must have a meter and it must not be destroyed before this CoS.
+	 *  The default value is ODP_COS_INVALID. */
+	odp_cos_t parent;
+
+} odp_cls_meter_param_t;
+
 /**
  * Class of service parameters
  * Used to communicate class of service creation options
@@ -301,6 +400,9 @@ typedef struct odp_cls_cos_param {
 
 	/** Packet input vector configuration */
 	odp_pktin_vector_config_t vector;
+
+	/** Meter configuration */
+	odp_cls_meter_param_t meter;
 } odp_cls_cos_param_t;
 
 /**
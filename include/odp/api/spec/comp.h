@@ -262,6 +262,22 @@ typedef struct odp_comp_deflate_param {
 	odp_comp_huffman_code_t huffman_code;
 } odp_comp_deflate_param_t;
 
+/**
+ * LZS algorithm specific parameters
+ */
+typedef struct odp_comp_lzs_param_t {
+	/**
+	 * Compression level
+	 *
+	 * Valid range is integer between (0 ... max_level), where 0 selects
+	 * implementation default level, 1 the fastest compression and
+	 * max_level the best compression.
+	 *
+	 * @see 'max_level' in odp_comp_alg_capability_t
+	 */
+	uint32_t comp_level;
+} odp_comp_lzs_param_t;
+
 /**
  * Compression algorithm specific parameters
  */
@@ -274,6 +290,9 @@ typedef union odp_comp_alg_param_t {
 		/** deflate algo params */
 		odp_comp_deflate_param_t deflate;
 	} zlib;
+
+	/** LZS parameters */
+	odp_comp_lzs_param_t lzs;
 } odp_comp_alg_param_t;
 
  /**
@@ -304,6 +304,37 @@ typedef struct odp_pktout_queue_param_t {
 	  * 1 and interface capability. The default value is 1. */
 	unsigned int num_queues;
 
+	/** Transmit batching
+	  *
+	  * When enabled, packets sent with odp_pktout_send() are accumulated
+	  * per output queue and passed to the interface in batches. This
+	  * reduces the number of transmit doorbells (kernel kicks) when
+	  * application sends packets in small bursts, with the cost of added
+	  * latency. Batching is supported only in ODP_PKTOUT_MODE_DIRECT mode.
+	  *
+	  * An accumulated batch is transmitted when 'max_pkts' packets have
+	  * been accumulated, or by the first odp_pktout_send() call after the
+	  * oldest packet of the batch has waited 'max_tmo_us' microseconds.
+	  * Timeout is checked only in odp_pktout_send(). Application must call
+	  * odp_pktout_flush() when it has no more packets to send to the
+	  * queue, otherwise accumulated packets may not be transmitted. */
+	struct {
+		/** Maximum number of packets in a batch
+		  *
+		  * Values 0 and 1 disable batching. The value must not exceed
+		  * odp_pktio_capability_t::tx_batch.max_pkts. The default
+		  * value is 0. */
+		uint32_t max_pkts;
+
+		/** Maximum time in microseconds a packet waits in a batch
+		  *
+		  * The default value is 0, which disables the timeout. A batch
+		  * is then transmitted only when it is full, or when
+		  * odp_pktout_flush() is called. */
+		uint32_t max_tmo_us;
+
+	} batch;
+
 } odp_pktout_queue_param_t;
 
 /**
@@ -845,6 +876,15 @@ typedef struct odp_pktio_capability_t {
 		uint32_t max_output;
 	} maxlen;
 
+	/** Transmit batching capability */
+	struct {
+		/** Maximum value of odp_pktout_queue_param_t::batch.max_pkts
+		 *
+		 * Zero when transmit batching is not supported. */
+		uint32_t max_pkts;
+
+	} tx_batch;
+
 } odp_pktio_capability_t;
 
 /**
@@ -1257,6 +1297,11 @@ uint64_t odp_pktin_wait_time(uint64_t nsec);
  * specified e.g. for protocol offload purposes. Link protocol specific frame
  * checksum and padding are added to frames before transmission.
  *
+ * When transmit batching is enabled on the queue, packets are consumed when
+ * those are accumulated into the batch of the queue. Accumulated packets are
+ * transmitted later (see odp_pktout_queue_param_t::batch and
+ * odp_pktout_flush()).
+ *
  * @param queue        Packet output queue handle for sending packets
  * @param packets[]    Array of packets to send
  * @param num          Number of packets to send
@@ -1267,6 +1312,39 @@ uint64_t odp_pktin_wait_time(uint64_t nsec);
 int odp_pktout_send(odp_pktout_queue_t queue, const odp_packet_t packets[],
 		    int num);
 
+/**
+ * Transmit accumulated packets of an output queue
+ *
+ * Passes packets accumulated by transmit batching (see
+ * odp_pktout_queue_param_t::batch) to the interface without waiting for the
+ * batch to fill up or the batch timeout to expire. Packets that the interface
+ * does not accept remain accumulated and are transmitted by later send or flush
+ * calls. The call does nothing when batching is not enabled on the queue.
+ *
+ * @param queue  Packet output queue handle
+ *
+ * @return Number of packets remaining accumulated
+ * @retval <0 on failure
+ */
+int odp_pktout_flush(odp_pktout_queue_t queue);
+
+/**
+ * Number of free transmit slots of an output queue
+ *
+ * Returns the number of packets that the next odp_pktout_send() call on the
+ * queue is able to accept, when the queue is not concurrently used by other
+ * threads. The value is a snapshot and may be lower than the actual number
+ * of free slots, but not higher. Application, traffic manager and schedulers
+ * may use this to hold back packets instead of dropping them when the
+ * interface is not able to transmit at the rate packets are produced.
+ *
+ * @param queue  Packet output queue handle
+ *
+ * @return Number of free transmit slots
+ * @retval <0 on failure, or when the interface does not support the query
+ */
+int odp_pktout_free_slots(odp_pktout_queue_t queue);
+
 /**
  * LSO profile parameters
  */
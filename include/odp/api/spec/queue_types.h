@@ -20,6 +20,7 @@ extern "C" {
 
 #include <odp/api/schedule_types.h>
 #include <odp/api/deprecated.h>
+#include <odp/api/pool.h>
 
 /** @addtogroup odp_queue
  *  @{
@@ -259,6 +260,49 @@ typedef struct odp_queue_capability_t {
 
 } odp_queue_capability_t;
 
+/**
+ * Queue event vector configuration
+ *
+ * When event vector aggregation is enabled on a scheduled queue, the
+ * scheduler combines consecutive packet events of the queue into packet
+ * vector events (ODP_EVENT_PACKET_VECTOR) before passing those to the
+ * application. Other event types are passed as is. The original event order
+ * is maintained: a vector contains packets that were consecutive in the
+ * queue, and events that precede or follow those packets in the queue
+ * precede or follow the vector.
+ */
+typedef struct odp_queue_vector_config_t {
+	/** Enable event vector aggregation
+	 *
+	 *  When true, event vector aggregation is enabled and configured with
+	 *  the other parameters. Otherwise, the other parameters are ignored.
+	 *  The default value is false. */
+	odp_bool_t enable;
+
+	/** Vector pool
+	 *
+	 *  Pool of ODP_POOL_VECTOR type, where packet vectors are allocated
+	 *  from. When a vector cannot be allocated, packets are passed to the
+	 *  application as is. */
+	odp_pool_t pool;
+
+	/** Maximum time to wait for events
+	 *
+	 *  Maximum time in nanoseconds the scheduler may wait for more events
+	 *  to form a vector. The value must not exceed
+	 *  odp_schedule_capability_t::vector::max_tmo_ns. */
+	uint64_t max_tmo_ns;
+
+	/** Maximum number of packets in a vector
+	 *
+	 *  The value must be between odp_schedule_capability_t::vector::min_size
+	 *  and odp_schedule_capability_t::vector::max_size, and must not be
+	 *  greater than odp_pool_param_t::vector::max_size of the vector
+	 *  pool. */
+	uint32_t max_size;
+
+} odp_queue_vector_config_t;
+
 /**
  * ODP Queue parameters
  */
@@ -332,6 +376,13 @@ typedef struct odp_queue_param_t {
 	  * default size. */
 	uint32_t size;
 
+	/** Event vector aggregation configuration
+	  *
+	  * Event vector aggregation can be enabled only on ODP_QUEUE_TYPE_SCHED
+	  * queues, when supported by the scheduler
+	  * (odp_schedule_capability_t::vector). It is disabled by default. */
+	odp_queue_vector_config_t vector;
+
 } odp_queue_param_t;
 
 /**
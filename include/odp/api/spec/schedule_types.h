@@ -225,6 +225,29 @@ typedef struct odp_schedule_capability_t {
 	 * The specification is the same as for the blocking implementation. */
 	odp_support_t waitfree_queues;
 
+	/** Event vector aggregation capabilities of scheduled queues
+	 *
+	 * @see odp_queue_vector_config_t */
+	struct {
+		/** Event vector aggregation support */
+		odp_support_t supported;
+
+		/** Maximum number of packets in a vector */
+		uint32_t max_size;
+
+		/** Minimum value allowed to be configured to
+		 *  odp_queue_vector_config_t::max_size */
+		uint32_t min_size;
+
+		/** Maximum timeout in nanoseconds */
+		uint64_t max_tmo_ns;
+
+		/** Minimum value allowed to be configured to
+		 *  odp_queue_vector_config_t::max_tmo_ns */
+		uint64_t min_tmo_ns;
+
+	} vector;
+
 } odp_schedule_capability_t;
 
 /**
@@ -198,6 +198,19 @@ typedef struct odp_stash_param_t {
 	 */
 	uint32_t cache_size;
 
+	/** Number of object handles moved at once between a thread local
+	 *  cache and the stash
+	 *
+	 *  When a thread local cache runs empty or full, the implementation
+	 *  moves at least this many object handles between the cache and the
+	 *  stash in a single operation. A larger burst reduces the number of
+	 *  operations on the shared stash, but keeps more handles in thread
+	 *  local caches. The value must not exceed 'cache_size'. The default
+	 *  value is 0, which selects an implementation specific burst size.
+	 *  The value is ignored when 'cache_size' is zero.
+	 */
+	uint32_t burst_size;
+
 } odp_stash_param_t;
 
 /**
@@ -324,6 +337,41 @@ int32_t odp_stash_put(odp_stash_t stash, const void *obj, int32_t num);
  */
 int32_t odp_stash_get(odp_stash_t stash, void *obj, int32_t num);
 
+/**
+ * Put pointer sized object handles into a stash
+ *
+ * Otherwise like odp_stash_put(), but object handles are passed as an array of
+ * uintptr_t values. This call may be used only when 'obj_size' in stash
+ * creation parameters is sizeof(uintptr_t). This allows e.g. pointers to
+ * application objects to be recycled through a stash without per call object
+ * size checks.
+ *
+ * @param stash  Stash handle
+ * @param ptr    Array of object handles to be stored
+ * @param num    Number of object handles to store
+ *
+ * @return Number of object handles actually stored (0 ... num)
+ * @retval <0 on failure
+ */
+int32_t odp_stash_put_ptr(odp_stash_t stash, const uintptr_t ptr[],
+			  int32_t num);
+
+/**
+ * Get pointer sized object handles from a stash
+ *
+ * Otherwise like odp_stash_get(), but object handles are output as an array of
+ * uintptr_t values. This call may be used only when 'obj_size' in stash
+ * creation parameters is sizeof(uintptr_t).
+ *
+ * @param      stash  Stash handle
+ * @param[out] ptr    Array of object handles for output
+ * @param      num    Maximum number of object handles to get from the stash
+ *
+ * @return Number of object handles actually output (0 ... num) to 'ptr' array
+ * @retval <0 on failure
+ */
+int32_t odp_stash_get_ptr(odp_stash_t stash, uintptr_t ptr[], int32_t num);
+
 /**
  * Flush object handles from the thread local cache
  *
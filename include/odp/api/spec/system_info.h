@@ -250,6 +250,23 @@ void odp_sys_info_print(void);
  */
 void odp_sys_config_print(void);
 
+/**
+ * Write trace records into a file
+ *
+ * Writes fast path trace records collected by the implementation into a file.
+ * File format is implementation defined (e.g. Chrome trace event JSON, which
+ * can be opened with Perfetto UI or chrome://tracing). Each call writes
+ * records collected since the previous call. Tracing is implementation
+ * specific and may not be supported at all (or it may need to be enabled at
+ * build time).
+ *
+ * @param path    Output file path
+ *
+ * @retval 0 on success
+ * @retval <0 on failure, or when tracing is not supported
+ */
+int odp_sys_trace_flush(const char *path);
+
 /**
  * @}
  */
@@ -480,6 +480,77 @@ int odp_timer_set_rel(odp_timer_t timer, uint64_t rel_tick,
  */
 int odp_timer_cancel(odp_timer_t timer, odp_event_t *tmo_ev);
 
+/**
+ * Set (or reset) multiple timers with absolute expiration times
+ *
+ * Like odp_timer_set_abs(), but sets 'num' timers with a single call. Timers
+ * are processed in array order and each operation succeeds or fails
+ * independently of the others. The result of each operation is written into
+ * 'result' array. Timers may belong to different timer pools, but performance
+ * is optimized for batches of timers from the same timer pool.
+ *
+ * When 'tmo_ev' is NULL, all timers are reset without changing the event.
+ * Otherwise, each entry of the array is handled like 'tmo_ev' of
+ * odp_timer_set_abs(): an ODP_EVENT_INVALID entry resets the timer without
+ * changing the event, and a successful reset with a new event outputs the old
+ * event into the same entry. An entry of a failed operation is not modified.
+ *
+ * @param         timer    Timer handle array
+ * @param         abs_tick Absolute expiration time array in timer ticks
+ * @param[in,out] tmo_ev   Event handle array, or NULL
+ * @param[out]    result   Result array. Each entry is one of the return values
+ *                         of odp_timer_set_abs() (odp_timer_set_t).
+ * @param         num      Number of timers to set
+ *
+ * @return Number of successful operations (0 ... num)
+ *
+ * @see odp_timer_set_abs(), odp_timer_set_rel_multi()
+ */
+int odp_timer_set_abs_multi(const odp_timer_t timer[],
+			    const uint64_t abs_tick[], odp_event_t tmo_ev[],
+			    int result[], int num);
+
+/**
+ * Set (or reset) multiple timers with relative expiration times
+ *
+ * Like odp_timer_set_abs_multi(), but the expiration time of each timer is
+ * relative to the current time of its timer pool:
+ * expiration tick = odp_timer_current_tick() + 'rel_tick[i]'.
+ *
+ * @param         timer    Timer handle array
+ * @param         rel_tick Relative expiration time array in timer ticks
+ * @param[in,out] tmo_ev   Event handle array, or NULL
+ * @param[out]    result   Result array. Each entry is one of the return values
+ *                         of odp_timer_set_rel() (odp_timer_set_t).
+ * @param         num      Number of timers to set
+ *
+ * @return Number of successful operations (0 ... num)
+ *
+ * @see odp_timer_set_rel(), odp_timer_set_abs_multi()
+ */
+int odp_timer_set_rel_multi(const odp_timer_t timer[],
+			    const uint64_t rel_tick[], odp_event_t tmo_ev[],
+			    int result[], int num);
+
+/**
+ * Cancel multiple timers
+ *
+ * Like odp_timer_cancel(), but cancels 'num' timers with a single call. Timers
+ * are processed in array order. The timeout event of each cancelled timer is
+ * output into 'tmo_ev' array. An entry is set to ODP_EVENT_INVALID when the
+ * timer was inactive or already expired.
+ *
+ * @param      timer  Timer handle array
+ * @param[out] tmo_ev Event handle array for output
+ * @param      num    Number of timers to cancel
+ *
+ * @return Number of cancelled timers (0 ... num)
+ *
+ * @see odp_timer_cancel()
+ */
+int odp_timer_cancel_multi(const odp_timer_t timer[], odp_event_t tmo_ev[],
+			   int num);
+
 /**
  * Get timeout handle from a ODP_EVENT_TIMEOUT type event
  *
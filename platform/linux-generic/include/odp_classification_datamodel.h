@@ -51,6 +51,12 @@ extern "C" {
 #define CLS_COS_QUEUE_MAX		32
 /* Max number of implementation created queues */
 #define CLS_QUEUE_GROUP_MAX		(CLS_COS_MAX_ENTRY * CLS_COS_QUEUE_MAX)
+/* Max number of meters in a CoS hierarchy */
+#define CLS_METER_MAX_LEVELS		4
+/* Min meter rate in bytes per second */
+#define CLS_METER_MIN_RATE		1000
+/* Max meter burst size in bytes */
+#define CLS_METER_MAX_BURST		UINT32_MAX
 
 /* CoS index is stored in odp_packet_hdr_t */
 ODP_STATIC_ASSERT(CLS_COS_MAX_ENTRY <= UINT16_MAX, "CoS_does_not_fit_16_bits");
@@ -125,6 +131,38 @@ typedef struct pmr_term_value {
 
 } pmr_term_value_t;
 
+/*
+Meter
+
+Token buckets are implemented with the generic cell rate algorithm: bucket
+state is a single theoretical arrival time (TAT), which is updated with CAS.
+Time and costs are in units of 1/16 ns since meter creation.
+*/
+typedef struct cls_meter_t {
+	/* Committed bucket TAT */
+	odp_atomic_u64_t c_tat ODP_ALIGNED_CACHE;
+
+	/* Peak (trTCM), or committed plus excess (srTCM) bucket TAT */
+	odp_atomic_u64_t pe_tat;
+
+	/* Bucket sizes (burst tolerance) in time units */
+	uint64_t c_tau;
+	uint64_t pe_tau;
+	uint64_t e_tau;
+
+	/* Time units per byte in 48.16 fixed point */
+	uint64_t c_cost;
+	uint64_t pe_cost;
+
+	/* Meter creation time in nsec */
+	uint64_t epoch;
+
+	odp_cls_meter_mode_t mode;
+	uint8_t drop[ODP_NUM_PACKET_COLORS];
+	union cos_u *parent;
+
+} cls_meter_t;
+
 /*
 Class Of Service
 */
@@ -145,6 +183,8 @@ struct cos_s {
 	odp_queue_param_t queue_param;
 	char name[ODP_COS_NAME_LEN];	/* name */
 	uint8_t index;
+	uint8_t meter_level;		/* Number of meters in hierarchy */
+	cls_meter_t meter;		/* Meter */
 };
 
 typedef union cos_u {
@@ -42,6 +42,17 @@ int _odp_cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
 			     uint16_t pkt_len, uint32_t seg_len, odp_pool_t *pool,
 			     odp_packet_hdr_t *pkt_hdr, odp_bool_t parse);
 
+/**
+Packet RSS hash
+
+Calculates a software RSS (Toeplitz) hash over the parsed IPv4/IPv6 addresses
+and TCP/UDP ports selected by hash_proto. Returns zero when none of the
+selected fields are present in the packet.
+**/
+uint32_t _odp_cls_packet_rss_hash(odp_packet_hdr_t *pkt_hdr,
+				  odp_cls_hash_proto_t hash_proto,
+				  const uint8_t *base);
+
 /**
 Packet IO classifier init
 
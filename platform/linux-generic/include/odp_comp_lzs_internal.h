@@ -0,0 +1,78 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP LZS (ANSI X3.241) codec
+ *
+ * Each call compresses or decompresses one complete block of data. A
+ * compressed block ends with an end marker and is padded to a byte boundary.
+ */
+
+#ifndef ODP_COMP_LZS_INTERNAL_H_
+#define ODP_COMP_LZS_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Maximum LZS match offset */
+#define _ODP_LZS_WINDOW      2048
+
+/* Number of match finder hash table entries */
+#define _ODP_LZS_HASH_SIZE   4096
+
+/* Maximum compression level */
+#define _ODP_LZS_MAX_LEVEL   9
+
+/* Worst case compressed data size of 'len' bytes: all literals (9 bits each)
+ * and the end marker */
+#define _ODP_LZS_MAX_OUT(len) ((len) + ((len) + 7) / 8 + 3)
+
+/* Decompression return codes */
+#define _ODP_LZS_OUT_OF_SPACE (-1)
+#define _ODP_LZS_CORRUPT      (-2)
+
+/* Compressor state */
+typedef struct {
+	/* Newest position (+ base + 1) per hash */
+	uint32_t head[_ODP_LZS_HASH_SIZE];
+
+	/* Previous position with the same hash */
+	uint32_t prev[_ODP_LZS_WINDOW];
+
+	/* Positions at or below base belong to previous blocks */
+	uint32_t base;
+
+} _odp_lzs_state_t;
+
+/* Initialize compressor state */
+void _odp_lzs_init(_odp_lzs_state_t *state);
+
+/* Compress a block
+ *
+ * Level 1 is the fastest, _ODP_LZS_MAX_LEVEL the best compression and 0 the
+ * default level. Returns compressed data length, or _ODP_LZS_OUT_OF_SPACE
+ * when 'dst' is too small. */
+int32_t _odp_lzs_compress(_odp_lzs_state_t *state, uint32_t level,
+			  const uint8_t *src, uint32_t src_len,
+			  uint8_t *dst, uint32_t dst_len);
+
+/* Decompress a block
+ *
+ * Returns decompressed data length, _ODP_LZS_OUT_OF_SPACE when 'dst' is too
+ * small, or _ODP_LZS_CORRUPT when input data is not valid. */
+int32_t _odp_lzs_decompress(const uint8_t *src, uint32_t src_len,
+			    uint8_t *dst, uint32_t dst_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
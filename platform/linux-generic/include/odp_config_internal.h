@@ -116,6 +116,16 @@ extern "C" {
 				   CONFIG_PACKET_HEADROOM + \
 				   CONFIG_PACKET_TAILROOM)
 
+/*
+ * Minimum packet segment length of a packet pool size class
+ *
+ * Packet pools created with subparameters (pkt.num_subparam > 0) consist of
+ * multiple size classes. Segment length of a size class follows the class
+ * packet length and is rounded up into this value instead of
+ * CONFIG_PACKET_SEG_LEN_MIN.
+ */
+#define CONFIG_PACKET_CLASS_SEG_LEN_MIN 256
+
 /* Maximum number of shared memory blocks.
  *
  * This the the number of separate SHM areas that can be reserved concurrently
@@ -0,0 +1,37 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP internal crypto routines
+ */
+
+#ifndef ODP_CRYPTO_INTERNAL_H_
+#define ODP_CRYPTO_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/api/crypto.h>
+#include <odp/api/packet.h>
+
+/* Process multiple packets of a synchronous session in place
+ *
+ * All packets use the same session, so session state (e.g. cipher and auth
+ * contexts) is resolved once and stays hot in cache over the whole group.
+ * Operations are done in place: output packets are the input packets. Results
+ * are stored into packets as in odp_crypto_op(). Returns the number of
+ * packets processed. */
+int _odp_crypto_op_session(odp_crypto_session_t session, odp_packet_t pkt[],
+			   const odp_crypto_packet_op_param_t param[], int num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
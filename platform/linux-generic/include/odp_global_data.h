@@ -41,6 +41,10 @@ typedef struct {
 typedef struct {
 	uint64_t default_huge_page_size;
 	char     *default_huge_page_dir;
+	/* Huge page size and mount point used for shared memory. Equal to
+	 * the default values unless configured otherwise. */
+	uint64_t shm_huge_page_size;
+	char     *shm_huge_page_dir;
 } hugepage_info_t;
 
 /* Read-only global data. Members should not be modified after global init
@@ -25,6 +25,11 @@ int _odp_thread_init_local(odp_thread_type_t type);
 int _odp_thread_term_local(void);
 int _odp_thread_term_global(void);
 
+int _odp_trace_init_global(void);
+int _odp_trace_init_local(void);
+int _odp_trace_term_local(void);
+int _odp_trace_term_global(void);
+
 int _odp_pcapng_init_global(void);
 int _odp_pcapng_term_global(void);
 
@@ -64,6 +69,8 @@ int _odp_timer_init_global(const odp_init_t *params);
 int _odp_timer_init_local(void);
 int _odp_timer_term_global(void);
 int _odp_timer_term_local(void);
+int _odp_timer_res_probe_start(const odp_init_t *params);
+int _odp_timer_res_probe_stop(void);
 
 int _odp_time_init_global(void);
 int _odp_time_term_global(void);
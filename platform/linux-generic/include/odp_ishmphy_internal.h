@@ -13,7 +13,7 @@ extern "C" {
 
 #include <stdint.h>
 
-void *_odp_ishmphy_reserve_single_va(uint64_t len, int fd);
+void *_odp_ishmphy_reserve_single_va(uint64_t len, int fd, int flags);
 int   _odp_ishmphy_free_single_va(void);
 void *_odp_ishmphy_map(int fd, uint64_t size, uint64_t offset, int flags);
 int   _odp_ishmphy_unmap(void *start, uint64_t len, int flags);
@@ -28,11 +28,18 @@ struct rte_mbuf;
 
 /**
  * Calculate size of zero-copy DPDK packet pool object
+ *
+ * Returns 'block_size' when zero-copy is disabled or the pool is not
+ * compatible with DPDK mbuf layout.
  */
-uint32_t _odp_dpdk_pool_obj_size(pool_t *pool, uint32_t block_size);
+uint32_t _odp_dpdk_pool_obj_size(pool_t *pool, uint32_t block_size,
+				 uint32_t seg_len);
 
 /**
  * Create zero-copy DPDK packet pool
+ *
+ * Not creating the DPDK pool is not an error. DPDK pktios use copy mode with
+ * the pool in that case.
  */
 int _odp_dpdk_pool_create(pool_t *pool);
 
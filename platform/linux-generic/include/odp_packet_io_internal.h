@@ -24,6 +24,7 @@ extern "C" {
 #include <odp/api/plat/pktio_inlines.h>
 #include <odp/api/spinlock.h>
 #include <odp/api/ticketlock.h>
+#include <odp/api/time.h>
 #include <odp_classification_datamodel.h>
 #include <odp_align_internal.h>
 #include <odp_debug_internal.h>
@@ -41,6 +42,8 @@ extern "C" {
 #define PKTIO_LSO_PROFILES 16
 #define PKTIO_LSO_MAX_PAYLOAD_OFFSET 128
 #define PKTIO_LSO_MAX_SEGMENTS 8
+/* Maximum number of packets in a transmit batch */
+#define PKTIO_TX_BATCH_MAX 32
 ODP_STATIC_ASSERT(PKTIO_LSO_PROFILES < UINT8_MAX, "PKTIO_LSO_PROFILES_ERROR");
 
 #define PKTIO_NAME_LEN 256
@@ -57,6 +60,24 @@ ODP_STATIC_ASSERT(PKTIO_LSO_PROFILES < UINT8_MAX, "PKTIO_LSO_PROFILES_ERROR");
 /* Forward declaration */
 struct pktio_if_ops;
 
+/* Transmit batch of an output queue */
+typedef struct {
+	odp_ticketlock_t lock;
+	/* Maximum number of packets in the batch. Zero when batching is
+	 * disabled. */
+	uint16_t max;
+	/* Number of packets in the batch */
+	uint16_t num;
+	/* Queue may be used by multiple threads concurrently */
+	uint8_t mt_safe;
+	/* Batch timeout, zero when disabled */
+	uint64_t tmo_ns;
+	/* Time when the oldest packet was added */
+	odp_time_t first;
+	odp_packet_t pkt[PKTIO_TX_BATCH_MAX];
+
+} pktout_batch_t;
+
 #if defined(_ODP_PKTIO_NETMAP)
 #define PKTIO_PRIVATE_SIZE 74752
 #elif defined(_ODP_PKTIO_DPDK) && ODP_CACHE_LINE_SIZE == 128
@@ -137,6 +158,7 @@ struct pktio_entry {
 	struct {
 		odp_queue_t        queue;
 		odp_pktout_queue_t pktout;
+		pktout_batch_t     batch;
 	} out_queue[PKTIO_MAX_QUEUES];
 
 	/**< inotify instance for pcapng fifos */
@@ -147,6 +169,10 @@ struct pktio_entry {
 		} state[PKTIO_MAX_QUEUES];
 		int fd[PKTIO_MAX_QUEUES];
 	} pcapng;
+
+	/* Software RSS stage. Non-NULL when input queues are fed in software
+	 * from a single driver input queue. */
+	struct sw_rss_t *sw_rss;
 };
 
 typedef union {
@@ -169,6 +195,12 @@ typedef struct {
 	struct {
 		/* Frame start offset from base pointer at packet input */
 		uint16_t pktin_frame_offset;
+
+		/* Max number of software RSS input queues (0: disabled) */
+		uint32_t sw_rss_max_queues;
+
+		/* Software RSS ring size per input queue */
+		uint32_t sw_rss_ring_size;
 	} config;
 
 	pktio_entry_t entries[ODP_CONFIG_PKTIO_ENTRIES];
@@ -204,6 +236,7 @@ typedef struct pktio_if_ops {
 	int (*fd_set)(pktio_entry_t *entry, int index, fd_set *readfds);
 	int (*send)(pktio_entry_t *entry, int index,
 		    const odp_packet_t packets[], int num);
+	int (*tx_free_slots)(pktio_entry_t *entry, int index);
 	uint32_t (*maxlen_get)(pktio_entry_t *pktio_entry);
 	int (*maxlen_set)(pktio_entry_t *pktio_entry, uint32_t maxlen_input,
 			  uint32_t maxlen_output);
@@ -269,6 +302,9 @@ extern const pktio_if_ops_t _odp_netmap_pktio_ops;
 extern const pktio_if_ops_t _odp_dpdk_pktio_ops;
 extern const pktio_if_ops_t _odp_sock_mmsg_pktio_ops;
 extern const pktio_if_ops_t _odp_sock_mmap_pktio_ops;
+#ifdef _ODP_PKTIO_SOCKET_URING
+extern const pktio_if_ops_t _odp_sock_uring_pktio_ops;
+#endif
 extern const pktio_if_ops_t _odp_loopback_pktio_ops;
 #ifdef _ODP_PKTIO_PCAP
 extern const pktio_if_ops_t _odp_pcap_pktio_ops;
@@ -18,6 +18,7 @@
 extern "C" {
 #endif
 
+#include <odp/api/pool.h>
 #include <odp/api/shared_memory.h>
 #include <odp/api/ticketlock.h>
 
@@ -44,6 +45,9 @@ typedef struct ODP_ALIGNED_CACHE {
 
 } pool_ring_t;
 
+/* Maximum number of size classes in a packet pool */
+#define POOL_MAX_CLASSES (ODP_POOL_MAX_SUBPARAMS + 1)
+
 /* Callback function for pool destroy */
 typedef void (*pool_destroy_cb_fn)(void *pool);
 
@@ -57,6 +61,10 @@ typedef struct pool_t {
 	uint32_t         ring_mask;
 	uint32_t         cache_size;
 	uint32_t         burst_size;
+	/* Packet headers are reset when freed into the pool */
+	uint8_t          pkt_reset;
+	/* Reference API has been used on buffers of the pool */
+	odp_atomic_u32_t refs_used;
 	odp_shm_t        shm;
 	odp_shm_t        uarea_shm;
 	uint64_t         shm_size;
@@ -76,6 +84,14 @@ typedef struct pool_t {
 	uint8_t         *max_addr;
 	uint8_t         *uarea_base_addr;
 
+	/* Buffer headers. Headers are either in the beginning of each block
+	 * (stride is block size) or in a separate array after the blocks
+	 * (stride is header size). */
+	uint8_t         *hdr_base_addr;
+	uint8_t         *hdr_max_addr;
+	uint32_t         hdr_stride;
+	uint8_t          separate_hdr;
+
 	/* Used by DPDK zero-copy pktio */
 	uint32_t         dpdk_elt_size;
 	uint32_t         skipped_blocks;
@@ -84,6 +100,15 @@ typedef struct pool_t {
 	pool_destroy_cb_fn ext_destroy;
 	void            *ext_desc;
 
+	/* Packet pool size classes in ascending segment length order. The
+	 * first class is the pool itself. Other classes are hidden pools,
+	 * which share the handle of the pool. */
+	uint32_t         num_class;
+	struct pool_t   *class_pool[POOL_MAX_CLASSES];
+
+	/* Pool which a hidden size class belongs to, otherwise NULL */
+	struct pool_t   *class_parent;
+
 	struct ODP_CACHE_ALIGNED {
 		odp_atomic_u64_t alloc_ops;
 		odp_atomic_u64_t alloc_fails;
@@ -110,6 +135,7 @@ typedef struct pool_global_t {
 		uint32_t burst_size;
 		uint32_t pkt_base_align;
 		uint32_t buf_min_align;
+		uint8_t  pkt_separate_hdr;
 	} config;
 
 } pool_global_t;
@@ -134,14 +160,13 @@ static inline odp_buffer_hdr_t *buf_hdl_to_hdr(odp_buffer_t buf)
 static inline odp_buffer_hdr_t *buf_hdr_from_index(pool_t *pool,
 						   uint32_t buffer_idx)
 {
-	uint64_t block_offset;
+	uint64_t hdr_offset;
 	odp_buffer_hdr_t *buf_hdr;
 
-	block_offset = (buffer_idx * (uint64_t)pool->block_size) +
-			pool->block_offset;
+	hdr_offset = buffer_idx * (uint64_t)pool->hdr_stride;
 
 	/* clang requires cast to uintptr_t */
-	buf_hdr = (odp_buffer_hdr_t *)(uintptr_t)&pool->base_addr[block_offset];
+	buf_hdr = (odp_buffer_hdr_t *)(uintptr_t)&pool->hdr_base_addr[hdr_offset];
 
 	return buf_hdr;
 }
@@ -162,6 +187,8 @@ static inline odp_buffer_hdr_t *buf_hdr_from_index_u32(uint32_t u32)
 
 int _odp_buffer_alloc_multi(pool_t *pool, odp_buffer_hdr_t *buf_hdr[], int num);
 void _odp_buffer_free_multi(odp_buffer_hdr_t *buf_hdr[], int num_free);
+void _odp_buffer_free_to_pool(pool_t *pool, odp_buffer_hdr_t *buf_hdr[],
+			      int num);
 int _odp_buffer_is_valid(odp_buffer_t buf);
 
 #ifdef __cplusplus
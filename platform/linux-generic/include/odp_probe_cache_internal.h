@@ -0,0 +1,43 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP probe cache
+ *
+ * Caches system properties that are measured during odp_init_global() (e.g.
+ * HW time counter frequency) across runs. Cached values are valid during the
+ * same system boot.
+ */
+
+#ifndef ODP_PROBE_CACHE_INTERNAL_H_
+#define ODP_PROBE_CACHE_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Probe cache entry names */
+#define _ODP_PROBE_TIME_FREQ_HZ  "time_freq_hz"
+#define _ODP_PROBE_TIMER_RES_NS  "timer_res_ns"
+
+/* Load cached values from the cache file, when enabled in config */
+int _odp_probe_cache_init_global(void);
+
+/* Get a cached value. Returns 1 when the value was found, otherwise 0. */
+int _odp_probe_cache_get(const char *name, uint64_t *value);
+
+/* Store a value into the cache and update the cache file */
+void _odp_probe_cache_set(const char *name, uint64_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
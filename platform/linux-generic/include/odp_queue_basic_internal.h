@@ -23,7 +23,6 @@ extern "C" {
 #include <odp/api/ticketlock.h>
 #include <odp_config_internal.h>
 #include <odp_ring_mpmc_internal.h>
-#include <odp_ring_st_internal.h>
 #include <odp_ring_spsc_internal.h>
 #include <odp_queue_lf.h>
 
@@ -33,6 +32,15 @@ extern "C" {
 #define QUEUE_STATUS_NOTSCHED     3
 #define QUEUE_STATUS_SCHED        4
 
+/* Status of a scheduled queue changes without the queue lock:
+ *   NOTSCHED  -> SCHED      enqueue into a queue that is not scheduled
+ *   SCHED     -> NOTSCHED   scheduler finds the queue empty
+ *   SCHED     -> DESTROYED  queue destroy while the queue is scheduled
+ *   DESTROYED -> FREE       scheduler finds the queue destroyed
+ *   NOTSCHED  -> FREE       queue destroy
+ * Only the thread that moved the queue into SCHED state adds it into
+ * scheduling, and only the scheduler that owns the queue dequeues from it. */
+
 struct queue_entry_s {
 	/* The first cache line is read only */
 	queue_enq_fn_t       enqueue ODP_ALIGNED_CACHE;
@@ -49,13 +57,10 @@ struct queue_entry_s {
 	ring_mpmc_t          ring_mpmc;
 
 	odp_ticketlock_t     lock;
-	union {
-		ring_st_t    ring_st;
-		ring_spsc_t  ring_spsc;
-	};
+	ring_spsc_t          ring_spsc;
 
 	odp_atomic_u64_t     num_timers;
-	int                  status;
+	odp_atomic_u32_t     status;
 
 	queue_deq_multi_fn_t orig_dequeue_multi;
 	odp_queue_param_t param;
@@ -153,6 +153,26 @@ static inline uint32_t ring_mpmc_enq_multi(ring_mpmc_t *ring,
 	return num;
 }
 
+/* Read data from the ring head without dequeuing it. Data stays valid only
+ * when the caller is the only reader of the ring. */
+static inline uint32_t ring_mpmc_peek(ring_mpmc_t *ring, uint32_t *ring_data,
+				      uint32_t ring_mask, uint32_t data[],
+				      uint32_t num)
+{
+	uint32_t head, num_data, i;
+
+	head     = odp_atomic_load_acq_u32(&ring->r_head);
+	num_data = odp_atomic_load_acq_u32(&ring->w_tail) - head;
+
+	if (num > num_data)
+		num = num_data;
+
+	for (i = 0; i < num; i++)
+		data[i] = ring_data[(head + 1 + i) & ring_mask];
+
+	return num;
+}
+
 /* Check if ring is empty */
 static inline int ring_mpmc_is_empty(ring_mpmc_t *ring)
 {
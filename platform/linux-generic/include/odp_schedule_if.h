@@ -84,6 +84,7 @@ extern const schedule_fn_t *_odp_sched_fn;
 int _odp_sched_cb_pktin_poll(int pktio_index, int pktin_index,
 			     odp_buffer_hdr_t *hdr_tbl[], int num);
 int _odp_sched_cb_pktin_poll_one(int pktio_index, int rx_queue, odp_event_t evts[]);
+int _odp_sched_cb_pktin_ready(int pktio_index, int pktin_index);
 void _odp_sched_cb_pktio_stop_finalize(int pktio_index);
 
 /* For debugging */
@@ -21,6 +21,7 @@ extern "C" {
 #define _ODP_ISHM_SINGLE_VA		1
 #define _ODP_ISHM_LOCK			2
 #define _ODP_ISHM_EXPORT		4 /* create export descr file in /tmp */
+#define _ODP_ISHM_POPULATE		8 /* pre-fault pages at map time */
 
 /**
  * Shared memory block info
@@ -0,0 +1,126 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP hot path tracing
+ *
+ * Tracepoints record the start and end time of a fast path operation into a
+ * per thread ring. Rings are written without locks and the oldest records are
+ * overwritten when a ring is full. odp_sys_trace_flush() writes the records
+ * in Chrome trace event format.
+ *
+ * Tracing is enabled at build time (--enable-trace). When disabled,
+ * tracepoints compile into nothing.
+ */
+
+#ifndef ODP_TRACE_INTERNAL_H_
+#define ODP_TRACE_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/autoheader_internal.h>
+#include <odp/api/time.h>
+#include <odp/api/plat/time_inlines.h>
+
+#include <stdint.h>
+
+/* Tracepoints */
+typedef enum {
+	_ODP_TRACE_SCHEDULE = 0,
+	_ODP_TRACE_PKTIN_POLL,
+	_ODP_TRACE_QUEUE_ENQ,
+	_ODP_TRACE_QUEUE_DEQ,
+	_ODP_TRACE_CRYPTO_OP,
+	_ODP_TRACE_IPSEC_IN,
+	_ODP_TRACE_IPSEC_OUT,
+	_ODP_TRACE_TM_ENQ,
+	_ODP_TRACE_PKTOUT_SEND,
+	_ODP_TRACE_NUM
+
+} _odp_trace_id_t;
+
+/* Trace record */
+typedef struct {
+	/* Start and end time stamps (odp_time_t) */
+	uint64_t start;
+	uint64_t end;
+
+	/* Handle of the (first) event, queue or other object operated on */
+	uint64_t handle;
+
+	/* Tracepoint */
+	uint16_t id;
+
+	/* Number of events */
+	uint16_t num;
+
+	uint32_t reserved;
+
+} _odp_trace_rec_t;
+
+/* Per thread trace ring */
+typedef struct {
+	_odp_trace_rec_t *rec;
+	uint32_t mask;
+
+	/* Number of records written. Updated only by the owner thread. */
+	uint32_t wr_idx;
+
+} _odp_trace_ring_t;
+
+extern __thread _odp_trace_ring_t *_odp_trace_ring;
+
+/* Start time of a traced operation */
+static inline uint64_t _odp_trace_begin(void)
+{
+	if (!_ODP_TRACE)
+		return 0;
+
+	return odp_time_local().u64;
+}
+
+/* Record a traced operation. Operations that did not process any events are
+ * not recorded. */
+static inline void _odp_trace_end(_odp_trace_id_t id, uint64_t start,
+				  uint64_t handle, int num)
+{
+	_odp_trace_ring_t *ring;
+	_odp_trace_rec_t *rec;
+	uint32_t idx;
+
+	if (!_ODP_TRACE)
+		return;
+
+	ring = _odp_trace_ring;
+	if (ring == NULL || num <= 0)
+		return;
+
+	idx = ring->wr_idx;
+	rec = &ring->rec[idx & ring->mask];
+
+	/* Index update of the previous record is visible before the old
+	 * content of this slot is overwritten */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	rec->start  = start;
+	rec->end    = odp_time_local().u64;
+	rec->handle = handle;
+	rec->id     = id;
+	rec->num    = num > UINT16_MAX ? UINT16_MAX : num;
+
+	/* Record content is written before the index is updated */
+	__atomic_store_n(&ring->wr_idx, idx + 1, __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -265,6 +265,7 @@ struct tm_queue_obj_s {
 	uint32_t pkts_enqueued_cnt;
 	uint32_t pkts_dequeued_cnt;
 	uint32_t pkts_consumed_cnt;
+	uint32_t pkts_discarded_cnt;
 	_odp_int_pkt_queue_t _odp_int_pkt_queue;
 	tm_wred_node_t tm_wred_node;
 	odp_packet_t pkt;
@@ -395,6 +396,8 @@ struct tm_system_s {
 
 	tm_random_data_t tm_random_data;
 	odp_pktout_queue_t pktout;
+	/* Packets may be held in pktout transmit batch */
+	odp_bool_t pktout_flush;
 	uint64_t   current_time;
 	uint8_t    tm_idx;
 	uint8_t    first_enq;
@@ -15,17 +15,6 @@ AC_ARG_WITH([dpdk-path],
     [DPDK_PATH="$withval"
      pktio_dpdk_support=yes],[])
 
-##########################################################################
-# Enable zero-copy DPDK pktio
-##########################################################################
-zero_copy=0
-AC_ARG_ENABLE([dpdk-zero-copy],
-    [AS_HELP_STRING([--enable-dpdk-zero-copy],
-                    [enable experimental zero-copy DPDK pktio mode [default=disabled] (linux-generic)])],
-    [if test x$enableval = xyes; then
-        zero_copy=1
-    fi])
-
 ##########################################################################
 # Check for DPDK availability
 #
@@ -46,8 +35,6 @@ then
     ODP_CHECK_CFLAG([-Wno-error=cast-align])
     AC_DEFINE([_ODP_PKTIO_DPDK], [1],
 	      [Define to 1 to enable DPDK packet I/O support])
-    AC_DEFINE_UNQUOTED([_ODP_DPDK_ZERO_COPY], [$zero_copy],
-	      [Define to 1 to enable DPDK zero copy support])
 else
     pktio_dpdk_support=no
 fi
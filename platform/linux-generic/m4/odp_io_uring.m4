@@ -0,0 +1,29 @@
+##########################################################################
+# Enable io_uring socket packet IO support
+##########################################################################
+io_uring_support=no
+
+AC_ARG_ENABLE([io-uring-support],
+    [AS_HELP_STRING([--disable-io-uring-support],
+                    [disable io_uring socket IO support]
+                    [[default=enabled if available] (linux-generic)])],
+    [io_uring_support=$enableval], [io_uring_support=yes])
+
+##########################################################################
+# Check for provided buffer ring and multishot receive support
+##########################################################################
+if test x$io_uring_support = xyes
+then
+    AC_CHECK_DECLS([IORING_REGISTER_PBUF_RING, IORING_RECV_MULTISHOT], [],
+        [io_uring_support=no], [[#include <linux/io_uring.h>]])
+fi
+
+if test x$io_uring_support = xyes
+then
+    AC_DEFINE([_ODP_PKTIO_SOCKET_URING], [1],
+	      [Define to 1 to enable io_uring socket packet I/O support])
+fi
+
+AC_CONFIG_COMMANDS_PRE([dnl
+AM_CONDITIONAL([ODP_PKTIO_SOCKET_URING], [test x$io_uring_support = xyes])
+])
@@ -29,11 +29,18 @@
 #include <stdbool.h>
 #include <inttypes.h>
 #include <odp/api/spinlock.h>
+#include <odp/api/time.h>
 
 /* Debug level for per packet classification operations */
 #define CLS_DBG  3
 #define MAX_MARK UINT16_MAX
 
+/* Meter time unit is 1/16 nsec */
+#define METER_TIME_SHIFT 4
+/* Meter cost per byte has 16 fractional bits */
+#define METER_COST_SHIFT 16
+#define METER_COST_MASK  ((1ULL << METER_COST_SHIFT) - 1)
+
 #define LOCK(a)      odp_spinlock_lock(a)
 #define UNLOCK(a)    odp_spinlock_unlock(a)
 #define LOCK_INIT(a)	odp_spinlock_init(a)
@@ -153,6 +160,10 @@ void odp_cls_cos_param_init(odp_cls_cos_param_t *param)
 	param->drop_policy = ODP_COS_DROP_NEVER;
 	param->num_queue = 1;
 	param->vector.enable = false;
+	param->meter.mode = ODP_CLS_METER_NONE;
+	param->meter.yellow = ODP_CLS_METER_MARK;
+	param->meter.red = ODP_CLS_METER_DROP;
+	param->meter.parent = ODP_COS_INVALID;
 	odp_queue_param_init(&param->queue_param);
 }
 
@@ -197,6 +208,11 @@ int odp_cls_capability(odp_cls_capability_t *capability)
 	capability->threshold_bp.all_bits = 0;
 	capability->max_hash_queues = CLS_COS_QUEUE_MAX;
 	capability->max_mark = MAX_MARK;
+	capability->meter.srtcm = ODP_SUPPORT_YES;
+	capability->meter.trtcm = ODP_SUPPORT_YES;
+	capability->meter.max_levels = CLS_METER_MAX_LEVELS;
+	capability->meter.min_rate = CLS_METER_MIN_RATE;
+	capability->meter.max_burst = CLS_METER_MAX_BURST;
 	return 0;
 }
 
@@ -228,6 +244,113 @@ static inline void _cls_queue_unwind(uint32_t tbl_index, uint32_t j)
 		odp_queue_destroy(queue_grp_tbl->s.queue[tbl_index + --j]);
 }
 
+static cos_t *get_cos_entry(odp_cos_t cos);
+
+/* Time units per byte at 'rate' bytes per second */
+static inline uint64_t meter_cost(uint64_t rate)
+{
+	return (ODP_TIME_SEC_IN_NS << (METER_TIME_SHIFT + METER_COST_SHIFT)) / rate;
+}
+
+/* Time units of 'bytes' at 'cost', rounded to nearest */
+static inline uint64_t meter_units(uint64_t bytes, uint64_t cost)
+{
+	return (bytes >> METER_COST_SHIFT) * cost +
+	       (((bytes & METER_COST_MASK) * cost + (METER_COST_MASK >> 1)) >>
+		METER_COST_SHIFT);
+}
+
+static int meter_check(const odp_cls_meter_param_t *param, uint8_t *level)
+{
+	cos_t *parent;
+
+	*level = 0;
+
+	if (param->mode == ODP_CLS_METER_NONE)
+		return 0;
+
+	if (param->mode != ODP_CLS_METER_SRTCM &&
+	    param->mode != ODP_CLS_METER_TRTCM) {
+		ODP_ERR("Bad meter mode %i\n", param->mode);
+		return -1;
+	}
+
+	if (param->cir < CLS_METER_MIN_RATE || param->cbs == 0 ||
+	    param->cbs > CLS_METER_MAX_BURST) {
+		ODP_ERR("Bad meter CIR or CBS\n");
+		return -1;
+	}
+
+	if (param->mode == ODP_CLS_METER_SRTCM &&
+	    param->ebs > CLS_METER_MAX_BURST) {
+		ODP_ERR("Bad meter EBS\n");
+		return -1;
+	}
+
+	if (param->mode == ODP_CLS_METER_TRTCM &&
+	    (param->pir < param->cir || param->pbs == 0 ||
+	     param->pbs > CLS_METER_MAX_BURST)) {
+		ODP_ERR("Bad meter PIR or PBS\n");
+		return -1;
+	}
+
+	*level = 1;
+
+	if (param->parent == ODP_COS_INVALID)
+		return 0;
+
+	parent = get_cos_entry(param->parent);
+
+	if (parent == NULL || parent->s.meter_level == 0) {
+		ODP_ERR("Parent CoS does not have a meter\n");
+		return -1;
+	}
+
+	if (parent->s.meter_level >= CLS_METER_MAX_LEVELS) {
+		ODP_ERR("Too many meter levels\n");
+		return -1;
+	}
+
+	*level = parent->s.meter_level + 1;
+	return 0;
+}
+
+static void meter_init(cos_t *cos, const odp_cls_meter_param_t *param,
+		       uint8_t level)
+{
+	cls_meter_t *meter = &cos->s.meter;
+
+	cos->s.meter_level = level;
+	meter->mode = level ? param->mode : ODP_CLS_METER_NONE;
+
+	if (meter->mode == ODP_CLS_METER_NONE)
+		return;
+
+	/* Buckets are full in the beginning */
+	odp_atomic_init_u64(&meter->c_tat, 0);
+	odp_atomic_init_u64(&meter->pe_tat, 0);
+
+	meter->c_cost = meter_cost(param->cir);
+	meter->c_tau = meter_units(param->cbs, meter->c_cost);
+
+	if (meter->mode == ODP_CLS_METER_SRTCM) {
+		/* Combined bucket of committed and excess tokens */
+		meter->pe_cost = meter->c_cost;
+		meter->e_tau = meter_units(param->ebs, meter->c_cost);
+		meter->pe_tau = meter->c_tau + meter->e_tau;
+	} else {
+		meter->pe_cost = meter_cost(param->pir);
+		meter->pe_tau = meter_units(param->pbs, meter->pe_cost);
+		meter->e_tau = 0;
+	}
+
+	meter->drop[ODP_PACKET_GREEN] = 0;
+	meter->drop[ODP_PACKET_YELLOW] = param->yellow == ODP_CLS_METER_DROP;
+	meter->drop[ODP_PACKET_RED] = param->red == ODP_CLS_METER_DROP;
+	meter->parent = level > 1 ? get_cos_entry(param->parent) : NULL;
+	meter->epoch = odp_time_global_ns();
+}
+
 odp_cos_t odp_cls_cos_create(const char *name, const odp_cls_cos_param_t *param)
 {
 	uint32_t i, j;
@@ -235,6 +358,7 @@ odp_cos_t odp_cls_cos_create(const char *name, const odp_cls_cos_param_t *param)
 	odp_cls_drop_t drop_policy;
 	cos_t *cos;
 	uint32_t tbl_index;
+	uint8_t meter_level;
 
 	/* num_queue should not be zero */
 	if (param->num_queue > CLS_COS_QUEUE_MAX || param->num_queue < 1)
@@ -263,6 +387,9 @@ odp_cos_t odp_cls_cos_create(const char *name, const odp_cls_cos_param_t *param)
 		}
 	}
 
+	if (meter_check(&param->meter, &meter_level))
+		return ODP_COS_INVALID;
+
 	drop_policy = param->drop_policy;
 
 	for (i = 0; i < CLS_COS_MAX_ENTRY; i++) {
@@ -314,6 +441,7 @@ odp_cos_t odp_cls_cos_create(const char *name, const odp_cls_cos_param_t *param)
 			odp_atomic_init_u32(&cos->s.num_rule, 0);
 			cos->s.index = i;
 			cos->s.vector = param->vector;
+			meter_init(cos, &param->meter, meter_level);
 			UNLOCK(&cos->s.lock);
 			return _odp_cos_from_ndx(i);
 		}
@@ -348,8 +476,7 @@ odp_pmr_t alloc_pmr(pmr_t **pmr)
 	return ODP_PMR_INVALID;
 }
 
-static
-cos_t *get_cos_entry(odp_cos_t cos)
+static cos_t *get_cos_entry(odp_cos_t cos)
 {
 	uint32_t cos_id = _odp_cos_to_ndx(cos);
 
@@ -1561,9 +1688,98 @@ static inline cos_t *cls_select_cos(pktio_entry_t *entry,
 	return cls->default_cos;
 }
 
-static uint32_t packet_rss_hash(odp_packet_hdr_t *pkt_hdr,
-				odp_cls_hash_proto_t hash_proto,
-				const uint8_t *base);
+/* Time units the bucket is ahead of 'now', i.e. the bucket fill level */
+static inline uint64_t meter_ahead(uint64_t tat, uint64_t now)
+{
+	return tat > now ? tat - now : 0;
+}
+
+/* Consume 'units' from a bucket, when the fill level stays within 'tau' */
+static inline int meter_consume(odp_atomic_u64_t *tat_ptr, uint64_t now,
+				uint64_t units, uint64_t tau)
+{
+	uint64_t tat = odp_atomic_load_u64(tat_ptr);
+	uint64_t ahead;
+
+	do {
+		ahead = meter_ahead(tat, now);
+
+		if (ahead + units > tau)
+			return 0;
+
+	} while (!odp_atomic_cas_u64(tat_ptr, &tat, now + ahead + units));
+
+	return 1;
+}
+
+/* Color-aware meter. Concurrent updates of the two buckets are not atomic
+ * as a whole, which may cause a packet to be colored as if it had arrived
+ * slightly earlier or later. */
+static odp_packet_color_t meter_color(cls_meter_t *meter, uint64_t ns,
+				      uint32_t len, odp_packet_color_t color)
+{
+	uint64_t now, c_units, ahead_c;
+
+	if (color == ODP_PACKET_RED)
+		return ODP_PACKET_RED;
+
+	now = ns > meter->epoch ? (ns - meter->epoch) << METER_TIME_SHIFT : 0;
+	c_units = meter_units(len, meter->c_cost);
+
+	if (meter->mode == ODP_CLS_METER_TRTCM) {
+		if (!meter_consume(&meter->pe_tat, now,
+				   meter_units(len, meter->pe_cost),
+				   meter->pe_tau))
+			return ODP_PACKET_RED;
+
+		if (color == ODP_PACKET_YELLOW ||
+		    !meter_consume(&meter->c_tat, now, c_units, meter->c_tau))
+			return ODP_PACKET_YELLOW;
+
+		return ODP_PACKET_GREEN;
+	}
+
+	/* srTCM: green packets consume both committed and combined bucket,
+	 * yellow packets only excess tokens of the combined bucket */
+	if (color == ODP_PACKET_GREEN &&
+	    meter_consume(&meter->c_tat, now, c_units, meter->c_tau)) {
+		meter_consume(&meter->pe_tat, now, c_units, UINT64_MAX);
+		return ODP_PACKET_GREEN;
+	}
+
+	ahead_c = meter_ahead(odp_atomic_load_u64(&meter->c_tat), now);
+
+	if (meter_consume(&meter->pe_tat, now, c_units,
+			  meter->e_tau + ahead_c))
+		return ODP_PACKET_YELLOW;
+
+	return ODP_PACKET_RED;
+}
+
+/* Meter packet through the CoS meter hierarchy. Returns non-zero when the
+ * packet is dropped, otherwise marks packet color. */
+static inline int cls_meter_packet(cos_t *cos, odp_packet_hdr_t *pkt_hdr,
+				   uint32_t len)
+{
+	odp_packet_color_t color = ODP_PACKET_GREEN;
+	uint64_t ns = odp_time_global_ns();
+	cls_meter_t *meter = &cos->s.meter;
+
+	while (1) {
+		color = meter_color(meter, ns, len, color);
+
+		if (meter->drop[color])
+			return 1;
+
+		if (meter->parent == NULL)
+			break;
+
+		meter = &meter->parent->s.meter;
+	}
+
+	pkt_hdr->p.input_flags.color = color;
+	return 0;
+}
 
 /**
  * Classify packet
@@ -1576,6 +1792,7 @@ static uint32_t packet_rss_hash(odp_packet_hdr_t *pkt_hdr,
  * @param pkt_hdr[out]	Packet header
  *
  * @retval 0 on success
+ * @retval 1 Packet dropped by a meter
  * @retval -EFAULT Bug
  * @retval -EINVAL Config error
  *
@@ -1610,6 +1827,12 @@ int _odp_cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
 	if (cos->s.pool == ODP_POOL_INVALID)
 		return -EFAULT;
 
+	if (odp_unlikely(cos->s.meter.mode != ODP_CLS_METER_NONE) &&
+	    cls_meter_packet(cos, pkt_hdr, pkt_len)) {
+		odp_atomic_inc_u64(&entry->s.stats_extra.in_discards);
+		return 1;
+	}
+
 	*pool = cos->s.pool;
 	pkt_hdr->p.input_flags.dst_queue = 1;
 	pkt_hdr->cos = cos->s.index;
@@ -1619,7 +1842,7 @@ int _odp_cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
 		return 0;
 	}
 
-	hash = packet_rss_hash(pkt_hdr, cos->s.hash_proto, base);
+	hash = _odp_cls_packet_rss_hash(pkt_hdr, cos->s.hash_proto, base);
 	/* CLS_COS_QUEUE_MAX is a power of 2 */
 	hash = hash & (CLS_COS_QUEUE_MAX - 1);
 	tbl_index = (cos->s.index * CLS_COS_QUEUE_MAX) + (hash %
@@ -1628,9 +1851,9 @@ int _odp_cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
 	return 0;
 }
 
-static uint32_t packet_rss_hash(odp_packet_hdr_t *pkt_hdr,
-				odp_cls_hash_proto_t hash_proto,
-				const uint8_t *base)
+uint32_t _odp_cls_packet_rss_hash(odp_packet_hdr_t *pkt_hdr,
+				  odp_cls_hash_proto_t hash_proto,
+				  const uint8_t *base)
 {
 	thash_tuple_t tuple;
 	const _odp_ipv4hdr_t *ipv4;
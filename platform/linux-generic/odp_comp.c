@@ -4,23 +4,64 @@
  * SPDX-License-Identifier:     BSD-3-Clause
  */
 
+#include <odp_posix_extensions.h>
+
+#include <pthread.h>
+#include <sched.h>
 #include <string.h>
+#include <time.h>
 
 #include <odp/api/comp.h>
+#include <odp/api/cpu.h>
 #include <odp/api/event.h>
+#include <odp/api/init.h>
 #include <odp/api/packet.h>
+#include <odp/api/queue.h>
+#include <odp/api/time.h>
 #include <odp/api/plat/strong_types.h>
 #include <odp_packet_internal.h>
 #include <odp_global_data.h>
 
+#include <odp_comp_lzs_internal.h>
+#include <odp_config_internal.h>
 #include <odp_debug_internal.h>
 #include <odp_init_internal.h>
+#include <odp_libconfig_internal.h>
+#include <odp_ring_u32_internal.h>
 
 #include "miniz/miniz.h"
 
 #define MAX_SESSIONS  16
 #define MEM_LEVEL   8
 
+/* Linear buffer size for LZS processing of segmented packets */
+#define LZS_MAX_LEN   (64 * 1024)
+#define LZS_BUF_SIZE  _ODP_LZS_MAX_OUT(LZS_MAX_LEN)
+
+/* Maximum number of asynchronous operations queued per session */
+#define ASYNC_QUEUE_SIZE  256
+
+/* Ring of sessions with queued operations. Each session is in the ring at
+ * most once. */
+#define ASYNC_RING_SIZE   (2 * MAX_SESSIONS)
+#define ASYNC_RING_MASK   (ASYNC_RING_SIZE - 1)
+
+#define MAX_ASYNC_WORKERS 16
+#define MAX_ASYNC_BURST   QUEUE_MULTI_MAX
+
+/* Worker sleeps after this many empty polls */
+#define ASYNC_IDLE_ROUNDS 1000
+#define ASYNC_SLEEP_NS    50000
+
+/* Session destroy waits this long for workers to complete queued operations
+ * before completing those itself */
+#define ASYNC_REM_TMO_NS  ODP_TIME_SEC_IN_NS
+
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(ASYNC_RING_SIZE),
+		  "ASYNC_RING_SIZE is not a power of 2");
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(ASYNC_QUEUE_SIZE),
+		  "ASYNC_QUEUE_SIZE is not a power of 2");
+
 /** Forward declaration of session structure */
 typedef struct odp_comp_generic_session odp_comp_generic_session_t;
 
@@ -35,20 +76,45 @@ int (*comp_func_t)(odp_packet_t pkt_in,
 		   const odp_comp_packet_op_param_t *params,
 		   odp_comp_generic_session_t *session);
 
+/**
+ * Asynchronous operation
+ */
+typedef struct {
+	odp_packet_t pkt_in;
+	odp_packet_t pkt_out;
+	odp_comp_packet_op_param_t param;
+} comp_async_op_t;
+
 /**
  * Per session data structure
  */
 struct odp_comp_generic_session {
 	struct odp_comp_generic_session *next;
 	odp_comp_session_param_t        params;
+	uint32_t                        index;
 	struct {
 		comp_func_t func;
+		uint32_t level;
 		mz_stream stream;
 		union {
 			tdefl_compressor comp;
 			inflate_state inflate;
+			struct {
+				_odp_lzs_state_t state;
+				uint8_t in[LZS_BUF_SIZE];
+				uint8_t out[LZS_BUF_SIZE];
+			} lzs;
 		} data;
 	} comp;
+
+	/* Operations waiting for a worker thread */
+	struct {
+		odp_spinlock_t lock;
+		uint32_t head;
+		uint32_t tail;
+		uint32_t in_ring;
+		comp_async_op_t op[ASYNC_QUEUE_SIZE];
+	} async;
 };
 
 typedef struct odp_comp_global_s {
@@ -56,6 +122,32 @@ typedef struct odp_comp_global_s {
 	odp_shm_t global_shm;
 	odp_comp_generic_session_t *free;
 	odp_comp_generic_session_t  sessions[MAX_SESSIONS];
+
+	struct {
+		/* Configuration */
+		int num_workers;
+		uint32_t burst;
+
+		/* Worker thread start and stop take a long time, so those
+		 * are serialized with a mutex instead of the global lock */
+		pthread_mutex_t lock;
+
+		/* Number of asynchronous sessions. Protected by async lock. */
+		uint32_t num_sessions;
+		odp_atomic_u32_t stop;
+		pthread_t thread[MAX_ASYNC_WORKERS];
+
+		/* Workers report local init status to the starter. Protected
+		 * by init_lock. */
+		pthread_mutex_t init_lock;
+		pthread_cond_t init_cond;
+		int num_init;
+		int init_failed;
+
+		ring_u32_t ring;
+		/* Overlaps with ring.data[] */
+		uint32_t ring_data[ASYNC_RING_SIZE];
+	} async;
 } odp_comp_global_t;
 
 static odp_comp_global_t *global;
@@ -217,6 +309,103 @@ static void process_input(odp_packet_t pkt_out,
 	}
 }
 
+/*
+ * LZS routine to perform LZS compression/decompression
+ *
+ * Each operation processes one complete LZS block. Data in a single segment
+ * is processed in place, segmented data through session linear buffers.
+ */
+static int lzs_comp(odp_packet_t pkt_in,
+		    odp_packet_t pkt_out,
+		    const odp_comp_packet_op_param_t *params,
+		    odp_comp_generic_session_t *session)
+{
+	odp_comp_packet_result_t *result = get_op_result_from_packet(pkt_out);
+	uint32_t in_offset = params->in_data_range.offset;
+	uint32_t in_len = params->in_data_range.length;
+	uint32_t out_offset = params->out_data_range.offset;
+	uint32_t out_len = params->out_data_range.length;
+	uint32_t pkt_len = odp_packet_len(pkt_out);
+	uint32_t seg_len = 0;
+	const uint8_t *src;
+	uint8_t *dst;
+	int copy_out = 0;
+	int32_t ret;
+
+	src = odp_packet_offset(pkt_in, in_offset, &seg_len, NULL);
+
+	if (src == NULL || seg_len < in_len) {
+		if (in_len > LZS_BUF_SIZE ||
+		    odp_packet_copy_to_mem(pkt_in, in_offset, in_len,
+					   session->comp.data.lzs.in)) {
+			ODP_DBG("Bad input data range\n");
+			result->status = ODP_COMP_STATUS_FAILURE;
+			return -1;
+		}
+
+		src = session->comp.data.lzs.in;
+	}
+
+	/* Output is limited to packet length */
+	if (out_offset >= pkt_len)
+		out_len = 0;
+	else if (out_len > pkt_len - out_offset)
+		out_len = pkt_len - out_offset;
+
+	dst = odp_packet_offset(pkt_out, out_offset, &seg_len, NULL);
+
+	if (dst == NULL || seg_len < out_len) {
+		dst = session->comp.data.lzs.out;
+		copy_out = 1;
+
+		if (out_len > LZS_BUF_SIZE)
+			out_len = LZS_BUF_SIZE;
+	}
+
+	if (session->params.op == ODP_COMP_OP_COMPRESS)
+		ret = _odp_lzs_compress(&session->comp.data.lzs.state,
+					session->comp.level, src, in_len,
+					dst, out_len);
+	else
+		ret = _odp_lzs_decompress(src, in_len, dst, out_len);
+
+	if (ret < 0) {
+		ODP_DBG("LZS failed: %i\n", ret);
+		if (ret == _ODP_LZS_OUT_OF_SPACE)
+			result->status = ODP_COMP_STATUS_OUT_OF_SPACE_TERM;
+		else
+			result->status = ODP_COMP_STATUS_FAILURE;
+		return -1;
+	}
+
+	if (copy_out && ret &&
+	    odp_packet_copy_from_mem(pkt_out, out_offset, ret, dst)) {
+		result->status = ODP_COMP_STATUS_FAILURE;
+		return -1;
+	}
+
+	result->output_data_range.length = ret;
+	result->status = ODP_COMP_STATUS_SUCCESS;
+
+	return 0;
+}
+
+static int lzs_init(odp_comp_generic_session_t *session)
+{
+	uint32_t level = session->params.alg_param.lzs.comp_level;
+
+	if (level > _ODP_LZS_MAX_LEVEL) {
+		ODP_DBG("Bad LZS level %u\n", level);
+		return -1;
+	}
+
+	session->comp.level = level;
+	_odp_lzs_init(&session->comp.data.lzs.state);
+	session->comp.func = lzs_comp;
+
+	return 0;
+}
+
 /*
  * Deflate routine to perform deflate based compression/decompression
  *
@@ -403,6 +592,229 @@ static int term_def(odp_comp_generic_session_t *session)
 	return 0;
 }
 
+static int _odp_comp_single(odp_packet_t pkt_in, odp_packet_t pkt_out,
+			    const odp_comp_packet_op_param_t *param);
+
+/* Complete a burst of queued operations of a session. Returns number of
+ * operations completed. */
+static uint32_t async_complete(odp_comp_generic_session_t *session)
+{
+	comp_async_op_t op[MAX_ASYNC_BURST];
+	odp_event_t ev[MAX_ASYNC_BURST];
+	uint32_t i, num;
+	int num_enq;
+
+	odp_spinlock_lock(&session->async.lock);
+
+	num = session->async.tail - session->async.head;
+	if (num > global->async.burst)
+		num = global->async.burst;
+
+	for (i = 0; i < num; i++) {
+		uint32_t idx = (session->async.head + i) & (ASYNC_QUEUE_SIZE - 1);
+
+		op[i] = session->async.op[idx];
+	}
+
+	session->async.head += num;
+
+	odp_spinlock_unlock(&session->async.lock);
+
+	/* Operation status is passed to the application in packet result */
+	for (i = 0; i < num; i++) {
+		_odp_comp_single(op[i].pkt_in, op[i].pkt_out, &op[i].param);
+		ev[i] = odp_packet_to_event(op[i].pkt_out);
+	}
+
+	if (num) {
+		num_enq = odp_queue_enq_multi(session->params.compl_queue,
+					      ev, num);
+		if (odp_unlikely(num_enq < 0))
+			num_enq = 0;
+
+		if (odp_unlikely((uint32_t)num_enq < num)) {
+			ODP_DBG("Dropped %u comp results\n", num - num_enq);
+			odp_event_free_multi(&ev[num_enq], num - num_enq);
+		}
+	}
+
+	return num;
+}
+
+/* Process a burst of queued operations of a session */
+static void async_process(odp_comp_generic_session_t *session)
+{
+	int requeue = 0;
+
+	async_complete(session);
+
+	odp_spinlock_lock(&session->async.lock);
+
+	if (session->async.tail == session->async.head)
+		session->async.in_ring = 0;
+	else
+		requeue = 1;
+
+	odp_spinlock_unlock(&session->async.lock);
+
+	if (requeue)
+		ring_u32_enq(&global->async.ring, ASYNC_RING_MASK,
+			     session->index);
+}
+
+static void *async_worker(void *arg ODP_UNUSED)
+{
+	struct timespec ts = {.tv_sec = 0, .tv_nsec = ASYNC_SLEEP_NS};
+	uint32_t idle = 0;
+	uint32_t idx;
+	int ret;
+
+	ret = odp_init_local((odp_instance_t)odp_global_ro.main_pid,
+			     ODP_THREAD_CONTROL);
+	if (ret)
+		ODP_ERR("Comp worker local init failed\n");
+
+	pthread_mutex_lock(&global->async.init_lock);
+	global->async.num_init++;
+	if (ret)
+		global->async.init_failed = 1;
+	pthread_cond_signal(&global->async.init_cond);
+	pthread_mutex_unlock(&global->async.init_lock);
+
+	if (ret)
+		return NULL;
+
+	while (!odp_atomic_load_u32(&global->async.stop)) {
+		if (ring_u32_deq(&global->async.ring, ASYNC_RING_MASK, &idx) == 0) {
+			if (++idle < ASYNC_IDLE_ROUNDS) {
+				odp_cpu_pause();
+			} else {
+				idle = 0;
+				nanosleep(&ts, NULL);
+			}
+			continue;
+		}
+
+		idle = 0;
+		async_process(&global->sessions[idx]);
+	}
+
+	if (odp_term_local() < 0)
+		ODP_ERR("Comp worker local term failed\n");
+
+	return NULL;
+}
+
+static int async_workers_start(void)
+{
+	int i, ret, failed;
+
+	odp_atomic_store_u32(&global->async.stop, 0);
+	global->async.num_init = 0;
+	global->async.init_failed = 0;
+
+	for (i = 0; i < global->async.num_workers; i++) {
+		ret = pthread_create(&global->async.thread[i], NULL,
+				     async_worker, NULL);
+		if (ret) {
+			ODP_ERR("Comp worker thread create failed: %i\n", ret);
+			break;
+		}
+	}
+
+	/* Wait for created workers to complete local init */
+	pthread_mutex_lock(&global->async.init_lock);
+	while (global->async.num_init < i)
+		pthread_cond_wait(&global->async.init_cond,
+				  &global->async.init_lock);
+	failed = global->async.init_failed;
+	pthread_mutex_unlock(&global->async.init_lock);
+
+	if (i == global->async.num_workers && !failed)
+		return 0;
+
+	odp_atomic_store_u32(&global->async.stop, 1);
+
+	while (i--)
+		pthread_join(global->async.thread[i], NULL);
+
+	return -1;
+}
+
+static void async_workers_stop(void)
+{
+	int i;
+
+	odp_atomic_store_u32(&global->async.stop, 1);
+
+	for (i = 0; i < global->async.num_workers; i++)
+		pthread_join(global->async.thread[i], NULL);
+
+	/* Drop stale entries of sessions completed by session destroy */
+	ring_u32_init(&global->async.ring);
+}
+
+static int async_session_add(void)
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&global->async.lock);
+
+	/* Workers are started with the first asynchronous session */
+	if (global->async.num_sessions == 0)
+		ret = async_workers_start();
+
+	if (ret == 0)
+		global->async.num_sessions++;
+
+	pthread_mutex_unlock(&global->async.lock);
+
+	return ret;
+}
+
+static void async_session_rem(odp_comp_generic_session_t *session)
+{
+	uint32_t pending;
+	odp_time_t end = odp_time_sum(odp_time_local(),
+				      odp_time_local_from_ns(ASYNC_REM_TMO_NS));
+
+	/* Wait for workers to complete queued operations */
+	do {
+		odp_spinlock_lock(&session->async.lock);
+		pending = session->async.in_ring;
+		odp_spinlock_unlock(&session->async.lock);
+
+		if (pending)
+			sched_yield();
+	} while (pending && odp_time_cmp(end, odp_time_local()) > 0);
+
+	if (pending) {
+		ODP_ERR("Comp workers stuck, completing operations of session %u\n",
+			session->index);
+
+		while (async_complete(session))
+			;
+
+		odp_spinlock_lock(&session->async.lock);
+		session->async.in_ring = 0;
+		odp_spinlock_unlock(&session->async.lock);
+	}
+
+	pthread_mutex_lock(&global->async.lock);
+
+	global->async.num_sessions--;
+	if (global->async.num_sessions == 0)
+		async_workers_stop();
+
+	pthread_mutex_unlock(&global->async.lock);
+}
+
+static inline int use_async_workers(odp_comp_generic_session_t *session)
+{
+	return global->async.num_workers &&
+	       session->params.mode == ODP_COMP_OP_MODE_ASYNC;
+}
+
 odp_comp_session_t
 odp_comp_session_create(const odp_comp_session_param_t *params)
 {
@@ -428,13 +840,30 @@ odp_comp_session_create(const odp_comp_session_param_t *params)
 		if (rc < 0)
 			goto cleanup;
 		break;
+	case ODP_COMP_ALG_LZS:
+		rc = lzs_init(session);
+		if (rc < 0)
+			goto cleanup;
+		break;
 	default:
 		rc = -1;
 		goto cleanup;
 	}
 
+	session->async.head = 0;
+	session->async.tail = 0;
+	session->async.in_ring = 0;
+
+	if (use_async_workers(session) && async_session_add())
+		goto cleanup_alg;
+
 	return (odp_comp_session_t)session;
 
+cleanup_alg:
+	if (params->comp_algo == ODP_COMP_ALG_DEFLATE ||
+	    params->comp_algo == ODP_COMP_ALG_ZLIB)
+		term_def(session);
+
 cleanup:
 	free_session(session);
 
@@ -448,6 +877,9 @@ int odp_comp_session_destroy(odp_comp_session_t session)
 
 	generic = (odp_comp_generic_session_t *)(intptr_t)session;
 
+	if (use_async_workers(generic))
+		async_session_rem(generic);
+
 	switch (generic->params.comp_algo) {
 	case ODP_COMP_ALG_DEFLATE:
 	case ODP_COMP_ALG_ZLIB:
@@ -461,7 +893,7 @@ int odp_comp_session_destroy(odp_comp_session_t session)
 		return -1;
 	}
 
-	memset(generic, 0, sizeof(*generic));
+	memset(&generic->params, 0, sizeof(generic->params));
 	free_session(generic);
 	return 0;
 }
@@ -477,6 +909,7 @@ int odp_comp_capability(odp_comp_capability_t *capa)
 	capa->comp_algos.bit.null = 1;
 	capa->comp_algos.bit.deflate = 1;
 	capa->comp_algos.bit.zlib = 1;
+	capa->comp_algos.bit.lzs = 1;
 	capa->hash_algos.bit.none = 1;
 	capa->sync = ODP_SUPPORT_YES;
 	capa->async = ODP_SUPPORT_YES;
@@ -501,6 +934,12 @@ odp_comp_alg_capability(odp_comp_alg_t comp,
 		capa->max_level = MZ_BEST_COMPRESSION;
 		capa->compression_ratio = 50;
 		return 0;
+	case ODP_COMP_ALG_LZS:
+		capa->hash_algo.all_bits = 0;
+		capa->hash_algo.bit.none = 1;
+		capa->max_level = _ODP_LZS_MAX_LEVEL;
+		capa->compression_ratio = 60;
+		return 0;
 	default:
 		/* Error unsupported enum */
 		return -1;
@@ -566,12 +1005,64 @@ int odp_comp_op(const odp_packet_t pkt_in[], odp_packet_t pkt_out[],
 	return i;
 }
 
+/* Queue operations for worker threads. Consecutive operations of the same
+ * session are queued under one lock. */
+static int async_enq(const odp_packet_t pkt_in[], odp_packet_t pkt_out[],
+		     int num_pkt, const odp_comp_packet_op_param_t param[])
+{
+	int i = 0;
+
+	while (i < num_pkt) {
+		odp_comp_session_t hdl = param[i].session;
+		odp_comp_generic_session_t *session = to_gen_session(hdl);
+		int push = 0;
+		int num = 0;
+
+		odp_spinlock_lock(&session->async.lock);
+
+		while (i < num_pkt && param[i].session == hdl &&
+		       session->async.tail - session->async.head <
+		       ASYNC_QUEUE_SIZE) {
+			uint32_t idx = session->async.tail &
+				       (ASYNC_QUEUE_SIZE - 1);
+			comp_async_op_t *op = &session->async.op[idx];
+
+			op->pkt_in  = pkt_in[i];
+			op->pkt_out = pkt_out[i];
+			op->param   = param[i];
+			session->async.tail++;
+			i++;
+			num++;
+		}
+
+		if (num && !session->async.in_ring) {
+			session->async.in_ring = 1;
+			push = 1;
+		}
+
+		odp_spinlock_unlock(&session->async.lock);
+
+		if (push)
+			ring_u32_enq(&global->async.ring, ASYNC_RING_MASK,
+				     session->index);
+
+		/* Session queue is full */
+		if (num == 0)
+			break;
+	}
+
+	return i;
+}
+
 int odp_comp_op_enq(const odp_packet_t pkt_in[], odp_packet_t pkt_out[],
 		    int num_pkt, const odp_comp_packet_op_param_t param[])
 {
 	int i;
 	int rc;
 
+	if (num_pkt > 0 && use_async_workers(to_gen_session(param[0].session)))
+		return async_enq(pkt_in, pkt_out, num_pkt, param);
+
 	for (i = 0; i < num_pkt; i++) {
 		odp_event_t event;
 		odp_comp_generic_session_t *session;
@@ -605,6 +1096,44 @@ int odp_comp_result(odp_comp_packet_result_t *result,
 	return 0;
 }
 
+static int read_config_file(odp_comp_global_t *global)
+{
+	const char *str;
+	int val = 0;
+
+	ODP_PRINT("Compression config:\n");
+
+	str = "comp.async_workers";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val < 0 || val > MAX_ASYNC_WORKERS) {
+		ODP_ERR("Bad value %s = %i\n", str, val);
+		return -1;
+	}
+
+	global->async.num_workers = val;
+	ODP_PRINT("  %s: %i\n", str, val);
+
+	str = "comp.async_burst";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val < 1 || val > MAX_ASYNC_BURST) {
+		ODP_ERR("Bad value %s = %i\n", str, val);
+		return -1;
+	}
+
+	global->async.burst = val;
+	ODP_PRINT("  %s: %i\n\n", str, val);
+
+	return 0;
+}
+
 int _odp_comp_init_global(void)
 {
 	size_t mem_size;
@@ -629,14 +1158,47 @@ int _odp_comp_init_global(void)
 	memset(global, 0, mem_size);
 	global->global_shm = shm;
 
+	if (read_config_file(global)) {
+		odp_shm_free(shm);
+		return -1;
+	}
+
 	/* Initialize free list and lock */
 	for (idx = 0; idx < MAX_SESSIONS; idx++) {
+		global->sessions[idx].index = idx;
+		odp_spinlock_init(&global->sessions[idx].async.lock);
 		global->sessions[idx].next = global->free;
 		global->free = &global->sessions[idx];
 	}
 	odp_spinlock_init(&global->lock);
 
+	ring_u32_init(&global->async.ring);
+	odp_atomic_init_u32(&global->async.stop, 0);
+
+	if (pthread_mutex_init(&global->async.lock, NULL)) {
+		ODP_ERR("Async lock init failed\n");
+		goto error_lock;
+	}
+
+	if (pthread_mutex_init(&global->async.init_lock, NULL)) {
+		ODP_ERR("Async init lock init failed\n");
+		goto error_init_lock;
+	}
+
+	if (pthread_cond_init(&global->async.init_cond, NULL)) {
+		ODP_ERR("Async init cond init failed\n");
+		goto error_init_cond;
+	}
+
 	return 0;
+
+error_init_cond:
+	pthread_mutex_destroy(&global->async.init_lock);
+error_init_lock:
+	pthread_mutex_destroy(&global->async.lock);
+error_lock:
+	odp_shm_free(shm);
+	return -1;
 }
 
 int _odp_comp_term_global(void)
@@ -657,6 +1219,13 @@ int _odp_comp_term_global(void)
 		rc = -1;
 	}
 
+	if (global->async.num_sessions)
+		async_workers_stop();
+
+	pthread_cond_destroy(&global->async.init_cond);
+	pthread_mutex_destroy(&global->async.init_lock);
+	pthread_mutex_destroy(&global->async.lock);
+
 	ret = odp_shm_free(global->global_shm);
 	if (ret < 0) {
 		ODP_ERR("shm free failed for comp_pool\n");
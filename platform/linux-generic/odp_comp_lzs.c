@@ -0,0 +1,360 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/api/byteorder.h>
+#include <odp/api/debug.h>
+#include <odp/api/hints.h>
+
+#include <odp_comp_lzs_internal.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/* Level used when zero is requested */
+#define DEFAULT_LEVEL 3
+
+#define HASH_BITS     12
+#define WINDOW_MASK   (_ODP_LZS_WINDOW - 1)
+
+/* Offset 0 is reserved for the end marker */
+#define MAX_OFFSET    (_ODP_LZS_WINDOW - 1)
+
+/* Offsets below this are coded with 7 bits, others with 11 bits */
+#define SHORT_OFFSET  128
+
+/* Matches are found with a three byte hash */
+#define MIN_MATCH     3
+
+/* Reset position base before it wraps around */
+#define MAX_BASE      0xf0000000
+
+ODP_STATIC_ASSERT((1 << HASH_BITS) == _ODP_LZS_HASH_SIZE, "Bad hash size");
+
+typedef struct {
+	uint8_t *ptr;
+	uint8_t *end;
+	uint64_t bits;
+	uint32_t num;
+	int      overflow;
+
+} bit_wr_t;
+
+typedef struct {
+	const uint8_t *ptr;
+	const uint8_t *end;
+	uint64_t bits;
+	uint32_t num;
+
+} bit_rd_t;
+
+/* Write 'n' (max 32) bits, most significant bit first */
+static inline void put_bits(bit_wr_t *wr, uint32_t val, uint32_t n)
+{
+	wr->bits = (wr->bits << n) | val;
+	wr->num += n;
+
+	while (wr->num >= 8) {
+		wr->num -= 8;
+
+		if (odp_unlikely(wr->ptr == wr->end)) {
+			wr->overflow = 1;
+			wr->num = 0;
+			return;
+		}
+
+		*wr->ptr++ = (uint8_t)(wr->bits >> wr->num);
+	}
+}
+
+static inline void put_literal(bit_wr_t *wr, uint8_t byte)
+{
+	/* 0 + 8 bit literal */
+	put_bits(wr, byte, 9);
+}
+
+static inline void put_match(bit_wr_t *wr, uint32_t offset, uint32_t len)
+{
+	/* 1 + 1 + 7 bit offset, or 1 + 0 + 11 bit offset */
+	if (offset < SHORT_OFFSET)
+		put_bits(wr, (0x3 << 7) | offset, 9);
+	else
+		put_bits(wr, (0x2 << 11) | offset, 13);
+
+	/* Length: 2..4 in 2 bits, 5..7 in 4 bits, and 8 or more as 1111
+	 * followed by 4 bit groups, where 1111 means that another group
+	 * follows */
+	if (len <= 4) {
+		put_bits(wr, len - 2, 2);
+	} else if (len <= 7) {
+		put_bits(wr, 0xc | (len - 5), 4);
+	} else {
+		len -= 8;
+		put_bits(wr, 0xf, 4);
+
+		while (len >= 15) {
+			put_bits(wr, 0xf, 4);
+			len -= 15;
+		}
+
+		put_bits(wr, len, 4);
+	}
+}
+
+static inline void put_end(bit_wr_t *wr)
+{
+	/* End marker is a short offset of zero */
+	put_bits(wr, 0x3 << 7, 9);
+
+	/* Pad to byte boundary */
+	if (wr->num)
+		put_bits(wr, 0, 8 - wr->num);
+}
+
+/* Read 'n' (max 16) bits */
+static inline int get_bits(bit_rd_t *rd, uint32_t n, uint32_t *val)
+{
+	while (rd->num < n) {
+		if (odp_unlikely(rd->ptr == rd->end))
+			return -1;
+
+		rd->bits = (rd->bits << 8) | *rd->ptr++;
+		rd->num += 8;
+	}
+
+	rd->num -= n;
+	*val = (uint32_t)(rd->bits >> rd->num) & ((1u << n) - 1);
+
+	return 0;
+}
+
+static inline uint32_t hash3(const uint8_t *p)
+{
+	uint32_t val = p[0] | (p[1] << 8) | (p[2] << 16);
+
+	return (val * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static inline uint32_t match_len(const uint8_t *ref, const uint8_t *cur,
+				 const uint8_t *end)
+{
+	const uint8_t *start = cur;
+
+	while (cur + 8 <= end) {
+		uint64_t a, b;
+
+		memcpy(&a, ref, 8);
+		memcpy(&b, cur, 8);
+
+		if (a != b) {
+#if ODP_BYTE_ORDER == ODP_LITTLE_ENDIAN
+			return (cur - start) + (__builtin_ctzll(a ^ b) >> 3);
+#else
+			return (cur - start) + (__builtin_clzll(a ^ b) >> 3);
+#endif
+		}
+
+		ref += 8;
+		cur += 8;
+	}
+
+	while (cur < end && *ref == *cur) {
+		ref++;
+		cur++;
+	}
+
+	return cur - start;
+}
+
+void _odp_lzs_init(_odp_lzs_state_t *state)
+{
+	memset(state->head, 0, sizeof(state->head));
+	state->base = 0;
+}
+
+int32_t _odp_lzs_compress(_odp_lzs_state_t *state, uint32_t level,
+			  const uint8_t *src, uint32_t src_len,
+			  uint8_t *dst, uint32_t dst_len)
+{
+	bit_wr_t wr;
+	uint32_t max_chain;
+	uint32_t pos = 0;
+	uint32_t *head = state->head;
+	uint32_t *prev = state->prev;
+	const uint8_t *end = src + src_len;
+	uint32_t base;
+
+	if (level == 0)
+		level = DEFAULT_LEVEL;
+
+	if (level > _ODP_LZS_MAX_LEVEL)
+		level = _ODP_LZS_MAX_LEVEL;
+
+	max_chain = 1u << (level - 1);
+
+	/* Hash table entries of previous blocks are ignored */
+	if (state->base + src_len > MAX_BASE)
+		_odp_lzs_init(state);
+
+	base = state->base;
+	state->base += src_len + 1;
+
+	wr.ptr = dst;
+	wr.end = dst + dst_len;
+	wr.bits = 0;
+	wr.num = 0;
+	wr.overflow = 0;
+
+	while (pos + MIN_MATCH <= src_len) {
+		uint32_t h = hash3(&src[pos]);
+		uint32_t cand = head[h];
+		uint32_t best_len = 0;
+		uint32_t best_off = 0;
+		uint32_t chain = max_chain;
+
+		head[h] = base + pos + 1;
+		prev[pos & WINDOW_MASK] = cand;
+
+		while (cand > base && chain--) {
+			uint32_t ref = cand - base - 1;
+			uint32_t offset = pos - ref;
+			uint32_t len;
+
+			if (offset > MAX_OFFSET)
+				break;
+
+			if (src[ref + best_len] == src[pos + best_len]) {
+				len = match_len(&src[ref], &src[pos], end);
+
+				if (len > best_len) {
+					best_len = len;
+					best_off = offset;
+
+					if (pos + len == src_len)
+						break;
+				}
+			}
+
+			cand = prev[ref & WINDOW_MASK];
+		}
+
+		if (best_len >= MIN_MATCH) {
+			uint32_t i;
+
+			put_match(&wr, best_off, best_len);
+
+			/* The fastest level does not index bytes inside
+			 * matches */
+			if (level > 1) {
+				for (i = pos + 1; i < pos + best_len &&
+				     i + MIN_MATCH <= src_len; i++) {
+					h = hash3(&src[i]);
+					prev[i & WINDOW_MASK] = head[h];
+					head[h] = base + i + 1;
+				}
+			}
+
+			pos += best_len;
+		} else {
+			put_literal(&wr, src[pos]);
+			pos++;
+		}
+
+		if (odp_unlikely(wr.overflow))
+			return _ODP_LZS_OUT_OF_SPACE;
+	}
+
+	while (pos < src_len)
+		put_literal(&wr, src[pos++]);
+
+	put_end(&wr);
+
+	if (odp_unlikely(wr.overflow))
+		return _ODP_LZS_OUT_OF_SPACE;
+
+	return wr.ptr - dst;
+}
+
+int32_t _odp_lzs_decompress(const uint8_t *src, uint32_t src_len,
+			    uint8_t *dst, uint32_t dst_len)
+{
+	bit_rd_t rd;
+	uint32_t val, offset, len;
+	uint32_t pos = 0;
+
+	rd.ptr = src;
+	rd.end = src + src_len;
+	rd.bits = 0;
+	rd.num = 0;
+
+	while (1) {
+		if (get_bits(&rd, 1, &val))
+			return _ODP_LZS_CORRUPT;
+
+		if (val == 0) {
+			if (get_bits(&rd, 8, &val))
+				return _ODP_LZS_CORRUPT;
+
+			if (odp_unlikely(pos == dst_len))
+				return _ODP_LZS_OUT_OF_SPACE;
+
+			dst[pos++] = (uint8_t)val;
+			continue;
+		}
+
+		if (get_bits(&rd, 1, &val))
+			return _ODP_LZS_CORRUPT;
+
+		if (val) {
+			if (get_bits(&rd, 7, &offset))
+				return _ODP_LZS_CORRUPT;
+
+			/* End marker */
+			if (offset == 0)
+				return pos;
+		} else {
+			if (get_bits(&rd, 11, &offset))
+				return _ODP_LZS_CORRUPT;
+
+			if (offset == 0)
+				return _ODP_LZS_CORRUPT;
+		}
+
+		if (get_bits(&rd, 2, &val))
+			return _ODP_LZS_CORRUPT;
+
+		if (val < 3) {
+			len = val + 2;
+		} else {
+			if (get_bits(&rd, 2, &val))
+				return _ODP_LZS_CORRUPT;
+
+			if (val < 3) {
+				len = val + 5;
+			} else {
+				len = 8;
+
+				do {
+					if (get_bits(&rd, 4, &val))
+						return _ODP_LZS_CORRUPT;
+
+					len += val;
+				} while (val == 15);
+			}
+		}
+
+		if (odp_unlikely(offset > pos))
+			return _ODP_LZS_CORRUPT;
+
+		if (odp_unlikely(len > dst_len - pos))
+			return _ODP_LZS_OUT_OF_SPACE;
+
+		/* Source and destination may overlap */
+		while (len--) {
+			dst[pos] = dst[pos - offset];
+			pos++;
+		}
+	}
+}
@@ -12,12 +12,14 @@
 #include <odp/api/debug.h>
 #include <odp/api/align.h>
 #include <odp/api/shared_memory.h>
+#include <odp_crypto_internal.h>
 #include <odp_debug_internal.h>
 #include <odp/api/hints.h>
 #include <odp/api/random.h>
 #include <odp/api/plat/packet_inlines.h>
 #include <odp/api/plat/thread_inlines.h>
 #include <odp_packet_internal.h>
+#include <odp_trace_internal.h>
 #include <odp/api/plat/queue_inlines.h>
 
 /* Inlined API functions */
@@ -454,6 +456,25 @@ int odp_crypto_result(odp_crypto_packet_result_t *result,
 	return 0;
 }
 
+static inline
+void crypto_process(odp_packet_t pkt)
+{
+	odp_crypto_packet_result_t *op_result;
+	odp_packet_hdr_t *pkt_hdr;
+
+	/* Fill in result */
+	packet_subtype_set(pkt, ODP_EVENT_PACKET_CRYPTO);
+	op_result = get_op_result_from_packet(pkt);
+	op_result->cipher_status.alg_err = ODP_CRYPTO_ALG_ERR_NONE;
+	op_result->cipher_status.hw_err = ODP_CRYPTO_HW_ERR_NONE;
+	op_result->auth_status.alg_err = ODP_CRYPTO_ALG_ERR_NONE;
+	op_result->auth_status.hw_err = ODP_CRYPTO_HW_ERR_NONE;
+	op_result->ok = true;
+
+	pkt_hdr = packet_hdr(pkt);
+	pkt_hdr->p.flags.crypto_err = !op_result->ok;
+}
+
 static
 int crypto_int(odp_packet_t pkt_in,
 	       odp_packet_t *pkt_out,
@@ -462,8 +483,6 @@ int crypto_int(odp_packet_t pkt_in,
 	odp_crypto_generic_session_t *session;
 	odp_bool_t allocated = false;
 	odp_packet_t out_pkt = *pkt_out;
-	odp_crypto_packet_result_t *op_result;
-	odp_packet_hdr_t *pkt_hdr;
 
 	session = (odp_crypto_generic_session_t *)(intptr_t)param->session;
 
@@ -496,17 +515,7 @@ int crypto_int(odp_packet_t pkt_in,
 		pkt_in = ODP_PACKET_INVALID;
 	}
 
-	/* Fill in result */
-	packet_subtype_set(out_pkt, ODP_EVENT_PACKET_CRYPTO);
-	op_result = get_op_result_from_packet(out_pkt);
-	op_result->cipher_status.alg_err = ODP_CRYPTO_ALG_ERR_NONE;
-	op_result->cipher_status.hw_err = ODP_CRYPTO_HW_ERR_NONE;
-	op_result->auth_status.alg_err = ODP_CRYPTO_ALG_ERR_NONE;
-	op_result->auth_status.hw_err = ODP_CRYPTO_HW_ERR_NONE;
-	op_result->ok = true;
-
-	pkt_hdr = packet_hdr(out_pkt);
-	pkt_hdr->p.flags.crypto_err = !op_result->ok;
+	crypto_process(out_pkt);
 
 	/* Synchronous, simply return results */
 	*pkt_out = out_pkt;
@@ -529,6 +538,7 @@ int odp_crypto_op(const odp_packet_t pkt_in[],
 {
 	int i, rc;
 	odp_crypto_generic_session_t *session;
+	uint64_t trace_start = _odp_trace_begin();
 
 	for (i = 0; i < num_pkt; i++) {
 		session = (odp_crypto_generic_session_t *)(intptr_t)param[i].session;
@@ -539,9 +549,37 @@ int odp_crypto_op(const odp_packet_t pkt_in[],
 			break;
 	}
 
+	_odp_trace_end(_ODP_TRACE_CRYPTO_OP, trace_start,
+		       i ? odp_crypto_session_to_u64(param[0].session) : 0, i);
+
 	return i;
 }
 
+int _odp_crypto_op_session(odp_crypto_session_t session_hdl,
+			   odp_packet_t pkt[],
+			   const odp_crypto_packet_op_param_t param[],
+			   int num)
+{
+	odp_crypto_generic_session_t *session;
+	uint64_t trace_start = _odp_trace_begin();
+	int i;
+
+	session = (odp_crypto_generic_session_t *)(intptr_t)session_hdl;
+	ODP_ASSERT(ODP_CRYPTO_SYNC == session->p.op_mode);
+	(void)session;
+	(void)param;
+
+	for (i = 0; i < num; i++) {
+		ODP_ASSERT(param[i].session == session_hdl);
+		crypto_process(pkt[i]);
+	}
+
+	_odp_trace_end(_ODP_TRACE_CRYPTO_OP, trace_start,
+		       odp_crypto_session_to_u64(session_hdl), num);
+
+	return num;
+}
+
 int odp_crypto_op_enq(const odp_packet_t pkt_in[],
 		      const odp_packet_t pkt_out[],
 		      const odp_crypto_packet_op_param_t param[],
@@ -12,6 +12,7 @@
 #include <odp/api/debug.h>
 #include <odp/api/align.h>
 #include <odp/api/shared_memory.h>
+#include <odp_crypto_internal.h>
 #include <odp_debug_internal.h>
 #include <odp/api/hints.h>
 #include <odp/api/random.h>
@@ -20,6 +21,7 @@
 #include <odp_packet_internal.h>
 #include <odp/api/plat/queue_inlines.h>
 #include <odp_global_data.h>
+#include <odp_trace_internal.h>
 
 /* Inlined API functions */
 #include <odp/api/plat/event_inlines.h>
@@ -2727,18 +2729,48 @@ int odp_crypto_result(odp_crypto_packet_result_t *result,
 	return 0;
 }
 
+static inline
+void crypto_process(odp_packet_t pkt,
+		    const odp_crypto_packet_op_param_t *param,
+		    odp_crypto_generic_session_t *session)
+{
+	odp_crypto_alg_err_t rc_cipher;
+	odp_crypto_alg_err_t rc_auth;
+	odp_crypto_packet_result_t *op_result;
+	odp_packet_hdr_t *pkt_hdr;
+
+	/* Invoke the functions */
+	if (session->do_cipher_first) {
+		rc_cipher = session->cipher.func(pkt, param, session);
+		rc_auth = session->auth.func(pkt, param, session);
+	} else {
+		rc_auth = session->auth.func(pkt, param, session);
+		rc_cipher = session->cipher.func(pkt, param, session);
+	}
+
+	/* Fill in result */
+	packet_subtype_set(pkt, ODP_EVENT_PACKET_CRYPTO);
+	op_result = get_op_result_from_packet(pkt);
+	op_result->cipher_status.alg_err = rc_cipher;
+	op_result->cipher_status.hw_err = ODP_CRYPTO_HW_ERR_NONE;
+	op_result->auth_status.alg_err = rc_auth;
+	op_result->auth_status.hw_err = ODP_CRYPTO_HW_ERR_NONE;
+	op_result->ok =
+		(rc_cipher == ODP_CRYPTO_ALG_ERR_NONE) &&
+		(rc_auth == ODP_CRYPTO_ALG_ERR_NONE);
+
+	pkt_hdr = packet_hdr(pkt);
+	pkt_hdr->p.flags.crypto_err = !op_result->ok;
+}
+
 static
 int crypto_int(odp_packet_t pkt_in,
 	       odp_packet_t *pkt_out,
 	       const odp_crypto_packet_op_param_t *param)
 {
-	odp_crypto_alg_err_t rc_cipher = ODP_CRYPTO_ALG_ERR_NONE;
-	odp_crypto_alg_err_t rc_auth = ODP_CRYPTO_ALG_ERR_NONE;
 	odp_crypto_generic_session_t *session;
 	odp_bool_t allocated = false;
 	odp_packet_t out_pkt = *pkt_out;
-	odp_crypto_packet_result_t *op_result;
-	odp_packet_hdr_t *pkt_hdr;
 
 	session = (odp_crypto_generic_session_t *)(intptr_t)param->session;
 
@@ -2772,29 +2804,7 @@ int crypto_int(odp_packet_t pkt_in,
 	}
 
 	crypto_init(session);
-
-	/* Invoke the functions */
-	if (session->do_cipher_first) {
-		rc_cipher = session->cipher.func(out_pkt, param, session);
-		rc_auth = session->auth.func(out_pkt, param, session);
-	} else {
-		rc_auth = session->auth.func(out_pkt, param, session);
-		rc_cipher = session->cipher.func(out_pkt, param, session);
-	}
-
-	/* Fill in result */
-	packet_subtype_set(out_pkt, ODP_EVENT_PACKET_CRYPTO);
-	op_result = get_op_result_from_packet(out_pkt);
-	op_result->cipher_status.alg_err = rc_cipher;
-	op_result->cipher_status.hw_err = ODP_CRYPTO_HW_ERR_NONE;
-	op_result->auth_status.alg_err = rc_auth;
-	op_result->auth_status.hw_err = ODP_CRYPTO_HW_ERR_NONE;
-	op_result->ok =
-		(rc_cipher == ODP_CRYPTO_ALG_ERR_NONE) &&
-		(rc_auth == ODP_CRYPTO_ALG_ERR_NONE);
-
-	pkt_hdr = packet_hdr(out_pkt);
-	pkt_hdr->p.flags.crypto_err = !op_result->ok;
+	crypto_process(out_pkt, param, session);
 
 	/* Synchronous, simply return results */
 	*pkt_out = out_pkt;
@@ -2817,6 +2827,7 @@ int odp_crypto_op(const odp_packet_t pkt_in[],
 {
 	int i, rc;
 	odp_crypto_generic_session_t *session;
+	uint64_t trace_start = _odp_trace_begin();
 
 	for (i = 0; i < num_pkt; i++) {
 		session = (odp_crypto_generic_session_t *)(intptr_t)param[i].session;
@@ -2827,9 +2838,41 @@ int odp_crypto_op(const odp_packet_t pkt_in[],
 			break;
 	}
 
+	_odp_trace_end(_ODP_TRACE_CRYPTO_OP, trace_start,
+		       i ? odp_crypto_session_to_u64(param[0].session) : 0, i);
+
 	return i;
 }
 
+int _odp_crypto_op_session(odp_crypto_session_t session_hdl,
+			   odp_packet_t pkt[],
+			   const odp_crypto_packet_op_param_t param[],
+			   int num)
+{
+	odp_crypto_generic_session_t *session;
+	uint64_t trace_start = _odp_trace_begin();
+	int i;
+
+	session = (odp_crypto_generic_session_t *)(intptr_t)session_hdl;
+	ODP_ASSERT(ODP_CRYPTO_SYNC == session->p.op_mode);
+
+	crypto_init(session);
+
+	for (i = 0; i < num; i++) {
+		ODP_ASSERT(param[i].session == session_hdl);
+
+		if (odp_likely(i + 1 < num))
+			odp_packet_prefetch(pkt[i + 1], 0, ODP_CACHE_LINE_SIZE);
+
+		crypto_process(pkt[i], &param[i], session);
+	}
+
+	_odp_trace_end(_ODP_TRACE_CRYPTO_OP, trace_start,
+		       odp_crypto_session_to_u64(session_hdl), num);
+
+	return num;
+}
+
 int odp_crypto_op_enq(const odp_packet_t pkt_in[],
 		      const odp_packet_t pkt_out[],
 		      const odp_crypto_packet_op_param_t param[],
@@ -8,17 +8,22 @@
 
 #include <odp/api/init.h>
 #include <odp/api/shared_memory.h>
+#include <odp/api/time.h>
 #include <odp_debug_internal.h>
 #include <odp_init_internal.h>
 #include <odp_schedule_if.h>
 #include <odp_libconfig_internal.h>
+#include <odp_probe_cache_internal.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
 #include <unistd.h>
 
 enum init_stage {
 	NO_INIT = 0,    /* No init stages completed */
 	LIBCONFIG_INIT,
+	PROBE_CACHE_INIT,
+	TIMER_PROBE_INIT,
 	CPUMASK_INIT,
 	CPU_CYCLES_INIT,
 	TIME_INIT,
@@ -28,6 +33,7 @@ enum init_stage {
 	GLOBAL_RW_DATA_INIT,
 	HASH_INIT,
 	THREAD_INIT,
+	TRACE_INIT,
 	POOL_INIT,
 	STASH_INIT,
 	QUEUE_INIT,
@@ -46,9 +52,90 @@ enum init_stage {
 	ALL_INIT      /* All init stages completed */
 };
 
+static const char * const init_stage_name[ALL_INIT] = {
+	[LIBCONFIG_INIT]      = "libconfig",
+	[PROBE_CACHE_INIT]    = "probe cache",
+	[TIMER_PROBE_INIT]    = "timer probe start",
+	[CPUMASK_INIT]        = "cpumask",
+	[CPU_CYCLES_INIT]     = "cpu cycles",
+	[TIME_INIT]           = "time",
+	[SYSINFO_INIT]        = "system info",
+	[ISHM_INIT]           = "ishm",
+	[FDSERVER_INIT]       = "fdserver",
+	[GLOBAL_RW_DATA_INIT] = "global rw data",
+	[HASH_INIT]           = "hash",
+	[THREAD_INIT]         = "thread",
+	[TRACE_INIT]          = "trace",
+	[POOL_INIT]           = "pool",
+	[STASH_INIT]          = "stash",
+	[QUEUE_INIT]          = "queue",
+	[SCHED_INIT]          = "schedule",
+	[PKTIO_INIT]          = "pktio",
+	[TIMER_INIT]          = "timer",
+	[RANDOM_INIT]         = "random",
+	[CRYPTO_INIT]         = "crypto",
+	[COMP_INIT]           = "comp",
+	[CLASSIFICATION_INIT] = "classification",
+	[TRAFFIC_MNGR_INIT]   = "traffic manager",
+	[NAME_TABLE_INIT]     = "name table",
+	[IPSEC_EVENTS_INIT]   = "ipsec events",
+	[IPSEC_SAD_INIT]      = "ipsec sad",
+	[IPSEC_INIT]          = "ipsec"
+};
+
+/* Start-up profile of odp_init_global(). Time is measured with
+ * clock_gettime() since ODP time is initialized only in TIME_INIT stage. */
+static struct {
+	uint64_t ns[ALL_INIT];
+	uint64_t start_ns;
+	uint64_t prev_ns;
+
+} init_prof;
+
 odp_global_data_ro_t odp_global_ro;
 odp_global_data_rw_t *odp_global_rw;
 
+static uint64_t init_prof_time(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * ODP_TIME_SEC_IN_NS + ts.tv_nsec;
+}
+
+/* Record end time of an init stage */
+static enum init_stage init_stage_done(enum init_stage stage)
+{
+	uint64_t now = init_prof_time();
+
+	init_prof.ns[stage] = now - init_prof.prev_ns;
+	init_prof.prev_ns = now;
+
+	return stage;
+}
+
+static void init_prof_print(void)
+{
+	const char *str = "system.init_profile";
+	uint64_t total = init_prof.prev_ns - init_prof.start_ns;
+	int val = 0;
+	int i;
+
+	if (!_odp_libconfig_lookup_int(str, &val) || !val)
+		return;
+
+	ODP_PRINT("\nodp_init_global() profile\n");
+	ODP_PRINT("-------------------------\n");
+
+	for (i = LIBCONFIG_INIT; i < ALL_INIT; i++)
+		ODP_PRINT("  %-20s %10.3f ms\n", init_stage_name[i],
+			  (double)init_prof.ns[i] / ODP_TIME_MSEC_IN_NS);
+
+	ODP_PRINT("  %-20s %10.3f ms\n\n", "total",
+		  (double)total / ODP_TIME_MSEC_IN_NS);
+}
+
 static void disable_features(odp_global_data_ro_t *global_ro,
 			     const odp_init_t *init_param)
 {
@@ -218,6 +305,13 @@ static int term_global(enum init_stage stage)
 		}
 		/* Fall through */
 
+	case TRACE_INIT:
+		if (_odp_trace_term_global()) {
+			ODP_ERR("ODP trace term failed.\n");
+			rc = -1;
+		}
+		/* Fall through */
+
 	case THREAD_INIT:
 		if (_odp_thread_term_global()) {
 			ODP_ERR("ODP thread term failed.\n");
@@ -276,6 +370,16 @@ static int term_global(enum init_stage stage)
 		}
 		/* Fall through */
 
+	case TIMER_PROBE_INIT:
+		if (_odp_timer_res_probe_stop()) {
+			ODP_ERR("ODP timer probe stop failed.\n");
+			rc = -1;
+		}
+		/* Fall through */
+
+	case PROBE_CACHE_INIT:
+		/* Fall through */
+
 	case LIBCONFIG_INIT:
 		if (_odp_libconfig_term_global()) {
 			ODP_ERR("ODP runtime config term failed.\n");
@@ -296,6 +400,10 @@ int odp_init_global(odp_instance_t *instance,
 {
 	enum init_stage stage = NO_INIT;
 
+	memset(&init_prof, 0, sizeof(init_prof));
+	init_prof.start_ns = init_prof_time();
+	init_prof.prev_ns = init_prof.start_ns;
+
 	memset(&odp_global_ro, 0, sizeof(odp_global_data_ro_t));
 	odp_global_ro.main_pid = getpid();
 	odp_global_ro.log_fn = odp_override_log;
@@ -317,153 +425,175 @@ int odp_init_global(odp_instance_t *instance,
 		ODP_ERR("ODP runtime config init failed.\n");
 		goto init_failed;
 	}
-	stage = LIBCONFIG_INIT;
+	stage = init_stage_done(LIBCONFIG_INIT);
 
 	disable_features(&odp_global_ro, params);
 
+	if (_odp_probe_cache_init_global()) {
+		ODP_ERR("ODP probe cache init failed.\n");
+		goto init_failed;
+	}
+	stage = init_stage_done(PROBE_CACHE_INIT);
+
+	/* Timer resolution is probed in background, while other subsystems
+	 * are initialized */
+	if (_odp_timer_res_probe_start(params)) {
+		ODP_ERR("ODP timer probe start failed.\n");
+		goto init_failed;
+	}
+	stage = init_stage_done(TIMER_PROBE_INIT);
+
 	if (_odp_cpumask_init_global(params)) {
 		ODP_ERR("ODP cpumask init failed.\n");
 		goto init_failed;
 	}
-	stage = CPUMASK_INIT;
+	stage = init_stage_done(CPUMASK_INIT);
 
 	if (_odp_cpu_cycles_init_global()) {
 		ODP_ERR("ODP cpu cycle init failed.\n");
 		goto init_failed;
 	}
-	stage = CPU_CYCLES_INIT;
+	stage = init_stage_done(CPU_CYCLES_INIT);
 
 	if (_odp_time_init_global()) {
 		ODP_ERR("ODP time init failed.\n");
 		goto init_failed;
 	}
-	stage = TIME_INIT;
+	stage = init_stage_done(TIME_INIT);
 
 	if (_odp_system_info_init()) {
 		ODP_ERR("ODP system_info init failed.\n");
 		goto init_failed;
 	}
-	stage = SYSINFO_INIT;
+	stage = init_stage_done(SYSINFO_INIT);
 
 	if (_odp_ishm_init_global(params)) {
 		ODP_ERR("ODP ishm init failed.\n");
 		goto init_failed;
 	}
-	stage = ISHM_INIT;
+	stage = init_stage_done(ISHM_INIT);
 
 	if (_odp_fdserver_init_global()) {
 		ODP_ERR("ODP fdserver init failed.\n");
 		goto init_failed;
 	}
-	stage = FDSERVER_INIT;
+	stage = init_stage_done(FDSERVER_INIT);
 
 	if (global_rw_data_init()) {
 		ODP_ERR("ODP global RW data init failed.\n");
 		goto init_failed;
 	}
-	stage = GLOBAL_RW_DATA_INIT;
+	stage = init_stage_done(GLOBAL_RW_DATA_INIT);
 
 	if (_odp_hash_init_global()) {
 		ODP_ERR("ODP hash init failed.\n");
 		goto init_failed;
 	}
-	stage = HASH_INIT;
+	stage = init_stage_done(HASH_INIT);
 
 	if (_odp_thread_init_global()) {
 		ODP_ERR("ODP thread init failed.\n");
 		goto init_failed;
 	}
-	stage = THREAD_INIT;
+	stage = init_stage_done(THREAD_INIT);
+
+	if (_odp_trace_init_global()) {
+		ODP_ERR("ODP trace init failed.\n");
+		goto init_failed;
+	}
+	stage = init_stage_done(TRACE_INIT);
 
 	if (_odp_pool_init_global()) {
 		ODP_ERR("ODP pool init failed.\n");
 		goto init_failed;
 	}
-	stage = POOL_INIT;
+	stage = init_stage_done(POOL_INIT);
 
 	if (_odp_stash_init_global()) {
 		ODP_ERR("ODP stash init failed.\n");
 		goto init_failed;
 	}
-	stage = STASH_INIT;
+	stage = init_stage_done(STASH_INIT);
 
 	if (_odp_queue_init_global()) {
 		ODP_ERR("ODP queue init failed.\n");
 		goto init_failed;
 	}
-	stage = QUEUE_INIT;
+	stage = init_stage_done(QUEUE_INIT);
 
 	if (_odp_schedule_init_global()) {
 		ODP_ERR("ODP schedule init failed.\n");
 		goto init_failed;
 	}
-	stage = SCHED_INIT;
+	stage = init_stage_done(SCHED_INIT);
 
 	if (_odp_pktio_init_global()) {
 		ODP_ERR("ODP packet io init failed.\n");
 		goto init_failed;
 	}
-	stage = PKTIO_INIT;
+	stage = init_stage_done(PKTIO_INIT);
 
 	if (_odp_timer_init_global(params)) {
 		ODP_ERR("ODP timer init failed.\n");
 		goto init_failed;
 	}
-	stage = TIMER_INIT;
+	stage = init_stage_done(TIMER_INIT);
 
 	/* No init neeeded */
-	stage = RANDOM_INIT;
+	stage = init_stage_done(RANDOM_INIT);
 
 	if (_odp_crypto_init_global()) {
 		ODP_ERR("ODP crypto init failed.\n");
 		goto init_failed;
 	}
-	stage = CRYPTO_INIT;
+	stage = init_stage_done(CRYPTO_INIT);
 
 	if (_odp_comp_init_global()) {
 		ODP_ERR("ODP comp init failed.\n");
 		goto init_failed;
 	}
-	stage = COMP_INIT;
+	stage = init_stage_done(COMP_INIT);
 
 	if (_odp_classification_init_global()) {
 		ODP_ERR("ODP classification init failed.\n");
 		goto init_failed;
 	}
-	stage = CLASSIFICATION_INIT;
+	stage = init_stage_done(CLASSIFICATION_INIT);
 
 	if (_odp_tm_init_global()) {
 		ODP_ERR("ODP traffic manager init failed\n");
 		goto init_failed;
 	}
-	stage = TRAFFIC_MNGR_INIT;
+	stage = init_stage_done(TRAFFIC_MNGR_INIT);
 
 	if (_odp_int_name_tbl_init_global()) {
 		ODP_ERR("ODP name table init failed\n");
 		goto init_failed;
 	}
-	stage = NAME_TABLE_INIT;
+	stage = init_stage_done(NAME_TABLE_INIT);
 
 	if (_odp_ipsec_events_init_global()) {
 		ODP_ERR("ODP IPsec events init failed.\n");
 		goto init_failed;
 	}
-	stage = IPSEC_EVENTS_INIT;
+	stage = init_stage_done(IPSEC_EVENTS_INIT);
 
 	if (_odp_ipsec_sad_init_global()) {
 		ODP_ERR("ODP IPsec SAD init failed.\n");
 		goto init_failed;
 	}
-	stage = IPSEC_SAD_INIT;
+	stage = init_stage_done(IPSEC_SAD_INIT);
 
 	if (_odp_ipsec_init_global()) {
 		ODP_ERR("ODP IPsec init failed.\n");
 		goto init_failed;
 	}
-	stage = IPSEC_INIT;
+	stage = init_stage_done(IPSEC_INIT);
 
 	*instance = (odp_instance_t)odp_global_ro.main_pid;
 
+	init_prof_print();
+
 	return 0;
 
 init_failed:
@@ -530,6 +660,13 @@ static int term_local(enum init_stage stage)
 		}
 		/* Fall through */
 
+	case TRACE_INIT:
+		if (_odp_trace_term_local()) {
+			ODP_ERR("ODP trace local term failed.\n");
+			rc = -1;
+		}
+		/* Fall through */
+
 	case THREAD_INIT:
 		rc_thd = _odp_thread_term_local();
 		if (rc_thd < 0) {
@@ -576,6 +713,12 @@ int odp_init_local(odp_instance_t instance, odp_thread_type_t thr_type)
 	}
 	stage = THREAD_INIT;
 
+	if (_odp_trace_init_local()) {
+		ODP_ERR("ODP trace local init failed.\n");
+		goto init_fail;
+	}
+	stage = TRACE_INIT;
+
 	if (_odp_pktio_init_local()) {
 		ODP_ERR("ODP packet io local init failed.\n");
 		goto init_fail;
@@ -14,11 +14,13 @@
 
 #include <odp_global_data.h>
 #include <odp_init_internal.h>
+#include <odp_crypto_internal.h>
 #include <odp_debug_internal.h>
 #include <odp_packet_internal.h>
 #include <odp_ipsec_internal.h>
 #include <odp/api/plat/queue_inlines.h>
 #include <odp_classification_internal.h>
+#include <odp_trace_internal.h>
 
 #include <protocols/eth.h>
 #include <protocols/ip.h>
@@ -247,6 +249,10 @@ static odp_ipsec_packet_result_t *ipsec_pkt_result(odp_packet_t packet)
 
 #define ipv4_hdr_len(ip) (_ODP_IPV4HDR_IHL((ip)->ver_ihl) * 4)
 
+/* Maximum number of packets processed as one burst in odp_ipsec_in() and
+ * odp_ipsec_out() */
+#define IPSEC_BURST_SIZE 32
+
 static const uint8_t ipsec_padding[255] = {
 	      0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
 	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
@@ -379,7 +385,12 @@ static int ipsec_parse_ipv6(ipsec_state_t *state, odp_packet_t pkt)
 	return 0;
 }
 
-static inline ipsec_sa_t *ipsec_get_sa(odp_ipsec_sa_t sa,
+/*
+ * Resolve the SA of an inbound packet. When 'sa_ref' is NULL, the SA is looked
+ * up and a reference to it is taken. Otherwise, the caller holds a reference
+ * to 'sa_ref', which is checked against the packet.
+ */
+static inline ipsec_sa_t *ipsec_get_sa(ipsec_sa_t *sa_ref,
 				       odp_ipsec_protocol_t proto,
 				       uint32_t spi,
 				       odp_ipsec_ip_version_t ver,
@@ -388,7 +399,7 @@ static inline ipsec_sa_t *ipsec_get_sa(odp_ipsec_sa_t sa,
 {
 	ipsec_sa_t *ipsec_sa;
 
-	if (ODP_IPSEC_SA_INVALID == sa) {
+	if (NULL == sa_ref) {
 		ipsec_sa_lookup_t lookup;
 
 		lookup.proto = proto;
@@ -402,8 +413,7 @@ static inline ipsec_sa_t *ipsec_get_sa(odp_ipsec_sa_t sa,
 			return NULL;
 		}
 	} else {
-		ipsec_sa = _odp_ipsec_sa_use(sa);
-		ODP_ASSERT(NULL != ipsec_sa);
+		ipsec_sa = sa_ref;
 		if (ipsec_sa->proto != proto ||
 		    ipsec_sa->spi != spi) {
 			status->error.proto = 1;
@@ -439,7 +449,7 @@ static int ipsec_in_iv(odp_packet_t pkt,
 static int ipsec_in_esp(odp_packet_t *pkt,
 			ipsec_state_t *state,
 			ipsec_sa_t **_ipsec_sa,
-			odp_ipsec_sa_t sa,
+			ipsec_sa_t *sa_ref,
 			odp_crypto_packet_op_param_t *param,
 			odp_ipsec_op_status_t *status)
 {
@@ -475,7 +485,7 @@ static int ipsec_in_esp(odp_packet_t *pkt,
 		return -1;
 	}
 
-	ipsec_sa = ipsec_get_sa(sa, ODP_IPSEC_ESP,
+	ipsec_sa = ipsec_get_sa(sa_ref, ODP_IPSEC_ESP,
 				odp_be_to_cpu_32(esp.spi),
 				state->is_ipv4 ? ODP_IPSEC_IPV4 :
 						ODP_IPSEC_IPV6,
@@ -562,7 +572,7 @@ static int ipsec_in_esp_post(odp_packet_t pkt,
 static int ipsec_in_ah(odp_packet_t *pkt,
 		       ipsec_state_t *state,
 		       ipsec_sa_t **_ipsec_sa,
-		       odp_ipsec_sa_t sa,
+		       ipsec_sa_t *sa_ref,
 		       odp_crypto_packet_op_param_t *param,
 		       odp_ipsec_op_status_t *status)
 {
@@ -578,7 +588,7 @@ static int ipsec_in_ah(odp_packet_t *pkt,
 		return -1;
 	}
 
-	ipsec_sa = ipsec_get_sa(sa, ODP_IPSEC_AH,
+	ipsec_sa = ipsec_get_sa(sa_ref, ODP_IPSEC_AH,
 				odp_be_to_cpu_32(ah.spi),
 				state->is_ipv4 ? ODP_IPSEC_IPV4 :
 						ODP_IPSEC_IPV6,
@@ -700,75 +710,87 @@ ipsec_sa_err_stats_update(ipsec_sa_t *sa, odp_ipsec_op_status_t *status)
 		odp_atomic_inc_u64(&sa->stats.hard_exp_pkts_err);
 }
 
-static ipsec_sa_t *ipsec_in_single(odp_packet_t pkt,
-				   odp_ipsec_sa_t sa,
-				   odp_packet_t *pkt_out,
-				   odp_ipsec_op_status_t *status)
+/*
+ * Parse an inbound packet, resolve its SA and fill in crypto operation
+ * parameters. Returns the SA, or NULL when the SA could not be resolved.
+ * Status is set on failure.
+ */
+static ipsec_sa_t *ipsec_in_prepare(odp_packet_t *pkt,
+				    ipsec_sa_t *sa_ref,
+				    ipsec_state_t *state,
+				    odp_crypto_packet_op_param_t *param,
+				    odp_ipsec_op_status_t *status)
 {
-	ipsec_state_t state;
 	ipsec_sa_t *ipsec_sa = NULL;
-	odp_crypto_packet_op_param_t param;
 	int rc;
-	odp_crypto_packet_result_t crypto; /**< Crypto operation result */
 
-	state.ip_offset = odp_packet_l3_offset(pkt);
-	ODP_ASSERT(ODP_PACKET_OFFSET_INVALID != state.ip_offset);
+	state->ip_offset = odp_packet_l3_offset(*pkt);
+	ODP_ASSERT(ODP_PACKET_OFFSET_INVALID != state->ip_offset);
 
-	state.ip = odp_packet_l3_ptr(pkt, NULL);
-	ODP_ASSERT(NULL != state.ip);
+	state->ip = odp_packet_l3_ptr(*pkt, NULL);
+	ODP_ASSERT(NULL != state->ip);
 
 	/* Initialize parameters block */
-	memset(&param, 0, sizeof(param));
+	memset(param, 0, sizeof(*param));
 
 	/*
 	 * FIXME: maybe use packet flag as below ???
 	 * This adds requirement that input packets contain not only valid
 	 * l3/l4 offsets, but also valid packet flags
-	 * state.is_ipv4 = odp_packet_has_ipv4(pkt);
+	 * state->is_ipv4 = odp_packet_has_ipv4(pkt);
 	 */
-	state.is_ipv4 = (((uint8_t *)state.ip)[0] >> 4) == 0x4;
-	state.is_ipv6 = (((uint8_t *)state.ip)[0] >> 4) == 0x6;
-	if (state.is_ipv4)
-		rc = ipsec_parse_ipv4(&state, pkt);
-	else if (state.is_ipv6)
-		rc = ipsec_parse_ipv6(&state, pkt);
+	state->is_ipv4 = (((uint8_t *)state->ip)[0] >> 4) == 0x4;
+	state->is_ipv6 = (((uint8_t *)state->ip)[0] >> 4) == 0x6;
+	if (state->is_ipv4)
+		rc = ipsec_parse_ipv4(state, *pkt);
+	else if (state->is_ipv6)
+		rc = ipsec_parse_ipv6(state, *pkt);
 	else
 		rc = -1;
 	if (rc < 0 ||
-	    state.ip_tot_len + state.ip_offset > odp_packet_len(pkt)) {
+	    state->ip_tot_len + state->ip_offset > odp_packet_len(*pkt)) {
 		status->error.alg = 1;
-		goto exit;
+		return NULL;
 	}
 
 	/* Check IP header for IPSec protocols and look it up */
-	if (_ODP_IPPROTO_ESP == state.ip_next_hdr ||
-	    _ODP_IPPROTO_UDP == state.ip_next_hdr) {
-		rc = ipsec_in_esp(&pkt, &state, &ipsec_sa, sa, &param, status);
-	} else if (_ODP_IPPROTO_AH == state.ip_next_hdr) {
-		rc = ipsec_in_ah(&pkt, &state, &ipsec_sa, sa, &param, status);
+	if (_ODP_IPPROTO_ESP == state->ip_next_hdr ||
+	    _ODP_IPPROTO_UDP == state->ip_next_hdr) {
+		rc = ipsec_in_esp(pkt, state, &ipsec_sa, sa_ref, param, status);
+	} else if (_ODP_IPPROTO_AH == state->ip_next_hdr) {
+		rc = ipsec_in_ah(pkt, state, &ipsec_sa, sa_ref, param, status);
 	} else {
 		status->error.proto = 1;
-		goto exit;
+		return NULL;
 	}
 	if (rc < 0)
-		goto exit;
+		return ipsec_sa;
 
 	if (_odp_ipsec_sa_replay_precheck(ipsec_sa,
-					  state.in.seq_no,
+					  state->in.seq_no,
 					  status) < 0)
-		goto exit;
+		return ipsec_sa;
 
 	if (_odp_ipsec_sa_stats_precheck(ipsec_sa, status) < 0)
-		goto exit;
+		return ipsec_sa;
 
-	param.session = ipsec_sa->session;
+	param->session = ipsec_sa->session;
 
-	rc = odp_crypto_op(&pkt, &pkt, &param, 1);
-	if (rc < 0) {
-		ODP_DBG("Crypto failed\n");
-		status->error.alg = 1;
-		goto exit;
-	}
+	return ipsec_sa;
+}
+
+/*
+ * Check crypto result of an inbound packet, update SA state and remove IPsec
+ * headers. Status is set on failure.
+ */
+static void ipsec_in_finish(odp_packet_t *pkt_out,
+			    ipsec_sa_t *ipsec_sa,
+			    ipsec_state_t *state,
+			    odp_ipsec_op_status_t *status)
+{
+	odp_packet_t pkt = *pkt_out;
+	odp_crypto_packet_result_t crypto; /**< Crypto operation result */
+	int rc;
 
 	rc = odp_crypto_result(&crypto, pkt);
 	if (rc < 0) {
@@ -790,21 +812,21 @@ static ipsec_sa_t *ipsec_in_single(odp_packet_t pkt,
 	}
 
 	if (_odp_ipsec_sa_replay_update(ipsec_sa,
-					state.in.seq_no,
+					state->in.seq_no,
 					status) < 0)
 		goto exit;
 
 	if (_odp_ipsec_sa_lifetime_update(ipsec_sa,
-					  state.stats_length,
+					  state->stats_length,
 					  status) < 0)
 		goto post_lifetime_err_cnt_update;
 
-	state.ip = odp_packet_l3_ptr(pkt, NULL);
+	state->ip = odp_packet_l3_ptr(pkt, NULL);
 
 	if (ODP_IPSEC_ESP == ipsec_sa->proto)
-		rc = ipsec_in_esp_post(pkt, &state);
+		rc = ipsec_in_esp_post(pkt, state);
 	else if (ODP_IPSEC_AH == ipsec_sa->proto)
-		rc = ipsec_in_ah_post(pkt, &state);
+		rc = ipsec_in_ah_post(pkt, state);
 	else
 		rc = -1;
 	if (rc < 0) {
@@ -812,90 +834,90 @@ static ipsec_sa_t *ipsec_in_single(odp_packet_t pkt,
 		goto post_lifetime_err_cnt_update;
 	}
 
-	if (odp_packet_trunc_tail(&pkt, state.in.trl_len, NULL, NULL) < 0) {
+	if (odp_packet_trunc_tail(&pkt, state->in.trl_len, NULL, NULL) < 0) {
 		status->error.alg = 1;
 		goto post_lifetime_err_cnt_update;
 	}
-	state.ip_tot_len -= state.in.trl_len;
+	state->ip_tot_len -= state->in.trl_len;
 
 	if (ODP_IPSEC_MODE_TUNNEL == ipsec_sa->mode) {
 		/* We have a tunneled IPv4 packet, strip outer and IPsec
 		 * headers */
-		odp_packet_move_data(pkt, state.ip_hdr_len + state.in.hdr_len,
+		odp_packet_move_data(pkt, state->ip_hdr_len + state->in.hdr_len,
 				     0,
-				     state.ip_offset);
-		if (odp_packet_trunc_head(&pkt, state.ip_hdr_len +
-					  state.in.hdr_len,
+				     state->ip_offset);
+		if (odp_packet_trunc_head(&pkt, state->ip_hdr_len +
+					  state->in.hdr_len,
 					  NULL, NULL) < 0) {
 			status->error.alg = 1;
 			goto post_lifetime_err_cnt_update;
 		}
-		state.ip_tot_len -= state.ip_hdr_len + state.in.hdr_len;
-		if (_ODP_IPPROTO_IPIP == state.ip_next_hdr) {
-			state.is_ipv4 = 1;
-			state.is_ipv6 = 0;
-		} else if (_ODP_IPPROTO_IPV6 == state.ip_next_hdr) {
-			state.is_ipv4 = 0;
-			state.is_ipv6 = 1;
-		} else if (_ODP_IPPROTO_NO_NEXT == state.ip_next_hdr) {
-			state.is_ipv4 = 0;
-			state.is_ipv6 = 0;
+		state->ip_tot_len -= state->ip_hdr_len + state->in.hdr_len;
+		if (_ODP_IPPROTO_IPIP == state->ip_next_hdr) {
+			state->is_ipv4 = 1;
+			state->is_ipv6 = 0;
+		} else if (_ODP_IPPROTO_IPV6 == state->ip_next_hdr) {
+			state->is_ipv4 = 0;
+			state->is_ipv6 = 1;
+		} else if (_ODP_IPPROTO_NO_NEXT == state->ip_next_hdr) {
+			state->is_ipv4 = 0;
+			state->is_ipv6 = 0;
 		} else {
 			status->error.proto = 1;
 			goto post_lifetime_err_cnt_update;
 		}
 	} else {
-		odp_packet_move_data(pkt, state.in.hdr_len, 0,
-				     state.ip_offset + state.ip_hdr_len);
-		if (odp_packet_trunc_head(&pkt, state.in.hdr_len,
+		odp_packet_move_data(pkt, state->in.hdr_len, 0,
+				     state->ip_offset + state->ip_hdr_len);
+		if (odp_packet_trunc_head(&pkt, state->in.hdr_len,
 					  NULL, NULL) < 0) {
 			status->error.alg = 1;
 			goto post_lifetime_err_cnt_update;
 		}
-		state.ip_tot_len -= state.in.hdr_len;
+		state->ip_tot_len -= state->in.hdr_len;
 	}
 
 	/* Finalize the IPv4 header */
-	if (state.is_ipv4 && odp_packet_len(pkt) > _ODP_IPV4HDR_LEN) {
+	if (state->is_ipv4 && odp_packet_len(pkt) > _ODP_IPV4HDR_LEN) {
 		_odp_ipv4hdr_t *ipv4hdr = odp_packet_l3_ptr(pkt, NULL);
 
 		if (ODP_IPSEC_MODE_TRANSPORT == ipsec_sa->mode)
-			ipv4hdr->tot_len = odp_cpu_to_be_16(state.ip_tot_len);
+			ipv4hdr->tot_len = odp_cpu_to_be_16(state->ip_tot_len);
 		else
 			ipv4hdr->ttl -= ipsec_sa->dec_ttl;
 		_odp_packet_ipv4_chksum_insert(pkt);
-	} else if (state.is_ipv6 && odp_packet_len(pkt) > _ODP_IPV6HDR_LEN) {
+	} else if (state->is_ipv6 && odp_packet_len(pkt) > _ODP_IPV6HDR_LEN) {
 		_odp_ipv6hdr_t *ipv6hdr = odp_packet_l3_ptr(pkt, NULL);
 
 		if (ODP_IPSEC_MODE_TRANSPORT == ipsec_sa->mode)
 			ipv6hdr->payload_len =
-				odp_cpu_to_be_16(state.ip_tot_len -
+				odp_cpu_to_be_16(state->ip_tot_len -
 						  _ODP_IPV6HDR_LEN);
 		else
 			ipv6hdr->hop_limit -= ipsec_sa->dec_ttl;
-	} else if (state.ip_next_hdr != _ODP_IPPROTO_NO_NEXT) {
+	} else if (state->ip_next_hdr != _ODP_IPPROTO_NO_NEXT) {
 		status->error.proto = 1;
 		goto post_lifetime_err_cnt_update;
 	}
 
-	if (_ODP_IPPROTO_NO_NEXT == state.ip_next_hdr &&
+	if (_ODP_IPPROTO_NO_NEXT == state->ip_next_hdr &&
 	    ODP_IPSEC_MODE_TUNNEL == ipsec_sa->mode) {
 		odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
 
 		packet_parse_reset(pkt_hdr, 0);
-		pkt_hdr->p.l3_offset = state.ip_offset;
+		pkt_hdr->p.l3_offset = state->ip_offset;
 	} else {
 		odp_packet_parse_param_t parse_param;
 
-		parse_param.proto = state.is_ipv4 ? ODP_PROTO_IPV4 :
-			state.is_ipv6 ? ODP_PROTO_IPV6 :
+		parse_param.proto = state->is_ipv4 ? ODP_PROTO_IPV4 :
+			state->is_ipv6 ? ODP_PROTO_IPV6 :
 			ODP_PROTO_NONE;
 		parse_param.last_layer = ipsec_config->inbound.parse_level;
 		parse_param.chksums = ipsec_config->inbound.chksums;
 
 		/* We do not care about return code here.
 		 * Parsing error should not result in IPsec error. */
-		odp_packet_parse(pkt, state.ip_offset, &parse_param);
+		odp_packet_parse(pkt, state->ip_offset, &parse_param);
 	}
 
 	goto exit;
@@ -906,6 +928,36 @@ post_lifetime_err_cnt_update:
 
 exit:
 	*pkt_out = pkt;
+}
+
+static ipsec_sa_t *ipsec_in_single(odp_packet_t pkt,
+				   odp_ipsec_sa_t sa,
+				   odp_packet_t *pkt_out,
+				   odp_ipsec_op_status_t *status)
+{
+	ipsec_state_t state;
+	ipsec_sa_t *ipsec_sa;
+	ipsec_sa_t *sa_ref = NULL;
+	odp_crypto_packet_op_param_t param;
+
+	if (ODP_IPSEC_SA_INVALID != sa) {
+		sa_ref = _odp_ipsec_sa_use(sa);
+		ODP_ASSERT(NULL != sa_ref);
+	}
+
+	ipsec_sa = ipsec_in_prepare(&pkt, sa_ref, &state, &param, status);
+
+	if (!status->error.all) {
+		_odp_crypto_op_session(param.session, &pkt, &param, 1);
+		ipsec_in_finish(&pkt, ipsec_sa, &state, status);
+	}
+
+	/* Caller releases the returned SA. Release the reference here when
+	 * processing failed before the SA was resolved. */
+	if (NULL == ipsec_sa && NULL != sa_ref)
+		_odp_ipsec_sa_unuse(sa_ref);
+
+	*pkt_out = pkt;
 
 	if (ipsec_config->stats_en)
 		ipsec_sa_err_stats_update(ipsec_sa, status);
@@ -913,10 +965,173 @@ exit:
 	return ipsec_sa;
 }
 
+/*
+ * Issue crypto operations of a burst. Packets are grouped per session and
+ * each group is processed with one backend call, which keeps session state
+ * hot in cache. Packets with an error status are skipped.
+ */
+static void ipsec_crypto_burst(odp_packet_t pkt[],
+			       const odp_crypto_packet_op_param_t param[],
+			       const odp_ipsec_op_status_t status[],
+			       int num)
+{
+	odp_packet_t grp_pkt[num];
+	odp_crypto_packet_op_param_t grp_param[num];
+	uint8_t done[num];
+	odp_crypto_session_t session;
+	int i, j, n;
+
+	memset(done, 0, sizeof(done));
+
+	for (i = 0; i < num; i++) {
+		if (done[i] || status[i].error.all)
+			continue;
+
+		session = param[i].session;
+		n = 0;
+
+		for (j = i; j < num; j++) {
+			if (done[j] || status[j].error.all ||
+			    param[j].session != session)
+				continue;
+
+			grp_pkt[n] = pkt[j];
+			grp_param[n] = param[j];
+			done[j] = 1;
+			n++;
+		}
+
+		/* Operations are done in place, packet handles do not change */
+		_odp_crypto_op_session(session, grp_pkt, grp_param, n);
+	}
+}
+
+/*
+ * Process a burst of inbound packets
+ *
+ * SA references are taken once per SA of the burst. Packets are prepared one
+ * by one, crypto operations are issued per session and packets are finished
+ * in input order, which keeps anti-replay window updates in order.
+ */
+static void ipsec_in_burst(const odp_packet_t pkt_in[], odp_packet_t pkt_out[],
+			   int num, const odp_ipsec_in_param_t *param,
+			   unsigned sa_idx)
+{
+	ipsec_state_t state[num];
+	odp_crypto_packet_op_param_t crypto_param[num];
+	odp_ipsec_op_status_t status[num];
+	ipsec_sa_t *ipsec_sa[num];
+	ipsec_sa_t *sa_ref[num];
+	ipsec_sa_t *ref[num];
+	unsigned sa_inc = (param->num_sa > 1) ? 1 : 0;
+	int num_ref = 0;
+	int i, j;
+
+	memset(status, 0, sizeof(status));
+
+	for (i = 0; i < num; i++) {
+		odp_ipsec_sa_t sa;
+
+		pkt_out[i] = pkt_in[i];
+		sa_ref[i] = NULL;
+
+		if (0 == param->num_sa)
+			continue;
+
+		sa = param->sa[sa_idx + i * sa_inc];
+		ODP_ASSERT(ODP_IPSEC_SA_INVALID != sa);
+
+		for (j = num_ref - 1; j >= 0; j--) {
+			if (ref[j]->ipsec_sa_hdl == sa) {
+				sa_ref[i] = ref[j];
+				break;
+			}
+		}
+
+		if (NULL == sa_ref[i]) {
+			sa_ref[i] = _odp_ipsec_sa_use(sa);
+			ODP_ASSERT(NULL != sa_ref[i]);
+			ref[num_ref++] = sa_ref[i];
+		}
+	}
+
+	for (i = 0; i < num; i++)
+		ipsec_sa[i] = ipsec_in_prepare(&pkt_out[i], sa_ref[i], &state[i],
+					       &crypto_param[i], &status[i]);
+
+	ipsec_crypto_burst(pkt_out, crypto_param, status, num);
+
+	for (i = 0; i < num; i++) {
+		odp_packet_t pkt;
+		odp_ipsec_packet_result_t *result;
+
+		if (!status[i].error.all)
+			ipsec_in_finish(&pkt_out[i], ipsec_sa[i], &state[i],
+					&status[i]);
+
+		if (ipsec_config->stats_en)
+			ipsec_sa_err_stats_update(ipsec_sa[i], &status[i]);
+
+		pkt = pkt_out[i];
+		packet_subtype_set(pkt, ODP_EVENT_PACKET_IPSEC);
+		result = ipsec_pkt_result(pkt);
+		memset(result, 0, sizeof(*result));
+		result->status = status[i];
+		if (NULL != ipsec_sa[i])
+			result->sa = ipsec_sa[i]->ipsec_sa_hdl;
+		else
+			result->sa = ODP_IPSEC_SA_INVALID;
+	}
+
+	/* Last thing */
+	if (0 == param->num_sa) {
+		for (i = 0; i < num; i++)
+			if (NULL != ipsec_sa[i])
+				_odp_ipsec_sa_unuse(ipsec_sa[i]);
+	} else {
+		for (i = 0; i < num_ref; i++)
+			_odp_ipsec_sa_unuse(ref[i]);
+	}
+}
+
+/* Block of outbound sequence numbers reserved by a thread */
+typedef struct {
+	uint64_t next;
+	uint64_t end;
+} ipsec_seq_block_t;
+
+/* Reserve 'num' sequence numbers with one atomic operation */
+static inline void ipsec_seq_reserve(ipsec_sa_t *ipsec_sa,
+				     ipsec_seq_block_t *seq, uint32_t num)
+{
+	seq->next = odp_atomic_fetch_add_u64(&ipsec_sa->hot.out.seq, num);
+	seq->end  = seq->next + num;
+}
+
+/*
+ * Give back unused sequence numbers of a block. This succeeds only when no
+ * other thread has reserved numbers after the block. Otherwise, the numbers
+ * are skipped, which is allowed for outbound SAs.
+ */
+static inline void ipsec_seq_release(ipsec_sa_t *ipsec_sa,
+				     ipsec_seq_block_t *seq)
+{
+	uint64_t end = seq->end;
+
+	if (seq->next == end)
+		return;
+
+	odp_atomic_cas_u64(&ipsec_sa->hot.out.seq, &end, seq->next);
+	seq->end = seq->next;
+}
+
 /* Generate sequence number */
 static inline
-uint64_t ipsec_seq_no(ipsec_sa_t *ipsec_sa)
+uint64_t ipsec_seq_no(ipsec_sa_t *ipsec_sa, ipsec_seq_block_t *seq)
 {
+	if (odp_likely(seq->next < seq->end))
+		return seq->next++;
+
 	return odp_atomic_fetch_add_u64(&ipsec_sa->hot.out.seq, 1);
 }
 
@@ -1156,7 +1371,8 @@ static int ipsec_out_esp(odp_packet_t *pkt,
 			 odp_crypto_packet_op_param_t *param,
 			 odp_ipsec_op_status_t *status,
 			 uint32_t mtu,
-			 const odp_ipsec_out_opt_t *opt)
+			 const odp_ipsec_out_opt_t *opt,
+			 ipsec_seq_block_t *seq)
 {
 	_odp_esphdr_t esp;
 	_odp_esptrl_t esptrl;
@@ -1201,7 +1417,7 @@ static int ipsec_out_esp(odp_packet_t *pkt,
 		return -1;
 	}
 
-	seq_no = ipsec_seq_no(ipsec_sa);
+	seq_no = ipsec_seq_no(ipsec_sa, seq);
 
 	if (ipsec_out_iv(state, ipsec_sa, seq_no) < 0) {
 		status->error.alg = 1;
@@ -1328,7 +1544,8 @@ static int ipsec_out_ah(odp_packet_t *pkt,
 			ipsec_sa_t *ipsec_sa,
 			odp_crypto_packet_op_param_t *param,
 			odp_ipsec_op_status_t *status,
-			uint32_t mtu)
+			uint32_t mtu,
+			ipsec_seq_block_t *seq)
 {
 	_odp_ahhdr_t ah;
 	unsigned hdr_len = _ODP_AHHDR_LEN + ipsec_sa->esp_iv_len +
@@ -1342,7 +1559,7 @@ static int ipsec_out_ah(odp_packet_t *pkt,
 		return -1;
 	}
 
-	seq_no = ipsec_seq_no(ipsec_sa);
+	seq_no = ipsec_seq_no(ipsec_sa, seq);
 
 	memset(&ah, 0, sizeof(ah));
 	ah.spi = odp_cpu_to_be_32(ipsec_sa->spi);
@@ -1482,49 +1699,42 @@ static void ipsec_out_checksums(odp_packet_t pkt,
 		_odp_packet_sctp_chksum_insert(pkt);
 }
 
-static ipsec_sa_t *ipsec_out_single(odp_packet_t pkt,
-				    odp_ipsec_sa_t sa,
-				    odp_packet_t *pkt_out,
-				    const odp_ipsec_out_opt_t *opt,
-				    odp_ipsec_op_status_t *status)
+/*
+ * Add IPsec headers to an outbound packet and fill in crypto operation
+ * parameters. Sequence numbers are taken from 'seq' when it has numbers left.
+ * Returns 0 on success. Status is set on failure.
+ */
+static int ipsec_out_prepare(odp_packet_t *pkt,
+			     ipsec_sa_t *ipsec_sa,
+			     const odp_ipsec_out_opt_t *opt,
+			     ipsec_seq_block_t *seq,
+			     ipsec_state_t *state,
+			     odp_crypto_packet_op_param_t *param,
+			     odp_ipsec_op_status_t *status)
 {
-	ipsec_state_t state;
-	ipsec_sa_t *ipsec_sa;
-	odp_crypto_packet_op_param_t param;
-	int rc;
-	odp_crypto_packet_result_t crypto; /**< Crypto operation result */
 	odp_ipsec_frag_mode_t frag_mode;
 	uint32_t mtu;
-
-	/*
-	 * No need to do _odp_ipsec_sa_use() here since an ODP application
-	 * is not allowed to do call IPsec output before SA creation has
-	 * completed nor call odp_ipsec_sa_disable() before IPsec output
-	 * has completed. IOW, the needed sychronization between threads
-	 * is done by the application.
-	 */
-	ipsec_sa = _odp_ipsec_sa_entry_from_hdl(sa);
-	ODP_ASSERT(NULL != ipsec_sa);
+	int rc;
 
 	if (opt->flag.tfc_dummy) {
-		odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
+		odp_packet_hdr_t *pkt_hdr = packet_hdr(*pkt);
 
 		ODP_ASSERT(ODP_IPSEC_MODE_TUNNEL == ipsec_sa->mode);
 		pkt_hdr->p.l2_offset = ODP_PACKET_OFFSET_INVALID;
 		pkt_hdr->p.l3_offset = 0;
-		state.ip_offset = 0;
-		state.ip = NULL;
-		state.is_ipv4 = 0;
-		state.is_ipv6 = 0;
+		state->ip_offset = 0;
+		state->ip = NULL;
+		state->is_ipv4 = 0;
+		state->is_ipv6 = 0;
 	} else {
-		state.ip_offset = odp_packet_l3_offset(pkt);
-		ODP_ASSERT(ODP_PACKET_OFFSET_INVALID != state.ip_offset);
+		state->ip_offset = odp_packet_l3_offset(*pkt);
+		ODP_ASSERT(ODP_PACKET_OFFSET_INVALID != state->ip_offset);
 
-		state.ip = odp_packet_l3_ptr(pkt, NULL);
-		ODP_ASSERT(NULL != state.ip);
+		state->ip = odp_packet_l3_ptr(*pkt, NULL);
+		ODP_ASSERT(NULL != state->ip);
 
-		state.is_ipv4 = (((uint8_t *)state.ip)[0] >> 4) == 0x4;
-		state.is_ipv6 = (((uint8_t *)state.ip)[0] >> 4) == 0x6;
+		state->is_ipv4 = (((uint8_t *)state->ip)[0] >> 4) == 0x4;
+		state->is_ipv6 = (((uint8_t *)state->ip)[0] >> 4) == 0x6;
 	}
 
 	frag_mode = opt->flag.frag_mode ? opt->frag_mode :
@@ -1535,32 +1745,32 @@ static ipsec_sa_t *ipsec_out_single(odp_packet_t pkt,
 		mtu = UINT32_MAX;
 
 	/* Initialize parameters block */
-	memset(&param, 0, sizeof(param));
+	memset(param, 0, sizeof(*param));
 
 	if (ODP_IPSEC_MODE_TRANSPORT == ipsec_sa->mode) {
-		if (state.is_ipv4)
-			rc = ipsec_parse_ipv4(&state, pkt);
-		else if (state.is_ipv6)
-			rc = ipsec_parse_ipv6(&state, pkt);
+		if (state->is_ipv4)
+			rc = ipsec_parse_ipv4(state, *pkt);
+		else if (state->is_ipv6)
+			rc = ipsec_parse_ipv6(state, *pkt);
 		else
 			rc = -1;
 
 		if (rc == 0) {
-			if (state.ip_tot_len + state.ip_offset !=
-			    odp_packet_len(pkt))
+			if (state->ip_tot_len + state->ip_offset !=
+			    odp_packet_len(*pkt))
 				rc = -1;
 			else
-				ipsec_out_checksums(pkt, &state);
+				ipsec_out_checksums(*pkt, state);
 		}
 	} else {
-		if (state.is_ipv4) {
-			rc = ipsec_out_tunnel_parse_ipv4(&state, ipsec_sa);
-		} else if (state.is_ipv6) {
-			rc = ipsec_out_tunnel_parse_ipv6(&state, ipsec_sa);
+		if (state->is_ipv4) {
+			rc = ipsec_out_tunnel_parse_ipv4(state, ipsec_sa);
+		} else if (state->is_ipv6) {
+			rc = ipsec_out_tunnel_parse_ipv6(state, ipsec_sa);
 		} else if (opt->flag.tfc_dummy) {
-			state.out_tunnel.ip_tos = 0;
-			state.out_tunnel.ip_df = 0;
-			state.out_tunnel.ip_flabel = 0;
+			state->out_tunnel.ip_tos = 0;
+			state->out_tunnel.ip_df = 0;
+			state->out_tunnel.ip_flabel = 0;
 			rc = 0;
 		} else {
 			rc = -1;
@@ -1568,46 +1778,103 @@ static ipsec_sa_t *ipsec_out_single(odp_packet_t pkt,
 
 		if (rc < 0) {
 			status->error.alg = 1;
-			goto exit;
+			return -1;
 		}
 
-		ipsec_out_checksums(pkt, &state);
+		ipsec_out_checksums(*pkt, state);
 
 		if (ipsec_sa->tun_ipv4)
-			rc = ipsec_out_tunnel_ipv4(&pkt, &state, ipsec_sa,
+			rc = ipsec_out_tunnel_ipv4(pkt, state, ipsec_sa,
 						   opt->flag.ip_param ?
 						   &opt->ipv4 :
 						   &ipsec_sa->out.tun_ipv4.param);
 		else
-			rc = ipsec_out_tunnel_ipv6(&pkt, &state, ipsec_sa,
+			rc = ipsec_out_tunnel_ipv6(pkt, state, ipsec_sa,
 						   opt->flag.ip_param ?
 						   &opt->ipv6 :
 						   &ipsec_sa->out.tun_ipv6.param);
 	}
 	if (rc < 0) {
 		status->error.alg = 1;
-		goto exit;
+		return -1;
 	}
 
 	if (ODP_IPSEC_ESP == ipsec_sa->proto) {
-		rc = ipsec_out_esp(&pkt, &state, ipsec_sa, &param, status, mtu,
-				   opt);
+		rc = ipsec_out_esp(pkt, state, ipsec_sa, param, status, mtu,
+				   opt, seq);
 	} else if (ODP_IPSEC_AH == ipsec_sa->proto) {
-		rc = ipsec_out_ah(&pkt, &state, ipsec_sa, &param, status, mtu);
+		rc = ipsec_out_ah(pkt, state, ipsec_sa, param, status, mtu,
+				  seq);
 	} else {
 		status->error.alg = 1;
-		goto exit;
+		return -1;
 	}
 	if (rc < 0)
-		goto exit;
+		return -1;
 
 	/* No need to run precheck here, we know that packet is authentic */
 	if (_odp_ipsec_sa_lifetime_update(ipsec_sa,
-					  state.stats_length,
-					  status) < 0)
-		goto post_lifetime_err_cnt_update;
+					  state->stats_length,
+					  status) < 0) {
+		if (ipsec_config->stats_en)
+			odp_atomic_inc_u64(&ipsec_sa->stats.post_lifetime_err_pkts);
+		return -1;
+	}
+
+	param->session = ipsec_sa->session;
+
+	return 0;
+}
+
+/*
+ * Check crypto result of an outbound packet and finalize the IP header.
+ * Status is set on failure.
+ */
+static void ipsec_out_finish(odp_packet_t pkt,
+			     ipsec_sa_t *ipsec_sa,
+			     ipsec_state_t *state,
+			     odp_ipsec_op_status_t *status)
+{
+	odp_crypto_packet_result_t crypto; /**< Crypto operation result */
+	int rc;
+
+	rc = odp_crypto_result(&crypto, pkt);
+	if (rc < 0 || !crypto.ok) {
+		ODP_DBG("Crypto failed\n");
+		status->error.alg = 1;
+
+		if (ipsec_config->stats_en)
+			odp_atomic_inc_u64(&ipsec_sa->stats.post_lifetime_err_pkts);
+		return;
+	}
+
+	/* Finalize the IP header */
+	if (ODP_IPSEC_ESP == ipsec_sa->proto)
+		ipsec_out_esp_post(state, pkt);
+	else if (ODP_IPSEC_AH == ipsec_sa->proto)
+		ipsec_out_ah_post(state, pkt);
+}
+
+static ipsec_sa_t *ipsec_out_single(odp_packet_t pkt,
+				    odp_ipsec_sa_t sa,
+				    odp_packet_t *pkt_out,
+				    const odp_ipsec_out_opt_t *opt,
+				    odp_ipsec_op_status_t *status)
+{
+	ipsec_state_t state;
+	ipsec_sa_t *ipsec_sa;
+	odp_crypto_packet_op_param_t param;
+	ipsec_seq_block_t seq = { .next = 0, .end = 0 };
 
-	param.session = ipsec_sa->session;
+	/*
+	 * No need to do _odp_ipsec_sa_use() here since an ODP application
+	 * is not allowed to do call IPsec output before SA creation has
+	 * completed nor call odp_ipsec_sa_disable() before IPsec output
+	 * has completed. IOW, the needed sychronization between threads
+	 * is done by the application.
+	 */
+	ipsec_sa = _odp_ipsec_sa_entry_from_hdl(sa);
+	ODP_ASSERT(NULL != ipsec_sa);
 
 	/*
 	 * NOTE: Do not change to an asynchronous design without thinking
@@ -1621,38 +1888,12 @@ static ipsec_sa_t *ipsec_out_single(odp_packet_t pkt,
 	 * the SA before this output routine returns (and all its side
 	 * effects are visible to the disabling thread).
 	 */
-	rc = odp_crypto_op(&pkt, &pkt, &param, 1);
-	if (rc < 0) {
-		ODP_DBG("Crypto failed\n");
-		status->error.alg = 1;
-		goto post_lifetime_err_cnt_update;
+	if (ipsec_out_prepare(&pkt, ipsec_sa, opt, &seq, &state, &param,
+			      status) == 0) {
+		_odp_crypto_op_session(param.session, &pkt, &param, 1);
+		ipsec_out_finish(pkt, ipsec_sa, &state, status);
 	}
 
-	rc = odp_crypto_result(&crypto, pkt);
-	if (rc < 0) {
-		ODP_DBG("Crypto failed\n");
-		status->error.alg = 1;
-		goto post_lifetime_err_cnt_update;
-	}
-
-	if (!crypto.ok) {
-		status->error.alg = 1;
-		goto post_lifetime_err_cnt_update;
-	}
-
-	/* Finalize the IP header */
-	if (ODP_IPSEC_ESP == ipsec_sa->proto)
-		ipsec_out_esp_post(&state, pkt);
-	else if (ODP_IPSEC_AH == ipsec_sa->proto)
-		ipsec_out_ah_post(&state, pkt);
-
-	goto exit;
-
-post_lifetime_err_cnt_update:
-	if (ipsec_config->stats_en)
-		odp_atomic_inc_u64(&ipsec_sa->stats.post_lifetime_err_pkts);
-
-exit:
 	*pkt_out = pkt;
 	return ipsec_sa;
 }
@@ -1662,107 +1903,175 @@ int odp_ipsec_in(const odp_packet_t pkt_in[], int num_in,
 		 const odp_ipsec_in_param_t *param)
 {
 	int in_pkt = 0;
-	int out_pkt = 0;
 	int max_out = *num_out;
-	unsigned sa_idx = 0;
 	unsigned sa_inc = (param->num_sa > 1) ? 1 : 0;
+	uint64_t trace_start = _odp_trace_begin();
 
-	while (in_pkt < num_in && out_pkt < max_out) {
-		odp_packet_t pkt = pkt_in[in_pkt];
-		odp_ipsec_op_status_t status;
-		odp_ipsec_sa_t sa;
-		ipsec_sa_t *ipsec_sa;
-		odp_ipsec_packet_result_t *result;
-
-		memset(&status, 0, sizeof(status));
-
-		if (0 == param->num_sa) {
-			sa = ODP_IPSEC_SA_INVALID;
-		} else {
-			sa = param->sa[sa_idx];
-			ODP_ASSERT(ODP_IPSEC_SA_INVALID != sa);
-		}
-
-		ipsec_sa = ipsec_in_single(pkt, sa, &pkt, &status);
+	if (num_in > max_out)
+		num_in = max_out;
 
-		packet_subtype_set(pkt, ODP_EVENT_PACKET_IPSEC);
-		result = ipsec_pkt_result(pkt);
-		memset(result, 0, sizeof(*result));
-		result->status = status;
-		if (NULL != ipsec_sa)
-			result->sa = ipsec_sa->ipsec_sa_hdl;
-		else
-			result->sa = ODP_IPSEC_SA_INVALID;
+	while (in_pkt < num_in) {
+		int num = num_in - in_pkt;
 
-		pkt_out[out_pkt] = pkt;
-		in_pkt++;
-		out_pkt++;
-		sa_idx += sa_inc;
+		if (num > IPSEC_BURST_SIZE)
+			num = IPSEC_BURST_SIZE;
 
-		/* Last thing */
-		if (NULL != ipsec_sa)
-			_odp_ipsec_sa_unuse(ipsec_sa);
+		ipsec_in_burst(&pkt_in[in_pkt], &pkt_out[in_pkt], num, param,
+			       in_pkt * sa_inc);
+		in_pkt += num;
 	}
 
-	*num_out = out_pkt;
+	*num_out = in_pkt;
+
+	_odp_trace_end(_ODP_TRACE_IPSEC_IN, trace_start,
+		       param->num_sa ? odp_ipsec_sa_to_u64(param->sa[0]) : 0,
+		       in_pkt);
 
 	return in_pkt;
 }
 
 static odp_ipsec_out_opt_t default_out_opt;
 
-int odp_ipsec_out(const odp_packet_t pkt_in[], int num_in,
-		  odp_packet_t pkt_out[], int *num_out,
-		  const odp_ipsec_out_param_t *param)
+/*
+ * Process a burst of outbound packets
+ *
+ * Packets are sorted by SA. For each SA, the SA is resolved once, a block of
+ * sequence numbers is reserved with one atomic operation and crypto
+ * operations of all packets are issued with one backend call. Sequence
+ * numbers of an SA follow the input order of its packets.
+ */
+static void ipsec_out_burst(const odp_packet_t pkt_in[],
+			    odp_packet_t pkt_out[], int num,
+			    const odp_ipsec_out_param_t *param,
+			    unsigned sa_idx, unsigned opt_idx)
 {
-	int in_pkt = 0;
-	int out_pkt = 0;
-	int max_out = *num_out;
-	unsigned sa_idx = 0;
-	unsigned opt_idx = 0;
+	ipsec_state_t state[num];
+	odp_crypto_packet_op_param_t crypto_param[num];
+	odp_ipsec_op_status_t status[num];
+	ipsec_sa_t *ipsec_sa[num];
+	odp_packet_t grp_pkt[num];
+	odp_crypto_packet_op_param_t grp_param[num];
+	int grp_idx[num];
+	uint8_t done[num];
 	unsigned sa_inc = (param->num_sa > 1) ? 1 : 0;
 	unsigned opt_inc = (param->num_opt > 1) ? 1 : 0;
+	int i, j, n, num_crypto;
 
-	ODP_ASSERT(param->num_sa != 0);
+	memset(status, 0, sizeof(status));
+	memset(done, 0, sizeof(done));
 
-	while (in_pkt < num_in && out_pkt < max_out) {
-		odp_packet_t pkt = pkt_in[in_pkt];
-		odp_ipsec_op_status_t status;
+	for (i = 0; i < num; i++)
+		pkt_out[i] = pkt_in[i];
+
+	for (i = 0; i < num; i++) {
 		odp_ipsec_sa_t sa;
-		ipsec_sa_t *ipsec_sa;
-		odp_ipsec_packet_result_t *result;
-		const odp_ipsec_out_opt_t *opt;
+		ipsec_sa_t *sa_entry;
+		ipsec_seq_block_t seq;
 
-		memset(&status, 0, sizeof(status));
+		if (done[i])
+			continue;
 
-		sa = param->sa[sa_idx];
+		sa = param->sa[sa_idx + i * sa_inc];
 		ODP_ASSERT(ODP_IPSEC_SA_INVALID != sa);
 
-		if (0 == param->num_opt)
-			opt = &default_out_opt;
-		else
-			opt = &param->opt[opt_idx];
+		/* See ipsec_out_single() for why no SA reference is taken */
+		sa_entry = _odp_ipsec_sa_entry_from_hdl(sa);
+		ODP_ASSERT(NULL != sa_entry);
 
-		ipsec_sa = ipsec_out_single(pkt, sa, &pkt, opt, &status);
-		ODP_ASSERT(NULL != ipsec_sa);
+		n = 0;
+		for (j = i; j < num; j++) {
+			if (done[j] || param->sa[sa_idx + j * sa_inc] != sa)
+				continue;
+
+			done[j] = 1;
+			ipsec_sa[j] = sa_entry;
+			grp_idx[n++] = j;
+		}
+
+		ipsec_seq_reserve(sa_entry, &seq, n);
+
+		num_crypto = 0;
+		for (j = 0; j < n; j++) {
+			int idx = grp_idx[j];
+			const odp_ipsec_out_opt_t *opt;
+
+			if (0 == param->num_opt)
+				opt = &default_out_opt;
+			else
+				opt = &param->opt[opt_idx + idx * opt_inc];
+
+			if (ipsec_out_prepare(&pkt_out[idx], sa_entry, opt, &seq,
+					      &state[idx], &crypto_param[idx],
+					      &status[idx]))
+				continue;
+
+			grp_pkt[num_crypto] = pkt_out[idx];
+			grp_param[num_crypto] = crypto_param[idx];
+			grp_idx[num_crypto] = idx;
+			num_crypto++;
+		}
+
+		ipsec_seq_release(sa_entry, &seq);
+
+		if (num_crypto == 0)
+			continue;
+
+		_odp_crypto_op_session(sa_entry->session, grp_pkt, grp_param,
+				       num_crypto);
+
+		for (j = 0; j < num_crypto; j++) {
+			int idx = grp_idx[j];
+
+			ipsec_out_finish(pkt_out[idx], sa_entry, &state[idx],
+					 &status[idx]);
+		}
+	}
+
+	for (i = 0; i < num; i++) {
+		odp_packet_t pkt = pkt_out[i];
+		odp_ipsec_packet_result_t *result;
 
 		packet_subtype_set(pkt, ODP_EVENT_PACKET_IPSEC);
 		result = ipsec_pkt_result(pkt);
 		memset(result, 0, sizeof(*result));
-		result->status = status;
-		result->sa = ipsec_sa->ipsec_sa_hdl;
+		result->status = status[i];
+		result->sa = ipsec_sa[i]->ipsec_sa_hdl;
 
 		if (ipsec_config->stats_en)
-			ipsec_sa_err_stats_update(ipsec_sa, &status);
+			ipsec_sa_err_stats_update(ipsec_sa[i], &status[i]);
+	}
+}
 
-		pkt_out[out_pkt] = pkt;
-		in_pkt++;
-		out_pkt++;
-		sa_idx += sa_inc;
-		opt_idx += opt_inc;
+int odp_ipsec_out(const odp_packet_t pkt_in[], int num_in,
+		  odp_packet_t pkt_out[], int *num_out,
+		  const odp_ipsec_out_param_t *param)
+{
+	int in_pkt = 0;
+	int max_out = *num_out;
+	unsigned sa_inc = (param->num_sa > 1) ? 1 : 0;
+	unsigned opt_inc = (param->num_opt > 1) ? 1 : 0;
+	uint64_t trace_start = _odp_trace_begin();
+
+	ODP_ASSERT(param->num_sa != 0);
+
+	if (num_in > max_out)
+		num_in = max_out;
+
+	while (in_pkt < num_in) {
+		int num = num_in - in_pkt;
+
+		if (num > IPSEC_BURST_SIZE)
+			num = IPSEC_BURST_SIZE;
+
+		ipsec_out_burst(&pkt_in[in_pkt], &pkt_out[in_pkt], num, param,
+				in_pkt * sa_inc, in_pkt * opt_inc);
+		in_pkt += num;
 	}
 
-	*num_out = out_pkt;
+	*num_out = in_pkt;
+
+	_odp_trace_end(_ODP_TRACE_IPSEC_OUT, trace_start,
+		       odp_ipsec_sa_to_u64(param->sa[0]), in_pkt);
 
 	return in_pkt;
 }
@@ -41,6 +41,7 @@
 #include <odp/api/align.h>
 #include <odp/api/system_info.h>
 #include <odp/api/debug.h>
+#include <odp/api/time.h>
 #include <odp_init_internal.h>
 #include <odp_errno_define.h>
 #include <odp_shm_internal.h>
@@ -184,6 +185,14 @@ typedef struct {
 	uint64_t dev_seq;	/* used when creating device names */
 	/* limit for reserving memory using huge pages */
 	uint64_t huge_page_limit;
+	/* _ODP_ISHM_POPULATE and _ODP_ISHM_LOCK flags set on all blocks */
+	uint32_t prefault_flags;
+	/* statistics of pre-faulted mappings */
+	struct {
+		uint64_t num;
+		uint64_t len;
+		uint64_t nsec;
+	} prefault;
 	uint32_t odpthread_cnt;	/* number of running ODP threads   */
 	ishm_block_t  block[ISHM_MAX_NB_BLOCKS];
 	void *single_va_start;	/* start of single VA memory */
@@ -252,6 +261,40 @@ static struct huge_page_cache *hpc;
 /* prototypes: */
 static void procsync(void);
 
+/* Huge page size used for shared memory. Zero if no huge pages available. */
+static inline uint64_t hp_size(void)
+{
+	return odp_global_ro.hugepage_info.shm_huge_page_size;
+}
+
+/* Map a block and record time spent on pre-faulting its pages */
+static void *map_prefault(int fd, uint64_t len, uint64_t offset, int flags)
+{
+	void *addr;
+	uint64_t t1 = 0;
+
+	if (flags & _ODP_ISHM_POPULATE)
+		t1 = odp_time_local_ns();
+
+	if (flags & _ODP_ISHM_SINGLE_VA)
+		addr = _odp_ishmphy_reserve_single_va(len, fd, flags);
+	else
+		addr = _odp_ishmphy_map(fd, len, offset, flags);
+
+	if (addr && (flags & _ODP_ISHM_POPULATE)) {
+		uint64_t nsec = odp_time_local_ns() - t1;
+
+		ishm_tbl->prefault.num++;
+		ishm_tbl->prefault.len  += len;
+		ishm_tbl->prefault.nsec += nsec;
+
+		ODP_DBG("Pre-faulted %" PRIu64 " kB in %" PRIu64 " usec\n",
+			len / 1024, nsec / 1000);
+	}
+
+	return addr;
+}
+
 static int hp_create_file(uint64_t len, const char *filename)
 {
 	int fd;
@@ -289,7 +332,7 @@ static int hp_create_file(uint64_t len, const char *filename)
 	}
 
 	/* commit huge page */
-	addr = _odp_ishmphy_map(fd, len, 0, 0);
+	addr = _odp_ishmphy_map(fd, len, 0, _ODP_ISHM_POPULATE);
 	if (addr == NULL) {
 		/* no more pages available */
 		close(fd);
@@ -319,13 +362,13 @@ static void hp_init(void)
 
 	ODP_DBG("Init HP cache with up to %d pages\n", count);
 
-	if (!odp_global_ro.hugepage_info.default_huge_page_dir) {
+	if (!odp_global_ro.hugepage_info.shm_huge_page_dir) {
 		ODP_ERR("No huge page dir\n");
 		return;
 	}
 
 	snprintf(dir, ISHM_FILENAME_MAXLEN, "%s/%s",
-		 odp_global_ro.hugepage_info.default_huge_page_dir,
+		 odp_global_ro.hugepage_info.shm_huge_page_dir,
 		 odp_global_ro.uid);
 
 	if (mkdir(dir, 0744) != 0) {
@@ -353,7 +396,7 @@ static void hp_init(void)
 	hpc->max_fds = count;
 	hpc->total = 0;
 	hpc->idx = -1;
-	hpc->len = odp_sys_huge_page_size();
+	hpc->len = hp_size();
 
 	for (int i = 0; i < count; ++i) {
 		int fd;
@@ -669,12 +712,12 @@ static int create_file(int block_index, huge_flag_t huge, uint64_t len,
 
 	/* huge dir must be known to create files there!: */
 	if ((huge == HUGE) &&
-	    (!odp_global_ro.hugepage_info.default_huge_page_dir))
+	    (!odp_global_ro.hugepage_info.shm_huge_page_dir))
 		return -1;
 
 	if (huge == HUGE)
 		snprintf(dir, ISHM_FILENAME_MAXLEN, "%s/%s",
-			 odp_global_ro.hugepage_info.default_huge_page_dir,
+			 odp_global_ro.hugepage_info.shm_huge_page_dir,
 			 odp_global_ro.uid);
 	else
 		snprintf(dir, ISHM_FILENAME_MAXLEN, "%s/%s",
@@ -777,7 +820,7 @@ static void *do_map(int block_index, uint64_t len, uint32_t align,
 	}
 
 	/* try to mmap: */
-	mapped_addr = _odp_ishmphy_map(*fd, len, offset, flags);
+	mapped_addr = map_prefault(*fd, len, offset, flags);
 	if (mapped_addr == NULL) {
 		if (!new_block->external_fd) {
 			close(*fd);
@@ -812,7 +855,7 @@ static void *alloc_single_va(const char *name, int new_index, uint64_t size,
 	*fd = ishm_tbl->single_va_fd;
 
 	if (ishm_tbl->single_va_huge) {
-		page_sz = odp_sys_huge_page_size();
+		page_sz = hp_size();
 		new_block->huge = HUGE;
 	} else {
 		page_sz = odp_sys_page_size();
@@ -869,7 +912,7 @@ static void *do_remap(int block_index, int fd)
 	ODP_ASSERT(!(flags & _ODP_ISHM_SINGLE_VA));
 
 	/* try to mmap: */
-	mapped_addr = _odp_ishmphy_map(fd, len, offset, flags);
+	mapped_addr = map_prefault(fd, len, offset, flags);
 
 	if (mapped_addr == NULL)
 		return NULL;
@@ -1069,9 +1112,11 @@ int _odp_ishm_reserve(const char *name, uint64_t size, int fd,
 	/* update this process view... */
 	procsync();
 
+	flags |= ishm_tbl->prefault_flags;
+
 	/* Get system page sizes: page_hp_size is 0 if no huge page available*/
 	page_sz      = odp_sys_page_size();
-	page_hp_size = odp_sys_huge_page_size();
+	page_hp_size = hp_size();
 
 	/* grab a new entry: */
 	for (new_index = 0; new_index < ISHM_MAX_NB_BLOCKS; new_index++) {
@@ -1258,10 +1303,11 @@ static void *reserve_single_va(uint64_t size, int *fd_out)
 	uint64_t len;		/* mapped length */
 	int fd = -1;
 	void *addr = NULL;
+	int flags = _ODP_ISHM_SINGLE_VA | ishm_tbl->prefault_flags;
 
 	/* Get system page sizes: page_hp_size is 0 if no huge page available*/
 	page_sz      = odp_sys_page_size();
-	page_hp_size = odp_sys_huge_page_size();
+	page_hp_size = hp_size();
 
 	/* Try first huge pages when possible and needed: */
 	if (page_hp_size && (size > page_sz)) {
@@ -1269,7 +1315,7 @@ static void *reserve_single_va(uint64_t size, int *fd_out)
 		len = (size + (page_hp_size - 1)) & (-page_hp_size);
 		fd = create_file(-1, HUGE, len, 0, 0, true);
 		if (fd >= 0) {
-			addr = _odp_ishmphy_reserve_single_va(len, fd);
+			addr = map_prefault(fd, len, 0, flags);
 			if (!addr) {
 				close(fd);
 				unlink(ishm_tbl->single_va_filename);
@@ -1289,7 +1335,7 @@ static void *reserve_single_va(uint64_t size, int *fd_out)
 
 		fd = create_file(-1, NORMAL, len, 0, 0, true);
 		if (fd >= 0)
-			addr = _odp_ishmphy_reserve_single_va(len, fd);
+			addr = map_prefault(fd, len, 0, flags);
 		ishm_tbl->single_va_huge = false;
 	}
 
@@ -1560,7 +1606,7 @@ int _odp_ishm_info(int block_index, _odp_ishm_info_t *info)
 	info->addr	 = ishm_proctable->entry[proc_index].start;
 	info->size	 = ishm_tbl->block[block_index].user_len;
 	info->page_size  = (ishm_tbl->block[block_index].huge == HUGE) ?
-			   odp_sys_huge_page_size() : odp_sys_page_size();
+			   hp_size() : odp_sys_page_size();
 	info->flags	 = ishm_tbl->block[block_index].flags;
 	info->user_flags = ishm_tbl->block[block_index].user_flags;
 
@@ -1665,10 +1711,11 @@ int _odp_ishm_init_global(const odp_init_t *init)
 	int i;
 	int val_kb;
 	uid_t uid;
-	char *hp_dir = odp_global_ro.hugepage_info.default_huge_page_dir;
+	char *hp_dir = odp_global_ro.hugepage_info.shm_huge_page_dir;
 	uint64_t max_memory;
 	uint64_t internal;
 	uint64_t huge_page_limit;
+	int prefault;
 
 	if (!_odp_libconfig_lookup_ext_int("shm", NULL, "single_va_size_kb",
 					   &val_kb)) {
@@ -1690,6 +1737,19 @@ int _odp_ishm_init_global(const odp_init_t *init)
 
 	ODP_DBG("Shm huge page usage limit: %dkB\n", val_kb);
 
+	if (!_odp_libconfig_lookup_ext_int("shm", NULL, "prefault",
+					   &prefault)) {
+		ODP_ERR("Unable to read pre-fault mode from config\n");
+		return -1;
+	}
+
+	if (prefault < 0 || prefault > 2) {
+		ODP_ERR("Bad pre-fault mode: %d\n", prefault);
+		return -1;
+	}
+
+	ODP_DBG("Shm pre-fault mode: %d\n", prefault);
+
 	/* user requested memory size + some extra for internal use */
 	if (init && init->shm.max_memory)
 		max_memory = init->shm.max_memory + internal;
@@ -1741,6 +1801,10 @@ int _odp_ishm_init_global(const odp_init_t *init)
 	ishm_tbl->dev_seq = 0;
 	ishm_tbl->odpthread_cnt = 0;
 	ishm_tbl->huge_page_limit = huge_page_limit;
+	if (prefault)
+		ishm_tbl->prefault_flags |= _ODP_ISHM_POPULATE;
+	if (prefault == 2)
+		ishm_tbl->prefault_flags |= _ODP_ISHM_LOCK;
 	odp_spinlock_init(&ishm_tbl->lock);
 
 	/* allocate space for the internal shared mem fragment table: */
@@ -2065,6 +2129,11 @@ int _odp_ishm_status(const char *title)
 	ODP_PRINT("%65s(%" PRIu64 "MB) %4s(%" PRIu64 "MB)\n",
 		  "", len_total / 1024 / 1024,
 		  "", lost_total / 1024 / 1024);
+	ODP_PRINT("\nhuge page size: %" PRIu64 " kB\n", hp_size() / 1024);
+	ODP_PRINT("pre-faulted: %" PRIu64 " mappings, %" PRIu64 " MB, "
+		  "%" PRIu64 " usec\n", ishm_tbl->prefault.num,
+		  ishm_tbl->prefault.len / 1024 / 1024,
+		  ishm_tbl->prefault.nsec / 1000);
 
 	/* display the virtual space allocations... : */
 	ODP_PRINT("\nishm virtual space:\n");
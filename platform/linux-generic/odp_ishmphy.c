@@ -42,15 +42,17 @@ static uint64_t common_va_len;
  * This function is called at odp_init_global() time to pre-reserve some memory
  * which is inherited by all odpthreads (i.e. descendant processes and threads).
  * This memory block is later used when memory is reserved with
- * _ODP_ISHM_SINGLE_VA flag.
+ * _ODP_ISHM_SINGLE_VA flag. _ODP_ISHM_POPULATE and _ODP_ISHM_LOCK flags apply
+ * to the entire memory block.
  * returns the address of the mapping or NULL on error.
  */
-void *_odp_ishmphy_reserve_single_va(uint64_t len, int fd)
+void *_odp_ishmphy_reserve_single_va(uint64_t len, int fd, int flags)
 {
 	void *addr;
+	int mmap_flags = (flags & _ODP_ISHM_POPULATE) ? MAP_POPULATE : 0;
 
 	addr = mmap(NULL, len, PROT_READ | PROT_WRITE,
-		    MAP_SHARED | MAP_POPULATE, fd, 0);
+		    MAP_SHARED | mmap_flags, fd, 0);
 	if (addr == MAP_FAILED) {
 		ODP_ERR("mmap failed: %s\n", strerror(errno));
 		return NULL;
@@ -59,6 +61,13 @@ void *_odp_ishmphy_reserve_single_va(uint64_t len, int fd)
 	if (mprotect(addr, len, PROT_READ | PROT_WRITE))
 		ODP_ERR("mprotect failed: %s\n", strerror(errno));
 
+	if ((flags & _ODP_ISHM_LOCK) && mlock(addr, len)) {
+		ODP_ERR("mlock failed: %s\n", strerror(errno));
+		if (munmap(addr, len))
+			ODP_ERR("munmap failed: %s\n", strerror(errno));
+		return NULL;
+	}
+
 	ODP_DBG("VA Reserved: %p, len=%" PRIu64 "\n", addr, len);
 
 	common_va_address = addr;
@@ -93,7 +102,7 @@ int _odp_ishmphy_free_single_va(void)
 void *_odp_ishmphy_map(int fd, uint64_t size, uint64_t offset, int flags)
 {
 	void *mapped_addr;
-	int mmap_flags = MAP_POPULATE;
+	int mmap_flags = (flags & _ODP_ISHM_POPULATE) ? MAP_POPULATE : 0;
 
 	ODP_ASSERT(!(flags & _ODP_ISHM_SINGLE_VA));
 
@@ -131,13 +140,14 @@ int _odp_ishmphy_unmap(void *start, uint64_t len, int flags)
 {
 	int ret;
 
+	/* Single VA memory stays mapped (and locked) until global terminate */
+	if (flags & _ODP_ISHM_SINGLE_VA)
+		return 0;
+
 	/* if locking was requested, unlock...*/
 	if (flags & _ODP_ISHM_LOCK)
 		munlock(start, len);
 
-	if (flags & _ODP_ISHM_SINGLE_VA)
-		return 0;
-
 	/* just release the mapping */
 	ret = munmap(start, len);
 	if (ret)
@@ -305,10 +305,7 @@ static inline void link_segments(odp_packet_hdr_t *pkt_hdr[], int num)
 	uint32_t seg_len = ((pool_t *)(head->buf_hdr.pool_ptr))->seg_len;
 
 	while (1) {
-		odp_buffer_hdr_t *buf_hdr = &pkt_hdr[cur]->buf_hdr;
-
 		hdr = pkt_hdr[cur];
-		hdr->seg_data = buf_hdr->base_data;
 		hdr->seg_len  = seg_len;
 
 		/* init_segments() handles first seg ref_cnt init */
@@ -334,21 +331,14 @@ static inline void link_segments(odp_packet_hdr_t *pkt_hdr[], int num)
 	}
 }
 
+/* Packet headers are stored in the pool in reset state: seg_data points to
+ * the beginning of the segment, seg_next is NULL and seg_count is one (see
+ * buffer_free_to_pool()). Single segment packets need no initialization
+ * here, packet_init() sets the segment length. */
 static inline void init_segments(odp_packet_hdr_t *pkt_hdr[], int num)
 {
-	odp_packet_hdr_t *hdr;
-	uint32_t seg_len;
-
 	/* First segment is the packet descriptor */
-	hdr = pkt_hdr[0];
-	seg_len = ((pool_t *)(hdr->buf_hdr.pool_ptr))->seg_len;
-
-	/* Defaults for single segment packet */
-	hdr->seg_data = hdr->buf_hdr.base_data;
-	hdr->seg_len  = seg_len;
-	hdr->seg_next = NULL;
-
-	hdr->seg_count = num;
+	odp_packet_hdr_t *hdr = pkt_hdr[0];
 
 	if (ODP_DEBUG == 1) {
 		uint32_t prev_ref =
@@ -358,8 +348,10 @@ static inline void init_segments(odp_packet_hdr_t *pkt_hdr[], int num)
 	}
 
 	/* Link segments */
-	if (odp_unlikely(num > 1))
+	if (odp_unlikely(num > 1)) {
+		hdr->seg_count = num;
 		link_segments(pkt_hdr, num);
+	}
 }
 
 static inline void reset_segments(odp_packet_hdr_t *pkt_hdr)
@@ -467,8 +459,13 @@ static inline odp_packet_hdr_t *add_segments(odp_packet_hdr_t *pkt_hdr,
 
 static inline void buffer_ref_inc(odp_buffer_hdr_t *buf_hdr)
 {
+	pool_t *pool = buf_hdr->pool_ptr;
 	uint32_t ref_cnt = odp_atomic_load_u32(&buf_hdr->ref_cnt);
 
+	/* Disable reference check bypass on free */
+	if (odp_unlikely(odp_atomic_load_u32(&pool->refs_used) == 0))
+		odp_atomic_store_u32(&pool->refs_used, 1);
+
 	/* First count increment after alloc */
 	if (odp_likely(ref_cnt == 0))
 		odp_atomic_store_u32(&buf_hdr->ref_cnt, 2);
@@ -507,6 +504,23 @@ static inline void packet_free_multi(odp_buffer_hdr_t *hdr[], int num)
 	uint32_t ref_cnt;
 	int num_ref = 0;
 
+	/* Reference counts need not to be checked when reference API has not
+	 * been used on the pool. In debug mode, the count is always used. */
+	if (ODP_DEBUG == 0 && odp_likely(num > 0)) {
+		pool_t *pool = hdr[0]->pool_ptr;
+
+		if (odp_likely(odp_atomic_load_u32(&pool->refs_used) == 0)) {
+			for (i = 1; i < num; i++)
+				if (odp_unlikely(hdr[i]->pool_ptr != pool))
+					break;
+
+			if (odp_likely(i == num)) {
+				_odp_buffer_free_to_pool(pool, hdr, num);
+				return;
+			}
+		}
+	}
+
 	for (i = 0; i < num; i++) {
 		/* Zero when reference API has not been used */
 		ref_cnt = buffer_ref(hdr[i]);
@@ -672,23 +686,55 @@ static inline int packet_alloc(pool_t *pool, uint32_t len, int max_pkt,
 	return num;
 }
 
+/* Allocate from the smallest size class which stores 'len' bytes into a
+ * single segment. Larger classes are used when a class runs out of packets. */
+static int packet_alloc_class(pool_t *pool, uint32_t len, int max_pkt,
+			      odp_packet_t *pkt)
+{
+	uint32_t num_class = pool->num_class;
+	uint32_t i = 0;
+	int num = 0;
+
+	while (i < num_class - 1 && len > pool->class_pool[i]->seg_len)
+		i++;
+
+	for (; i < num_class && num < max_pkt; i++) {
+		pool_t *class = pool->class_pool[i];
+		int num_seg = num_segments(len, class->seg_len);
+
+		num += packet_alloc(class, len, max_pkt - num, num_seg,
+				    &pkt[num]);
+	}
+
+	return num;
+}
+
+static inline int packet_alloc_pool(pool_t *pool, uint32_t len, int max_pkt,
+				    odp_packet_t *pkt)
+{
+	int num_seg;
+
+	if (odp_unlikely(pool->num_class > 1))
+		return packet_alloc_class(pool, len, max_pkt, pkt);
+
+	num_seg = num_segments(len, pool->seg_len);
+
+	return packet_alloc(pool, len, max_pkt, num_seg, pkt);
+}
+
 int _odp_packet_alloc_multi(odp_pool_t pool_hdl, uint32_t len,
 			    odp_packet_t pkt[], int max_num)
 {
 	pool_t *pool = pool_entry_from_hdl(pool_hdl);
-	int num, num_seg;
 
-	num_seg = num_segments(len, pool->seg_len);
-	num     = packet_alloc(pool, len, max_num, num_seg, pkt);
-
-	return num;
+	return packet_alloc_pool(pool, len, max_num, pkt);
 }
 
 odp_packet_t odp_packet_alloc(odp_pool_t pool_hdl, uint32_t len)
 {
 	pool_t *pool = pool_entry_from_hdl(pool_hdl);
 	odp_packet_t pkt;
-	int num, num_seg;
+	int num;
 
 	if (odp_unlikely(pool->params.type != ODP_POOL_PACKET)) {
 		_odp_errno = EINVAL;
@@ -698,8 +744,7 @@ odp_packet_t odp_packet_alloc(odp_pool_t pool_hdl, uint32_t len)
 	if (odp_unlikely(len > pool->max_len || len == 0))
 		return ODP_PACKET_INVALID;
 
-	num_seg = num_segments(len, pool->seg_len);
-	num     = packet_alloc(pool, len, 1, num_seg, &pkt);
+	num = packet_alloc_pool(pool, len, 1, &pkt);
 
 	if (odp_unlikely(num == 0))
 		return ODP_PACKET_INVALID;
@@ -711,7 +756,6 @@ int odp_packet_alloc_multi(odp_pool_t pool_hdl, uint32_t len,
 			   odp_packet_t pkt[], int max_num)
 {
 	pool_t *pool = pool_entry_from_hdl(pool_hdl);
-	int num, num_seg;
 
 	if (odp_unlikely(pool->params.type != ODP_POOL_PACKET)) {
 		_odp_errno = EINVAL;
@@ -721,10 +765,7 @@ int odp_packet_alloc_multi(odp_pool_t pool_hdl, uint32_t len,
 	if (odp_unlikely(len > pool->max_len || len == 0))
 		return -1;
 
-	num_seg = num_segments(len, pool->seg_len);
-	num     = packet_alloc(pool, len, max_num, num_seg, pkt);
-
-	return num;
+	return packet_alloc_pool(pool, len, max_num, pkt);
 }
 
 void odp_packet_free(odp_packet_t pkt)
@@ -30,10 +30,14 @@
 #include <odp/api/plat/queue_inlines.h>
 #include <odp_libconfig_internal.h>
 #include <odp_event_vector_internal.h>
+#include <odp_pool_internal.h>
+#include <odp_ring_mpmc_internal.h>
+#include <odp_trace_internal.h>
 
 #include <string.h>
 #include <inttypes.h>
 #include <sys/ioctl.h>
+#include <sys/select.h>
 #include <ifaddrs.h>
 #include <errno.h>
 #include <time.h>
@@ -49,6 +53,39 @@
 /* Max wait time supported to avoid potential overflow */
 #define MAX_WAIT_TIME (UINT64_MAX / 1024)
 
+/* Max number of packets received from the driver per software RSS round */
+#define SW_RSS_BURST QUEUE_MULTI_MAX
+
+/* Software RSS ring size limits */
+#define SW_RSS_MIN_RING_SIZE (2 * SW_RSS_BURST)
+#define SW_RSS_MAX_RING_SIZE (16 * 1024)
+
+/* Software RSS input queue */
+typedef struct ODP_ALIGNED_CACHE {
+	ring_mpmc_t ring;
+
+	/* Packet index ring data */
+	uint32_t *ring_data;
+
+} sw_rss_queue_t;
+
+/* Software RSS stage. Packets are received from the single driver input queue
+ * and distributed by flow hash into input queue specific rings. The driver is
+ * polled by any thread that finds its own ring empty. */
+typedef struct sw_rss_t {
+	/* Serializes driver receive and packet distribution, which keeps
+	 * packet order within each ring */
+	odp_spinlock_t lock ODP_ALIGNED_CACHE;
+
+	odp_cls_hash_proto_t hash_proto;
+	uint32_t num_queue;
+	uint32_t ring_mask;
+	odp_shm_t shm;
+
+	sw_rss_queue_t queue[PKTIO_MAX_QUEUES];
+
+} sw_rss_t;
+
 /* Global variables */
 static pktio_global_t *pktio_global;
 
@@ -65,6 +102,187 @@ static inline odp_buffer_hdr_t *packet_vector_to_buf_hdr(odp_packet_vector_t pkt
 	return &_odp_packet_vector_hdr(pktv)->buf_hdr;
 }
 
+static void sw_rss_hash_proto(odp_cls_hash_proto_t *cls,
+			      odp_pktin_hash_proto_t hash_proto)
+{
+	cls->all = 0;
+
+	if (hash_proto.proto.ipv4 || hash_proto.proto.ipv4_tcp ||
+	    hash_proto.proto.ipv4_udp)
+		cls->ipv4 = 1;
+	if (hash_proto.proto.ipv6 || hash_proto.proto.ipv6_tcp ||
+	    hash_proto.proto.ipv6_udp)
+		cls->ipv6 = 1;
+	if (hash_proto.proto.ipv4_tcp || hash_proto.proto.ipv6_tcp)
+		cls->tcp = 1;
+	if (hash_proto.proto.ipv4_udp || hash_proto.proto.ipv6_udp)
+		cls->udp = 1;
+}
+
+static int sw_rss_create(pktio_entry_t *entry,
+			 const odp_pktin_queue_param_t *param)
+{
+	char name[ODP_SHM_NAME_LEN];
+	odp_shm_t shm;
+	sw_rss_t *rss;
+	uint32_t i, *ring_data;
+	uint32_t num_queue = param->num_queues;
+	uint32_t ring_size = pktio_global->config.sw_rss_ring_size;
+	uint64_t shm_size = sizeof(sw_rss_t) +
+			    (uint64_t)num_queue * ring_size * sizeof(uint32_t);
+
+	snprintf(name, sizeof(name), "_odp_pktio_sw_rss_%i",
+		 odp_pktio_index(entry->s.handle));
+
+	shm = odp_shm_reserve(name, shm_size, ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		ODP_ERR("pktio %s: software RSS shm reserve failed\n",
+			entry->s.name);
+		return -1;
+	}
+
+	rss = odp_shm_addr(shm);
+	memset(rss, 0, sizeof(sw_rss_t));
+
+	odp_spinlock_init(&rss->lock);
+	sw_rss_hash_proto(&rss->hash_proto, param->hash_proto);
+	rss->num_queue = num_queue;
+	rss->ring_mask = ring_size - 1;
+	rss->shm = shm;
+
+	ring_data = (uint32_t *)(uintptr_t)((uint8_t *)rss + sizeof(sw_rss_t));
+
+	for (i = 0; i < num_queue; i++) {
+		ring_mpmc_init(&rss->queue[i].ring);
+		rss->queue[i].ring_data = &ring_data[i * ring_size];
+	}
+
+	entry->s.sw_rss = rss;
+
+	return 0;
+}
+
+static void sw_rss_destroy(pktio_entry_t *entry)
+{
+	sw_rss_t *rss = entry->s.sw_rss;
+	uint32_t i, j, num;
+	uint32_t idx[SW_RSS_BURST];
+
+	if (rss == NULL)
+		return;
+
+	/* Free packets left in the rings */
+	for (i = 0; i < rss->num_queue; i++) {
+		while ((num = ring_mpmc_deq_multi(&rss->queue[i].ring,
+						  rss->queue[i].ring_data,
+						  rss->ring_mask, idx,
+						  SW_RSS_BURST))) {
+			for (j = 0; j < num; j++)
+				odp_packet_free(packet_from_buf_hdr(buf_hdr_from_index_u32(idx[j])));
+		}
+	}
+
+	entry->s.sw_rss = NULL;
+
+	if (odp_shm_free(rss->shm))
+		ODP_ERR("pktio %s: software RSS shm free failed\n",
+			entry->s.name);
+}
+
+static inline int sw_rss_deq(sw_rss_t *rss, int index, odp_packet_t packets[],
+			     int num)
+{
+	uint32_t idx[num];
+	int i, ret;
+
+	ret = ring_mpmc_deq_multi(&rss->queue[index].ring,
+				  rss->queue[index].ring_data, rss->ring_mask,
+				  idx, num);
+
+	for (i = 0; i < ret; i++)
+		packets[i] = packet_from_buf_hdr(buf_hdr_from_index_u32(idx[i]));
+
+	return ret;
+}
+
+/* Poll the driver and distribute received packets into input queue rings */
+static void sw_rss_distribute(pktio_entry_t *entry, sw_rss_t *rss)
+{
+	odp_packet_t pkt_tbl[SW_RSS_BURST];
+	uint32_t idx[rss->num_queue][SW_RSS_BURST];
+	uint32_t num[rss->num_queue];
+	uint32_t i, q, ret;
+	int pkts;
+
+	pkts = entry->s.ops->recv(entry, 0, pkt_tbl, SW_RSS_BURST);
+	if (pkts <= 0)
+		return;
+
+	memset(num, 0, sizeof(num));
+
+	for (i = 0; i < (uint32_t)pkts; i++) {
+		odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt_tbl[i]);
+
+		q = _odp_cls_packet_rss_hash(pkt_hdr, rss->hash_proto,
+					     packet_data(pkt_hdr));
+		q = q % rss->num_queue;
+		idx[q][num[q]++] = packet_to_buf_hdr(pkt_tbl[i])->index.u32;
+	}
+
+	for (q = 0; q < rss->num_queue; q++) {
+		if (num[q] == 0)
+			continue;
+
+		ret = ring_mpmc_enq_multi(&rss->queue[q].ring,
+					  rss->queue[q].ring_data,
+					  rss->ring_mask, idx[q], num[q]);
+
+		/* Drop packets that do not fit into the ring */
+		for (i = ret; i < num[q]; i++)
+			odp_packet_free(packet_from_buf_hdr(buf_hdr_from_index_u32(idx[q][i])));
+
+		if (odp_unlikely(ret < num[q]))
+			odp_atomic_add_u64(&entry->s.stats_extra.in_discards,
+					   num[q] - ret);
+	}
+}
+
+/* Receive packets of a software RSS input queue. Packets are always passed
+ * through the rings, so that a flow keeps its order even when multiple
+ * threads take turns polling the driver. */
+static int sw_rss_recv(pktio_entry_t *entry, int index, odp_packet_t packets[],
+		       int num)
+{
+	sw_rss_t *rss = entry->s.sw_rss;
+	int ret;
+
+	if (num > SW_RSS_BURST)
+		num = SW_RSS_BURST;
+
+	ret = sw_rss_deq(rss, index, packets, num);
+	if (ret)
+		return ret;
+
+	/* Some other thread is polling the driver */
+	if (!odp_spinlock_trylock(&rss->lock))
+		return 0;
+
+	sw_rss_distribute(entry, rss);
+
+	odp_spinlock_unlock(&rss->lock);
+
+	return sw_rss_deq(rss, index, packets, num);
+}
+
+static inline int pktin_recv(pktio_entry_t *entry, int index,
+			     odp_packet_t packets[], int num)
+{
+	if (odp_unlikely(entry->s.sw_rss != NULL))
+		return sw_rss_recv(entry, index, packets, num);
+
+	return entry->s.ops->recv(entry, index, packets, num);
+}
+
 static int read_config_file(pktio_global_t *pktio_glb)
 {
 	const char *str;
@@ -86,6 +304,34 @@ static int read_config_file(pktio_global_t *pktio_glb)
 	pktio_glb->config.pktin_frame_offset = val;
 	ODP_PRINT("  %s: %i\n", str, val);
 
+	str = "pktio.sw_rss.max_queues";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val < 0 || val > PKTIO_MAX_QUEUES) {
+		ODP_ERR("Bad value %s = %i\n", str, val);
+		return -1;
+	}
+
+	pktio_glb->config.sw_rss_max_queues = val;
+	ODP_PRINT("  %s: %i\n", str, val);
+
+	str = "pktio.sw_rss.ring_size";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val < SW_RSS_MIN_RING_SIZE || val > SW_RSS_MAX_RING_SIZE) {
+		ODP_ERR("Bad value %s = %i\n", str, val);
+		return -1;
+	}
+
+	pktio_glb->config.sw_rss_ring_size = ROUNDUP_POWER2_U32((uint32_t)val);
+	ODP_PRINT("  %s: %i\n", str, val);
+
 	ODP_PRINT("\n");
 
 	return 0;
@@ -195,6 +441,8 @@ static void init_out_queues(pktio_entry_t *entry)
 	for (i = 0; i < PKTIO_MAX_QUEUES; i++) {
 		entry->s.out_queue[i].queue  = ODP_QUEUE_INVALID;
 		entry->s.out_queue[i].pktout = PKTOUT_INVALID;
+		entry->s.out_queue[i].batch.max = 0;
+		entry->s.out_queue[i].batch.num = 0;
 	}
 }
 
@@ -510,6 +758,7 @@ int odp_pktio_close(odp_pktio_t hdl)
 	lock_entry(entry);
 
 	destroy_in_queues(entry, entry->s.num_in_queue);
+	sw_rss_destroy(entry);
 	destroy_out_queues(entry, entry->s.num_out_queue);
 
 	entry->s.num_in_queue  = 0;
@@ -607,8 +856,16 @@ int odp_pktio_start(odp_pktio_t hdl)
 		ODP_ERR("Already started\n");
 		return -1;
 	}
-	if (entry->s.ops->start)
+	if (entry->s.ops->start) {
+		unsigned int num_in_queue = entry->s.num_in_queue;
+
+		/* Driver sees only its own input queue */
+		if (entry->s.sw_rss)
+			entry->s.num_in_queue = 1;
+
 		res = entry->s.ops->start(entry);
+		entry->s.num_in_queue = num_in_queue;
+	}
 	if (!res)
 		entry->s.state = PKTIO_STATE_STARTED;
 
@@ -646,6 +903,8 @@ int odp_pktio_start(odp_pktio_t hdl)
 	return res;
 }
 
+static void pktout_batch_drain(pktio_entry_t *entry);
+
 static int _pktio_stop(pktio_entry_t *entry)
 {
 	int res = 0;
@@ -656,6 +915,9 @@ static int _pktio_stop(pktio_entry_t *entry)
 		return -1;
 	}
 
+	/* Transmit or drop packets left in transmit batches */
+	pktout_batch_drain(entry);
+
 	if (entry->s.ops->stop)
 		res = entry->s.ops->stop(entry);
 
@@ -847,7 +1109,7 @@ static inline int pktin_recv_buf(pktio_entry_t *entry, int pktin_index,
 	/* Some compilers need this dummy initialization */
 	cur_queue = ODP_QUEUE_INVALID;
 
-	pkts = entry->s.ops->recv(entry, pktin_index, packets, num);
+	pkts = pktin_recv(entry, pktin_index, packets, num);
 
 	for (i = 0; i < pkts; i++) {
 		pkt = packets[i];
@@ -1154,7 +1416,7 @@ int _odp_sched_cb_pktin_poll_one(int pktio_index,
 	}
 
 	ODP_ASSERT((unsigned int)rx_queue < entry->s.num_in_queue);
-	num_pkts = entry->s.ops->recv(entry, rx_queue, packets, num);
+	num_pkts = pktin_recv(entry, rx_queue, packets, num);
 
 	num_rx = 0;
 	for (i = 0; i < num_pkts; i++) {
@@ -1222,6 +1484,34 @@ int _odp_sched_cb_pktin_poll(int pktio_index, int pktin_index,
 	return pktin_recv_buf(entry, pktin_index, hdr_tbl, num);
 }
 
+/* Check without blocking if a pktin queue has packets to receive. Returns 1
+ * when ready, 0 when not ready and <0 when readiness cannot be checked. */
+int _odp_sched_cb_pktin_ready(int pktio_index, int pktin_index)
+{
+	pktio_entry_t *entry = pktio_entry_by_index(pktio_index);
+	struct timeval timeout = {0, 0};
+	fd_set readfds;
+	int maxfd, ret;
+
+	/* Let the next poll handle interface state changes */
+	if (odp_unlikely(entry->s.state != PKTIO_STATE_STARTED))
+		return 1;
+
+	if (entry->s.ops->fd_set == NULL || entry->s.sw_rss != NULL)
+		return -1;
+
+	FD_ZERO(&readfds);
+	maxfd = entry->s.ops->fd_set(entry, pktin_index, &readfds);
+	if (maxfd < 0)
+		return -1;
+
+	ret = select(maxfd + 1, &readfds, NULL, NULL, &timeout);
+	if (ret < 0)
+		return errno == EINTR ? 1 : -1;
+
+	return ret > 0;
+}
+
 void _odp_sched_cb_pktio_stop_finalize(int pktio_index)
 {
 	int state;
@@ -1774,6 +2064,19 @@ int single_capability(odp_pktio_capability_t *capa)
 	return 0;
 }
 
+static uint32_t drv_max_input_queues(pktio_entry_t *entry)
+{
+	odp_pktio_capability_t capa;
+	int ret;
+
+	if (entry->s.ops->capability)
+		ret = entry->s.ops->capability(entry, &capa);
+	else
+		ret = single_capability(&capa);
+
+	return ret ? 0 : capa.max_input_queues;
+}
+
 int odp_pktio_capability(odp_pktio_t pktio, odp_pktio_capability_t *capa)
 {
 	pktio_entry_t *entry;
@@ -1806,6 +2109,8 @@ int odp_pktio_capability(odp_pktio_t pktio, odp_pktio_capability_t *capa)
 		 * we can report that it is supported.
 		 */
 		capa->config.pktout.bit.no_packet_refs = 1;
+		/* Transmit batching is common to all pktios */
+		capa->tx_batch.max_pkts = PKTIO_TX_BATCH_MAX;
 
 		/* LSO implementation is common to all pktios */
 		capa->lso.max_profiles           = PKTIO_LSO_PROFILES;
@@ -1818,6 +2123,11 @@ int odp_pktio_capability(odp_pktio_t pktio, odp_pktio_capability_t *capa)
 		capa->lso.proto.ipv4             = 1;
 		capa->lso.proto.custom           = 1;
 		capa->lso.mod_op.add_segment_num = 1;
+
+		/* Software RSS extends single queue drivers */
+		if (capa->max_input_queues == 1 &&
+		    pktio_global->config.sw_rss_max_queues > 1)
+			capa->max_input_queues = pktio_global->config.sw_rss_max_queues;
 	}
 
 	/* Packet vector generation is common for all pktio types */
@@ -1908,6 +2218,8 @@ int odp_pktin_queue_config(odp_pktio_t pktio,
 	int rc;
 	odp_queue_t queue;
 	odp_pktin_queue_param_t default_param;
+	odp_pktin_queue_param_t drv_param;
+	int sw_rss;
 
 	if (param == NULL) {
 		odp_pktin_queue_param_init(&default_param);
@@ -1952,6 +2264,9 @@ int odp_pktin_queue_config(odp_pktio_t pktio,
 		return -1;
 	}
 
+	/* Distribute packets from a single queue driver in software */
+	sw_rss = num_queues > 1 && drv_max_input_queues(entry) == 1;
+
 	/* Validate packet vector parameters */
 	if (param->vector.enable) {
 		odp_pool_t pool = param->vector.pool;
@@ -1995,6 +2310,8 @@ int odp_pktin_queue_config(odp_pktio_t pktio,
 	if (entry->s.num_in_queue)
 		destroy_in_queues(entry, entry->s.num_in_queue);
 
+	sw_rss_destroy(entry);
+
 	for (i = 0; i < num_queues; i++) {
 		if (mode == ODP_PKTIN_MODE_QUEUE ||
 		    mode == ODP_PKTIN_MODE_SCHED) {
@@ -2055,8 +2372,28 @@ int odp_pktin_queue_config(odp_pktio_t pktio,
 
 	entry->s.num_in_queue = num_queues;
 
-	if (entry->s.ops->input_queues_config)
-		return entry->s.ops->input_queues_config(entry, param);
+	if (sw_rss) {
+		if (sw_rss_create(entry, param)) {
+			destroy_in_queues(entry, num_queues);
+			entry->s.num_in_queue = 0;
+			return -1;
+		}
+
+		/* Driver is configured with a single input queue */
+		drv_param = *param;
+		drv_param.num_queues = 1;
+		drv_param.hash_enable = 0;
+		param = &drv_param;
+	}
+
+	if (entry->s.ops->input_queues_config) {
+		if (sw_rss)
+			entry->s.num_in_queue = 1;
+
+		rc = entry->s.ops->input_queues_config(entry, param);
+		entry->s.num_in_queue = num_queues;
+		return rc;
+	}
 
 	return 0;
 }
@@ -2119,6 +2456,11 @@ int odp_pktout_queue_config(odp_pktio_t pktio,
 		return -1;
 	}
 
+	if (param->batch.max_pkts > capa.tx_batch.max_pkts) {
+		ODP_DBG("pktio %s: too large transmit batch\n", entry->s.name);
+		return -1;
+	}
+
 	/* If re-configuring, destroy old queues */
 	if (entry->s.num_out_queue) {
 		destroy_out_queues(entry, entry->s.num_out_queue);
@@ -2128,8 +2470,19 @@ int odp_pktout_queue_config(odp_pktio_t pktio,
 	init_out_queues(entry);
 
 	for (i = 0; i < num_queues; i++) {
+		pktout_batch_t *batch = &entry->s.out_queue[i].batch;
+
 		entry->s.out_queue[i].pktout.index = i;
 		entry->s.out_queue[i].pktout.pktio = pktio;
+
+		odp_ticketlock_init(&batch->lock);
+		batch->num = 0;
+		batch->max = 0;
+		batch->mt_safe = param->op_mode != ODP_PKTIO_OP_MT_UNSAFE;
+		batch->tmo_ns = param->batch.max_tmo_us * ODP_TIME_USEC_IN_NS;
+
+		if (mode == ODP_PKTOUT_MODE_DIRECT && param->batch.max_pkts > 1)
+			batch->max = param->batch.max_pkts;
 	}
 
 	entry->s.num_out_queue = num_queues;
@@ -2339,7 +2692,7 @@ int odp_pktin_recv(odp_pktin_queue_t queue, odp_packet_t packets[], int num)
 	if (odp_unlikely(entry->s.state != PKTIO_STATE_STARTED))
 		return 0;
 
-	ret = entry->s.ops->recv(entry, queue.index, packets, num);
+	ret = pktin_recv(entry, queue.index, packets, num);
 	if (_ODP_PCAPNG)
 		_odp_dump_pcapng_pkts(entry, queue.index, packets, ret);
 
@@ -2368,7 +2721,8 @@ int odp_pktin_recv_tmo(odp_pktin_queue_t queue, odp_packet_t packets[], int num,
 	if (odp_unlikely(entry->s.state != PKTIO_STATE_STARTED))
 		return 0;
 
-	if (entry->s.ops->recv_tmo && wait != ODP_PKTIN_NO_WAIT) {
+	if (entry->s.ops->recv_tmo && wait != ODP_PKTIN_NO_WAIT &&
+	    entry->s.sw_rss == NULL) {
 		ret = entry->s.ops->recv_tmo(entry, queue.index, packets, num,
 					      wait);
 		if (_ODP_PCAPNG)
@@ -2378,7 +2732,7 @@ int odp_pktin_recv_tmo(odp_pktin_queue_t queue, odp_packet_t packets[], int num,
 	}
 
 	while (1) {
-		ret = entry->s.ops->recv(entry, queue.index, packets, num);
+		ret = pktin_recv(entry, queue.index, packets, num);
 		if (_ODP_PCAPNG)
 			_odp_dump_pcapng_pkts(entry, queue.index, packets, ret);
 
@@ -2508,6 +2862,134 @@ uint64_t odp_pktin_wait_time(uint64_t nsec)
 	return (nsec / (1000)) + 1;
 }
 
+static inline int pktout_send_burst(pktio_entry_t *entry, int index,
+				    const odp_packet_t packets[], int num)
+{
+	uint64_t trace_start;
+	int ret;
+
+	if (_ODP_PCAPNG)
+		_odp_dump_pcapng_pkts(entry, index, packets, num);
+
+	trace_start = _odp_trace_begin();
+	ret = entry->s.ops->send(entry, index, packets, num);
+	_odp_trace_end(_ODP_TRACE_PKTOUT_SEND, trace_start,
+		       odp_pktio_to_u64(entry->s.handle), ret);
+
+	return ret;
+}
+
+static inline void batch_lock(pktout_batch_t *batch)
+{
+	if (batch->mt_safe)
+		odp_ticketlock_lock(&batch->lock);
+}
+
+static inline void batch_unlock(pktout_batch_t *batch)
+{
+	if (batch->mt_safe)
+		odp_ticketlock_unlock(&batch->lock);
+}
+
+/* Pass batched packets to the driver. Packets that the driver does not accept
+ * remain in the batch. Called with the batch lock held. */
+static int pktout_batch_flush(pktio_entry_t *entry, int index,
+			      pktout_batch_t *batch)
+{
+	int num = batch->num;
+	int ret, i;
+
+	if (num == 0)
+		return 0;
+
+	ret = pktout_send_burst(entry, index, batch->pkt, num);
+	if (odp_unlikely(ret <= 0))
+		return ret;
+
+	for (i = ret; i < num; i++)
+		batch->pkt[i - ret] = batch->pkt[i];
+
+	batch->num = num - ret;
+
+	/* Timeout of the remaining packets restarts */
+	if (batch->num && batch->tmo_ns)
+		batch->first = odp_time_local();
+
+	return ret;
+}
+
+static int pktout_batch_send(pktio_entry_t *entry, int index,
+			     const odp_packet_t packets[], int num)
+{
+	pktout_batch_t *batch = &entry->s.out_queue[index].batch;
+	int sent = 0;
+	int ret = 0;
+
+	batch_lock(batch);
+
+	while (1) {
+		int n = batch->max - batch->num;
+
+		if (n > num - sent)
+			n = num - sent;
+
+		if (n > 0) {
+			if (batch->num == 0 && batch->tmo_ns)
+				batch->first = odp_time_local();
+
+			memcpy(&batch->pkt[batch->num], &packets[sent],
+			       n * sizeof(odp_packet_t));
+			batch->num += n;
+			sent += n;
+		}
+
+		if (batch->num < batch->max &&
+		    (batch->tmo_ns == 0 ||
+		     odp_time_diff_ns(odp_time_local(), batch->first) <
+		     batch->tmo_ns))
+			break;
+
+		ret = pktout_batch_flush(entry, index, batch);
+
+		/* Stop when all packets are in the batch, or the driver does
+		 * not accept more packets */
+		if (ret <= 0 || sent == num)
+			break;
+	}
+
+	batch_unlock(batch);
+
+	if (odp_unlikely(sent == 0 && ret < 0))
+		return -1;
+
+	return sent;
+}
+
+static void pktout_batch_drain(pktio_entry_t *entry)
+{
+	unsigned int i;
+
+	for (i = 0; i < entry->s.num_out_queue; i++) {
+		pktout_batch_t *batch = &entry->s.out_queue[i].batch;
+
+		if (batch->max == 0)
+			continue;
+
+		batch_lock(batch);
+
+		pktout_batch_flush(entry, i, batch);
+
+		if (odp_unlikely(batch->num)) {
+			odp_atomic_add_u64(&entry->s.stats_extra.out_discards,
+					   batch->num);
+			odp_packet_free_multi(batch->pkt, batch->num);
+			batch->num = 0;
+		}
+
+		batch_unlock(batch);
+	}
+}
+
 int odp_pktout_send(odp_pktout_queue_t queue, const odp_packet_t packets[],
 		    int num)
 {
@@ -2523,10 +3005,74 @@ int odp_pktout_send(odp_pktout_queue_t queue, const odp_packet_t packets[],
 	if (odp_unlikely(entry->s.state != PKTIO_STATE_STARTED))
 		return 0;
 
-	if (_ODP_PCAPNG)
-		_odp_dump_pcapng_pkts(entry, queue.index, packets, num);
+	if (entry->s.out_queue[queue.index].batch.max)
+		return pktout_batch_send(entry, queue.index, packets, num);
+
+	return pktout_send_burst(entry, queue.index, packets, num);
+}
+
+int odp_pktout_flush(odp_pktout_queue_t queue)
+{
+	pktio_entry_t *entry;
+	odp_pktio_t pktio = queue.pktio;
+	pktout_batch_t *batch;
+	int ret, num;
+
+	entry = get_pktio_entry(pktio);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", pktio);
+		return -1;
+	}
+
+	batch = &entry->s.out_queue[queue.index].batch;
+
+	if (batch->max == 0)
+		return 0;
+
+	if (odp_unlikely(entry->s.state != PKTIO_STATE_STARTED))
+		return batch->num;
+
+	batch_lock(batch);
+	ret = pktout_batch_flush(entry, queue.index, batch);
+	num = batch->num;
+	batch_unlock(batch);
+
+	if (odp_unlikely(ret < 0))
+		return -1;
+
+	return num;
+}
+
+int odp_pktout_free_slots(odp_pktout_queue_t queue)
+{
+	pktio_entry_t *entry;
+	odp_pktio_t pktio = queue.pktio;
+	pktout_batch_t *batch;
+	int free_slots = -1;
+
+	entry = get_pktio_entry(pktio);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", pktio);
+		return -1;
+	}
+
+	if (odp_unlikely(entry->s.state != PKTIO_STATE_STARTED))
+		return 0;
+
+	batch = &entry->s.out_queue[queue.index].batch;
+
+	if (entry->s.ops->tx_free_slots)
+		free_slots = entry->s.ops->tx_free_slots(entry, queue.index);
+
+	if (batch->max == 0)
+		return free_slots;
+
+	/* Driver ring space is shared with batched packets. Without driver
+	 * support, only the space left in the batch is known to be free. */
+	if (free_slots < 0)
+		return batch->max - batch->num;
 
-	return entry->s.ops->send(entry, queue.index, packets, num);
+	return free_slots > batch->num ? free_slots - batch->num : 0;
 }
 
 /** Get printable format of odp_pktio_t */
@@ -14,14 +14,20 @@
 #include <odp_pcapng.h>
 #include <odp/api/plat/packet_inlines.h>
 #include <odp/api/shared_memory.h>
+#include <odp_align_internal.h>
+#include <odp_debug_internal.h>
 #include <odp_init_internal.h>
+#include <odp_libconfig_internal.h>
 #include <odp_macros_internal.h>
 #include <odp_packet_io_internal.h>
 #include <odp_posix_extensions.h>
+#include <odp_ring_mpmc_internal.h>
+#include <odp/api/atomic.h>
 #include <odp/api/spinlock.h>
 
 #include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
 #include <limits.h>
 #include <pthread.h>
 #include <unistd.h>
@@ -41,6 +47,26 @@
 #define INOTIFY_BUF_LEN (16 * (sizeof(struct inotify_event)))
 #define PCAPNG_WATCH_DIR "/var/run/odp/"
 
+/* Maximum capture ring size */
+#define PCAPNG_MAX_RING_SIZE (16 * 1024)
+
+/* Maximum number of records the writer thread handles per queue and round */
+#define PCAPNG_WRITER_BURST 32
+
+/* Writer thread sleep time when all capture rings are empty */
+#define PCAPNG_WRITER_IDLE_US 1000
+
+/* Ethertypes and header offsets used by the capture filter */
+#define PCAPNG_ETH_TYPE_OFFSET 12
+#define PCAPNG_ETH_HDR_LEN     14
+#define PCAPNG_VLAN_HDR_LEN    4
+#define PCAPNG_ETHTYPE_VLAN       0x8100
+#define PCAPNG_ETHTYPE_VLAN_OUTER 0x88a8
+#define PCAPNG_ETHTYPE_IPV4       0x0800
+#define PCAPNG_ETHTYPE_IPV6       0x86dd
+#define PCAPNG_IPV4_PROTO_OFFSET  9
+#define PCAPNG_IPV6_NEXT_OFFSET   6
+
 /* pcapng: enhanced packet block file encoding */
 typedef struct ODP_PACKED pcapng_section_hdr_block_s {
 	uint32_t block_type;
@@ -71,21 +97,147 @@ typedef struct pcapng_enhanced_packet_block_s {
 	uint32_t packet_len;
 } pcapng_enhanced_packet_block_t;
 
+/* Captured packet. Packet data follows the record header. */
+typedef struct {
+	uint64_t timestamp;
+	uint32_t packet_len;
+	uint32_t captured_len;
+	uint8_t data[];
+} pcapng_record_t;
+
+/* Capture data per pktio queue index. Packet input and output threads
+ * reserve records from the free ring, copy packet data into those and pass
+ * them to the writer thread through the record ring. */
+typedef struct ODP_ALIGNED_CACHE {
+	ring_mpmc_t free_ring;
+	ring_mpmc_t rec_ring;
+	uint32_t *free_data;
+	uint32_t *rec_data;
+	uint8_t *record;
+	uint32_t sample_cnt;
+	odp_atomic_u64_t captured;
+	odp_atomic_u64_t dropped;
+} pcapng_queue_t;
+
+/* Capture data per pktio */
+typedef struct {
+	odp_shm_t shm;
+	uint32_t num_queue;
+	uint32_t ring_mask;
+	uint32_t snap_len;
+	uint32_t record_size;
+	pcapng_queue_t queue[PKTIO_MAX_QUEUES];
+} pcapng_capture_t;
+
 typedef struct ODP_ALIGNED_CACHE {
 	odp_shm_t shm;
 	pktio_entry_t *entry[ODP_CONFIG_PKTIO_ENTRIES];
+	pcapng_capture_t *capture[ODP_CONFIG_PKTIO_ENTRIES];
 	int num_entries;
 	pthread_t inotify_thread;
 	int inotify_fd;
 	int inotify_watch_fd;
 	int inotify_is_running;
+	pthread_t writer_thread;
+	odp_atomic_u32_t writer_stop;
+	int writer_is_running;
 	odp_spinlock_t lock;
+
+	struct {
+		uint32_t snap_len;
+		uint32_t sample_rate;
+		uint32_t ring_size;
+		uint16_t filter_ethertype;
+		uint8_t filter_ip_proto;
+	} config;
+
 } pcapng_global_t;
 
 static pcapng_global_t *pcapng_gbl;
 
 int write_pcapng_hdr(pktio_entry_t *entry, int qidx);
 
+static int read_config_file(pcapng_global_t *gbl)
+{
+	const char *str;
+	int val = 0;
+
+	ODP_PRINT("Pcapng config:\n");
+
+	str = "pktio.pcapng.snap_len";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val < 0 || val > PIPE_BUF) {
+		ODP_ERR("Bad value %s = %i [max: %i]\n", str, val, PIPE_BUF);
+		return -1;
+	}
+
+	gbl->config.snap_len = val;
+	ODP_PRINT("  %s: %i\n", str, val);
+
+	str = "pktio.pcapng.sample_rate";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val < 1) {
+		ODP_ERR("Bad value %s = %i\n", str, val);
+		return -1;
+	}
+
+	gbl->config.sample_rate = val;
+	ODP_PRINT("  %s: %i\n", str, val);
+
+	str = "pktio.pcapng.ring_size";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val < 1 || val > PCAPNG_MAX_RING_SIZE) {
+		ODP_ERR("Bad value %s = %i [min: 1, max: %i]\n", str, val,
+			PCAPNG_MAX_RING_SIZE);
+		return -1;
+	}
+
+	gbl->config.ring_size = ROUNDUP_POWER2_U32((uint32_t)val);
+	ODP_PRINT("  %s: %i\n", str, val);
+
+	str = "pktio.pcapng.filter_ethertype";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val < 0 || val > UINT16_MAX) {
+		ODP_ERR("Bad value %s = %i\n", str, val);
+		return -1;
+	}
+
+	gbl->config.filter_ethertype = val;
+	ODP_PRINT("  %s: 0x%04x\n", str, val);
+
+	str = "pktio.pcapng.filter_ip_proto";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val < 0 || val > UINT8_MAX) {
+		ODP_ERR("Bad value %s = %i\n", str, val);
+		return -1;
+	}
+
+	gbl->config.filter_ip_proto = val;
+	ODP_PRINT("  %s: %i\n\n", str, val);
+
+	return 0;
+}
+
 int _odp_pcapng_init_global(void)
 {
 	odp_shm_t shm;
@@ -100,7 +252,13 @@ int _odp_pcapng_init_global(void)
 	memset(pcapng_gbl, 0, sizeof(pcapng_global_t));
 	pcapng_gbl->shm = shm;
 
+	if (read_config_file(pcapng_gbl)) {
+		odp_shm_free(shm);
+		return -1;
+	}
+
 	odp_spinlock_init(&pcapng_gbl->lock);
+	odp_atomic_init_u32(&pcapng_gbl->writer_stop, 0);
 
 	return 0;
 }
@@ -130,13 +288,18 @@ static void pcapng_drain_fifo(int fd)
 static void inotify_event_handle(pktio_entry_t *entry, int qidx,
 				 struct inotify_event *event)
 {
-	int mtu = MAX(odp_pktin_maxlen(entry->s.handle),
-		      odp_pktout_maxlen(entry->s.handle));
+	pcapng_capture_t *capture;
+
+	capture = pcapng_gbl->capture[odp_pktio_index(entry->s.handle)];
+	if (capture == NULL)
+		return;
 
 	if (event->mask & IN_OPEN) {
 		int ret;
 
-		if (PIPE_BUF < mtu + sizeof(pcapng_enhanced_packet_block_t) +
+		if (PIPE_BUF < ROUNDUP_ALIGN(capture->snap_len,
+					     PCAPNG_DATA_ALIGN) +
+		    sizeof(pcapng_enhanced_packet_block_t) +
 		    sizeof(uint32_t)) {
 			ODP_ERR("PIPE_BUF:%d too small. Disabling pcap\n",
 				PIPE_BUF);
@@ -286,6 +449,204 @@ static int get_fifo_max_size(void)
 	return ret;
 }
 
+static pcapng_capture_t *capture_create(pktio_entry_t *entry,
+					 uint32_t num_queue)
+{
+	pcapng_capture_t *capture;
+	odp_shm_t shm;
+	uint8_t *addr;
+	uint32_t i, j, snap_len, record_size;
+	uint32_t ring_size = pcapng_gbl->config.ring_size;
+	uint32_t mtu = MAX(odp_pktin_maxlen(entry->s.handle),
+			   odp_pktout_maxlen(entry->s.handle));
+	uint64_t ring_len = ROUNDUP_CACHE_LINE(ring_size * sizeof(uint32_t));
+	uint64_t queue_len;
+	char name[ODP_SHM_NAME_LEN];
+
+	/* Capture whole frames when snap length is not set */
+	snap_len = pcapng_gbl->config.snap_len;
+	if (snap_len == 0 || snap_len > mtu)
+		snap_len = mtu;
+
+	record_size = ROUNDUP_CACHE_LINE(sizeof(pcapng_record_t) +
+					 ROUNDUP_ALIGN(snap_len,
+						       PCAPNG_DATA_ALIGN));
+	queue_len = 2 * ring_len + (uint64_t)ring_size * record_size;
+
+	snprintf(name, sizeof(name), "_odp_pcapng_%i",
+		 odp_pktio_index(entry->s.handle));
+
+	shm = odp_shm_reserve(name, sizeof(pcapng_capture_t) +
+			      num_queue * queue_len, ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		ODP_ERR("Capture shm reserve failed\n");
+		return NULL;
+	}
+
+	capture = odp_shm_addr(shm);
+	memset(capture, 0, sizeof(pcapng_capture_t));
+	capture->shm = shm;
+	capture->num_queue = num_queue;
+	capture->ring_mask = ring_size - 1;
+	capture->snap_len = snap_len;
+	capture->record_size = record_size;
+
+	addr = (uint8_t *)capture + sizeof(pcapng_capture_t);
+
+	for (i = 0; i < num_queue; i++) {
+		pcapng_queue_t *queue = &capture->queue[i];
+
+		queue->free_data = (uint32_t *)(uintptr_t)addr;
+		queue->rec_data = (uint32_t *)(uintptr_t)(addr + ring_len);
+		queue->record = addr + 2 * ring_len;
+		addr += queue_len;
+
+		ring_mpmc_init(&queue->free_ring);
+		ring_mpmc_init(&queue->rec_ring);
+		odp_atomic_init_u64(&queue->captured, 0);
+		odp_atomic_init_u64(&queue->dropped, 0);
+
+		for (j = 0; j < ring_size; j++)
+			ring_mpmc_enq_multi(&queue->free_ring, queue->free_data,
+					    capture->ring_mask, &j, 1);
+	}
+
+	return capture;
+}
+
+static void capture_destroy(pktio_entry_t *entry, pcapng_capture_t *capture)
+{
+	uint32_t i;
+
+	for (i = 0; i < capture->num_queue; i++) {
+		pcapng_queue_t *queue = &capture->queue[i];
+
+		ODP_DBG("%s queue %u: captured %" PRIu64 ", dropped %" PRIu64
+			"\n", entry->s.name, i,
+			odp_atomic_load_u64(&queue->captured),
+			odp_atomic_load_u64(&queue->dropped));
+	}
+
+	if (odp_shm_free(capture->shm))
+		ODP_ERR("Capture shm free failed\n");
+}
+
+static inline pcapng_record_t *capture_record(pcapng_capture_t *capture,
+					      pcapng_queue_t *queue,
+					      uint32_t idx)
+{
+	return (pcapng_record_t *)(uintptr_t)
+		(queue->record + (uint64_t)idx * capture->record_size);
+}
+
+/* Write captured records of a queue into its fifo. Records are discarded
+ * when nobody reads the fifo. Returns number of records handled. */
+static int capture_drain(pktio_entry_t *entry, pcapng_capture_t *capture,
+			 uint32_t qidx)
+{
+	pcapng_queue_t *queue = &capture->queue[qidx];
+	uint32_t idx[PCAPNG_WRITER_BURST];
+	pcapng_enhanced_packet_block_t epb[PCAPNG_WRITER_BURST];
+	struct iovec iov[3 * PCAPNG_WRITER_BURST];
+	int fd = entry->s.pcapng.fd[qidx];
+	size_t block_len = 0;
+	int iovcnt = 0;
+	uint32_t num, i;
+
+	num = ring_mpmc_deq_multi(&queue->rec_ring, queue->rec_data,
+				  capture->ring_mask, idx,
+				  PCAPNG_WRITER_BURST);
+	if (num == 0)
+		return 0;
+
+	if (entry->s.pcapng.state[qidx] != PCAPNG_WR_PKT)
+		goto out;
+
+	for (i = 0; i < num; i++) {
+		pcapng_record_t *rec = capture_record(capture, queue, idx[i]);
+		uint32_t data_len = ROUNDUP_ALIGN(rec->captured_len,
+						  PCAPNG_DATA_ALIGN);
+		size_t len = sizeof(epb[i]) + data_len + sizeof(uint32_t);
+
+		/* Each fifo write is less than PIPE_BUF, so that writes are
+		 * atomic in non blocking mode. A failed write only means that
+		 * some packets are missing from the pcap file. */
+		if (block_len + len > PIPE_BUF) {
+			if (writev(fd, iov, iovcnt) < 0)
+				odp_atomic_add_u64(&queue->dropped, iovcnt / 3);
+
+			block_len = 0;
+			iovcnt = 0;
+		}
+
+		epb[i].block_type = PCAPNG_BLOCK_TYPE_EPB;
+		epb[i].block_total_length = len;
+		epb[i].interface_idx = 0;
+		epb[i].timestamp_high = (uint32_t)(rec->timestamp >> 32);
+		epb[i].timestamp_low = (uint32_t)(rec->timestamp);
+		epb[i].captured_len = rec->captured_len;
+		epb[i].packet_len = rec->packet_len;
+
+		/* epb */
+		iov[iovcnt].iov_base = &epb[i];
+		iov[iovcnt].iov_len = sizeof(epb[i]);
+		iovcnt++;
+
+		/* data */
+		iov[iovcnt].iov_base = rec->data;
+		iov[iovcnt].iov_len = data_len;
+		iovcnt++;
+
+		/* trailing */
+		iov[iovcnt].iov_base = &epb[i].block_total_length;
+		iov[iovcnt].iov_len = sizeof(uint32_t);
+		iovcnt++;
+
+		block_len += len;
+	}
+
+	if (iovcnt && writev(fd, iov, iovcnt) < 0)
+		odp_atomic_add_u64(&queue->dropped, iovcnt / 3);
+
+out:
+	ring_mpmc_enq_multi(&queue->free_ring, queue->free_data,
+			    capture->ring_mask, idx, num);
+
+	return num;
+}
+
+/* Writer thread moves captured packets from capture rings to fifos, so
+ * that packet input and output never wait for file I/O. */
+static void *writer_update(void *arg ODP_UNUSED)
+{
+	int i, num;
+	uint32_t qidx;
+
+	while (!odp_atomic_load_u32(&pcapng_gbl->writer_stop)) {
+		num = 0;
+
+		odp_spinlock_lock(&pcapng_gbl->lock);
+
+		for (i = 0; i < ODP_CONFIG_PKTIO_ENTRIES; i++) {
+			pktio_entry_t *entry = pcapng_gbl->entry[i];
+			pcapng_capture_t *capture = pcapng_gbl->capture[i];
+
+			if (entry == NULL || capture == NULL)
+				continue;
+
+			for (qidx = 0; qidx < capture->num_queue; qidx++)
+				num += capture_drain(entry, capture, qidx);
+		}
+
+		odp_spinlock_unlock(&pcapng_gbl->lock);
+
+		if (num == 0)
+			usleep(PCAPNG_WRITER_IDLE_US);
+	}
+
+	return NULL;
+}
+
 int _odp_pcapng_start(pktio_entry_t *entry)
 {
 	int ret = -1, fd;
@@ -294,6 +655,12 @@ int _odp_pcapng_start(pktio_entry_t *entry)
 	unsigned int max_queue =
 		MAX(entry->s.num_in_queue, entry->s.num_out_queue);
 	int fifo_sz;
+	int idx = odp_pktio_index(entry->s.handle);
+	pcapng_capture_t *capture;
+
+	capture = capture_create(entry, max_queue);
+	if (capture == NULL)
+		return -1;
 
 	fifo_sz = get_fifo_max_size();
 	if (fifo_sz < 0)
@@ -341,10 +708,14 @@ int _odp_pcapng_start(pktio_entry_t *entry)
 
 	odp_spinlock_lock(&pcapng_gbl->lock);
 
+	/* Entry is registered before the threads are started, so that
+	 * _odp_pcapng_stop() releases all state on failure */
+	pcapng_gbl->capture[idx] = capture;
+	pcapng_gbl->entry[idx] = entry;
+	pcapng_gbl->num_entries++;
+
 	/* already running from a previous pktio */
 	if (pcapng_gbl->inotify_is_running == 1) {
-		pcapng_gbl->entry[odp_pktio_index(entry->s.handle)] = entry;
-		pcapng_gbl->num_entries++;
 		odp_spinlock_unlock(&pcapng_gbl->lock);
 		return 0;
 	}
@@ -374,15 +745,25 @@ int _odp_pcapng_start(pktio_entry_t *entry)
 			     &pcapng_gbl->inotify_fd);
 	if (ret) {
 		ODP_ERR("Can't start inotify thread (ret=%d). pcapng disabled.\n", ret);
-	} else {
-		pcapng_gbl->entry[odp_pktio_index(entry->s.handle)] = entry;
-		pcapng_gbl->num_entries++;
-		pcapng_gbl->inotify_is_running = 1;
+		goto out_destroy;
 	}
 
+	pcapng_gbl->inotify_is_running = 1;
+
+	/* create a thread to write captured packets into fifos */
+	odp_atomic_store_u32(&pcapng_gbl->writer_stop, 0);
+	ret = pthread_create(&pcapng_gbl->writer_thread, &attr, writer_update,
+			     NULL);
+	if (ret) {
+		ODP_ERR("Can't start writer thread (ret=%d). pcapng disabled.\n", ret);
+		goto out_destroy;
+	}
+
+	pcapng_gbl->writer_is_running = 1;
+
 	odp_spinlock_unlock(&pcapng_gbl->lock);
 
-	return ret;
+	return 0;
 
 out_destroy:
 	odp_spinlock_unlock(&pcapng_gbl->lock);
@@ -398,12 +779,27 @@ void _odp_pcapng_stop(pktio_entry_t *entry)
 	unsigned int i;
 	unsigned int max_queue =
 		MAX(entry->s.num_in_queue, entry->s.num_out_queue);
+	int idx = odp_pktio_index(entry->s.handle);
+	pcapng_capture_t *capture;
+	int stop_writer = 0;
+
+	for (i = 0; i < max_queue; i++)
+		entry->s.pcapng.state[i] = PCAPNG_WR_STOP;
 
 	odp_spinlock_lock(&pcapng_gbl->lock);
 
-	pcapng_gbl->entry[odp_pktio_index(entry->s.handle)] = NULL;
+	capture = pcapng_gbl->capture[idx];
+	pcapng_gbl->capture[idx] = NULL;
+	pcapng_gbl->entry[idx] = NULL;
 	pcapng_gbl->num_entries--;
 
+	/* Writer thread is joined after releasing the lock */
+	if (pcapng_gbl->writer_is_running == 1 &&
+	    pcapng_gbl->num_entries == 0) {
+		pcapng_gbl->writer_is_running = 0;
+		stop_writer = 1;
+	}
+
 	if (pcapng_gbl->inotify_is_running == 1 &&
 	    pcapng_gbl->num_entries == 0) {
 		ret = pthread_cancel(pcapng_gbl->inotify_thread);
@@ -430,11 +826,22 @@ void _odp_pcapng_stop(pktio_entry_t *entry)
 
 	odp_spinlock_unlock(&pcapng_gbl->lock);
 
+	if (stop_writer) {
+		odp_atomic_store_u32(&pcapng_gbl->writer_stop, 1);
+		ret = pthread_join(pcapng_gbl->writer_thread, NULL);
+		if (ret)
+			ODP_ERR("can't join writer thread %s\n",
+				strerror(ret));
+	}
+
+	/* Writer thread does not access the capture data anymore */
+	if (capture)
+		capture_destroy(entry, capture);
+
 	for (i = 0; i < max_queue; i++) {
 		char pcapng_name[128];
 		char pcapng_path[256];
 
-		entry->s.pcapng.state[i] = PCAPNG_WR_STOP;
 		close(entry->s.pcapng.fd[i]);
 
 		get_pcapng_fifo_name(pcapng_name, sizeof(pcapng_name),
@@ -477,7 +884,7 @@ int write_pcapng_hdr(pktio_entry_t *entry, int qidx)
 	idb.block_total_length = sizeof(idb);
 	idb.block_total_length2 = sizeof(idb);
 	idb.linktype = PCAPNG_LINKTYPE_ETHERNET;
-	idb.snaplen = 0x0; /* unlimited */
+	idb.snaplen = pcapng_gbl->config.snap_len; /* 0: unlimited */
 	len = write(fd, &idb, sizeof(idb));
 	if (len != sizeof(idb)) {
 		ODP_ERR("Failed to write pcapng interface description\n");
@@ -488,93 +895,125 @@ int write_pcapng_hdr(pktio_entry_t *entry, int qidx)
 	return 0;
 }
 
-/*
- * make sure that each fifo write is less than PIPE_BUF
- * this will make sure writes are atomic (on non blocking mode).
- * writev() transfers all the data and returns the number of bytes requested or
- * -EAGAIN
- */
-static ssize_t write_fifo(int fd, struct iovec *iov, int iovcnt)
+/* Match packet headers against the capture filter. Only headers in the first
+ * segment are checked. */
+static inline int capture_filter_match(odp_packet_t pkt)
 {
-	ssize_t len = 0;
-
-	len = writev(fd, iov, iovcnt);
-	/*
-	 * we don't care if a writev fails, we asynchronously read the fifo
-	 * so the next block of packets might be successful. This error only
-	 * means that some packets failed to append on the pcap file
-	 */
-	if (len > 0)
-		fsync(fd);
-
-	return len;
+	uint16_t ethertype = pcapng_gbl->config.filter_ethertype;
+	uint8_t ip_proto = pcapng_gbl->config.filter_ip_proto;
+	uint32_t seg_len, offset;
+	uint16_t type;
+	const uint8_t *data;
+
+	data = odp_packet_offset(pkt, 0, &seg_len, NULL);
+
+	if (seg_len < PCAPNG_ETH_HDR_LEN)
+		return 0;
+
+	offset = PCAPNG_ETH_TYPE_OFFSET;
+	type = (data[offset] << 8) | data[offset + 1];
+
+	if (type == PCAPNG_ETHTYPE_VLAN || type == PCAPNG_ETHTYPE_VLAN_OUTER) {
+		offset += PCAPNG_VLAN_HDR_LEN;
+
+		if (seg_len < offset + 2)
+			return 0;
+
+		type = (data[offset] << 8) | data[offset + 1];
+	}
+
+	if (ethertype && type != ethertype)
+		return 0;
+
+	if (ip_proto == 0)
+		return 1;
+
+	/* L3 header follows ethertype */
+	offset += 2;
+
+	if (type == PCAPNG_ETHTYPE_IPV4)
+		offset += PCAPNG_IPV4_PROTO_OFFSET;
+	else if (type == PCAPNG_ETHTYPE_IPV6)
+		offset += PCAPNG_IPV6_NEXT_OFFSET;
+	else
+		return 0;
+
+	if (seg_len <= offset)
+		return 0;
+
+	return data[offset] == ip_proto;
 }
 
+/*
+ * Capture packets into the capture ring of the queue. Only the snap length of
+ * packet data is copied. The writer thread writes captured packets into the
+ * fifo. Packets are dropped when the ring is full.
+ */
 int _odp_pcapng_write_pkts(pktio_entry_t *entry, int qidx,
 			   const odp_packet_t packets[], int num)
 {
-	int i = 0;
-	struct iovec packet_iov[3 * num];
-	pcapng_enhanced_packet_block_t epb[num];
-	int iovcnt = 0;
-	ssize_t block_len = 0;
-	int fd = entry->s.pcapng.fd[qidx];
-	ssize_t len = 0, wlen;
+	pcapng_capture_t *capture;
+	pcapng_queue_t *queue;
+	const odp_packet_t *pkt[num];
+	uint32_t idx[num];
+	uint32_t sample_rate = pcapng_gbl->config.sample_rate;
+	int filter = pcapng_gbl->config.filter_ethertype ||
+		     pcapng_gbl->config.filter_ip_proto;
+	uint32_t num_pkt = 0;
+	uint32_t num_rec, i;
+	int n;
+
+	capture = pcapng_gbl->capture[odp_pktio_index(entry->s.handle)];
+	if (odp_unlikely(capture == NULL))
+		return 0;
 
-	for (i = 0; i < num; i++) {
-		odp_packet_hdr_t *pkt_hdr = packet_hdr(packets[i]);
-		uint32_t seg_len;
-		char *buf = (char *)odp_packet_offset(packets[i], 0, &seg_len,
-						      NULL);
-
-		if (block_len + sizeof(epb[i]) +
-		    ROUNDUP_ALIGN(seg_len, PCAPNG_DATA_ALIGN) +
-		    sizeof(uint32_t) > PIPE_BUF) {
-			wlen = write_fifo(fd, packet_iov, iovcnt);
-			if (wlen > 0) {
-				len += wlen;
-				block_len = 0;
-				iovcnt = 0;
-			}
+	queue = &capture->queue[qidx];
+
+	for (n = 0; n < num; n++) {
+		if (sample_rate > 1) {
+			/* Sample counter is updated without synchronization.
+			 * Sampling is approximate on multi-thread safe
+			 * queues. */
+			if (++queue->sample_cnt < sample_rate)
+				continue;
+
+			queue->sample_cnt = 0;
 		}
-		epb[i].block_type = PCAPNG_BLOCK_TYPE_EPB;
-		epb[i].block_total_length = sizeof(epb[i]) +
-			ROUNDUP_ALIGN(seg_len, PCAPNG_DATA_ALIGN) +
-			PCAPNG_DATA_ALIGN;
-		epb[i].interface_idx = 0;
-		epb[i].timestamp_high =
-			(uint32_t)(pkt_hdr->timestamp.u64 >> 32);
-		epb[i].timestamp_low = (uint32_t)(pkt_hdr->timestamp.u64);
-		epb[i].captured_len = seg_len;
-		epb[i].packet_len = seg_len;
 
-		/* epb */
-		packet_iov[iovcnt].iov_base = &epb[i];
-		packet_iov[iovcnt].iov_len = sizeof(epb[i]);
-		block_len += packet_iov[iovcnt].iov_len;
-		iovcnt++;
+		if (filter && !capture_filter_match(packets[n]))
+			continue;
 
-		/* data */
-		packet_iov[iovcnt].iov_base = buf;
-		packet_iov[iovcnt].iov_len =
-			ROUNDUP_ALIGN(seg_len, PCAPNG_DATA_ALIGN);
-		block_len += packet_iov[iovcnt].iov_len;
-		iovcnt++;
+		pkt[num_pkt++] = &packets[n];
+	}
 
-		/* trailing */
-		packet_iov[iovcnt].iov_base = &epb[i].block_total_length;
-		packet_iov[iovcnt].iov_len = sizeof(uint32_t);
-		block_len += packet_iov[iovcnt].iov_len;
-		iovcnt++;
+	if (num_pkt == 0)
+		return 0;
+
+	num_rec = ring_mpmc_deq_multi(&queue->free_ring, queue->free_data,
+				      capture->ring_mask, idx, num_pkt);
+
+	if (odp_unlikely(num_rec < num_pkt))
+		odp_atomic_add_u64(&queue->dropped, num_pkt - num_rec);
+
+	for (i = 0; i < num_rec; i++) {
+		odp_packet_hdr_t *pkt_hdr = packet_hdr(*pkt[i]);
+		pcapng_record_t *rec = capture_record(capture, queue, idx[i]);
+		uint32_t pkt_len = odp_packet_len(*pkt[i]);
+		uint32_t cap_len = MIN(pkt_len, capture->snap_len);
+
+		rec->timestamp = pkt_hdr->timestamp.u64;
+		rec->packet_len = pkt_len;
+		rec->captured_len = cap_len;
+		odp_packet_copy_to_mem(*pkt[i], 0, cap_len, rec->data);
 	}
 
-	if (iovcnt) {
-		wlen = write_fifo(fd, packet_iov, iovcnt);
-		if (wlen > 0)
-			len += wlen;
+	if (num_rec) {
+		ring_mpmc_enq_multi(&queue->rec_ring, queue->rec_data,
+				    capture->ring_mask, idx, num_rec);
+		odp_atomic_add_u64(&queue->captured, num_rec);
 	}
 
-	return len;
+	return num_rec;
 }
 
 #endif /* _ODP_PCAPNG */
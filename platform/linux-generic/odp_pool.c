@@ -242,6 +242,15 @@ static int read_config_file(pool_global_t *pool_glb)
 	pool_glb->config.pkt_base_align = align;
 	ODP_PRINT("  %s: %u\n", str, align);
 
+	str = "pool.pkt.separate_hdr";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	pool_glb->config.pkt_separate_hdr = !!val;
+	ODP_PRINT("  %s: %i\n", str, val);
+
 	str = "pool.buf.min_align";
 	if (!_odp_libconfig_lookup_int(str, &val)) {
 		ODP_ERR("Config option '%s' not found.\n", str);
@@ -411,6 +420,7 @@ static void init_buffers(pool_t *pool)
 	odp_event_vector_hdr_t *vect_hdr;
 	odp_shm_info_t shm_info;
 	void *addr;
+	void *block;
 	void *uarea = NULL;
 	uint8_t *data;
 	uint32_t offset;
@@ -419,6 +429,7 @@ static void init_buffers(pool_t *pool)
 	int type;
 	uint64_t page_size;
 	int skipped_blocks = 0;
+	int separate_hdr = pool->separate_hdr;
 
 	if (odp_shm_info(pool->shm, &shm_info))
 		ODP_ABORT("Shm info failed\n");
@@ -431,8 +442,9 @@ static void init_buffers(pool_t *pool)
 	for (i = 0; i < pool->num + skipped_blocks ; i++) {
 		int skip = 0;
 
-		addr    = &pool->base_addr[(i * pool->block_size) +
+		block   = &pool->base_addr[(i * pool->block_size) +
 					   pool->block_offset];
+		addr    = &pool->hdr_base_addr[i * pool->hdr_stride];
 		buf_hdr = addr;
 		pkt_hdr = addr;
 		vect_hdr = addr;
@@ -443,9 +455,9 @@ static void init_buffers(pool_t *pool)
 			uint64_t first_page;
 			uint64_t last_page;
 
-			first_page = ((uint64_t)(uintptr_t)addr &
+			first_page = ((uint64_t)(uintptr_t)block &
 					~(page_size - 1));
-			last_page = (((uint64_t)(uintptr_t)addr +
+			last_page = (((uint64_t)(uintptr_t)block +
 					pool->block_size - 1) &
 					~(page_size - 1));
 			if (last_page != first_page) {
@@ -461,13 +473,20 @@ static void init_buffers(pool_t *pool)
 		if (type == ODP_POOL_PACKET)
 			data = pkt_hdr->data;
 
+		/* Block contains only data */
+		if (separate_hdr)
+			data = block;
+
 		offset = pool->headroom;
 
 		/* move to correct align */
 		while (((uintptr_t)&data[offset]) % pool->align != 0)
 			offset++;
 
-		memset(buf_hdr, 0, (uintptr_t)data - (uintptr_t)buf_hdr);
+		if (separate_hdr)
+			memset(buf_hdr, 0, pool->hdr_stride);
+		else
+			memset(buf_hdr, 0, (uintptr_t)data - (uintptr_t)buf_hdr);
 
 		/* Initialize buffer metadata */
 		buf_hdr->index.u32    = 0;
@@ -523,7 +542,7 @@ static bool shm_is_from_huge_pages(odp_shm_t shm)
 }
 
 static odp_pool_t pool_create(const char *name, const odp_pool_param_t *params,
-			      uint32_t shmflags)
+			      uint32_t shmflags, odp_bool_t size_class)
 {
 	pool_t *pool;
 	uint32_t uarea_size, headroom, tailroom;
@@ -536,6 +555,7 @@ static odp_pool_t pool_create(const char *name, const odp_pool_param_t *params,
 	int max_prefix_len = strlen(max_prefix);
 	char shm_name[ODP_POOL_NAME_LEN + max_prefix_len];
 	char uarea_name[ODP_POOL_NAME_LEN + max_prefix_len];
+	int separate_hdr = 0;
 
 	align = 0;
 
@@ -593,8 +613,12 @@ static odp_pool_t pool_create(const char *name, const odp_pool_param_t *params,
 			seg_len = params->pkt.len;
 		if (params->pkt.seg_len && params->pkt.seg_len > seg_len)
 			seg_len = params->pkt.seg_len;
-		if (seg_len < CONFIG_PACKET_SEG_LEN_MIN)
+		if (size_class) {
+			if (seg_len < CONFIG_PACKET_CLASS_SEG_LEN_MIN)
+				seg_len = CONFIG_PACKET_CLASS_SEG_LEN_MIN;
+		} else if (seg_len < CONFIG_PACKET_SEG_LEN_MIN) {
 			seg_len = CONFIG_PACKET_SEG_LEN_MIN;
+		}
 
 		/* Make sure that at least one 'max_len' packet can fit in the
 		 * pool. */
@@ -661,9 +685,13 @@ static odp_pool_t pool_create(const char *name, const odp_pool_param_t *params,
 		hdr_size = ROUNDUP_CACHE_LINE(sizeof(odp_packet_hdr_t));
 		block_size = hdr_size + align + headroom + seg_len + tailroom;
 		/* Calculate extra space required for storing DPDK objects and
-		 * mbuf headers. NOP if no DPDK pktio used or zero-copy mode is
-		 * disabled. */
-		dpdk_obj_size = _odp_dpdk_pool_obj_size(pool, block_size);
+		 * mbuf headers. NOP if no DPDK pktio used, zero-copy mode is
+		 * disabled or pool parameters are not compatible with DPDK.
+		 * Size classes are not mapped to DPDK mempools. */
+		dpdk_obj_size = block_size;
+		if (!size_class)
+			dpdk_obj_size = _odp_dpdk_pool_obj_size(pool, block_size,
+								seg_len);
 		if (!dpdk_obj_size) {
 			ODP_ERR("Calculating DPDK mempool obj size failed\n");
 			return ODP_POOL_INVALID;
@@ -671,6 +699,12 @@ static odp_pool_t pool_create(const char *name, const odp_pool_param_t *params,
 		if (dpdk_obj_size != block_size) {
 			shmflags |= ODP_SHM_HP;
 			block_size = dpdk_obj_size;
+		} else if (_odp_pool_glb->config.pkt_separate_hdr) {
+			/* Packet headers are stored in a separate array. DPDK
+			 * zero-copy layout requires headers inside blocks. */
+			separate_hdr = 1;
+			block_size = ROUNDUP_CACHE_LINE(align + headroom +
+							seg_len + tailroom);
 		} else {
 			block_size = ROUNDUP_CACHE_LINE(block_size);
 		}
@@ -717,9 +751,22 @@ static odp_pool_t pool_create(const char *name, const odp_pool_param_t *params,
 	pool->block_size     = block_size;
 	pool->uarea_size     = uarea_size;
 	pool->shm_size       = (num + num_extra) * (uint64_t)block_size;
+	pool->hdr_stride     = block_size;
 	pool->uarea_shm_size = num * (uint64_t)uarea_size;
 	pool->ext_desc       = NULL;
 	pool->ext_destroy    = NULL;
+	pool->num_class      = 1;
+	pool->class_pool[0]  = pool;
+	pool->class_parent   = NULL;
+	pool->separate_hdr   = separate_hdr;
+
+	/* Header array is stored in the same shm block after the data blocks.
+	 * Header size is a multiple of cache line size, and so is block size,
+	 * so that headers are cache line aligned. */
+	if (separate_hdr) {
+		pool->hdr_stride = hdr_size;
+		pool->shm_size  += (num + num_extra) * (uint64_t)hdr_size;
+	}
 
 	pool->cache_size = 0;
 	pool->burst_size = 1;
@@ -749,6 +796,12 @@ static odp_pool_t pool_create(const char *name, const odp_pool_param_t *params,
 
 	pool->base_addr = odp_shm_addr(pool->shm);
 	pool->max_addr  = pool->base_addr + pool->shm_size - 1;
+	pool->hdr_base_addr = pool->base_addr + pool->block_offset;
+	pool->hdr_max_addr  = pool->max_addr;
+
+	if (separate_hdr)
+		pool->hdr_base_addr = pool->base_addr +
+				      (num + num_extra) * (uint64_t)block_size;
 
 	pool->uarea_shm = ODP_SHM_INVALID;
 	if (uarea_size) {
@@ -766,10 +819,14 @@ static odp_pool_t pool_create(const char *name, const odp_pool_param_t *params,
 	}
 
 	ring_ptr_init(&pool->ring->hdr);
+	pool->pkt_reset = params->type == ODP_POOL_PACKET;
+	odp_atomic_init_u32(&pool->refs_used, 0);
 	init_buffers(pool);
 
-	/* Create zero-copy DPDK memory pool. NOP if zero-copy is disabled. */
-	if (params->type == ODP_POOL_PACKET && _odp_dpdk_pool_create(pool)) {
+	/* Create zero-copy DPDK memory pool. NOP if zero-copy is disabled or
+	 * pool layout is not compatible. */
+	if (params->type == ODP_POOL_PACKET && !size_class &&
+	    _odp_dpdk_pool_create(pool)) {
 		ODP_ERR("Creating DPDK packet pool failed\n");
 		goto error;
 	}
@@ -796,6 +853,156 @@ error:
 	return ODP_POOL_INVALID;
 }
 
+static int pool_destroy(pool_t *pool)
+{
+	int i;
+
+	LOCK(&pool->lock);
+
+	if (pool->reserved == 0) {
+		UNLOCK(&pool->lock);
+		ODP_ERR("Pool not created\n");
+		return -1;
+	}
+
+	/* Destroy external DPDK mempool */
+	if (pool->ext_destroy) {
+		pool->ext_destroy(pool->ext_desc);
+		pool->ext_destroy = NULL;
+		pool->ext_desc = NULL;
+	}
+
+	/* Make sure local caches are empty */
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		cache_flush(&pool->local_cache[i], pool);
+
+	odp_shm_free(pool->shm);
+
+	if (pool->uarea_shm != ODP_SHM_INVALID)
+		odp_shm_free(pool->uarea_shm);
+
+	/* Hidden size classes get back their own handle */
+	pool->pool_hdl = pool_index_to_handle(pool->pool_idx);
+	pool->class_parent = NULL;
+	pool->num_class = 0;
+
+	pool->reserved = 0;
+	odp_shm_free(pool->ring_shm);
+	pool->ring = NULL;
+	UNLOCK(&pool->lock);
+
+	return 0;
+}
+
+/* Create a packet pool with multiple size classes. The first class (pkt.num
+ * and pkt.len) is the pool itself and each subparameter adds a hidden pool
+ * with its own ring and local caches. Classes share the pool handle, so that
+ * odp_packet_pool() and pool lookup see only the first class. */
+static odp_pool_t pool_create_multi(const char *name,
+				    const odp_pool_param_t *params,
+				    uint32_t shmflags)
+{
+	odp_pool_param_t class_param;
+	pool_t *class_pool[POOL_MAX_CLASSES];
+	pool_t *pool;
+	odp_pool_t pool_hdl;
+	uint32_t num_class = 0;
+	uint32_t i;
+
+	for (i = 0; i <= params->pkt.num_subparam; i++) {
+		class_param = *params;
+		class_param.pkt.num_subparam = 0;
+		class_param.pkt.max_num = 0;
+
+		if (i > 0) {
+			const odp_pool_pkt_subparam_t *sub = &params->pkt.sub[i - 1];
+
+			/* Nothing to store into an empty class */
+			if (sub->num == 0)
+				continue;
+
+			class_param.pkt.num = sub->num;
+			class_param.pkt.len = sub->len;
+		}
+
+		pool_hdl = pool_create(i == 0 ? name : NULL, &class_param,
+				       shmflags, true);
+
+		if (pool_hdl == ODP_POOL_INVALID)
+			goto error;
+
+		class_pool[num_class++] = pool_entry_from_hdl(pool_hdl);
+	}
+
+	pool = class_pool[0];
+	pool->params = *params;
+	pool->num_class = num_class;
+
+	for (i = 0; i < num_class; i++) {
+		pool->class_pool[i] = class_pool[i];
+
+		if (i > 0) {
+			class_pool[i]->pool_hdl = pool->pool_hdl;
+			class_pool[i]->class_parent = pool;
+		}
+	}
+
+	return pool->pool_hdl;
+
+error:
+	for (i = 0; i < num_class; i++)
+		pool_destroy(class_pool[i]);
+
+	return ODP_POOL_INVALID;
+}
+
+static int check_subparams(const odp_pool_param_t *params,
+			   const odp_pool_capability_t *capa)
+{
+	uint64_t num_total = params->pkt.num;
+	uint32_t len = params->pkt.len;
+	int i;
+
+	if (params->pkt.num_subparam == 0)
+		return 0;
+
+	if (len == 0) {
+		ODP_ERR("pkt.len required with subparameters\n");
+		return -1;
+	}
+
+	for (i = 0; i < params->pkt.num_subparam; i++) {
+		const odp_pool_pkt_subparam_t *sub = &params->pkt.sub[i];
+
+		if (sub->len < len) {
+			ODP_ERR("pkt.sub[%i].len not in ascending order %u\n",
+				i, sub->len);
+			return -1;
+		}
+
+		if (sub->len > capa->pkt.max_len) {
+			ODP_ERR("pkt.sub[%i].len too large %u\n", i, sub->len);
+			return -1;
+		}
+
+		if (sub->num > capa->pkt.max_num) {
+			ODP_ERR("pkt.sub[%i].num too large %u\n", i, sub->num);
+			return -1;
+		}
+
+		len = sub->len;
+		num_total += sub->num;
+	}
+
+	if (params->pkt.max_num && num_total > params->pkt.max_num) {
+		ODP_ERR("Total number of packets exceeds pkt.max_num %u\n",
+			params->pkt.max_num);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int check_params(const odp_pool_param_t *params)
 {
 	odp_pool_capability_t capa;
@@ -880,6 +1087,15 @@ static int check_params(const odp_pool_param_t *params)
 			return -1;
 		}
 
+		if (params->pkt.num_subparam > capa.pkt.max_num_subparam) {
+			ODP_ERR("pkt.num_subparam too large %u\n",
+				params->pkt.num_subparam);
+			return -1;
+		}
+
+		if (check_subparams(params, &capa))
+			return -1;
+
 		if (params->stats.all & ~capa.pkt.stats.all) {
 			ODP_ERR("Unsupported pool statistics counter\n");
 			return -1;
@@ -964,45 +1180,31 @@ odp_pool_t odp_pool_create(const char *name, const odp_pool_param_t *params)
 	if (odp_global_ro.shm_single_va)
 		shm_flags |= ODP_SHM_SINGLE_VA;
 
-	return pool_create(name, params, shm_flags);
+	if (params->type == ODP_POOL_PACKET && params->pkt.num_subparam)
+		return pool_create_multi(name, params, shm_flags);
+
+	return pool_create(name, params, shm_flags, false);
 }
 
 int odp_pool_destroy(odp_pool_t pool_hdl)
 {
 	pool_t *pool = pool_entry_from_hdl(pool_hdl);
-	int i;
+	pool_t *class_pool[POOL_MAX_CLASSES];
+	uint32_t num_class, i;
 
 	if (pool == NULL)
 		return -1;
 
-	LOCK(&pool->lock);
-
-	if (pool->reserved == 0) {
-		UNLOCK(&pool->lock);
-		ODP_ERR("Pool not created\n");
-		return -1;
-	}
+	num_class = pool->num_class;
 
-	/* Destroy external DPDK mempool */
-	if (pool->ext_destroy) {
-		pool->ext_destroy(pool->ext_desc);
-		pool->ext_destroy = NULL;
-		pool->ext_desc = NULL;
-	}
+	for (i = 1; i < num_class; i++)
+		class_pool[i] = pool->class_pool[i];
 
-	/* Make sure local caches are empty */
-	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
-		cache_flush(&pool->local_cache[i], pool);
-
-	odp_shm_free(pool->shm);
-
-	if (pool->uarea_shm != ODP_SHM_INVALID)
-		odp_shm_free(pool->uarea_shm);
+	if (pool_destroy(pool))
+		return -1;
 
-	pool->reserved = 0;
-	odp_shm_free(pool->ring_shm);
-	pool->ring = NULL;
-	UNLOCK(&pool->lock);
+	for (i = 1; i < num_class; i++)
+		pool_destroy(class_pool[i]);
 
 	return 0;
 }
@@ -1026,7 +1228,8 @@ odp_pool_t odp_pool_lookup(const char *name)
 		pool = pool_entry(i);
 
 		LOCK(&pool->lock);
-		if (strcmp(name, pool->name) == 0) {
+		if (pool->class_parent == NULL &&
+		    strcmp(name, pool->name) == 0) {
 			/* found it */
 			UNLOCK(&pool->lock);
 			return pool->pool_hdl;
@@ -1040,6 +1243,7 @@ odp_pool_t odp_pool_lookup(const char *name)
 int odp_pool_info(odp_pool_t pool_hdl, odp_pool_info_t *info)
 {
 	pool_t *pool = pool_entry_from_hdl(pool_hdl);
+	uint32_t i;
 
 	if (pool == NULL || info == NULL)
 		return -1;
@@ -1053,6 +1257,17 @@ int odp_pool_info(odp_pool_t pool_hdl, odp_pool_info_t *info)
 	info->min_data_addr = (uintptr_t)pool->base_addr;
 	info->max_data_addr = (uintptr_t)pool->max_addr;
 
+	for (i = 1; i < pool->num_class; i++) {
+		pool_t *class = pool->class_pool[i];
+
+		info->pkt.max_num += class->num;
+
+		if ((uintptr_t)class->base_addr < info->min_data_addr)
+			info->min_data_addr = (uintptr_t)class->base_addr;
+		if ((uintptr_t)class->max_addr > info->max_data_addr)
+			info->max_data_addr = (uintptr_t)class->max_addr;
+	}
+
 	return 0;
 }
 
@@ -1119,6 +1334,22 @@ int _odp_buffer_alloc_multi(pool_t *pool, odp_buffer_hdr_t *buf_hdr[], int max_n
 	return num_alloc;
 }
 
+/* Reset segmentation metadata of freed packet headers, so that single
+ * segment packets can be allocated without initializing the segments. The
+ * headers are likely in cache after the free call. */
+static inline void packet_hdr_reset(odp_buffer_hdr_t *buf_hdr[], int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		odp_packet_hdr_t *pkt_hdr = (odp_packet_hdr_t *)buf_hdr[i];
+
+		pkt_hdr->seg_data  = buf_hdr[i]->base_data;
+		pkt_hdr->seg_next  = NULL;
+		pkt_hdr->seg_count = 1;
+	}
+}
+
 static inline void buffer_free_to_pool(pool_t *pool,
 				       odp_buffer_hdr_t *buf_hdr[], int num)
 {
@@ -1128,6 +1359,9 @@ static inline void buffer_free_to_pool(pool_t *pool,
 	uint32_t cache_num, mask;
 	uint32_t cache_size = pool->cache_size;
 
+	if (pool->pkt_reset)
+		packet_hdr_reset(buf_hdr, num);
+
 	/* Special case of a very large free. Move directly to
 	 * the global pool. */
 	if (odp_unlikely(num > (int)cache_size)) {
@@ -1171,6 +1405,12 @@ static inline void buffer_free_to_pool(pool_t *pool,
 		odp_atomic_inc_u64(&pool->stats.cache_free_ops);
 }
 
+void _odp_buffer_free_to_pool(pool_t *pool, odp_buffer_hdr_t *buf_hdr[],
+			      int num)
+{
+	buffer_free_to_pool(pool, buf_hdr, num);
+}
+
 void _odp_buffer_free_multi(odp_buffer_hdr_t *buf_hdr[], int num_total)
 {
 	pool_t *pool;
@@ -1282,6 +1522,7 @@ int odp_pool_capability(odp_pool_capability_t *capa)
 	capa->pkt.max_seg_len      = max_seg_len;
 	capa->pkt.max_uarea_size   = MAX_SIZE;
 	capa->pkt.min_cache_size   = 0;
+	capa->pkt.max_num_subparam = ODP_POOL_MAX_SUBPARAMS;
 	capa->pkt.max_cache_size   = CONFIG_POOL_CACHE_MAX_SIZE;
 	capa->pkt.stats.all = supported_stats.all;
 
@@ -1334,10 +1575,28 @@ void odp_pool_print(odp_pool_t pool_hdl)
 	ODP_PRINT("  shm size        %" PRIu64 "\n", pool->shm_size);
 	ODP_PRINT("  base addr       %p\n", pool->base_addr);
 	ODP_PRINT("  max addr        %p\n", pool->max_addr);
+	ODP_PRINT("  header layout   %s\n",
+		  pool->separate_hdr ? "separate" : "in block");
+	if (pool->separate_hdr)
+		ODP_PRINT("  hdr base addr   %p\n", pool->hdr_base_addr);
 	ODP_PRINT("  uarea shm size  %" PRIu64 "\n", pool->uarea_shm_size);
 	ODP_PRINT("  uarea base addr %p\n", pool->uarea_base_addr);
 	ODP_PRINT("  cache size      %u\n", pool->cache_size);
 	ODP_PRINT("  burst size      %u\n", pool->burst_size);
+
+	if (pool->num_class > 1) {
+		uint32_t i;
+
+		ODP_PRINT("  size classes    %u\n", pool->num_class);
+
+		for (i = 0; i < pool->num_class; i++) {
+			pool_t *class = pool->class_pool[i];
+
+			ODP_PRINT("    class %u: seg len %u, block size %u, num %u\n",
+				  i, class->seg_len, class->block_size, class->num);
+		}
+	}
+
 	ODP_PRINT("\n");
 }
 
@@ -1384,6 +1643,7 @@ int odp_pool_index(odp_pool_t pool_hdl)
 int odp_pool_stats(odp_pool_t pool_hdl, odp_pool_stats_t *stats)
 {
 	pool_t *pool;
+	uint32_t i;
 
 	if (odp_unlikely(pool_hdl == ODP_POOL_INVALID)) {
 		ODP_ERR("Invalid pool handle\n");
@@ -1398,26 +1658,33 @@ int odp_pool_stats(odp_pool_t pool_hdl, odp_pool_stats_t *stats)
 
 	memset(stats, 0, sizeof(odp_pool_stats_t));
 
-	if (pool->params.stats.bit.available)
-		stats->available = ring_ptr_len(&pool->ring->hdr);
+	/* Counters of a multi-size pool are sums over all size classes */
+	for (i = 0; i < pool->num_class; i++) {
+		pool_t *class = pool->class_pool[i];
 
-	if (pool->params.stats.bit.alloc_ops)
-		stats->alloc_ops = odp_atomic_load_u64(&pool->stats.alloc_ops);
+		if (pool->params.stats.bit.available)
+			stats->available += ring_ptr_len(&class->ring->hdr);
 
-	if (pool->params.stats.bit.alloc_fails)
-		stats->alloc_fails = odp_atomic_load_u64(&pool->stats.alloc_fails);
+		if (pool->params.stats.bit.alloc_ops)
+			stats->alloc_ops += odp_atomic_load_u64(&class->stats.alloc_ops);
 
-	if (pool->params.stats.bit.free_ops)
-		stats->free_ops = odp_atomic_load_u64(&pool->stats.free_ops);
+		if (pool->params.stats.bit.alloc_fails)
+			stats->alloc_fails += odp_atomic_load_u64(&class->stats.alloc_fails);
 
-	if (pool->params.stats.bit.cache_available)
-		stats->cache_available = cache_total_available(pool);
+		if (pool->params.stats.bit.free_ops)
+			stats->free_ops += odp_atomic_load_u64(&class->stats.free_ops);
 
-	if (pool->params.stats.bit.cache_alloc_ops)
-		stats->cache_alloc_ops = odp_atomic_load_u64(&pool->stats.cache_alloc_ops);
+		if (pool->params.stats.bit.cache_available)
+			stats->cache_available += cache_total_available(class);
 
-	if (pool->params.stats.bit.cache_free_ops)
-		stats->cache_free_ops = odp_atomic_load_u64(&pool->stats.cache_free_ops);
+		if (pool->params.stats.bit.cache_alloc_ops)
+			stats->cache_alloc_ops +=
+				odp_atomic_load_u64(&class->stats.cache_alloc_ops);
+
+		if (pool->params.stats.bit.cache_free_ops)
+			stats->cache_free_ops +=
+				odp_atomic_load_u64(&class->stats.cache_free_ops);
+	}
 
 	return 0;
 }
@@ -1425,6 +1692,7 @@ int odp_pool_stats(odp_pool_t pool_hdl, odp_pool_stats_t *stats)
 int odp_pool_stats_reset(odp_pool_t pool_hdl)
 {
 	pool_t *pool;
+	uint32_t i;
 
 	if (odp_unlikely(pool_hdl == ODP_POOL_INVALID)) {
 		ODP_ERR("Invalid pool handle\n");
@@ -1433,11 +1701,15 @@ int odp_pool_stats_reset(odp_pool_t pool_hdl)
 
 	pool = pool_entry_from_hdl(pool_hdl);
 
-	odp_atomic_store_u64(&pool->stats.alloc_ops, 0);
-	odp_atomic_store_u64(&pool->stats.alloc_fails, 0);
-	odp_atomic_store_u64(&pool->stats.free_ops, 0);
-	odp_atomic_store_u64(&pool->stats.cache_alloc_ops, 0);
-	odp_atomic_store_u64(&pool->stats.cache_free_ops, 0);
+	for (i = 0; i < pool->num_class; i++) {
+		pool_t *class = pool->class_pool[i];
+
+		odp_atomic_store_u64(&class->stats.alloc_ops, 0);
+		odp_atomic_store_u64(&class->stats.alloc_fails, 0);
+		odp_atomic_store_u64(&class->stats.free_ops, 0);
+		odp_atomic_store_u64(&class->stats.cache_alloc_ops, 0);
+		odp_atomic_store_u64(&class->stats.cache_free_ops, 0);
+	}
 
 	return 0;
 }
@@ -1453,7 +1725,7 @@ static pool_t *find_pool(odp_buffer_hdr_t *buf_hdr)
 		if (pool->reserved == 0)
 			continue;
 
-		if (ptr >= pool->base_addr && ptr < pool->max_addr)
+		if (ptr >= pool->hdr_base_addr && ptr < pool->hdr_max_addr)
 			return pool;
 	}
 
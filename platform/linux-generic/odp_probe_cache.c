@@ -0,0 +1,251 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp_posix_extensions.h>
+
+#include <odp/api/spinlock.h>
+
+#include <odp_debug_internal.h>
+#include <odp_libconfig_internal.h>
+#include <odp_probe_cache_internal.h>
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define BOOT_ID_FILE   "/proc/sys/kernel/random/boot_id"
+#define BOOT_ID_LEN    40
+#define MAX_ENTRIES    8
+#define MAX_NAME_LEN   32
+
+typedef struct {
+	char name[MAX_NAME_LEN];
+	uint64_t value;
+
+} probe_entry_t;
+
+/* Cache is process local. Probes run and the file is written only during
+ * odp_init_global(), before any ODP threads have been created. Lock protects
+ * against background probe threads started during init. */
+static struct {
+	odp_spinlock_t lock;
+	int enabled;
+	int num;
+	char boot_id[BOOT_ID_LEN];
+	char path[PATH_MAX];
+	probe_entry_t entry[MAX_ENTRIES];
+
+} probe_cache;
+
+static int read_boot_id(char *boot_id)
+{
+	FILE *file;
+	int ret = -1;
+
+	file = fopen(BOOT_ID_FILE, "r");
+	if (file == NULL)
+		return -1;
+
+	if (fgets(boot_id, BOOT_ID_LEN, file) != NULL) {
+		boot_id[strcspn(boot_id, "\n")] = 0;
+		ret = 0;
+	}
+
+	fclose(file);
+	return ret;
+}
+
+static probe_entry_t *find_entry(const char *name)
+{
+	int i;
+
+	for (i = 0; i < probe_cache.num; i++)
+		if (strcmp(probe_cache.entry[i].name, name) == 0)
+			return &probe_cache.entry[i];
+
+	return NULL;
+}
+
+static void add_entry(const char *name, uint64_t value)
+{
+	probe_entry_t *entry = find_entry(name);
+
+	if (entry == NULL) {
+		if (probe_cache.num == MAX_ENTRIES)
+			return;
+
+		entry = &probe_cache.entry[probe_cache.num++];
+		strncpy(entry->name, name, MAX_NAME_LEN - 1);
+		entry->name[MAX_NAME_LEN - 1] = 0;
+	}
+
+	entry->value = value;
+}
+
+static void load_file(void)
+{
+	char boot_id[BOOT_ID_LEN];
+	char name[MAX_NAME_LEN];
+	uint64_t value;
+	struct stat st;
+	FILE *file;
+	int fd;
+
+	fd = open(probe_cache.path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	if (fd < 0)
+		return;
+
+	/* The file may be in a shared directory. Trust only a regular file,
+	 * which is owned and writable only by the user. */
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode) || st.st_uid != getuid() ||
+	    (st.st_mode & (S_IRWXG | S_IRWXO))) {
+		ODP_DBG("Probe cache %s is not trusted\n", probe_cache.path);
+		close(fd);
+		return;
+	}
+
+	file = fdopen(fd, "r");
+	if (file == NULL) {
+		close(fd);
+		return;
+	}
+
+	/* Values measured during an earlier boot are not valid */
+	if (fscanf(file, "boot_id %39s\n", boot_id) != 1 ||
+	    strcmp(boot_id, probe_cache.boot_id)) {
+		ODP_DBG("Probe cache %s is not valid\n", probe_cache.path);
+		fclose(file);
+		return;
+	}
+
+	while (fscanf(file, "%31s %" SCNu64 "\n", name, &value) == 2)
+		add_entry(name, value);
+
+	fclose(file);
+}
+
+static void write_file(void)
+{
+	char tmp[PATH_MAX + 16];
+	FILE *file;
+	int fd, i;
+
+	/* Write into a temporary file and rename it, so that concurrently
+	 * starting processes never see a partially written file. The file is
+	 * created exclusively, so that an existing file or symbolic link in a
+	 * shared directory is not written into. */
+	snprintf(tmp, sizeof(tmp), "%s.%d", probe_cache.path, (int)getpid());
+
+	fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC,
+		  S_IRUSR | S_IWUSR);
+	if (fd < 0) {
+		ODP_DBG("Probe cache file %s open failed\n", tmp);
+		return;
+	}
+
+	file = fdopen(fd, "w");
+	if (file == NULL) {
+		ODP_DBG("Probe cache file %s open failed\n", tmp);
+		close(fd);
+		unlink(tmp);
+		return;
+	}
+
+	fprintf(file, "boot_id %s\n", probe_cache.boot_id);
+
+	for (i = 0; i < probe_cache.num; i++)
+		fprintf(file, "%s %" PRIu64 "\n", probe_cache.entry[i].name,
+			probe_cache.entry[i].value);
+
+	if (fclose(file) || rename(tmp, probe_cache.path)) {
+		ODP_DBG("Probe cache file %s write failed\n", probe_cache.path);
+		unlink(tmp);
+	}
+}
+
+int _odp_probe_cache_init_global(void)
+{
+	const char *str;
+	const char *path;
+	int val = 0;
+
+	memset(&probe_cache, 0, sizeof(probe_cache));
+	odp_spinlock_init(&probe_cache.lock);
+
+	str = "system.probe_cache";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (!val)
+		return 0;
+
+	if (read_boot_id(probe_cache.boot_id)) {
+		ODP_DBG("Boot ID not available, probe cache disabled\n");
+		return 0;
+	}
+
+	path = getenv("ODP_PROBE_CACHE_FILE");
+	if (path) {
+		snprintf(probe_cache.path, PATH_MAX, "%s", path);
+	} else {
+		/* Prefer the per-user runtime directory over /tmp */
+		path = getenv("XDG_RUNTIME_DIR");
+		if (path && path[0])
+			snprintf(probe_cache.path, PATH_MAX, "%s/odp-probe-cache", path);
+		else
+			snprintf(probe_cache.path, PATH_MAX, "/tmp/odp-%d-probe-cache",
+				 (int)getuid());
+	}
+
+	probe_cache.enabled = 1;
+	load_file();
+
+	ODP_DBG("Probe cache %s: %i values\n", probe_cache.path,
+		probe_cache.num);
+
+	return 0;
+}
+
+int _odp_probe_cache_get(const char *name, uint64_t *value)
+{
+	probe_entry_t *entry;
+	int found = 0;
+
+	if (!probe_cache.enabled)
+		return 0;
+
+	odp_spinlock_lock(&probe_cache.lock);
+
+	entry = find_entry(name);
+	if (entry) {
+		*value = entry->value;
+		found = 1;
+	}
+
+	odp_spinlock_unlock(&probe_cache.lock);
+
+	return found;
+}
+
+void _odp_probe_cache_set(const char *name, uint64_t value)
+{
+	if (!probe_cache.enabled)
+		return;
+
+	odp_spinlock_lock(&probe_cache.lock);
+
+	add_entry(name, value);
+	write_file();
+
+	odp_spinlock_unlock(&probe_cache.lock);
+}
@@ -27,6 +27,7 @@
 #include <odp_libconfig_internal.h>
 #include <odp/api/plat/queue_inline_types.h>
 #include <odp_global_data.h>
+#include <odp_trace_internal.h>
 
 #include <odp/api/plat/ticketlock_inlines.h>
 #define LOCK(queue_ptr)      odp_ticketlock_lock(&((queue_ptr)->s.lock))
@@ -148,6 +149,7 @@ static int queue_init_global(void)
 		queue_entry_t *queue = qentry_from_index(i);
 
 		LOCK_INIT(queue);
+		odp_atomic_init_u32(&queue->s.status, QUEUE_STATUS_FREE);
 		queue->s.index  = i;
 		queue->s.handle = (odp_queue_t)queue;
 	}
@@ -208,7 +210,7 @@ static int queue_term_global(void)
 	for (i = 0; i < CONFIG_MAX_QUEUES; i++) {
 		queue = qentry_from_index(i);
 		LOCK(queue);
-		if (queue->s.status != QUEUE_STATUS_FREE) {
+		if (odp_atomic_load_u32(&queue->s.status) != QUEUE_STATUS_FREE) {
 			ODP_ERR("Not destroyed queue: %s\n", queue->s.name);
 			ret = -1;
 		}
@@ -263,6 +265,49 @@ static uint32_t queue_lock_count(odp_queue_t handle)
 		queue->s.param.sched.lock_count : 0;
 }
 
+static int queue_vector_check(const odp_queue_param_t *param)
+{
+	const odp_queue_vector_config_t *vector = &param->vector;
+	odp_schedule_capability_t capa;
+	odp_pool_info_t pool_info;
+
+	if (param->type != ODP_QUEUE_TYPE_SCHED) {
+		ODP_ERR("Vector aggregation supported only for scheduled queues\n");
+		return -1;
+	}
+
+	if (odp_schedule_capability(&capa) ||
+	    capa.vector.supported != ODP_SUPPORT_YES) {
+		ODP_ERR("Vector aggregation not supported by the scheduler\n");
+		return -1;
+	}
+
+	if (vector->max_size < capa.vector.min_size ||
+	    vector->max_size > capa.vector.max_size) {
+		ODP_ERR("Bad vector.max_size %" PRIu32 "\n", vector->max_size);
+		return -1;
+	}
+
+	if (vector->max_tmo_ns > capa.vector.max_tmo_ns) {
+		ODP_ERR("Bad vector.max_tmo_ns %" PRIu64 "\n", vector->max_tmo_ns);
+		return -1;
+	}
+
+	if (vector->pool == ODP_POOL_INVALID ||
+	    odp_pool_info(vector->pool, &pool_info)) {
+		ODP_ERR("Bad vector pool\n");
+		return -1;
+	}
+
+	if (pool_info.params.type != ODP_POOL_VECTOR ||
+	    vector->max_size > pool_info.params.vector.max_size) {
+		ODP_ERR("Vector pool not compatible\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 static odp_queue_t queue_create(const char *name,
 				const odp_queue_param_t *param)
 {
@@ -289,6 +334,9 @@ static odp_queue_t queue_create(const char *name,
 		}
 	}
 
+	if (param->vector.enable && queue_vector_check(param))
+		return ODP_QUEUE_INVALID;
+
 	if (param->nonblocking == ODP_BLOCKING) {
 		if (param->size > _odp_queue_glb->config.max_queue_size)
 			return ODP_QUEUE_INVALID;
@@ -317,11 +365,11 @@ static odp_queue_t queue_create(const char *name,
 	for (; i < max_idx; i++) {
 		queue = qentry_from_index(i);
 
-		if (queue->s.status != QUEUE_STATUS_FREE)
+		if (odp_atomic_load_u32(&queue->s.status) != QUEUE_STATUS_FREE)
 			continue;
 
 		LOCK(queue);
-		if (queue->s.status == QUEUE_STATUS_FREE) {
+		if (odp_atomic_load_u32(&queue->s.status) == QUEUE_STATUS_FREE) {
 			if (queue_init(queue, name, param)) {
 				UNLOCK(queue);
 				return ODP_QUEUE_INVALID;
@@ -349,9 +397,11 @@ static odp_queue_t queue_create(const char *name,
 			}
 
 			if (type == ODP_QUEUE_TYPE_SCHED)
-				queue->s.status = QUEUE_STATUS_NOTSCHED;
+				odp_atomic_store_u32(&queue->s.status,
+						     QUEUE_STATUS_NOTSCHED);
 			else
-				queue->s.status = QUEUE_STATUS_READY;
+				odp_atomic_store_u32(&queue->s.status,
+						     QUEUE_STATUS_READY);
 
 			handle = queue->s.handle;
 			UNLOCK(queue);
@@ -366,7 +416,8 @@ static odp_queue_t queue_create(const char *name,
 	if (type == ODP_QUEUE_TYPE_SCHED) {
 		if (_odp_sched_fn->create_queue(queue->s.index,
 						&queue->s.param.sched)) {
-			queue->s.status = QUEUE_STATUS_FREE;
+			odp_atomic_store_u32(&queue->s.status,
+					     QUEUE_STATUS_FREE);
 			ODP_ERR("schedule queue init failed\n");
 			return ODP_QUEUE_INVALID;
 		}
@@ -379,16 +430,19 @@ void _odp_sched_queue_set_status(uint32_t queue_index, int status)
 {
 	queue_entry_t *queue = qentry_from_index(queue_index);
 
-	LOCK(queue);
-
-	queue->s.status = status;
+	odp_atomic_store_rel_u32(&queue->s.status, status);
+}
 
-	UNLOCK(queue);
+static inline int sched_status_cas(queue_entry_t *queue, uint32_t old_val,
+				   uint32_t new_val)
+{
+	return odp_atomic_cas_acq_rel_u32(&queue->s.status, &old_val, new_val);
 }
 
 static int queue_destroy(odp_queue_t handle)
 {
 	int empty;
+	uint32_t status;
 	queue_entry_t *queue;
 
 	queue = qentry_from_handle(handle);
@@ -397,12 +451,13 @@ static int queue_destroy(odp_queue_t handle)
 		return -1;
 
 	LOCK(queue);
-	if (queue->s.status == QUEUE_STATUS_FREE) {
+	status = odp_atomic_load_u32(&queue->s.status);
+	if (status == QUEUE_STATUS_FREE) {
 		UNLOCK(queue);
 		ODP_ERR("queue \"%s\" already free\n", queue->s.name);
 		return -1;
 	}
-	if (queue->s.status == QUEUE_STATUS_DESTROYED) {
+	if (status == QUEUE_STATUS_DESTROYED) {
 		UNLOCK(queue);
 		ODP_ERR("queue \"%s\" already destroyed\n", queue->s.name);
 		return -1;
@@ -410,8 +465,6 @@ static int queue_destroy(odp_queue_t handle)
 
 	if (queue->s.spsc)
 		empty = ring_spsc_is_empty(&queue->s.ring_spsc);
-	else if (queue->s.type == ODP_QUEUE_TYPE_SCHED)
-		empty = ring_st_is_empty(&queue->s.ring_st);
 	else
 		empty = ring_mpmc_is_empty(&queue->s.ring_mpmc);
 
@@ -421,20 +474,28 @@ static int queue_destroy(odp_queue_t handle)
 		return -1;
 	}
 
-	switch (queue->s.status) {
-	case QUEUE_STATUS_READY:
-		queue->s.status = QUEUE_STATUS_FREE;
-		break;
-	case QUEUE_STATUS_NOTSCHED:
-		queue->s.status = QUEUE_STATUS_FREE;
-		_odp_sched_fn->destroy_queue(queue->s.index);
-		break;
-	case QUEUE_STATUS_SCHED:
-		/* Queue is still in scheduling */
-		queue->s.status = QUEUE_STATUS_DESTROYED;
-		break;
-	default:
-		ODP_ABORT("Unexpected queue status\n");
+	/* Scheduler may change status of a scheduled queue concurrently */
+	while (1) {
+		if (status == QUEUE_STATUS_READY) {
+			odp_atomic_store_u32(&queue->s.status,
+					     QUEUE_STATUS_FREE);
+			break;
+		} else if (status == QUEUE_STATUS_NOTSCHED) {
+			if (sched_status_cas(queue, status,
+					     QUEUE_STATUS_FREE)) {
+				_odp_sched_fn->destroy_queue(queue->s.index);
+				break;
+			}
+		} else if (status == QUEUE_STATUS_SCHED) {
+			/* Queue is still in scheduling */
+			if (sched_status_cas(queue, status,
+					     QUEUE_STATUS_DESTROYED))
+				break;
+		} else {
+			ODP_ABORT("Unexpected queue status\n");
+		}
+
+		status = odp_atomic_load_u32(&queue->s.status);
 	}
 
 	if (queue->s.queue_lf)
@@ -461,8 +522,7 @@ static odp_queue_t queue_lookup(const char *name)
 	for (i = 0; i < CONFIG_MAX_QUEUES; i++) {
 		queue_entry_t *queue = qentry_from_index(i);
 
-		if (queue->s.status == QUEUE_STATUS_FREE ||
-		    queue->s.status == QUEUE_STATUS_DESTROYED)
+		if (odp_atomic_load_u32(&queue->s.status) < QUEUE_STATUS_READY)
 			continue;
 
 		LOCK(queue);
@@ -655,7 +715,7 @@ static int queue_info(odp_queue_t handle, odp_queue_info_t *info)
 	queue = qentry_from_index(queue_id);
 
 	LOCK(queue);
-	status = queue->s.status;
+	status = odp_atomic_load_u32(&queue->s.status);
 
 	if (odp_unlikely(status == QUEUE_STATUS_FREE ||
 			 status == QUEUE_STATUS_DESTROYED)) {
@@ -690,7 +750,7 @@ static void queue_print(odp_queue_t handle)
 	queue = qentry_from_index(queue_id);
 
 	LOCK(queue);
-	status = queue->s.status;
+	status = odp_atomic_load_u32(&queue->s.status);
 
 	if (odp_unlikely(status == QUEUE_STATUS_FREE ||
 			 status == QUEUE_STATUS_DESTROYED)) {
@@ -731,6 +791,9 @@ static void queue_print(odp_queue_t handle)
 			    "ODP_SCHED_SYNC_ORDERED" : "unknown")));
 		ODP_PRINT("    priority      %d\n", queue->s.param.sched.prio);
 		ODP_PRINT("    group         %d\n", queue->s.param.sched.group);
+		if (queue->s.param.vector.enable)
+			ODP_PRINT("    vector size   %" PRIu32 "\n",
+				  queue->s.param.vector.max_size);
 	}
 	if (queue->s.pktin.pktio != ODP_PKTIO_INVALID) {
 		if (!odp_pktio_info(queue->s.pktin.pktio, &pktio_info))
@@ -743,9 +806,9 @@ static void queue_print(odp_queue_t handle)
 	ODP_PRINT("  timers          %" PRIu32 "\n",
 		  odp_atomic_load_u64(&queue->s.num_timers));
 	ODP_PRINT("  status          %s\n",
-		  queue->s.status == QUEUE_STATUS_READY ? "ready" :
-		  (queue->s.status == QUEUE_STATUS_NOTSCHED ? "not scheduled" :
-		   (queue->s.status == QUEUE_STATUS_SCHED ? "scheduled" : "unknown")));
+		  status == QUEUE_STATUS_READY ? "ready" :
+		  (status == QUEUE_STATUS_NOTSCHED ? "not scheduled" :
+		   (status == QUEUE_STATUS_SCHED ? "scheduled" : "unknown")));
 	ODP_PRINT("  param.size      %" PRIu32 "\n", queue->s.param.size);
 	if (queue->s.queue_lf) {
 		ODP_PRINT("  implementation  queue_lf\n");
@@ -755,10 +818,6 @@ static void queue_print(odp_queue_t handle)
 		ODP_PRINT("  implementation  ring_spsc\n");
 		ODP_PRINT("  length          %" PRIu32 "/%" PRIu32 "\n",
 			  ring_spsc_length(&queue->s.ring_spsc), queue->s.ring_mask + 1);
-	} else if (queue->s.type == ODP_QUEUE_TYPE_SCHED) {
-		ODP_PRINT("  implementation  ring_st\n");
-		ODP_PRINT("  length          %" PRIu32 "/%" PRIu32 "\n",
-			  ring_st_length(&queue->s.ring_st), queue->s.ring_mask + 1);
 	} else {
 		ODP_PRINT("  implementation  ring_mpmc\n");
 		ODP_PRINT("  length          %" PRIu32 "/%" PRIu32 "\n",
@@ -793,12 +852,12 @@ static void queue_print_all(void)
 	for (i = 0; i < CONFIG_MAX_QUEUES; i++) {
 		queue_entry_t *queue = qentry_from_index(i);
 
-		if (queue->s.status < QUEUE_STATUS_READY)
+		if (odp_atomic_load_u32(&queue->s.status) < QUEUE_STATUS_READY)
 			continue;
 
 		LOCK(queue);
 
-		status   = queue->s.status;
+		status   = odp_atomic_load_u32(&queue->s.status);
 		index    = queue->s.index;
 		name     = queue->s.name;
 		type     = queue->s.type;
@@ -813,16 +872,16 @@ static void queue_print_all(void)
 		} else if (queue->s.spsc) {
 			len     = ring_spsc_length(&queue->s.ring_spsc);
 			max_len = queue->s.ring_mask + 1;
-		} else if (type == ODP_QUEUE_TYPE_SCHED) {
-			len     = ring_st_length(&queue->s.ring_st);
-			max_len = queue->s.ring_mask + 1;
-			prio    = queue->s.param.sched.prio;
-			sync    = queue->s.param.sched.sync;
 		} else {
 			len     = ring_mpmc_length(&queue->s.ring_mpmc);
 			max_len = queue->s.ring_mask + 1;
 		}
 
+		if (type == ODP_QUEUE_TYPE_SCHED) {
+			prio    = queue->s.param.sched.prio;
+			sync    = queue->s.param.sched.sync;
+		}
+
 		UNLOCK(queue);
 
 		if (status < QUEUE_STATUS_READY)
@@ -863,89 +922,228 @@ static void queue_print_all(void)
 static inline int _sched_queue_enq_multi(odp_queue_t handle,
 					 odp_buffer_hdr_t *buf_hdr[], int num)
 {
-	int sched = 0;
 	int ret;
 	queue_entry_t *queue;
 	int num_enq;
-	ring_st_t *ring_st;
+	ring_mpmc_t *ring_mpmc;
 	uint32_t buf_idx[num];
 
 	queue = qentry_from_handle(handle);
-	ring_st = &queue->s.ring_st;
+	ring_mpmc = &queue->s.ring_mpmc;
 
 	if (_odp_sched_fn->ord_enq_multi(handle, (void **)buf_hdr, num, &ret))
 		return ret;
 
 	buffer_index_from_buf(buf_idx, buf_hdr, num);
 
-	LOCK(queue);
-
-	num_enq = ring_st_enq_multi(ring_st, queue->s.ring_data,
-				    queue->s.ring_mask, buf_idx, num);
+	num_enq = ring_mpmc_enq_multi(ring_mpmc, queue->s.ring_data,
+				      queue->s.ring_mask, buf_idx, num);
 
-	if (odp_unlikely(num_enq == 0)) {
-		UNLOCK(queue);
+	if (odp_unlikely(num_enq == 0))
 		return 0;
+
+	/* Events must be visible in the ring before status is read. Pairs
+	 * with the barrier in sched_queue_idle(). */
+	odp_mb_full();
+
+	/* Add queue to scheduling */
+	if (odp_atomic_load_u32(&queue->s.status) == QUEUE_STATUS_NOTSCHED &&
+	    sched_status_cas(queue, QUEUE_STATUS_NOTSCHED, QUEUE_STATUS_SCHED)) {
+		if (_odp_sched_fn->sched_queue(queue->s.index))
+			ODP_ABORT("schedule_queue failed\n");
 	}
 
-	if (queue->s.status == QUEUE_STATUS_NOTSCHED) {
-		queue->s.status = QUEUE_STATUS_SCHED;
-		sched = 1;
+	return num_enq;
+}
+
+/* Check status of a scheduled queue before dequeue. Informs scheduler about
+ * a destroyed queue. */
+static inline int sched_queue_check(queue_entry_t *queue)
+{
+	uint32_t status = odp_atomic_load_acq_u32(&queue->s.status);
+
+	if (odp_likely(status >= QUEUE_STATUS_READY))
+		return 0;
+
+	/* Bad queue, or queue has been destroyed */
+	if (status == QUEUE_STATUS_DESTROYED &&
+	    sched_status_cas(queue, status, QUEUE_STATUS_FREE))
+		_odp_sched_fn->destroy_queue(queue->s.index);
+
+	return -1;
+}
+
+/* Scheduler found the queue empty. Remove the queue from scheduling, unless
+ * events were enqueued concurrently. Returns 1 when the queue stays in
+ * scheduling, 0 when it was removed and -1 when it has been destroyed. */
+static inline int sched_queue_idle(queue_entry_t *queue)
+{
+	uint32_t status = odp_atomic_load_u32(&queue->s.status);
+
+	while (1) {
+		if (status == QUEUE_STATUS_DESTROYED)
+			return sched_queue_check(queue);
+
+		if (status != QUEUE_STATUS_SCHED)
+			return 0;
+
+		if (sched_status_cas(queue, status, QUEUE_STATUS_NOTSCHED))
+			break;
+
+		status = odp_atomic_load_u32(&queue->s.status);
 	}
 
-	UNLOCK(queue);
+	/* Status must be updated before the ring is read. Pairs with the
+	 * barrier in enqueue. */
+	odp_mb_full();
 
-	/* Add queue to scheduling */
-	if (sched && _odp_sched_fn->sched_queue(queue->s.index))
-		ODP_ABORT("schedule_queue failed\n");
+	if (odp_likely(ring_mpmc_is_empty(&queue->s.ring_mpmc)))
+		return 0;
 
-	return num_enq;
+	/* An enqueue saw the queue still scheduled. Take the queue back into
+	 * scheduling, unless the enqueuing thread was faster. */
+	return sched_status_cas(queue, QUEUE_STATUS_NOTSCHED,
+				QUEUE_STATUS_SCHED);
 }
 
-int _odp_sched_queue_deq(uint32_t queue_index, odp_event_t ev[], int max_num,
-			 int update_status)
+static inline int sched_queue_deq(queue_entry_t *queue, odp_event_t ev[],
+				  int max_num, int update_status)
 {
-	int num_deq, status;
-	ring_st_t *ring_st;
-	queue_entry_t *queue = qentry_from_index(queue_index);
+	int num_deq, ret;
+	ring_mpmc_t *ring_mpmc;
 	uint32_t buf_idx[max_num];
 
-	ring_st = &queue->s.ring_st;
+	ring_mpmc = &queue->s.ring_mpmc;
 
-	LOCK(queue);
+	if (odp_unlikely(sched_queue_check(queue)))
+		return -1;
 
-	status = queue->s.status;
+	do {
+		num_deq = ring_mpmc_deq_multi(ring_mpmc, queue->s.ring_data,
+					      queue->s.ring_mask, buf_idx,
+					      max_num);
 
-	if (odp_unlikely(status < QUEUE_STATUS_READY)) {
-		/* Bad queue, or queue has been destroyed.
-		 * Inform scheduler about a destroyed queue. */
-		if (queue->s.status == QUEUE_STATUS_DESTROYED) {
-			queue->s.status = QUEUE_STATUS_FREE;
-			_odp_sched_fn->destroy_queue(queue_index);
+		if (odp_likely(num_deq)) {
+			buffer_index_to_buf((odp_buffer_hdr_t **)ev, buf_idx,
+					    num_deq);
+			return num_deq;
 		}
 
-		UNLOCK(queue);
+		/* Already empty queue */
+		if (!update_status)
+			return 0;
+
+		ret = sched_queue_idle(queue);
+
+	} while (ret > 0);
+
+	return ret;
+}
+
+/* Dequeue from a queue with event vector aggregation. The first run of
+ * consecutive packets is combined into a single packet vector, which takes
+ * one output slot. Events are scanned in the ring before dequeue, so that
+ * no more events are dequeued than fit into the output table. Scheduler is
+ * the only reader of the ring, so scanned events stay in place. */
+static int sched_queue_deq_vector(queue_entry_t *queue, odp_event_t ev[],
+				  int max_num, int update_status)
+{
+	const uint32_t max_size = queue->s.param.vector.max_size;
+	uint32_t buf_idx[max_num + max_size];
+	uint32_t *ring_data = queue->s.ring_data;
+	uint32_t ring_mask = queue->s.ring_mask;
+	ring_mpmc_t *ring_mpmc = &queue->s.ring_mpmc;
+	odp_packet_vector_t pktv;
+	odp_packet_t *pkt_tbl;
+	uint32_t num, i, num_pkt = 0;
+	int num_deq, ret;
+	int num_out = 0;
+	int vec_pos = -1;
+
+	pktv = odp_packet_vector_alloc(queue->s.param.vector.pool);
+
+	/* Pass events as is when out of vectors */
+	if (odp_unlikely(pktv == ODP_PACKET_VECTOR_INVALID))
+		return sched_queue_deq(queue, ev, max_num, update_status);
+
+	if (odp_unlikely(sched_queue_check(queue))) {
+		odp_packet_vector_free(pktv);
 		return -1;
 	}
 
-	num_deq = ring_st_deq_multi(ring_st, queue->s.ring_data,
-				    queue->s.ring_mask, buf_idx, max_num);
+	do {
+		num = ring_mpmc_peek(ring_mpmc, ring_data, ring_mask, buf_idx,
+				     max_num + max_size);
 
-	if (num_deq == 0) {
-		/* Already empty queue */
-		if (update_status && status == QUEUE_STATUS_SCHED)
-			queue->s.status = QUEUE_STATUS_NOTSCHED;
+		if (odp_likely(num))
+			break;
 
-		UNLOCK(queue);
+		ret = update_status ? sched_queue_idle(queue) : 0;
 
-		return 0;
+		if (ret <= 0) {
+			odp_packet_vector_free(pktv);
+			return ret;
+		}
+	} while (1);
+
+	/* Scan ends when output slots run out, the vector is full or a
+	 * non-packet event follows the packets of the vector. */
+	for (i = 0; i < num; i++) {
+		odp_buffer_hdr_t *hdr = buf_hdr_from_index_u32(buf_idx[i]);
+		int is_pkt = (hdr->event_type == ODP_EVENT_PACKET);
+
+		if (vec_pos >= 0) {
+			if (!is_pkt || num_pkt == max_size)
+				break;
+
+			num_pkt++;
+			continue;
+		}
+
+		if (num_out == max_num)
+			break;
+
+		if (is_pkt) {
+			vec_pos = num_out;
+			num_pkt = 1;
+		}
+
+		num_out++;
 	}
 
-	UNLOCK(queue);
+	num_deq = ring_mpmc_deq_multi(ring_mpmc, ring_data, ring_mask, buf_idx,
+				      i);
 
-	buffer_index_to_buf((odp_buffer_hdr_t **)ev, buf_idx, num_deq);
+	ODP_ASSERT(num_deq == (int)i);
 
-	return num_deq;
+	if (vec_pos < 0) {
+		odp_packet_vector_free(pktv);
+		buffer_index_to_buf((odp_buffer_hdr_t **)ev, buf_idx, num_deq);
+		return num_deq;
+	}
+
+	/* Events before the vector, and packets of the vector */
+	buffer_index_to_buf((odp_buffer_hdr_t **)ev, buf_idx, vec_pos);
+
+	odp_packet_vector_tbl(pktv, &pkt_tbl);
+	buffer_index_to_buf((odp_buffer_hdr_t **)pkt_tbl, &buf_idx[vec_pos],
+			    num_pkt);
+	odp_packet_vector_size_set(pktv, num_pkt);
+	ev[vec_pos] = odp_packet_vector_to_event(pktv);
+
+	return vec_pos + 1;
+}
+
+int _odp_sched_queue_deq(uint32_t queue_index, odp_event_t ev[], int max_num,
+			 int update_status)
+{
+	queue_entry_t *queue = qentry_from_index(queue_index);
+
+	if (odp_unlikely(queue->s.param.vector.enable))
+		return sched_queue_deq_vector(queue, ev, max_num,
+					      update_status);
+
+	return sched_queue_deq(queue, ev, max_num, update_status);
 }
 
 static int sched_queue_enq_multi(odp_queue_t handle,
@@ -969,27 +1167,21 @@ static int sched_queue_enq(odp_queue_t handle, odp_buffer_hdr_t *buf_hdr)
 int _odp_sched_queue_empty(uint32_t queue_index)
 {
 	queue_entry_t *queue = qentry_from_index(queue_index);
-	int ret = 0;
-
-	LOCK(queue);
+	int ret;
 
-	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
-		/* Bad queue, or queue has been destroyed. */
-		UNLOCK(queue);
+	if (odp_unlikely(sched_queue_check(queue)))
 		return -1;
-	}
 
-	if (ring_st_is_empty(&queue->s.ring_st)) {
-		/* Already empty queue. Update status. */
-		if (queue->s.status == QUEUE_STATUS_SCHED)
-			queue->s.status = QUEUE_STATUS_NOTSCHED;
+	if (!ring_mpmc_is_empty(&queue->s.ring_mpmc))
+		return 0;
 
-		ret = 1;
-	}
+	/* Already empty queue. Update status. */
+	ret = sched_queue_idle(queue);
 
-	UNLOCK(queue);
+	if (ret < 0)
+		return -1;
 
-	return ret;
+	return !ret;
 }
 
 static int queue_init(queue_entry_t *queue, const char *name,
@@ -1074,7 +1266,7 @@ static int queue_init(queue_entry_t *queue, const char *name,
 
 			queue->s.ring_data = &_odp_queue_glb->ring_data[offset];
 			queue->s.ring_mask = queue_size - 1;
-			ring_st_init(&queue->s.ring_st);
+			ring_mpmc_init(&queue->s.ring_mpmc);
 		}
 	}
 
@@ -1149,6 +1341,8 @@ static int queue_api_enq_multi(odp_queue_t handle,
 			       const odp_event_t ev[], int num)
 {
 	queue_entry_t *queue = qentry_from_handle(handle);
+	uint64_t trace_start;
+	int ret;
 
 	if (odp_unlikely(num == 0))
 		return 0;
@@ -1156,8 +1350,13 @@ static int queue_api_enq_multi(odp_queue_t handle,
 	if (num > QUEUE_MULTI_MAX)
 		num = QUEUE_MULTI_MAX;
 
-	return queue->s.enqueue_multi(handle,
-				      (odp_buffer_hdr_t **)(uintptr_t)ev, num);
+	trace_start = _odp_trace_begin();
+	ret = queue->s.enqueue_multi(handle,
+				     (odp_buffer_hdr_t **)(uintptr_t)ev, num);
+	_odp_trace_end(_ODP_TRACE_QUEUE_ENQ, trace_start, (uintptr_t)handle,
+		       ret);
+
+	return ret;
 }
 
 static void queue_timer_add(odp_queue_t handle)
@@ -1177,20 +1376,29 @@ static void queue_timer_rem(odp_queue_t handle)
 static int queue_api_enq(odp_queue_t handle, odp_event_t ev)
 {
 	queue_entry_t *queue = qentry_from_handle(handle);
+	uint64_t trace_start = _odp_trace_begin();
+	int ret;
+
+	ret = queue->s.enqueue(handle, (odp_buffer_hdr_t *)(uintptr_t)ev);
+	_odp_trace_end(_ODP_TRACE_QUEUE_ENQ, trace_start, (uintptr_t)handle,
+		       ret == 0);
 
-	return queue->s.enqueue(handle,
-				(odp_buffer_hdr_t *)(uintptr_t)ev);
+	return ret;
 }
 
 static int queue_api_deq_multi(odp_queue_t handle, odp_event_t ev[], int num)
 {
 	queue_entry_t *queue = qentry_from_handle(handle);
+	uint64_t trace_start;
 	int ret;
 
 	if (num > QUEUE_MULTI_MAX)
 		num = QUEUE_MULTI_MAX;
 
+	trace_start = _odp_trace_begin();
 	ret = queue->s.dequeue_multi(handle, (odp_buffer_hdr_t **)ev, num);
+	_odp_trace_end(_ODP_TRACE_QUEUE_DEQ, trace_start, (uintptr_t)handle,
+		       ret);
 
 	if (odp_global_rw->inline_timers &&
 	    odp_atomic_load_u64(&queue->s.num_timers))
@@ -1202,8 +1410,12 @@ static int queue_api_deq_multi(odp_queue_t handle, odp_event_t ev[], int num)
 static odp_event_t queue_api_deq(odp_queue_t handle)
 {
 	queue_entry_t *queue = qentry_from_handle(handle);
+	uint64_t trace_start = _odp_trace_begin();
 	odp_event_t ev = (odp_event_t)queue->s.dequeue(handle);
 
+	_odp_trace_end(_ODP_TRACE_QUEUE_DEQ, trace_start, (uintptr_t)handle,
+		       ev != ODP_EVENT_INVALID);
+
 	if (odp_global_rw->inline_timers &&
 	    odp_atomic_load_u64(&queue->s.num_timers))
 		timer_run(ev != ODP_EVENT_INVALID ? 2 : 1);
@@ -368,6 +368,11 @@ static odp_queue_t queue_create(const char *name,
 
 	type = param->type;
 
+	if (param->vector.enable) {
+		ODP_ERR("Vector aggregation not supported\n");
+		return ODP_QUEUE_INVALID;
+	}
+
 	if (type == ODP_QUEUE_TYPE_SCHED) {
 		if (param->sched.prio < odp_schedule_min_prio() ||
 		    param->sched.prio > odp_schedule_max_prio()) {
@@ -43,7 +43,8 @@ static inline int spsc_enq_multi(odp_queue_t handle,
 
 	buffer_index_from_buf(buf_idx, buf_hdr, num);
 
-	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
+	if (odp_unlikely(odp_atomic_load_u32(&queue->s.status) <
+			 QUEUE_STATUS_READY)) {
 		ODP_ERR("Bad queue status\n");
 		return -1;
 	}
@@ -63,7 +64,8 @@ static inline int spsc_deq_multi(odp_queue_t handle,
 	queue = qentry_from_handle(handle);
 	ring_spsc = &queue->s.ring_spsc;
 
-	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
+	if (odp_unlikely(odp_atomic_load_u32(&queue->s.status) <
+			 QUEUE_STATUS_READY)) {
 		/* Bad queue, or queue has been destroyed. */
 		return -1;
 	}
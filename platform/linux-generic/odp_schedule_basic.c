@@ -34,8 +34,10 @@
 #include <odp_timer_internal.h>
 #include <odp_queue_basic_internal.h>
 #include <odp_libconfig_internal.h>
+#include <odp_trace_internal.h>
 #include <odp/api/plat/queue_inlines.h>
 
+#include <inttypes.h>
 #include <string.h>
 
 /* No synchronization context */
@@ -99,11 +101,69 @@ ODP_STATIC_ASSERT((8 * sizeof(prio_q_mask_t)) >= MAX_SPREAD,
 
 /* Limits for burst size configuration */
 #define BURST_MAX  255
+
+/* Limits for priority weight configuration */
+#define MAX_PRIO_WEIGHT 32
+#define MIN_PRIO_WEIGHT 1
+
+/* Priority weight table size */
+#define PRIO_WEIGHT_TBL_SIZE (NUM_PRIO * MAX_PRIO_WEIGHT)
+
+/* Priority modes */
+#define PRIO_MODE_STRICT   0
+#define PRIO_MODE_WEIGHTED 1
+
+/* Maximum packet input poll back off (in scheduling rounds) */
+#define MAX_PKTIN_BACKOFF 1024
 #define STASH_SIZE CONFIG_BURST_SIZE
 
 /* Ordered stash size */
 #define MAX_ORDERED_STASH 512
 
+/* Maximum number of atomic queues in affinity queues of a thread */
+#define MAX_AFFINITY 63
+
+/* Affinity queue ring size. Must be larger than MAX_AFFINITY. */
+#define AFFINITY_RING_SIZE (MAX_AFFINITY + 1)
+
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(AFFINITY_RING_SIZE),
+		  "Affinity_ring_size_is_not_power_of_two");
+
+/* Thread index of a queue that has not been processed yet */
+#define NO_AFFINITY_THR 0xffff
+
+/* Number of victim threads checked per stealing attempt */
+#define AFFINITY_STEAL_SCAN 8
+
+/* A thread tries to steal an affinity queue every this many schedule rounds,
+ * also when it has work to do. */
+#define AFFINITY_STEAL_ROUNDS 64
+
+/* Number of ordered contexts per queue, which can be parked into the reorder
+ * window. Must be a power of two. */
+#define REORDER_WINDOW 64
+
+/* Number of reorder banks per thread */
+#define REORDER_BANKS 8
+
+/* Maximum number of events stashed into a reorder bank */
+#define REORDER_BANK_SIZE 128
+
+/* Reorder window slot value of a parked context: valid bit, called ordered
+ * locks and reorder bank index + 1 (0 when context has no stashed events) */
+#define REORDER_SLOT_VALID      0x80000000
+#define REORDER_SLOT_LOCK_SHIFT 24
+#define REORDER_SLOT_BANK_MASK  0x00ffffff
+
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(REORDER_WINDOW),
+		  "Reorder_window_is_not_power_of_two");
+
+ODP_STATIC_ASSERT(CONFIG_QUEUE_MAX_ORD_LOCKS <= 7,
+		  "Ordered_locks_do_not_fit_reorder_slot");
+
+ODP_STATIC_ASSERT((ODP_THREAD_COUNT_MAX * REORDER_BANKS) <
+		  REORDER_SLOT_BANK_MASK, "Reorder_bank_does_not_fit_slot");
+
 /* Storage for stashed enqueue operation arguments */
 typedef struct {
 	odp_buffer_hdr_t *buf_hdr[QUEUE_MULTI_MAX];
@@ -127,6 +187,9 @@ typedef struct ODP_ALIGNED_CACHE {
 	uint8_t  sync_ctx;
 	uint16_t grp_round;
 	uint16_t spread_round;
+	uint16_t prio_round;
+	uint16_t steal_round;
+	uint16_t steal_thr;
 
 	struct {
 		uint16_t    num_ev;
@@ -150,6 +213,9 @@ typedef struct ODP_ALIGNED_CACHE {
 		int stash_num; /**< Number of stashed enqueue operations */
 		uint8_t in_order; /**< Order status */
 		lock_called_t lock_called; /**< States of ordered locks */
+		/** Reorder bank in use (reorder buffer mode) */
+		struct reorder_bank_t *bank;
+		uint32_t bank_idx; /**< Index of the reorder bank */
 		/** Storage for stashed enqueue operations */
 		ordered_stash_t stash[MAX_ORDERED_STASH];
 	} ordered;
@@ -166,6 +232,41 @@ typedef struct ODP_ALIGNED_CACHE {
 
 } prio_queue_t;
 
+/* Affinity queue of a thread */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Ring header */
+	ring_u32_t ring;
+
+	/* Ring data: queue indexes */
+	uint32_t queue_index[AFFINITY_RING_SIZE];
+
+} affinity_queue_t;
+
+/* Atomic queue affinity data of a thread */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Number of queues in affinity queues */
+	odp_atomic_u32_t num;
+
+	/* Thread has been initialized and not yet terminated */
+	odp_atomic_u32_t active;
+
+	/* Statistics. Updated only by the owner thread. */
+	struct ODP_ALIGNED_CACHE {
+		/* Atomic queue was last processed by the same thread */
+		uint64_t hit;
+		/* Atomic queue was last processed by another thread */
+		uint64_t miss;
+		/* Released atomic queue did not fit into affinity queues */
+		uint64_t spill;
+		/* Atomic queue taken from another thread's affinity queues */
+		uint64_t steal;
+	} stat;
+
+	/* Affinity queues per priority */
+	affinity_queue_t prio_q[NUM_PRIO];
+
+} thr_affinity_t;
+
 /* Order context of a queue */
 typedef struct ODP_ALIGNED_CACHE {
 	/* Current ordered context id */
@@ -179,15 +280,81 @@ typedef struct ODP_ALIGNED_CACHE {
 
 } order_context_t;
 
+/* Stashed enqueue operations of an ordered context. Performed by the thread
+ * that releases the context in order. */
+typedef struct ODP_ALIGNED_CACHE reorder_bank_t {
+	/* Bank is in use by the owner thread or parked */
+	odp_atomic_u32_t busy;
+
+	/* Number of stashed events */
+	uint32_t num;
+
+	/* Destination queue per event */
+	odp_queue_t queue[REORDER_BANK_SIZE];
+
+	/* Stashed events */
+	odp_buffer_hdr_t *buf_hdr[REORDER_BANK_SIZE];
+
+} reorder_bank_t;
+
+/* Reorder buffer data. Reserved only when the mode is enabled. */
+typedef struct {
+	/* Parked ordered contexts per queue */
+	odp_atomic_u32_t slot[CONFIG_MAX_SCHED_QUEUES][REORDER_WINDOW];
+
+	/* Statistics per thread. Updated only by the owner thread. */
+	struct ODP_ALIGNED_CACHE {
+		/* Context was parked instead of waiting */
+		uint64_t park;
+		/* Parked context of another thread was released */
+		uint64_t drain;
+		/* Waited for order */
+		uint64_t wait;
+	} stat[ODP_THREAD_COUNT_MAX];
+
+	/* Reorder banks of all threads */
+	reorder_bank_t bank[ODP_THREAD_COUNT_MAX * REORDER_BANKS];
+
+} sched_reorder_t;
+
+/* Adaptive packet input poll state of a queue. Accessed only by the thread
+ * that has dequeued the queue from its priority queue. */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Current back off interval in scheduling rounds */
+	uint16_t backoff;
+	/* Scheduling rounds left to skip */
+	uint16_t skip;
+	/* Previous poll filled the whole burst */
+	uint8_t busy;
+	/* Interface supports readiness check */
+	uint8_t fd_hint;
+
+	struct {
+		uint64_t poll;
+		uint64_t empty;
+		uint64_t skip;
+		uint64_t not_ready;
+	} stat;
+
+} pktin_poll_t;
+
 typedef struct {
 	struct {
 		uint8_t burst_default[NUM_PRIO];
 		uint8_t burst_max[NUM_PRIO];
 		uint8_t num_spread;
 		uint8_t prefer_ratio;
+		uint8_t affinity;
+		uint8_t affinity_max;
+		uint8_t reorder;
+		uint8_t prio_mode;
+		uint8_t prio_weight[NUM_PRIO];
+		uint16_t pktin_backoff_max;
 	} config;
 
 	uint16_t         max_spread;
+	uint16_t         prio_tbl_size;
+	uint8_t          prio_tbl[PRIO_WEIGHT_TBL_SIZE];
 	uint32_t         ring_mask;
 	prio_q_mask_t    prio_q_mask[NUM_PRIO];
 	odp_spinlock_t   mask_lock;
@@ -204,6 +371,8 @@ typedef struct {
 		uint8_t poll_pktin;
 		uint8_t pktio_index;
 		uint8_t pktin_index;
+		/* Thread that scheduled the atomic queue last time */
+		uint16_t last_thr;
 	} queue[CONFIG_MAX_SCHED_QUEUES];
 
 	/* Scheduler priority queues */
@@ -227,6 +396,16 @@ typedef struct {
 
 	order_context_t order[CONFIG_MAX_SCHED_QUEUES];
 
+	/* Adaptive packet input poll state per queue */
+	pktin_poll_t pktin_poll[CONFIG_MAX_SCHED_QUEUES];
+
+	/* Atomic queue affinity data per thread */
+	thr_affinity_t affinity[ODP_THREAD_COUNT_MAX];
+
+	/* Ordered queue reorder buffer */
+	sched_reorder_t *reorder;
+	odp_shm_t        reorder_shm;
+
 	/* Scheduler interface config options (not used in fast path) */
 	schedule_config_t config_if;
 	uint32_t max_queues;
@@ -287,6 +466,73 @@ static int read_config_file(sched_global_t *sched)
 	sched->config.prefer_ratio = val + 1;
 	ODP_PRINT("  %s: %i\n", str, val);
 
+	str = "sched_basic.atomic_affinity";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	sched->config.affinity = !!val;
+	ODP_PRINT("  %s: %i\n", str, val);
+
+	str = "sched_basic.atomic_affinity_max";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val > MAX_AFFINITY || val < 1) {
+		ODP_ERR("Bad value %s = %u [min: 1, max: %u]\n", str, val,
+			MAX_AFFINITY);
+		return -1;
+	}
+
+	sched->config.affinity_max = val;
+	ODP_PRINT("  %s: %i\n", str, val);
+
+	str = "sched_basic.ordered_reorder";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	sched->config.reorder = !!val;
+	ODP_PRINT("  %s: %i\n", str, val);
+
+	str = "sched_basic.prio_mode";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val != PRIO_MODE_STRICT && val != PRIO_MODE_WEIGHTED) {
+		ODP_ERR("Bad value %s = %i\n", str, val);
+		return -1;
+	}
+
+	sched->config.prio_mode = val;
+	ODP_PRINT("  %s: %i\n", str, val);
+
+	str = "sched_basic.prio_weight";
+	if (_odp_libconfig_lookup_array(str, burst_val, NUM_PRIO) !=
+	    NUM_PRIO) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	ODP_PRINT("  %s[] =         ", str);
+	for (i = 0; i < NUM_PRIO; i++) {
+		val = burst_val[i];
+		sched->config.prio_weight[i] = val;
+		ODP_PRINT(" %3i", val);
+
+		if (val > MAX_PRIO_WEIGHT || val < MIN_PRIO_WEIGHT) {
+			ODP_ERR("Bad value %i\n", val);
+			return -1;
+		}
+	}
+	ODP_PRINT("\n");
+
 	str = "sched_basic.burst_size_default";
 	if (_odp_libconfig_lookup_array(str, burst_val, NUM_PRIO) !=
 	    NUM_PRIO) {
@@ -328,6 +574,21 @@ static int read_config_file(sched_global_t *sched)
 
 	ODP_PRINT("\n");
 
+	str = "sched_basic.pktin_poll_backoff_max";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val > MAX_PKTIN_BACKOFF || val < 0) {
+		ODP_ERR("Bad value %s = %i [min: 0, max: %i]\n", str, val,
+			MAX_PKTIN_BACKOFF);
+		return -1;
+	}
+
+	sched->config.pktin_backoff_max = val;
+	ODP_PRINT("  %s: %i\n", str, val);
+
 	str = "sched_basic.group_enable.all";
 	if (!_odp_libconfig_lookup_int(str, &val)) {
 		ODP_ERR("Config option '%s' not found.\n", str);
@@ -366,6 +627,271 @@ static inline uint8_t spread_index(uint32_t index)
 	return index % sched->config.num_spread;
 }
 
+static inline ring_u32_t *queue_home_ring(uint32_t queue_index)
+{
+	int grp    = sched->queue[queue_index].grp;
+	int prio   = sched->queue[queue_index].prio;
+	int spread = sched->queue[queue_index].spread;
+
+	return &sched->prio_q[grp][prio][spread].ring;
+}
+
+static inline int queue_is_pktin(uint32_t queue_index)
+{
+	return sched->queue[queue_index].poll_pktin;
+}
+
+/* Add an atomic queue into affinity queues of a thread. Fails when the thread
+ * already holds the maximum number of queues. */
+static inline int affinity_enq(int thr, uint32_t queue_index)
+{
+	thr_affinity_t *aff = &sched->affinity[thr];
+	int prio = sched->queue[queue_index].prio;
+
+	if (odp_atomic_fetch_inc_u32(&aff->num) >= sched->config.affinity_max) {
+		odp_atomic_dec_u32(&aff->num);
+		return 0;
+	}
+
+	ring_u32_enq(&aff->prio_q[prio].ring, AFFINITY_RING_SIZE - 1,
+		     queue_index);
+	return 1;
+}
+
+/* Dequeue a queue from own affinity queue of a priority level. Queues of groups
+ * the thread is not a member of anymore are moved back to priority queues. */
+static inline int affinity_deq(int prio, uint32_t *queue_index)
+{
+	int thr = sched_local.thr;
+	thr_affinity_t *aff = &sched->affinity[thr];
+	ring_u32_t *ring = &aff->prio_q[prio].ring;
+	uint32_t qi;
+
+	while (ring_u32_deq(ring, AFFINITY_RING_SIZE - 1, &qi)) {
+		int grp = sched->queue[qi].grp;
+
+		odp_atomic_dec_u32(&aff->num);
+
+		if (odp_likely(odp_thrmask_isset(&sched->sched_grp[grp].mask,
+						 thr))) {
+			*queue_index = qi;
+			return 1;
+		}
+
+		ring_u32_enq(queue_home_ring(qi), sched->ring_mask, qi);
+	}
+
+	return 0;
+}
+
+/* Move all queues from affinity queues of a thread back to priority queues */
+static void affinity_flush(int thr)
+{
+	thr_affinity_t *aff = &sched->affinity[thr];
+	uint32_t qi;
+	int prio;
+
+	for (prio = 0; prio < NUM_PRIO; prio++) {
+		ring_u32_t *ring = &aff->prio_q[prio].ring;
+
+		while (ring_u32_deq(ring, AFFINITY_RING_SIZE - 1, &qi)) {
+			odp_atomic_dec_u32(&aff->num);
+			ring_u32_enq(queue_home_ring(qi), sched->ring_mask, qi);
+		}
+	}
+}
+
+/* Take the highest priority queue from affinity queues of another thread. Scans
+ * a few threads per call in round robin order. */
+static int affinity_steal(void)
+{
+	int i, prio;
+	int thr = sched_local.thr;
+	int num_thr = odp_thread_count_max();
+	uint32_t qi;
+
+	for (i = 0; i < AFFINITY_STEAL_SCAN; i++) {
+		thr_affinity_t *aff;
+		int victim = sched_local.steal_thr + 1;
+
+		if (victim >= num_thr)
+			victim = 0;
+
+		sched_local.steal_thr = victim;
+		aff = &sched->affinity[victim];
+
+		if (victim == thr || odp_atomic_load_u32(&aff->num) == 0)
+			continue;
+
+		for (prio = 0; prio < NUM_PRIO; prio++) {
+			ring_u32_t *ring = &aff->prio_q[prio].ring;
+
+			if (ring_u32_deq(ring, AFFINITY_RING_SIZE - 1, &qi) == 0)
+				continue;
+
+			odp_atomic_dec_u32(&aff->num);
+
+			if (!affinity_enq(thr, qi))
+				ring_u32_enq(queue_home_ring(qi),
+					     sched->ring_mask, qi);
+
+			sched->affinity[thr].stat.steal++;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/* Update affinity statistics and owner thread of a scheduled atomic queue */
+static inline void affinity_update(uint32_t queue_index)
+{
+	int thr = sched_local.thr;
+	thr_affinity_t *aff = &sched->affinity[thr];
+
+	if (sched->queue[queue_index].last_thr == thr) {
+		aff->stat.hit++;
+	} else {
+		aff->stat.miss++;
+		sched->queue[queue_index].last_thr = thr;
+	}
+}
+
+static void affinity_print(void)
+{
+	int i;
+
+	ODP_PRINT("\nScheduler atomic queue affinity statistics\n");
+	ODP_PRINT("------------------------------------------\n");
+	ODP_PRINT("  thr           hit          miss         spill         steal\n");
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		thr_affinity_t *aff = &sched->affinity[i];
+
+		if (aff->stat.hit == 0 && aff->stat.miss == 0)
+			continue;
+
+		ODP_PRINT("  %3i %13" PRIu64 " %13" PRIu64 " %13" PRIu64 " %13"
+			  PRIu64 "\n", i, aff->stat.hit, aff->stat.miss,
+			  aff->stat.spill, aff->stat.steal);
+	}
+
+	ODP_PRINT("\n");
+}
+
+static int reorder_init(void)
+{
+	sched_reorder_t *rob;
+	odp_shm_t shm;
+	uint32_t i, j;
+
+	shm = odp_shm_reserve("_odp_sched_reorder", sizeof(sched_reorder_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		ODP_ERR("Reorder buffer shm reserve failed.\n");
+		return -1;
+	}
+
+	rob = odp_shm_addr(shm);
+	memset(rob, 0, sizeof(sched_reorder_t));
+
+	for (i = 0; i < CONFIG_MAX_SCHED_QUEUES; i++)
+		for (j = 0; j < REORDER_WINDOW; j++)
+			odp_atomic_init_u32(&rob->slot[i][j], 0);
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX * REORDER_BANKS; i++)
+		odp_atomic_init_u32(&rob->bank[i].busy, 0);
+
+	sched->reorder = rob;
+	sched->reorder_shm = shm;
+
+	return 0;
+}
+
+static void reorder_print(void)
+{
+	int i;
+
+	ODP_PRINT("\nScheduler ordered queue reorder statistics\n");
+	ODP_PRINT("------------------------------------------\n");
+	ODP_PRINT("  thr          park         drain          wait\n");
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		uint64_t park = sched->reorder->stat[i].park;
+		uint64_t drain = sched->reorder->stat[i].drain;
+		uint64_t wait = sched->reorder->stat[i].wait;
+
+		if (park == 0 && drain == 0 && wait == 0)
+			continue;
+
+		ODP_PRINT("  %3i %13" PRIu64 " %13" PRIu64 " %13" PRIu64 "\n",
+			  i, park, drain, wait);
+	}
+
+	ODP_PRINT("\n");
+}
+
+static void pktin_poll_print(void)
+{
+	uint32_t qi;
+
+	ODP_PRINT("\nScheduler packet input poll statistics\n");
+	ODP_PRINT("--------------------------------------\n");
+	ODP_PRINT("  queue pktio pktin          poll         empty empty%%"
+		  "          skip     not ready\n");
+
+	for (qi = 0; qi < CONFIG_MAX_SCHED_QUEUES; qi++) {
+		pktin_poll_t *pp = &sched->pktin_poll[qi];
+		uint64_t empty_pct = 0;
+
+		if (pp->stat.poll == 0 && pp->stat.skip == 0)
+			continue;
+
+		if (pp->stat.poll)
+			empty_pct = (100 * pp->stat.empty) / pp->stat.poll;
+
+		ODP_PRINT("  %5u %5u %5u %13" PRIu64 " %13" PRIu64 " %6" PRIu64
+			  " %13" PRIu64 " %13" PRIu64 "\n", qi,
+			  sched->queue[qi].pktio_index,
+			  sched->queue[qi].pktin_index, pp->stat.poll,
+			  pp->stat.empty, empty_pct, pp->stat.skip,
+			  pp->stat.not_ready);
+	}
+
+	ODP_PRINT("\n");
+}
+
+/* Fill in priority weight table. Each priority appears in the table
+ * prio_weight[prio] times, spread evenly over the table (smooth weighted round
+ * robin). */
+static void prio_weight_tbl_init(void)
+{
+	int i, prio, sel;
+	int tot = 0;
+	int cur[NUM_PRIO];
+
+	for (prio = 0; prio < NUM_PRIO; prio++) {
+		cur[prio] = 0;
+		tot += sched->config.prio_weight[prio];
+	}
+
+	for (i = 0; i < tot; i++) {
+		sel = 0;
+
+		for (prio = 0; prio < NUM_PRIO; prio++) {
+			cur[prio] += sched->config.prio_weight[prio];
+
+			if (cur[prio] > cur[sel])
+				sel = prio;
+		}
+
+		cur[sel] -= tot;
+		sched->prio_tbl[i] = sel;
+	}
+
+	sched->prio_tbl_size = tot;
+}
+
 static void sched_local_init(void)
 {
 	int i;
@@ -378,6 +904,11 @@ static void sched_local_init(void)
 	sched_local.thr         = odp_thread_id();
 	sched_local.sync_ctx    = NO_SYNC_CONTEXT;
 	sched_local.stash.queue = ODP_QUEUE_INVALID;
+	sched_local.steal_thr   = sched_local.thr;
+
+	/* Threads start from different positions of the priority weight
+	 * table */
+	sched_local.prio_round = sched_local.thr % sched->prio_tbl_size;
 
 	spread = spread_index(sched_local.thr);
 	prefer_ratio = sched->config.prefer_ratio;
@@ -427,6 +958,8 @@ static int schedule_init_global(void)
 	/* When num_spread == 1, only spread_tbl[0] is used. */
 	sched->max_spread = (sched->config.num_spread - 1) * prefer_ratio;
 
+	prio_weight_tbl_init();
+
 	ring_size = MAX_RING_SIZE / sched->config.num_spread;
 	ring_size = ROUNDUP_POWER2_U32(ring_size);
 	ODP_ASSERT(ring_size <= MAX_RING_SIZE);
@@ -449,6 +982,23 @@ static int schedule_init_global(void)
 		}
 	}
 
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		thr_affinity_t *aff = &sched->affinity[i];
+
+		odp_atomic_init_u32(&aff->num, 0);
+		odp_atomic_init_u32(&aff->active, 0);
+
+		for (j = 0; j < NUM_PRIO; j++)
+			ring_u32_init(&aff->prio_q[j].ring);
+	}
+
+	sched->reorder_shm = ODP_SHM_INVALID;
+
+	if (sched->config.reorder && reorder_init()) {
+		odp_shm_free(shm);
+		return -1;
+	}
+
 	odp_spinlock_init(&sched->pktio_lock);
 	for (i = 0; i < NUM_PKTIO; i++)
 		sched->pktio[i].num_pktin = 0;
@@ -479,6 +1029,19 @@ static int schedule_term_global(void)
 	int i, j, grp;
 	uint32_t ring_mask = sched->ring_mask;
 
+	if (sched->config.affinity)
+		affinity_print();
+
+	if (sched->config.reorder)
+		reorder_print();
+
+	if (sched->config.pktin_backoff_max)
+		pktin_poll_print();
+
+	/* Queues left in affinity queues of terminated threads */
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		affinity_flush(i);
+
 	for (grp = 0; grp < NUM_SCHED_GRPS; grp++) {
 		for (i = 0; i < NUM_PRIO; i++) {
 			for (j = 0; j < MAX_SPREAD; j++) {
@@ -500,6 +1063,12 @@ static int schedule_term_global(void)
 		}
 	}
 
+	if (sched->reorder_shm != ODP_SHM_INVALID &&
+	    odp_shm_free(sched->reorder_shm)) {
+		ODP_ERR("Shm free failed for reorder buffer");
+		rc = -1;
+	}
+
 	ret = odp_shm_free(sched->shm);
 	if (ret < 0) {
 		ODP_ERR("Shm free failed for odp_scheduler");
@@ -512,6 +1081,7 @@ static int schedule_term_global(void)
 static int schedule_init_local(void)
 {
 	sched_local_init();
+	odp_atomic_store_u32(&sched->affinity[sched_local.thr].active, 1);
 	return 0;
 }
 
@@ -630,6 +1200,7 @@ static int schedule_create_queue(uint32_t queue_index,
 	sched->queue[queue_index].poll_pktin  = 0;
 	sched->queue[queue_index].pktio_index = 0;
 	sched->queue[queue_index].pktin_index = 0;
+	sched->queue[queue_index].last_thr    = NO_AFFINITY_THR;
 
 	odp_atomic_init_u64(&sched->order[queue_index].ctx, 0);
 	odp_atomic_init_u64(&sched->order[queue_index].next_ctx, 0);
@@ -672,10 +1243,19 @@ static void schedule_destroy_queue(uint32_t queue_index)
 
 static int schedule_sched_queue(uint32_t queue_index)
 {
-	int grp      = sched->queue[queue_index].grp;
-	int prio     = sched->queue[queue_index].prio;
-	int spread   = sched->queue[queue_index].spread;
-	ring_u32_t *ring = &sched->prio_q[grp][prio][spread].ring;
+	ring_u32_t *ring = queue_home_ring(queue_index);
+
+	/* Prefer the thread that processed the atomic queue last time */
+	if (sched->config.affinity &&
+	    sched->queue[queue_index].sync == ODP_SCHED_SYNC_ATOMIC &&
+	    !queue_is_pktin(queue_index)) {
+		uint16_t thr = sched->queue[queue_index].last_thr;
+
+		if (thr != NO_AFFINITY_THR &&
+		    odp_atomic_load_u32(&sched->affinity[thr].active) &&
+		    affinity_enq(thr, queue_index))
+			return 0;
+	}
 
 	ring_u32_enq(ring, sched->ring_mask, queue_index);
 	return 0;
@@ -695,6 +1275,9 @@ static void schedule_pktio_start(int pktio_index, int num_pktin,
 		sched->queue[qi].pktio_index = pktio_index;
 		sched->queue[qi].pktin_index = pktin_idx[i];
 
+		memset(&sched->pktin_poll[qi], 0, sizeof(pktin_poll_t));
+		sched->pktin_poll[qi].fd_hint = 1;
+
 		ODP_ASSERT(pktin_idx[i] <= MAX_PKTIN_INDEX);
 
 		/* Start polling */
@@ -708,8 +1291,18 @@ static inline void release_atomic(void)
 	uint32_t qi  = sched_local.stash.qi;
 	ring_u32_t *ring = sched_local.stash.ring;
 
-	/* Release current atomic queue */
-	ring_u32_enq(ring, sched->ring_mask, qi);
+	/* Release current atomic queue. With affinity, the queue stays on this
+	 * thread unless the thread has already too many queues. */
+	if (sched->config.affinity && !sched_local.pause &&
+	    !queue_is_pktin(qi)) {
+		if (affinity_enq(sched_local.thr, qi))
+			ring = NULL;
+		else
+			sched->affinity[sched_local.thr].stat.spill++;
+	}
+
+	if (ring)
+		ring_u32_enq(ring, sched->ring_mask, qi);
 
 	/* We don't hold sync context anymore */
 	sched_local.sync_ctx = NO_SYNC_CONTEXT;
@@ -741,6 +1334,64 @@ static inline void wait_for_order(uint32_t queue_index)
 	}
 }
 
+/* Take a free reorder bank of the thread into use */
+static inline reorder_bank_t *reorder_bank_get(void)
+{
+	uint32_t i;
+	uint32_t first = sched_local.thr * REORDER_BANKS;
+
+	for (i = first; i < first + REORDER_BANKS; i++) {
+		reorder_bank_t *bank = &sched->reorder->bank[i];
+
+		if (odp_atomic_load_acq_u32(&bank->busy))
+			continue;
+
+		odp_atomic_store_u32(&bank->busy, 1);
+		bank->num = 0;
+		sched_local.ordered.bank = bank;
+		sched_local.ordered.bank_idx = i;
+		return bank;
+	}
+
+	return NULL;
+}
+
+/* Perform enqueue operations of a reorder bank and free the bank. Consecutive
+ * events to the same destination queue are enqueued as a burst. */
+static inline void reorder_bank_flush(reorder_bank_t *bank)
+{
+	uint32_t i = 0;
+
+	while (i < bank->num) {
+		odp_queue_t queue = bank->queue[i];
+		odp_buffer_hdr_t **buf_hdr = &bank->buf_hdr[i];
+		int num = 1;
+		int num_enq;
+
+		while (i + num < bank->num && num < QUEUE_MULTI_MAX &&
+		       bank->queue[i + num] == queue)
+			num++;
+
+		num_enq = odp_queue_enq_multi(queue, (odp_event_t *)buf_hdr,
+					      num);
+
+		/* Drop packets that were not enqueued */
+		if (odp_unlikely(num_enq < num)) {
+			if (odp_unlikely(num_enq < 0))
+				num_enq = 0;
+
+			ODP_DBG("Dropped %i packets\n", num - num_enq);
+			_odp_buffer_free_multi(&buf_hdr[num_enq],
+					       num - num_enq);
+		}
+
+		i += num;
+	}
+
+	bank->num = 0;
+	odp_atomic_store_rel_u32(&bank->busy, 0);
+}
+
 /**
  * Perform stashed enqueue operations
  *
@@ -750,6 +1401,11 @@ static inline void ordered_stash_release(void)
 {
 	int i;
 
+	if (sched_local.ordered.bank) {
+		reorder_bank_flush(sched_local.ordered.bank);
+		sched_local.ordered.bank = NULL;
+	}
+
 	for (i = 0; i < sched_local.ordered.stash_num; i++) {
 		odp_queue_t queue;
 		odp_buffer_hdr_t **buf_hdr;
@@ -774,6 +1430,129 @@ static inline void ordered_stash_release(void)
 	sched_local.ordered.stash_num = 0;
 }
 
+/* Stash an enqueue operation into the reorder bank of the thread. When stash
+ * space runs out, waits for order and performs stashed operations. */
+static inline int reorder_enq(uint32_t src_queue, odp_queue_t dst_queue,
+			      void *buf_hdr[], int num, int *ret)
+{
+	reorder_bank_t *bank = sched_local.ordered.bank;
+	int i;
+
+	if (bank == NULL)
+		bank = reorder_bank_get();
+
+	if (odp_unlikely(bank == NULL ||
+			 bank->num + num > REORDER_BANK_SIZE)) {
+		sched->reorder->stat[sched_local.thr].wait++;
+		wait_for_order(src_queue);
+
+		sched_local.ordered.in_order = 1;
+
+		ordered_stash_release();
+		return 0;
+	}
+
+	for (i = 0; i < num; i++) {
+		bank->queue[bank->num + i] = dst_queue;
+		bank->buf_hdr[bank->num + i] = buf_hdr[i];
+	}
+
+	bank->num += num;
+
+	*ret = num;
+	return 1;
+}
+
+/* Park ordered context into the reorder window of the source queue. Returns 1
+ * when the context was parked. The thread that releases the previous context
+ * releases also this one. Returns 0 when the context must be released in order
+ * by this thread. */
+static inline int reorder_park(uint32_t qi)
+{
+	odp_atomic_u64_t *order_ctx = &sched->order[qi].ctx;
+	uint64_t ctx_id = sched_local.ordered.ctx;
+	uint64_t head = odp_atomic_load_acq_u64(order_ctx);
+	odp_atomic_u32_t *slot;
+	uint32_t val, i;
+
+	if (head == ctx_id)
+		return 0;
+
+	/* Too far ahead, slot may be still in use */
+	if (ctx_id - head >= REORDER_WINDOW) {
+		sched->reorder->stat[sched_local.thr].wait++;
+		return 0;
+	}
+
+	val = REORDER_SLOT_VALID;
+
+	for (i = 0; i < sched->queue[qi].order_lock_count; i++) {
+		if (sched_local.ordered.lock_called.u8[i])
+			val |= 1 << (REORDER_SLOT_LOCK_SHIFT + i);
+	}
+
+	if (sched_local.ordered.bank)
+		val |= sched_local.ordered.bank_idx + 1;
+
+	slot = &sched->reorder->slot[qi][ctx_id & (REORDER_WINDOW - 1)];
+	odp_atomic_store_rel_u32(slot, val);
+
+	/* Order slot store and context load. Pairs with reorder_drain(). */
+	odp_mb_full();
+
+	/* Previous context was released meanwhile. Take own context back, if
+	 * the releasing thread did not take it already. */
+	if (odp_atomic_load_acq_u64(order_ctx) == ctx_id &&
+	    odp_atomic_xchg_u32(slot, 0))
+		return 0;
+
+	sched->reorder->stat[sched_local.thr].park++;
+	sched_local.ordered.bank = NULL;
+	sched_local.ordered.lock_called.all = 0;
+	sched_local.sync_ctx = NO_SYNC_CONTEXT;
+	return 1;
+}
+
+/* Pass order to the next context and release following contexts that have
+ * been parked */
+static inline void reorder_drain(uint32_t qi, uint64_t ctx_id)
+{
+	odp_atomic_u64_t *order_ctx = &sched->order[qi].ctx;
+	odp_atomic_u64_t *lock = sched->order[qi].lock;
+	uint32_t lock_count = sched->queue[qi].order_lock_count;
+	sched_reorder_t *rob = sched->reorder;
+	odp_atomic_u32_t *slot;
+	uint32_t val, bank_idx, i;
+
+	while (1) {
+		ctx_id++;
+		odp_atomic_store_rel_u64(order_ctx, ctx_id);
+
+		/* Order context store and slot exchange. Pairs with
+		 * reorder_park(). */
+		odp_mb_full();
+
+		slot = &rob->slot[qi][ctx_id & (REORDER_WINDOW - 1)];
+		val = odp_atomic_xchg_u32(slot, 0);
+		if (val == 0)
+			return;
+
+		odp_mb_acquire();
+
+		/* Continue on behalf of the parked context */
+		for (i = 0; i < lock_count; i++) {
+			if (!(val & (1 << (REORDER_SLOT_LOCK_SHIFT + i))))
+				odp_atomic_store_rel_u64(&lock[i], ctx_id + 1);
+		}
+
+		bank_idx = val & REORDER_SLOT_BANK_MASK;
+		if (bank_idx)
+			reorder_bank_flush(&rob->bank[bank_idx - 1]);
+
+		rob->stat[sched_local.thr].drain++;
+	}
+}
+
 static inline void release_ordered(void)
 {
 	uint32_t qi;
@@ -781,6 +1560,10 @@ static inline void release_ordered(void)
 
 	qi = sched_local.ordered.src_queue;
 
+	if (sched->config.reorder && !sched_local.ordered.in_order &&
+	    reorder_park(qi))
+		return;
+
 	wait_for_order(qi);
 
 	/* Release all ordered locks */
@@ -799,7 +1582,10 @@ static inline void release_ordered(void)
 	ordered_stash_release();
 
 	/* Next thread can continue processing */
-	odp_atomic_add_rel_u64(&sched->order[qi].ctx, 1);
+	if (sched->config.reorder)
+		reorder_drain(qi, sched_local.ordered.ctx);
+	else
+		odp_atomic_add_rel_u64(&sched->order[qi].ctx, 1);
 }
 
 static void schedule_release_ordered(void)
@@ -823,6 +1609,9 @@ static int schedule_term_local(void)
 	else if (sched_local.sync_ctx == ODP_SCHED_SYNC_ORDERED)
 		schedule_release_ordered();
 
+	odp_atomic_store_u32(&sched->affinity[sched_local.thr].active, 0);
+	affinity_flush(sched_local.thr);
+
 	return 0;
 }
 
@@ -917,6 +1706,11 @@ static int schedule_ord_enq_multi(odp_queue_t dst_queue, void *buf_hdr[],
 		return 0;
 	}
 
+	/* In reorder buffer mode, also pktout operations are stashed and
+	 * dropped packets are freed. */
+	if (sched->config.reorder)
+		return reorder_enq(src_queue, dst_queue, buf_hdr, num, ret);
+
 	/* Pktout may drop packets, so the operation cannot be stashed. */
 	if (dst_qentry->s.pktout.pktio != ODP_PKTIO_INVALID ||
 	    odp_unlikely(stash_num >=  MAX_ORDERED_STASH)) {
@@ -941,9 +1735,65 @@ static int schedule_ord_enq_multi(odp_queue_t dst_queue, void *buf_hdr[],
 	return 1;
 }
 
-static inline int queue_is_pktin(uint32_t queue_index)
+/* Returns 1 when polling of a backed off packet input queue is skipped on this
+ * scheduling round */
+static inline int pktin_poll_skip(uint32_t qi, int pktio_index, int pktin_index)
 {
-	return sched->queue[queue_index].poll_pktin;
+	pktin_poll_t *pp = &sched->pktin_poll[qi];
+	int ready;
+
+	if (pp->skip) {
+		pp->skip--;
+		pp->stat.skip++;
+		return 1;
+	}
+
+	/* Check readiness before polling a backed off queue. Queues at the
+	 * maximum back off are always polled, so that packets buffered in
+	 * the driver (and not signaled through the file descriptor) are not
+	 * delayed indefinitely. */
+	if (pp->backoff == 0 || pp->backoff >= sched->config.pktin_backoff_max ||
+	    !pp->fd_hint)
+		return 0;
+
+	ready = _odp_sched_cb_pktin_ready(pktio_index, pktin_index);
+
+	if (ready < 0) {
+		pp->fd_hint = 0;
+		return 0;
+	}
+
+	if (ready)
+		return 0;
+
+	pp->stat.not_ready++;
+	pp->backoff = 2 * pp->backoff;
+	if (pp->backoff > sched->config.pktin_backoff_max)
+		pp->backoff = sched->config.pktin_backoff_max;
+	pp->skip = pp->backoff;
+
+	return 1;
+}
+
+static inline void pktin_poll_update(uint32_t qi, int num, int max_num)
+{
+	pktin_poll_t *pp = &sched->pktin_poll[qi];
+
+	pp->stat.poll++;
+
+	if (num) {
+		pp->backoff = 0;
+		pp->busy = (num >= max_num);
+		return;
+	}
+
+	/* Back off exponentially on consecutive empty polls */
+	pp->stat.empty++;
+	pp->busy = 0;
+	pp->backoff = pp->backoff ? 2 * pp->backoff : 1;
+	if (pp->backoff > sched->config.pktin_backoff_max)
+		pp->backoff = sched->config.pktin_backoff_max;
+	pp->skip = pp->backoff;
 }
 
 static inline int poll_pktin(uint32_t qi, int direct_recv,
@@ -953,7 +1803,9 @@ static inline int poll_pktin(uint32_t qi, int direct_recv,
 	odp_buffer_hdr_t **hdr_tbl;
 	int ret;
 	void *q_int;
+	uint64_t trace_start;
 	odp_buffer_hdr_t *b_hdr[CONFIG_BURST_SIZE];
+	int adaptive = sched->config.pktin_backoff_max;
 
 	hdr_tbl = (odp_buffer_hdr_t **)ev_tbl;
 
@@ -968,7 +1820,15 @@ static inline int poll_pktin(uint32_t qi, int direct_recv,
 	pktio_index = sched->queue[qi].pktio_index;
 	pktin_index = sched->queue[qi].pktin_index;
 
+	if (adaptive && pktin_poll_skip(qi, pktio_index, pktin_index))
+		return 0;
+
+	trace_start = _odp_trace_begin();
 	num = _odp_sched_cb_pktin_poll(pktio_index, pktin_index, hdr_tbl, max_num);
+	_odp_trace_end(_ODP_TRACE_PKTIN_POLL, trace_start, pktio_index, num);
+
+	if (adaptive && num >= 0)
+		pktin_poll_update(qi, num, max_num);
 
 	if (num == 0)
 		return 0;
@@ -1011,18 +1871,29 @@ static inline int poll_pktin(uint32_t qi, int direct_recv,
 }
 
 static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
-				  unsigned int max_num, int grp, int first)
+				  unsigned int max_num, int grp, int first,
+				  int prio_first)
 {
-	int prio, i;
+	int prio, n, i;
 	int ret;
 	int id;
 	uint32_t qi;
 	uint16_t burst_def;
 	int num_spread = sched->config.num_spread;
 	uint32_t ring_mask = sched->ring_mask;
+	int affinity = sched->config.affinity;
+	odp_atomic_u32_t *aff_num = &sched->affinity[sched_local.thr].num;
+
+	/* Schedule events. In weighted mode, prio_first is served first and
+	 * then all priorities in strict order. */
+	for (n = (prio_first < 0) ? 0 : -1; n < NUM_PRIO; n++) {
+		if (n < 0)
+			prio = prio_first;
+		else if (n == prio_first)
+			continue;
+		else
+			prio = n;
 
-	/* Schedule events */
-	for (prio = 0; prio < NUM_PRIO; prio++) {
 		if (sched->prio_q_mask[prio] == 0)
 			continue;
 
@@ -1044,22 +1915,29 @@ static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
 			if (id >= num_spread)
 				id = 0;
 
-			/* No queues created for this priority queue */
-			if (odp_unlikely((sched->prio_q_mask[prio] & (1 << id))
-			    == 0)) {
-				i++;
-				id++;
-				continue;
-			}
+			/* Atomic queues with affinity to this thread are
+			 * served first */
+			if (affinity && odp_atomic_load_u32(aff_num) &&
+			    affinity_deq(prio, &qi)) {
+				ring = queue_home_ring(qi);
+			} else {
+				/* No queues created for this priority queue */
+				if (odp_unlikely((sched->prio_q_mask[prio] &
+						  (1 << id)) == 0)) {
+					i++;
+					id++;
+					continue;
+				}
 
-			/* Get queue index from the priority queue */
-			ring = &sched->prio_q[grp][prio][id].ring;
+				/* Get queue index from the priority queue */
+				ring = &sched->prio_q[grp][prio][id].ring;
 
-			if (ring_u32_deq(ring, ring_mask, &qi) == 0) {
-				/* Priority queue empty */
-				i++;
-				id++;
-				continue;
+				if (ring_u32_deq(ring, ring_mask, &qi) == 0) {
+					/* Priority queue empty */
+					i++;
+					id++;
+					continue;
+				}
 			}
 
 			sync_ctx = sched_sync_type(qi);
@@ -1083,6 +1961,11 @@ static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
 
 			pktin = queue_is_pktin(qi);
 
+			/* Busy packet input queues are served with the full
+			 * stash size */
+			if (pktin && stashed && sched->pktin_poll[qi].busy)
+				max_deq = STASH_SIZE;
+
 			num = _odp_sched_queue_deq(qi, ev_tbl, max_deq, !pktin);
 
 			if (odp_unlikely(num < 0)) {
@@ -1139,6 +2022,9 @@ static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
 				sched_local.sync_ctx = sync_ctx;
 
 			} else if (sync_ctx == ODP_SCHED_SYNC_ATOMIC) {
+				if (affinity && !pktin)
+					affinity_update(qi);
+
 				/* Hold queue during atomic access */
 				sched_local.stash.qi   = qi;
 				sched_local.stash.ring = ring;
@@ -1174,12 +2060,13 @@ static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
 /*
  * Schedule queues
  */
-static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
-			      unsigned int max_num)
+static inline int schedule_queues(odp_queue_t *out_queue, odp_event_t out_ev[],
+				  unsigned int max_num)
 {
 	int i, num_grp;
 	int ret;
 	int first, grp_id;
+	int prio_first = -1;
 	uint16_t spread_round, grp_round;
 	uint32_t epoch;
 
@@ -1201,6 +2088,13 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 	if (odp_unlikely(sched_local.pause))
 		return 0;
 
+	/* Balance load between threads also when this thread is busy */
+	if (sched->config.affinity &&
+	    odp_unlikely(++sched_local.steal_round >= AFFINITY_STEAL_ROUNDS)) {
+		sched_local.steal_round = 0;
+		affinity_steal();
+	}
+
 	/* Each thread prefers a priority queue. Spread weight table avoids
 	 * starvation of other priority queues on low thread counts. */
 	spread_round = sched_local.spread_round;
@@ -1213,6 +2107,19 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 
 	first = sched_local.spread_tbl[spread_round];
 
+	/* Weighted priority mode guarantees each priority a share of
+	 * scheduling rounds */
+	if (sched->config.prio_mode == PRIO_MODE_WEIGHTED) {
+		uint16_t prio_round = sched_local.prio_round;
+
+		prio_first = sched->prio_tbl[prio_round];
+
+		if (odp_unlikely(prio_round + 1 >= sched->prio_tbl_size))
+			sched_local.prio_round = 0;
+		else
+			sched_local.prio_round = prio_round + 1;
+	}
+
 	epoch = odp_atomic_load_acq_u32(&sched->grp_epoch);
 	num_grp = sched_local.num_grp;
 
@@ -1228,7 +2135,8 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 		int grp;
 
 		grp = sched_local.grp[grp_id];
-		ret = do_schedule_grp(out_queue, out_ev, max_num, grp, first);
+		ret = do_schedule_grp(out_queue, out_ev, max_num, grp, first,
+				      prio_first);
 
 		if (odp_likely(ret))
 			return ret;
@@ -1238,9 +2146,29 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 			grp_id = 0;
 	}
 
+	/* Idle thread takes over queues from other threads. Those are
+	 * scheduled on the next round. */
+	if (sched->config.affinity)
+		affinity_steal();
+
 	return 0;
 }
 
+static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
+			      unsigned int max_num)
+{
+	uint64_t trace_start = _odp_trace_begin();
+	int ret;
+
+	ret = schedule_queues(out_queue, out_ev, max_num);
+
+	if (_ODP_TRACE && ret > 0)
+		_odp_trace_end(_ODP_TRACE_SCHEDULE, trace_start,
+			       out_queue ? (uintptr_t)*out_queue : 0, ret);
+
+	return ret;
+}
+
 static inline int schedule_run(odp_queue_t *out_queue, odp_event_t out_ev[],
 			       unsigned int max_num)
 {
@@ -1400,11 +2328,22 @@ static void schedule_order_lock_wait(uint32_t lock_index)
 static void schedule_pause(void)
 {
 	sched_local.pause = 1;
+
+	/* Let other threads continue processing queues of this thread */
+	if (sched->config.affinity) {
+		odp_atomic_store_u32(&sched->affinity[sched_local.thr].active,
+				     0);
+		affinity_flush(sched_local.thr);
+	}
 }
 
 static void schedule_resume(void)
 {
 	sched_local.pause = 0;
+
+	if (sched->config.affinity)
+		odp_atomic_store_u32(&sched->affinity[sched_local.thr].active,
+				     1);
 }
 
 static uint64_t schedule_wait_time(uint64_t ns)
@@ -1651,6 +2590,14 @@ static int schedule_capability(odp_schedule_capability_t *capa)
 	capa->max_queue_size = _odp_queue_glb->config.max_queue_size;
 	capa->max_flow_id = BUF_HDR_MAX_FLOW_ID;
 
+	/* Vectors are formed from events that are in the queue when it is
+	 * scheduled */
+	capa->vector.supported = ODP_SUPPORT_YES;
+	capa->vector.max_size = CONFIG_PACKET_VECTOR_MAX_SIZE;
+	capa->vector.min_size = 1;
+	capa->vector.max_tmo_ns = 0;
+	capa->vector.min_tmo_ns = 0;
+
 	return 0;
 }
 
@@ -1035,6 +1035,14 @@ static int schedule_capability(odp_schedule_capability_t *capa)
 	capa->max_queues = CONFIG_MAX_SCHED_QUEUES;
 	capa->max_queue_size = _odp_queue_glb->config.max_queue_size;
 
+	/* Vectors are formed from events that are in the queue when it is
+	 * scheduled */
+	capa->vector.supported = ODP_SUPPORT_YES;
+	capa->vector.max_size = CONFIG_PACKET_VECTOR_MAX_SIZE;
+	capa->vector.min_size = 1;
+	capa->vector.max_tmo_ns = 0;
+	capa->vector.min_tmo_ns = 0;
+
 	return 0;
 }
 
@@ -10,8 +10,10 @@
 #include <odp/api/ticketlock.h>
 #include <odp/api/shared_memory.h>
 #include <odp/api/stash.h>
+#include <odp/api/thread.h>
 #include <odp/api/plat/strong_types.h>
 
+#include <odp_align_internal.h>
 #include <odp_debug_internal.h>
 #include <odp_init_internal.h>
 #include <odp_ring_ptr_internal.h>
@@ -21,12 +23,32 @@
 #define MAX_RING_SIZE (1024 * 1024)
 #define MIN_RING_SIZE 64
 
+/* Maximum size of thread local cache */
+#define MAX_CACHE_SIZE 256
+
+/* Maximum default burst size between a thread local cache and the ring */
+#define MAX_DEFAULT_BURST 32
+
+/* Thread local cache of object handles. Handles are stored as uintptr_t
+ * values, which fit all supported object sizes. */
+typedef struct ODP_ALIGNED_CACHE stash_cache_t {
+	uint32_t  num;
+	uintptr_t obj[];
+
+} stash_cache_t;
+
 typedef struct stash_t {
 	char      name[ODP_STASH_NAME_LEN];
 	odp_shm_t shm;
 	int       index;
 	uint32_t  ring_mask;
 	uint32_t  obj_size;
+	uint32_t  cache_size;
+	uint32_t  burst_size;
+	uint32_t  cache_stride;
+
+	/* Thread local caches (ODP_THREAD_COUNT_MAX) or NULL */
+	uint8_t   *cache;
 
 	/* Ring header followed by variable sized data (object handles) */
 	union {
@@ -96,6 +118,7 @@ int odp_stash_capability(odp_stash_capability_t *capa, odp_stash_type_t type)
 	capa->max_stashes          = MAX_STASHES;
 	capa->max_num_obj          = MAX_RING_SIZE;
 	capa->max_obj_size         = sizeof(uintptr_t);
+	capa->max_cache_size       = MAX_CACHE_SIZE;
 
 	return 0;
 }
@@ -142,7 +165,8 @@ odp_stash_t odp_stash_create(const char *name, const odp_stash_param_t *param)
 {
 	odp_shm_t shm;
 	stash_t *stash;
-	uint64_t i, ring_size, shm_size;
+	uint64_t i, ring_size, shm_size, ring_len;
+	uint32_t cache_size, burst_size, cache_stride;
 	int ring_ptr, index;
 	char shm_name[ODP_STASH_NAME_LEN + 8];
 
@@ -151,6 +175,34 @@ odp_stash_t odp_stash_create(const char *name, const odp_stash_param_t *param)
 		return ODP_STASH_INVALID;
 	}
 
+	cache_size = param->cache_size;
+	burst_size = param->burst_size;
+
+	if (cache_size > MAX_CACHE_SIZE) {
+		ODP_ERR("Too large cache size.\n");
+		return ODP_STASH_INVALID;
+	}
+
+	if (cache_size && burst_size > cache_size) {
+		ODP_ERR("Burst size larger than cache size.\n");
+		return ODP_STASH_INVALID;
+	}
+
+	/* Default burst size: half of the cache */
+	if (cache_size && burst_size == 0) {
+		burst_size = cache_size / 2;
+
+		if (burst_size > MAX_DEFAULT_BURST)
+			burst_size = MAX_DEFAULT_BURST;
+		if (burst_size == 0)
+			burst_size = 1;
+	}
+
+	cache_stride = 0;
+	if (cache_size)
+		cache_stride = ROUNDUP_CACHE_LINE(sizeof(stash_cache_t) +
+						  cache_size * sizeof(uintptr_t));
+
 	if (param->num_obj > MAX_RING_SIZE) {
 		ODP_ERR("Too many objects.\n");
 		return ODP_STASH_INVALID;
@@ -184,9 +236,13 @@ odp_stash_t odp_stash_create(const char *name, const odp_stash_param_t *param)
 	snprintf(shm_name, sizeof(shm_name) - 1, "_stash_%s", name);
 
 	if (ring_ptr)
-		shm_size = sizeof(stash_t) + (ring_size * sizeof(uintptr_t));
+		ring_len = sizeof(stash_t) + (ring_size * sizeof(uintptr_t));
 	else
-		shm_size = sizeof(stash_t) + (ring_size * sizeof(uint32_t));
+		ring_len = sizeof(stash_t) + (ring_size * sizeof(uint32_t));
+
+	/* Thread local caches follow the ring */
+	ring_len = ROUNDUP_CACHE_LINE(ring_len);
+	shm_size = ring_len + (uint64_t)ODP_THREAD_COUNT_MAX * cache_stride;
 
 	shm = odp_shm_reserve(shm_name, shm_size, ODP_CACHE_LINE_SIZE, 0);
 
@@ -218,6 +274,21 @@ odp_stash_t odp_stash_create(const char *name, const odp_stash_param_t *param)
 	stash->shm          = shm;
 	stash->obj_size     = param->obj_size;
 	stash->ring_mask    = ring_size - 1;
+	stash->cache_size   = cache_size;
+	stash->burst_size   = burst_size;
+	stash->cache_stride = cache_stride;
+	stash->cache        = NULL;
+
+	if (cache_size) {
+		stash->cache = (uint8_t *)stash + ring_len;
+
+		for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+			stash_cache_t *cache = (stash_cache_t *)(uintptr_t)
+					       (stash->cache + i * cache_stride);
+
+			cache->num = 0;
+		}
+	}
 
 	/* This makes stash visible to lookups */
 	odp_ticketlock_lock(&stash_global->lock);
@@ -279,6 +350,201 @@ odp_stash_t odp_stash_lookup(const char *name)
 	return ODP_STASH_INVALID;
 }
 
+static inline stash_cache_t *thread_cache(stash_t *stash)
+{
+	return (stash_cache_t *)(uintptr_t)
+		(stash->cache + odp_thread_id() * stash->cache_stride);
+}
+
+/* Enqueue object handles stored as uintptr_t values into the ring */
+static inline void ring_put(stash_t *stash, const uintptr_t val[], uint32_t num)
+{
+	uint32_t i;
+
+	if (stash->obj_size == sizeof(uintptr_t)) {
+		ring_ptr_enq_multi(&stash->ring_ptr.hdr, stash->ring_mask,
+				   (void **)(uintptr_t)val, num);
+		return;
+	}
+
+	uint32_t u32[num];
+
+	for (i = 0; i < num; i++)
+		u32[i] = val[i];
+
+	ring_u32_enq_multi(&stash->ring_u32.hdr, stash->ring_mask, u32, num);
+}
+
+/* Dequeue object handles from the ring as uintptr_t values */
+static inline uint32_t ring_get(stash_t *stash, uintptr_t val[], uint32_t num)
+{
+	uint32_t i, num_deq;
+
+	if (stash->obj_size == sizeof(uintptr_t))
+		return ring_ptr_deq_multi(&stash->ring_ptr.hdr,
+					  stash->ring_mask, (void **)val, num);
+
+	uint32_t u32[num];
+
+	num_deq = ring_u32_deq_multi(&stash->ring_u32.hdr, stash->ring_mask,
+				     u32, num);
+
+	for (i = 0; i < num_deq; i++)
+		val[i] = u32[i];
+
+	return num_deq;
+}
+
+/* Put object handles into the thread local cache. When the cache is full,
+ * at least a burst of handles is moved from the cache into the ring. */
+static inline void cache_put(stash_t *stash, const uintptr_t val[],
+			     uint32_t num)
+{
+	stash_cache_t *cache = thread_cache(stash);
+	uint32_t cache_size = stash->cache_size;
+	uint32_t cache_num = cache->num;
+	uint32_t burst, i;
+
+	/* Special case of a very large put. Move directly to the ring. */
+	if (odp_unlikely(num > cache_size)) {
+		ring_put(stash, val, num);
+		return;
+	}
+
+	if (odp_unlikely(cache_size - cache_num < num)) {
+		burst = stash->burst_size;
+
+		if (num > burst)
+			burst = num;
+		if (burst > cache_num)
+			burst = cache_num;
+
+		cache_num -= burst;
+		ring_put(stash, &cache->obj[cache_num], burst);
+	}
+
+	for (i = 0; i < num; i++)
+		cache->obj[cache_num + i] = val[i];
+
+	cache->num = cache_num + num;
+}
+
+/* Get object handles from the thread local cache. When the cache runs empty,
+ * at least a burst of handles is moved from the ring into the cache. */
+static inline uint32_t cache_get(stash_t *stash, uintptr_t val[], uint32_t num)
+{
+	stash_cache_t *cache = thread_cache(stash);
+	uint32_t cache_num = cache->num;
+	uint32_t num_ch, num_deq, burst, i;
+
+	num_ch = num;
+	if (num_ch > cache_num)
+		num_ch = cache_num;
+
+	cache_num -= num_ch;
+
+	for (i = 0; i < num_ch; i++)
+		val[i] = cache->obj[cache_num + i];
+
+	cache->num = cache_num;
+
+	if (odp_likely(num_ch == num))
+		return num;
+
+	/* Cache is empty. Get more from the ring. */
+	num_deq = num - num_ch;
+	burst = stash->burst_size;
+	if (num_deq > burst)
+		burst = num_deq;
+
+	uintptr_t tmp[burst];
+
+	burst = ring_get(stash, tmp, burst);
+
+	if (odp_unlikely(burst < num_deq))
+		num_deq = burst;
+
+	for (i = 0; i < num_deq; i++)
+		val[num_ch + i] = tmp[i];
+
+	/* Cache possible extra handles */
+	for (i = num_deq; i < burst; i++)
+		cache->obj[i - num_deq] = tmp[i];
+
+	cache->num = burst - num_deq;
+
+	return num_ch + num_deq;
+}
+
+static int32_t stash_put_cached(stash_t *stash, const void *obj, int32_t num)
+{
+	uint32_t obj_size = stash->obj_size;
+	int32_t i;
+
+	if (obj_size == sizeof(uintptr_t)) {
+		cache_put(stash, obj, num);
+		return num;
+	}
+
+	uintptr_t val[num];
+
+	if (obj_size == sizeof(uint32_t)) {
+		const uint32_t *u32_ptr = obj;
+
+		for (i = 0; i < num; i++)
+			val[i] = u32_ptr[i];
+	} else if (obj_size == sizeof(uint16_t)) {
+		const uint16_t *u16_ptr = obj;
+
+		for (i = 0; i < num; i++)
+			val[i] = u16_ptr[i];
+	} else if (obj_size == sizeof(uint8_t)) {
+		const uint8_t *u8_ptr = obj;
+
+		for (i = 0; i < num; i++)
+			val[i] = u8_ptr[i];
+	} else {
+		return -1;
+	}
+
+	cache_put(stash, val, num);
+	return num;
+}
+
+static int32_t stash_get_cached(stash_t *stash, void *obj, int32_t num)
+{
+	uint32_t obj_size = stash->obj_size;
+	uint32_t i, num_get;
+
+	if (obj_size == sizeof(uintptr_t))
+		return cache_get(stash, obj, num);
+
+	uintptr_t val[num];
+
+	num_get = cache_get(stash, val, num);
+
+	if (obj_size == sizeof(uint32_t)) {
+		uint32_t *u32_ptr = obj;
+
+		for (i = 0; i < num_get; i++)
+			u32_ptr[i] = val[i];
+	} else if (obj_size == sizeof(uint16_t)) {
+		uint16_t *u16_ptr = obj;
+
+		for (i = 0; i < num_get; i++)
+			u16_ptr[i] = val[i];
+	} else if (obj_size == sizeof(uint8_t)) {
+		uint8_t *u8_ptr = obj;
+
+		for (i = 0; i < num_get; i++)
+			u8_ptr[i] = val[i];
+	} else {
+		return -1;
+	}
+
+	return num_get;
+}
+
 int32_t odp_stash_put(odp_stash_t st, const void *obj, int32_t num)
 {
 	stash_t *stash;
@@ -290,6 +556,9 @@ int32_t odp_stash_put(odp_stash_t st, const void *obj, int32_t num)
 	if (odp_unlikely(st == ODP_STASH_INVALID))
 		return -1;
 
+	if (stash->cache)
+		return stash_put_cached(stash, obj, num);
+
 	obj_size = stash->obj_size;
 
 	if (obj_size == sizeof(uintptr_t)) {
@@ -346,6 +615,9 @@ int32_t odp_stash_get(odp_stash_t st, void *obj, int32_t num)
 	if (odp_unlikely(st == ODP_STASH_INVALID))
 		return -1;
 
+	if (stash->cache)
+		return stash_get_cached(stash, obj, num);
+
 	obj_size = stash->obj_size;
 
 	if (obj_size == sizeof(uintptr_t)) {
@@ -391,10 +663,56 @@ int32_t odp_stash_get(odp_stash_t st, void *obj, int32_t num)
 	return -1;
 }
 
+int32_t odp_stash_put_ptr(odp_stash_t st, const uintptr_t ptr[], int32_t num)
+{
+	stash_t *stash = (stash_t *)(uintptr_t)st;
+
+	if (odp_unlikely(st == ODP_STASH_INVALID ||
+			 stash->obj_size != sizeof(uintptr_t)))
+		return -1;
+
+	if (stash->cache) {
+		cache_put(stash, ptr, num);
+		return num;
+	}
+
+	ring_ptr_enq_multi(&stash->ring_ptr.hdr, stash->ring_mask,
+			   (void **)(uintptr_t)ptr, num);
+	return num;
+}
+
+int32_t odp_stash_get_ptr(odp_stash_t st, uintptr_t ptr[], int32_t num)
+{
+	stash_t *stash = (stash_t *)(uintptr_t)st;
+
+	if (odp_unlikely(st == ODP_STASH_INVALID ||
+			 stash->obj_size != sizeof(uintptr_t)))
+		return -1;
+
+	if (stash->cache)
+		return cache_get(stash, ptr, num);
+
+	return ring_ptr_deq_multi(&stash->ring_ptr.hdr, stash->ring_mask,
+				  (void **)ptr, num);
+}
+
 int odp_stash_flush_cache(odp_stash_t st)
 {
+	stash_t *stash = (stash_t *)(uintptr_t)st;
+	stash_cache_t *cache;
+
 	if (odp_unlikely(st == ODP_STASH_INVALID))
 		return -1;
 
+	if (stash->cache == NULL)
+		return 0;
+
+	cache = thread_cache(stash);
+
+	if (cache->num) {
+		ring_put(stash, cache->obj, cache->num);
+		cache->num = 0;
+	}
+
 	return 0;
 }
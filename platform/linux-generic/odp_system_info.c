@@ -322,11 +322,57 @@ static int systemcpu(system_info_t *sysinfo)
  */
 static int system_hp(hugepage_info_t *hugeinfo)
 {
+	uint64_t size[16];
+	uint64_t hp_size;
+	char *hp_dir;
+	int i, num;
+	int val_kb = 0;
+
 	hugeinfo->default_huge_page_size = default_huge_page_size();
 
 	/* default_huge_page_dir may be NULL if no huge page support */
 	hugeinfo->default_huge_page_dir = get_hugepage_dir(0);
 
+	hugeinfo->shm_huge_page_size = hugeinfo->default_huge_page_size;
+	hugeinfo->shm_huge_page_dir  = hugeinfo->default_huge_page_dir;
+
+	/* Non-default huge page size for shared memory (e.g. 1 GB) */
+	if (!_odp_libconfig_lookup_ext_int("shm", NULL, "huge_page_size_kb",
+					   &val_kb) || val_kb <= 0)
+		return 0;
+
+	hp_size = (uint64_t)val_kb * 1024;
+
+	if (hp_size == hugeinfo->default_huge_page_size)
+		return 0;
+
+	num = odp_sys_huge_page_size_all(size, 16);
+	if (num > 16)
+		num = 16;
+
+	for (i = 0; i < num; i++) {
+		if (size[i] == hp_size)
+			break;
+	}
+
+	if (i == num) {
+		ODP_ERR("Huge page size %i kB not supported, using default "
+			"huge page size\n", val_kb);
+		return 0;
+	}
+
+	hp_dir = get_hugepage_dir(hp_size);
+	if (hp_dir == NULL) {
+		ODP_ERR("No hugetlbfs mount point for %i kB pages, using "
+			"default huge page size\n", val_kb);
+		return 0;
+	}
+
+	ODP_DBG("Shm huge page size %i kB, mount point %s\n", val_kb, hp_dir);
+
+	hugeinfo->shm_huge_page_size = hp_size;
+	hugeinfo->shm_huge_page_dir  = hp_dir;
+
 	return 0;
 }
 
@@ -409,7 +455,12 @@ int _odp_system_info_init(void)
  */
 int _odp_system_info_term(void)
 {
-	free(odp_global_ro.hugepage_info.default_huge_page_dir);
+	hugepage_info_t *hugeinfo = &odp_global_ro.hugepage_info;
+
+	if (hugeinfo->shm_huge_page_dir != hugeinfo->default_huge_page_dir)
+		free(hugeinfo->shm_huge_page_dir);
+
+	free(hugeinfo->default_huge_page_dir);
 
 	return 0;
 }
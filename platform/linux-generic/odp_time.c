@@ -14,6 +14,7 @@
 #include <odp/api/hints.h>
 #include <odp_debug_internal.h>
 #include <odp_init_internal.h>
+#include <odp_probe_cache_internal.h>
 #include <odp/api/plat/time_inlines.h>
 
 ODP_STATIC_ASSERT(_ODP_TIMESPEC_SIZE >= (sizeof(struct timespec)),
@@ -198,10 +199,19 @@ int _odp_time_init_global(void)
 
 	if (_odp_cpu_has_global_time()) {
 		global->use_hw = 1;
-		global->hw_freq_hz  = _odp_cpu_global_time_freq();
 
-		if (global->hw_freq_hz == 0)
-			return -1;
+		/* Frequency measurement takes hundreds of milliseconds, reuse
+		 * the value of an earlier run when available */
+		if (!_odp_probe_cache_get(_ODP_PROBE_TIME_FREQ_HZ,
+					  &global->hw_freq_hz)) {
+			global->hw_freq_hz = _odp_cpu_global_time_freq();
+
+			if (global->hw_freq_hz == 0)
+				return -1;
+
+			_odp_probe_cache_set(_ODP_PROBE_TIME_FREQ_HZ,
+					     global->hw_freq_hz);
+		}
 
 		ODP_PRINT("HW time counter freq: %" PRIu64 " hz\n\n",
 			  global->hw_freq_hz);
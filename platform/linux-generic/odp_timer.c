@@ -32,6 +32,7 @@
 #include <odp/api/cpu.h>
 #include <odp/api/pool.h>
 #include <odp_pool_internal.h>
+#include <odp_probe_cache_internal.h>
 #include <odp/api/debug.h>
 #include <odp_debug_internal.h>
 #include <odp/api/event.h>
@@ -180,6 +181,14 @@ typedef struct timer_local_t {
 /* Points to timer global data */
 static timer_global_t *timer_global;
 
+/* Background probe of POSIX timer resolution during odp_init_global() */
+static struct {
+	pthread_t thread;
+	int started;
+	uint64_t res_ns;
+
+} res_probe;
+
 /* Timer thread local data */
 static __thread timer_local_t timer_local;
 
@@ -550,12 +559,38 @@ static inline odp_buffer_t timer_free(timer_pool_t *tp, uint32_t idx)
  * expire/reset/cancel timer
  *****************************************************************************/
 
-static bool timer_reset(uint32_t idx, uint64_t abs_tck, odp_buffer_t *tmo_buf,
-			timer_pool_t *tp)
+/* Fill in some (constant) header fields for timeout events */
+static inline void timer_tmo_init(timer_pool_t *tp, uint32_t idx,
+				  odp_buffer_t tmo_buf)
+{
+	if (odp_event_type(odp_buffer_to_event(tmo_buf)) == ODP_EVENT_TIMEOUT) {
+		/* Convert from buffer to timeout hdr */
+		odp_timeout_hdr_t *tmo_hdr = timeout_hdr_from_buf(tmo_buf);
+
+		tmo_hdr->timer = tp_idx_to_handle(tp, idx);
+		tmo_hdr->user_ptr = tp->timers[idx].user_ptr;
+		/* expiration field filled in when timer expires */
+	}
+	/* Else ignore buffers of other types */
+}
+
+/* Update expiration tick and optionally the timeout buffer of a timer. Header
+ * of a new timeout buffer must have been initialized already. Memory models
+ * are used only with 128-bit atomics: batched operations perform the
+ * ordering with separate barriers and relaxed updates. */
+static inline bool timer_update(uint32_t idx, uint64_t abs_tck,
+				odp_buffer_t *tmo_buf, timer_pool_t *tp,
+				_odp_memmodel_t mm_rls,
+				_odp_memmodel_t mm_acq_rls)
 {
 	bool success = true;
 	tick_buf_t *tb = &tp->tick_buf[idx];
 
+#ifndef ODP_ATOMIC_U128
+	(void)mm_rls;
+	(void)mm_acq_rls;
+#endif
+
 	if (tmo_buf == NULL || *tmo_buf == ODP_BUFFER_INVALID) {
 #ifdef ODP_ATOMIC_U128 /* Target supports 128-bit atomic operations */
 		tick_buf_t new, old;
@@ -585,7 +620,7 @@ static bool timer_reset(uint32_t idx, uint64_t abs_tck, odp_buffer_t *tmo_buf,
 			 * retry update sequence until CAS succeeds */
 		} while (!_odp_atomic_u128_cmp_xchg_mm((_odp_atomic_u128_t *)tb,
 						       (_uint128_t *)&old, (_uint128_t *)&new,
-						       _ODP_MEMMODEL_RLS, _ODP_MEMMODEL_RLX));
+						       mm_rls, _ODP_MEMMODEL_RLX));
 #elif __GCC_ATOMIC_LLONG_LOCK_FREE >= 2 && \
 	defined __GCC_HAVE_SYNC_COMPARE_AND_SWAP_8
 	/* Target supports lock-free 64-bit CAS (and probably exchange) */
@@ -632,17 +667,6 @@ static bool timer_reset(uint32_t idx, uint64_t abs_tck, odp_buffer_t *tmo_buf,
 #endif
 	} else {
 		/* We have a new timeout buffer which replaces any old one */
-		/* Fill in some (constant) header fields for timeout events */
-		if (odp_event_type(odp_buffer_to_event(*tmo_buf)) ==
-		    ODP_EVENT_TIMEOUT) {
-			/* Convert from buffer to timeout hdr */
-			odp_timeout_hdr_t *tmo_hdr =
-				timeout_hdr_from_buf(*tmo_buf);
-			tmo_hdr->timer = tp_idx_to_handle(tp, idx);
-			tmo_hdr->user_ptr = tp->timers[idx].user_ptr;
-			/* expiration field filled in when timer expires */
-		}
-		/* Else ignore buffers of other types */
 		odp_buffer_t old_buf = ODP_BUFFER_INVALID;
 #ifdef ODP_ATOMIC_U128
 		tick_buf_t new, old;
@@ -658,7 +682,7 @@ static bool timer_reset(uint32_t idx, uint64_t abs_tck, odp_buffer_t *tmo_buf,
 		_odp_atomic_u128_xchg_mm((_odp_atomic_u128_t *)tb,
 					 (_uint128_t *)&new,
 					 (_uint128_t *)&old,
-					 _ODP_MEMMODEL_ACQ_RLS);
+					 mm_acq_rls);
 		old_buf = old.tmo_buf;
 #else
 		/* Take a related lock */
@@ -683,6 +707,16 @@ static bool timer_reset(uint32_t idx, uint64_t abs_tck, odp_buffer_t *tmo_buf,
 	return success;
 }
 
+static bool timer_reset(uint32_t idx, uint64_t abs_tck, odp_buffer_t *tmo_buf,
+			timer_pool_t *tp)
+{
+	if (tmo_buf != NULL && *tmo_buf != ODP_BUFFER_INVALID)
+		timer_tmo_init(tp, idx, *tmo_buf);
+
+	return timer_update(idx, abs_tck, tmo_buf, tp, _ODP_MEMMODEL_RLS,
+			    _ODP_MEMMODEL_ACQ_RLS);
+}
+
 static odp_buffer_t timer_set_unused(timer_pool_t *tp,
 				     uint32_t idx)
 {
@@ -726,7 +760,7 @@ static odp_buffer_t timer_set_unused(timer_pool_t *tp,
 }
 
 static odp_buffer_t timer_cancel(timer_pool_t *tp,
-				 uint32_t idx)
+				 uint32_t idx, _odp_memmodel_t mm_rls)
 {
 	tick_buf_t *tb = &tp->tick_buf[idx];
 	odp_buffer_t old_buf;
@@ -758,10 +792,12 @@ static odp_buffer_t timer_cancel(timer_pool_t *tp,
 	} while (!_odp_atomic_u128_cmp_xchg_mm((_odp_atomic_u128_t *)tb,
 					       (_uint128_t *)&old,
 					       (_uint128_t *)&new,
-					       _ODP_MEMMODEL_RLS,
+					       mm_rls,
 					       _ODP_MEMMODEL_RLX));
 	old_buf = old.tmo_buf;
 #else
+	(void)mm_rls;
+
 	/* Take a related lock */
 	while (_odp_atomic_flag_tas(IDX2LOCK(idx)))
 		/* While lock is taken, spin using relaxed loads */
@@ -1077,11 +1113,12 @@ static void *timer_thread(void *arg)
  * that the timer would not be overrun.
  * The candidate resolution value is from 1ms to 100us, 10us...1ns etc.
  */
-static int timer_res_init(void)
+/* Find the highest POSIX timer resolution empirically */
+static uint64_t timer_res_probe(void)
 {
 	struct sigevent sigev;
 	timer_t timerid;
-	uint64_t res, sec, nsec;
+	uint64_t res, sec, nsec, highest_res_ns;
 	struct itimerspec ispec;
 	sigset_t sigset;
 	siginfo_t si;
@@ -1101,7 +1138,7 @@ static int timer_res_init(void)
 	/* Timer resolution start from 1ms */
 	res = ODP_TIME_MSEC_IN_NS;
 	/* Set initial value of timer_res */
-	timer_global->highest_res_ns = res;
+	highest_res_ns = res;
 	sigemptyset(&sigset);
 	/* Add SIGUSR1 to sigset */
 	sigaddset(&sigset, SIGUSR1);
@@ -1130,25 +1167,97 @@ static int timer_res_init(void)
 				if (timer_getoverrun(timerid))
 					/* overrun at this resolution */
 					/* goto the end */
-					goto timer_res_init_done;
+					goto timer_res_probe_done;
 			}
 		}
 		/* Set timer_res */
-		timer_global->highest_res_ns = res;
+		highest_res_ns = res;
 		/* Test the next timer resolution candidate */
 		res /= 10;
 	}
 
-timer_res_init_done:
-	timer_global->highest_res_ns *= TIMER_RES_ROUNDUP_FACTOR;
+timer_res_probe_done:
+	highest_res_ns *= TIMER_RES_ROUNDUP_FACTOR;
 	if (timer_delete(timerid) != 0)
 		ODP_ABORT("timer_delete() returned error %s\n",
 			  strerror(errno));
 	sigemptyset(&sigset);
 	sigprocmask(SIG_BLOCK, &sigset, NULL);
+	return highest_res_ns;
+}
+
+static void *timer_res_probe_thread(void *arg ODP_UNUSED)
+{
+	res_probe.res_ns = timer_res_probe();
+
+	return NULL;
+}
+
+int _odp_timer_res_probe_start(const odp_init_t *params)
+{
+	const char *conf_str;
+	uint64_t res_ns;
+	int val = 0;
+
+	memset(&res_probe, 0, sizeof(res_probe));
+
+	if (params && params->not_used.feat.timer)
+		return 0;
+
+	conf_str =  "timer.inline";
+	if (!_odp_libconfig_lookup_int(conf_str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", conf_str);
+		return -1;
+	}
+
+	/* Inline timers do not use POSIX timers */
+	if (val)
+		return 0;
+
+	if (_odp_probe_cache_get(_ODP_PROBE_TIMER_RES_NS, &res_ns)) {
+		res_probe.res_ns = res_ns;
+		return 0;
+	}
+
+	/* Probe in background while other subsystems are initialized. The
+	 * probe thread blocks SIGUSR1 only in itself. On failure, probe is
+	 * done in _odp_timer_init_global(). */
+	if (pthread_create(&res_probe.thread, NULL, timer_res_probe_thread,
+			   NULL) == 0)
+		res_probe.started = 1;
+
 	return 0;
 }
 
+int _odp_timer_res_probe_stop(void)
+{
+	if (res_probe.started) {
+		if (pthread_join(res_probe.thread, NULL)) {
+			ODP_ERR("Timer resolution probe join failed\n");
+			return -1;
+		}
+
+		res_probe.started = 0;
+		_odp_probe_cache_set(_ODP_PROBE_TIMER_RES_NS,
+				     res_probe.res_ns);
+	}
+
+	return 0;
+}
+
+static void timer_res_init(void)
+{
+	_odp_timer_res_probe_stop();
+
+	if (res_probe.res_ns == 0) {
+		res_probe.res_ns = timer_res_probe();
+		_odp_probe_cache_set(_ODP_PROBE_TIMER_RES_NS,
+				     res_probe.res_ns);
+	}
+
+	timer_global->highest_res_ns = res_probe.res_ns;
+}
+
 static void itimer_init(timer_pool_t *tp)
 {
 	struct sigevent   sigev;
@@ -1418,7 +1527,7 @@ int odp_timer_cancel(odp_timer_t hdl, odp_event_t *tmo_ev)
 	timer_pool_t *tp = handle_to_tp(hdl);
 	uint32_t idx = handle_to_idx(hdl, tp);
 	/* Set the expiration tick of the timer to TMO_INACTIVE */
-	odp_buffer_t old_buf = timer_cancel(tp, idx);
+	odp_buffer_t old_buf = timer_cancel(tp, idx, _ODP_MEMMODEL_RLS);
 
 	if (old_buf != ODP_BUFFER_INVALID) {
 		*tmo_ev = odp_buffer_to_event(old_buf);
@@ -1428,6 +1537,139 @@ int odp_timer_cancel(odp_timer_t hdl, odp_event_t *tmo_ev)
 	}
 }
 
+/* Set multiple timers. Timer handles are resolved, tick buffers prefetched and
+ * current time read (once per timer pool) for a burst of timers, before the
+ * timers are updated with relaxed operations between a single pair of release
+ * and acquire barriers. */
+static int timer_set_multi(const odp_timer_t timer[], const uint64_t tick[],
+			   odp_event_t tmo_ev[], int result[], int num,
+			   int rel)
+{
+	timer_pool_t *tp_tbl[CONFIG_BURST_SIZE];
+	uint32_t idx[CONFIG_BURST_SIZE];
+	uint64_t abs_tck[CONFIG_BURST_SIZE];
+	int num_success = 0;
+	int first, i;
+
+	for (first = 0; first < num; first += CONFIG_BURST_SIZE) {
+		timer_pool_t *tp = NULL;
+		uint64_t cur_tick = 0;
+		int burst = num - first;
+
+		if (burst > CONFIG_BURST_SIZE)
+			burst = CONFIG_BURST_SIZE;
+
+		for (i = 0; i < burst; i++) {
+			odp_timer_t hdl = timer[first + i];
+			timer_pool_t *timer_tp = handle_to_tp(hdl);
+			uint64_t tck = tick[first + i];
+			int ret = ODP_TIMER_SUCCESS;
+
+			if (timer_tp != tp) {
+				tp = timer_tp;
+				cur_tick = current_nsec(tp);
+			}
+
+			tp_tbl[i] = tp;
+			idx[i] = handle_to_idx(hdl, tp);
+
+			if (rel) {
+				if (odp_unlikely(tck < tp->min_rel_tck))
+					ret = ODP_TIMER_TOOEARLY;
+				else if (odp_unlikely(tck > tp->max_rel_tck))
+					ret = ODP_TIMER_TOOLATE;
+				tck += cur_tick;
+			} else {
+				if (odp_unlikely(tck < cur_tick + tp->min_rel_tck))
+					ret = ODP_TIMER_TOOEARLY;
+				else if (odp_unlikely(tck > cur_tick + tp->max_rel_tck))
+					ret = ODP_TIMER_TOOLATE;
+			}
+
+			abs_tck[i] = tck;
+			result[first + i] = ret;
+
+			if (ret == ODP_TIMER_SUCCESS && tmo_ev != NULL &&
+			    tmo_ev[first + i] != ODP_EVENT_INVALID)
+				timer_tmo_init(tp, idx[i],
+					       odp_buffer_from_event(tmo_ev[first + i]));
+		}
+
+		/* Timeout headers are visible before any timer update */
+		odp_mb_release();
+
+		for (i = 0; i < burst; i++) {
+			odp_buffer_t *tmo_buf = NULL;
+
+			if (result[first + i] != ODP_TIMER_SUCCESS)
+				continue;
+
+			if (tmo_ev != NULL)
+				tmo_buf = (odp_buffer_t *)&tmo_ev[first + i];
+
+			if (timer_update(idx[i], abs_tck[i], tmo_buf, tp_tbl[i],
+					 _ODP_MEMMODEL_RLX, _ODP_MEMMODEL_RLX))
+				num_success++;
+			else
+				result[first + i] = ODP_TIMER_NOEVENT;
+		}
+
+		/* Old timeout buffers are returned to the caller */
+		odp_mb_acquire();
+	}
+
+	return num_success;
+}
+
+int odp_timer_set_abs_multi(const odp_timer_t timer[],
+			    const uint64_t abs_tick[], odp_event_t tmo_ev[],
+			    int result[], int num)
+{
+	return timer_set_multi(timer, abs_tick, tmo_ev, result, num, 0);
+}
+
+int odp_timer_set_rel_multi(const odp_timer_t timer[],
+			    const uint64_t rel_tick[], odp_event_t tmo_ev[],
+			    int result[], int num)
+{
+	return timer_set_multi(timer, rel_tick, tmo_ev, result, num, 1);
+}
+
+int odp_timer_cancel_multi(const odp_timer_t timer[], odp_event_t tmo_ev[],
+			   int num)
+{
+	timer_pool_t *tp_tbl[CONFIG_BURST_SIZE];
+	uint32_t idx[CONFIG_BURST_SIZE];
+	int num_cancel = 0;
+	int first, i;
+
+	for (first = 0; first < num; first += CONFIG_BURST_SIZE) {
+		int burst = num - first;
+
+		if (burst > CONFIG_BURST_SIZE)
+			burst = CONFIG_BURST_SIZE;
+
+		for (i = 0; i < burst; i++) {
+			tp_tbl[i] = handle_to_tp(timer[first + i]);
+			idx[i] = handle_to_idx(timer[first + i], tp_tbl[i]);
+		}
+
+		odp_mb_release();
+
+		for (i = 0; i < burst; i++) {
+			odp_buffer_t old_buf = timer_cancel(tp_tbl[i], idx[i],
+							    _ODP_MEMMODEL_RLX);
+
+			tmo_ev[first + i] = odp_buffer_to_event(old_buf);
+
+			if (old_buf != ODP_BUFFER_INVALID)
+				num_cancel++;
+		}
+	}
+
+	return num_cancel;
+}
+
 uint64_t odp_timer_to_u64(odp_timer_t hdl)
 {
 	return _odp_pri(hdl);
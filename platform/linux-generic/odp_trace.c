@@ -0,0 +1,263 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp_posix_extensions.h>
+
+#include <odp/api/shared_memory.h>
+#include <odp/api/spinlock.h>
+#include <odp/api/system_info.h>
+#include <odp/api/thread.h>
+#include <odp/api/time.h>
+
+#include <odp_align_internal.h>
+#include <odp_debug_internal.h>
+#include <odp_global_data.h>
+#include <odp_init_internal.h>
+#include <odp_libconfig_internal.h>
+#include <odp_trace_internal.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Trace ring size limits */
+#define MIN_RING_SIZE 64
+#define MAX_RING_SIZE (1024 * 1024)
+
+typedef struct {
+	odp_shm_t shm;
+	odp_spinlock_t lock;
+	uint32_t ring_size;
+	uint32_t num_thr;
+
+	/* Time stamp base (ns) */
+	uint64_t start_ns;
+
+	/* Number of records already written into a trace file */
+	uint32_t rd_idx[ODP_THREAD_COUNT_MAX];
+
+	_odp_trace_ring_t ring[ODP_THREAD_COUNT_MAX];
+
+} trace_global_t;
+
+static trace_global_t *trace_global;
+
+__thread _odp_trace_ring_t *_odp_trace_ring;
+
+static const char * const trace_name[_ODP_TRACE_NUM] = {
+	[_ODP_TRACE_SCHEDULE]    = "schedule",
+	[_ODP_TRACE_PKTIN_POLL]  = "pktin_poll",
+	[_ODP_TRACE_QUEUE_ENQ]   = "queue_enq",
+	[_ODP_TRACE_QUEUE_DEQ]   = "queue_deq",
+	[_ODP_TRACE_CRYPTO_OP]   = "crypto_op",
+	[_ODP_TRACE_IPSEC_IN]    = "ipsec_in",
+	[_ODP_TRACE_IPSEC_OUT]   = "ipsec_out",
+	[_ODP_TRACE_TM_ENQ]      = "tm_enq",
+	[_ODP_TRACE_PKTOUT_SEND] = "pktout_send"
+};
+
+static int read_config_file(uint32_t *ring_size)
+{
+	const char *str;
+	int val = 0;
+
+	ODP_PRINT("Trace config:\n");
+
+	str = "trace.ring_size";
+	if (!_odp_libconfig_lookup_int(str, &val)) {
+		ODP_ERR("Config option '%s' not found.\n", str);
+		return -1;
+	}
+
+	if (val < MIN_RING_SIZE || val > MAX_RING_SIZE) {
+		ODP_ERR("Bad value %s = %i\n", str, val);
+		return -1;
+	}
+
+	*ring_size = ROUNDUP_POWER2_U32((uint32_t)val);
+	ODP_PRINT("  %s: %i\n\n", str, val);
+
+	return 0;
+}
+
+int _odp_trace_init_global(void)
+{
+	odp_shm_t shm;
+	uint32_t i, ring_size, num_thr;
+	uint64_t shm_size;
+	_odp_trace_rec_t *rec;
+
+	if (!_ODP_TRACE)
+		return 0;
+
+	if (read_config_file(&ring_size))
+		return -1;
+
+	num_thr = odp_thread_count_max();
+	shm_size = ROUNDUP_CACHE_LINE(sizeof(trace_global_t)) +
+		   (uint64_t)num_thr * ring_size * sizeof(_odp_trace_rec_t);
+
+	shm = odp_shm_reserve("_odp_trace_global", shm_size,
+			      ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		ODP_ERR("Shm reserve failed\n");
+		return -1;
+	}
+
+	trace_global = odp_shm_addr(shm);
+	memset(trace_global, 0, sizeof(trace_global_t));
+
+	trace_global->shm = shm;
+	trace_global->ring_size = ring_size;
+	trace_global->num_thr = num_thr;
+	trace_global->start_ns = odp_time_to_ns(odp_time_local());
+	odp_spinlock_init(&trace_global->lock);
+
+	rec = (_odp_trace_rec_t *)(uintptr_t)((uint8_t *)trace_global +
+		ROUNDUP_CACHE_LINE(sizeof(trace_global_t)));
+
+	for (i = 0; i < num_thr; i++) {
+		trace_global->ring[i].rec  = &rec[i * ring_size];
+		trace_global->ring[i].mask = ring_size - 1;
+	}
+
+	return 0;
+}
+
+int _odp_trace_term_global(void)
+{
+	const char *file;
+
+	if (!_ODP_TRACE || trace_global == NULL)
+		return 0;
+
+	file = getenv("ODP_TRACE_FILE");
+	if (file && odp_sys_trace_flush(file))
+		ODP_ERR("Trace write to %s failed\n", file);
+
+	if (odp_shm_free(trace_global->shm)) {
+		ODP_ERR("Shm free failed\n");
+		return -1;
+	}
+
+	trace_global = NULL;
+
+	return 0;
+}
+
+int _odp_trace_init_local(void)
+{
+	int thr;
+
+	if (!_ODP_TRACE)
+		return 0;
+
+	thr = odp_thread_id();
+	if (thr < 0 || (uint32_t)thr >= trace_global->num_thr)
+		return -1;
+
+	_odp_trace_ring = &trace_global->ring[thr];
+
+	return 0;
+}
+
+int _odp_trace_term_local(void)
+{
+	_odp_trace_ring = NULL;
+
+	return 0;
+}
+
+static inline double time_us(uint64_t time, uint64_t start_ns)
+{
+	odp_time_t t = {.u64 = time};
+
+	return (double)(int64_t)(odp_time_to_ns(t) - start_ns) / 1000.0;
+}
+
+static void write_ring(FILE *file, int thr, int *first)
+{
+	_odp_trace_ring_t *ring = &trace_global->ring[thr];
+	uint32_t ring_size = trace_global->ring_size;
+	uint64_t start_ns = trace_global->start_ns;
+	int pid = (int)odp_global_ro.main_pid;
+	uint32_t rd_idx = trace_global->rd_idx[thr];
+	uint32_t wr_idx = __atomic_load_n(&ring->wr_idx, __ATOMIC_ACQUIRE);
+	uint32_t i;
+
+	/* Older records have been overwritten */
+	if (wr_idx - rd_idx > ring_size)
+		rd_idx = wr_idx - ring_size;
+
+	if (rd_idx == wr_idx)
+		return;
+
+	fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%i,"
+		"\"tid\":%i,\"args\":{\"name\":\"odp thread %i\"}}",
+		*first ? "" : ",\n", pid, thr, thr);
+	*first = 0;
+
+	for (i = rd_idx; i != wr_idx; i++) {
+		_odp_trace_rec_t rec = ring->rec[i & ring->mask];
+
+		/* The owner thread may have overwritten the record while it
+		 * was copied. The slot is being rewritten already when the
+		 * write index is ring size ahead of it. */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&ring->wr_idx, __ATOMIC_RELAXED) - i >=
+		    ring_size)
+			continue;
+
+		if (rec.id >= _ODP_TRACE_NUM)
+			continue;
+
+		fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"odp\",\"ph\":\"X\","
+			"\"pid\":%i,\"tid\":%i,\"ts\":%.3f,\"dur\":%.3f,"
+			"\"args\":{\"num\":%u,\"handle\":\"0x%" PRIx64 "\"}}",
+			trace_name[rec.id], pid, thr,
+			time_us(rec.start, start_ns),
+			time_us(rec.end, start_ns) - time_us(rec.start, start_ns),
+			rec.num, rec.handle);
+	}
+
+	trace_global->rd_idx[thr] = wr_idx;
+}
+
+int odp_sys_trace_flush(const char *path)
+{
+	FILE *file;
+	uint32_t thr;
+	int first = 1;
+
+	if (!_ODP_TRACE || trace_global == NULL)
+		return -1;
+
+	odp_spinlock_lock(&trace_global->lock);
+
+	file = fopen(path, "w");
+	if (file == NULL) {
+		odp_spinlock_unlock(&trace_global->lock);
+		ODP_ERR("Failed to open %s\n", path);
+		return -1;
+	}
+
+	fprintf(file, "{\"traceEvents\":[\n");
+
+	for (thr = 0; thr < trace_global->num_thr; thr++)
+		write_ring(file, thr, &first);
+
+	fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+
+	odp_spinlock_unlock(&trace_global->lock);
+
+	if (fclose(file)) {
+		ODP_ERR("Failed to write %s\n", path);
+		return -1;
+	}
+
+	return 0;
+}
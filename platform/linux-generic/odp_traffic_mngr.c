@@ -31,6 +31,7 @@
 #include <odp_init_internal.h>
 #include <odp_errno_define.h>
 #include <odp_global_data.h>
+#include <odp_trace_internal.h>
 
 /* Local vars */
 static const
@@ -2007,6 +2008,7 @@ static int tm_enqueue(tm_system_t *tm_system,
 	tm_wred_node_t *initial_tm_wred_node;
 	odp_bool_t drop_eligible, drop;
 	uint32_t frame_len, pkt_depth;
+	uint64_t trace_start = _odp_trace_begin();
 	int rc;
 
 	tm_group = GET_TM_GROUP(tm_system->odp_tm_group);
@@ -2040,6 +2042,9 @@ static int tm_enqueue(tm_system_t *tm_system,
 	frame_len = odp_packet_len(pkt);
 	pkt_depth = tm_queue_cnts_increment(tm_system, initial_tm_wred_node,
 					    tm_queue_obj->priority, frame_len);
+
+	_odp_trace_end(_ODP_TRACE_TM_ENQ, trace_start,
+		       tm_queue_obj->queue_num, 1);
 	return pkt_depth;
 }
 
@@ -2229,6 +2234,7 @@ static void tm_send_pkt(tm_system_t *tm_system, uint32_t max_sends)
 	odp_packet_t odp_pkt;
 	pkt_desc_t *pkt_desc;
 	uint32_t cnt;
+	int ret;
 
 	for (cnt = 1; cnt <= max_sends; cnt++) {
 		pkt_desc = &tm_system->egress_pkt_desc;
@@ -2242,16 +2248,37 @@ static void tm_send_pkt(tm_system_t *tm_system, uint32_t max_sends)
 			return;
 		}
 
+		/* Hold the packet at egress while the output queue is full.
+		 * It is retried on the next round. */
+		if (tm_system->egress.egress_kind == ODP_TM_EGRESS_PKT_IO &&
+		    odp_pktout_free_slots(tm_system->pktout) == 0)
+			return;
+
 		if (tm_system->marking_enabled)
 			tm_egress_marking(tm_system, odp_pkt);
 
-		tm_system->egress_pkt_desc = EMPTY_PKT_DESC;
-		if (tm_system->egress.egress_kind == ODP_TM_EGRESS_PKT_IO)
-			odp_pktout_send(tm_system->pktout, &odp_pkt, 1);
-		else if (tm_system->egress.egress_kind == ODP_TM_EGRESS_FN)
+		if (tm_system->egress.egress_kind == ODP_TM_EGRESS_PKT_IO) {
+			ret = odp_pktout_send(tm_system->pktout, &odp_pkt, 1);
+
+			/* Output queue is busy, retry on the next round */
+			if (ret == 0)
+				return;
+
+			/* Drop the packet on error, so that it does not block
+			 * the tm_queue */
+			if (odp_unlikely(ret < 0)) {
+				odp_packet_free(odp_pkt);
+				tm_queue_obj->pkts_discarded_cnt++;
+			} else {
+				tm_system->pktout_flush = true;
+			}
+		} else if (tm_system->egress.egress_kind == ODP_TM_EGRESS_FN) {
 			tm_system->egress.egress_fcn(odp_pkt);
-		else
+		} else {
 			return;
+		}
+
+		tm_system->egress_pkt_desc = EMPTY_PKT_DESC;
 
 		tm_queue_obj->sent_pkt = tm_queue_obj->pkt;
 		tm_queue_obj->sent_pkt_desc = tm_queue_obj->in_pkt_desc;
@@ -2502,6 +2529,14 @@ static void *tm_system_thread(void *arg)
 		if (tm_system->egress_pkt_desc.queue_num != 0)
 			tm_send_pkt(tm_system, 1);
 
+		/* No more packets ready for egress, send out packets held in
+		 * the transmit batch */
+		if (tm_system->pktout_flush &&
+		    tm_system->egress_pkt_desc.queue_num == 0) {
+			tm_system->pktout_flush = false;
+			(void)odp_pktout_flush(tm_system->pktout);
+		}
+
 		current_ns = odp_time_to_ns(odp_time_local());
 		tm_system->current_time = current_ns;
 		tm_system->is_idle = (timer_cnt == 0) &&
@@ -4693,13 +4728,14 @@ void odp_tm_stats_print(odp_tm_t odp_tm)
 		tm_queue_obj = tm_system->queue_num_tbl[queue_num - 1];
 		if (tm_queue_obj && tm_queue_obj->pkts_rcvd_cnt != 0)
 			ODP_PRINT("queue_num=%u priority=%u rcvd=%u enqueued=%u "
-				  "dequeued=%u consumed=%u\n",
+				  "dequeued=%u consumed=%u discarded=%u\n",
 				  queue_num,
 				  tm_queue_obj->priority,
 				  tm_queue_obj->pkts_rcvd_cnt,
 				  tm_queue_obj->pkts_enqueued_cnt,
 				  tm_queue_obj->pkts_dequeued_cnt,
-				  tm_queue_obj->pkts_consumed_cnt);
+				  tm_queue_obj->pkts_consumed_cnt,
+				  tm_queue_obj->pkts_discarded_cnt);
 	}
 }
 
@@ -82,11 +82,6 @@
 #define MEMPOOL_FLAGS 0
 #endif
 
-#if _ODP_DPDK_ZERO_COPY
-ODP_STATIC_ASSERT(CONFIG_PACKET_HEADROOM == RTE_PKTMBUF_HEADROOM,
-		  "ODP and DPDK headroom sizes not matching!");
-#endif
-
 /* DPDK poll mode drivers requiring minimum RX burst size DPDK_MIN_RX_BURST */
 #define IXGBE_DRV_NAME "net_ixgbe"
 #define I40E_DRV_NAME "net_i40e"
@@ -118,6 +113,7 @@ typedef struct {
 	int num_tx_desc;
 	uint8_t rx_drop_en;
 	uint8_t set_flow_hash;
+	uint8_t zero_copy;
 } dpdk_opt_t;
 
 struct pkt_cache_t {
@@ -149,6 +145,7 @@ typedef struct ODP_ALIGNED_CACHE {
 	uint8_t vdev_sysc_promisc;
 	uint8_t lockless_rx;		/**< no locking for rx */
 	uint8_t lockless_tx;		/**< no locking for tx */
+	uint8_t zero_copy;		/**< zero-copy mode active */
 	  /** RX queue locks */
 	odp_ticketlock_t rx_lock[PKTIO_MAX_QUEUES] ODP_ALIGNED_CACHE;
 	odp_ticketlock_t tx_lock[PKTIO_MAX_QUEUES];  /**< TX queue locks */
@@ -226,11 +223,16 @@ static int init_options(pktio_entry_t *pktio_entry,
 		return -1;
 	opt->set_flow_hash = !!val;
 
+	if (!lookup_opt("zero_copy", dev_info->driver_name, &val))
+		return -1;
+	opt->zero_copy = !!val;
+
 	ODP_DBG("DPDK interface (%s): %" PRIu16 "\n", dev_info->driver_name,
 		pkt_priv(pktio_entry)->port_id);
 	ODP_DBG("  num_rx_desc: %d\n", opt->num_rx_desc);
 	ODP_DBG("  num_tx_desc: %d\n", opt->num_tx_desc);
 	ODP_DBG("  rx_drop_en: %d\n", opt->rx_drop_en);
+	ODP_DBG("  zero_copy: %d\n", opt->zero_copy);
 
 	return 0;
 }
@@ -338,14 +340,7 @@ static struct rte_mempool *mbuf_pool_create(const char *name,
 	uint32_t total_size;
 
 	if (!(pool_entry->mem_from_huge_pages)) {
-		ODP_ERR("DPDK requires memory is allocated from huge pages\n");
-		goto fail;
-	}
-
-	if (pool_entry->seg_len < RTE_MBUF_DEFAULT_BUF_SIZE) {
-		ODP_ERR("Some NICs need at least %dB buffers to not segment "
-			 "standard ethernet frames. Increase pool seg_len.\n",
-			 RTE_MBUF_DEFAULT_BUF_SIZE);
+		ODP_DBG("DPDK requires memory is allocated from huge pages\n");
 		goto fail;
 	}
 
@@ -492,12 +487,24 @@ static void pool_destroy(void *pool)
 	}
 }
 
+/* Zero-copy mode is enabled in the config file */
+static int zero_copy_config(void)
+{
+	int val;
+
+	if (!lookup_opt("zero_copy", NULL, &val))
+		return 0;
+
+	return val;
+}
+
 int _odp_dpdk_pool_create(pool_t *pool)
 {
 	struct rte_mempool *pkt_pool;
 	char pool_name[RTE_MEMPOOL_NAMESIZE];
 
-	if (!_ODP_DPDK_ZERO_COPY)
+	/* Pool layout was not prepared for zero-copy */
+	if (pool->block_offset == 0)
 		return 0;
 
 	pool->pool_in_use = 0;
@@ -507,9 +514,10 @@ int _odp_dpdk_pool_create(pool_t *pool)
 		 pool->pool_idx);
 	pkt_pool = mbuf_pool_create(pool_name, pool);
 
+	/* DPDK pktios fall back to copy mode with this pool */
 	if (pkt_pool == NULL) {
-		ODP_ERR("Creating external DPDK pool failed\n");
-		return -1;
+		ODP_DBG("Pool %s not zero-copy compatible\n", pool->name);
+		return 0;
 	}
 
 	pool->ext_desc = pkt_pool;
@@ -519,13 +527,28 @@ int _odp_dpdk_pool_create(pool_t *pool)
 	return 0;
 }
 
-uint32_t _odp_dpdk_pool_obj_size(pool_t *pool, uint32_t block_size)
+uint32_t _odp_dpdk_pool_obj_size(pool_t *pool, uint32_t block_size,
+				 uint32_t seg_len)
 {
 	struct rte_mempool_objsz sz;
 	uint32_t total_size;
 
-	if (!_ODP_DPDK_ZERO_COPY)
+	if (!zero_copy_config())
+		return block_size;
+
+	/* Pools incompatible with DPDK mbuf layout are used in copy mode */
+	if (CONFIG_PACKET_HEADROOM != RTE_PKTMBUF_HEADROOM) {
+		ODP_DBG("ODP and DPDK headroom sizes not matching\n");
 		return block_size;
+	}
+
+	if (seg_len < RTE_MBUF_DEFAULT_BUF_SIZE) {
+		ODP_DBG("Some NICs need at least %dB buffers to not segment "
+			"standard ethernet frames. Pool seg_len %" PRIu32 " "
+			"is used in copy mode.\n", RTE_MBUF_DEFAULT_BUF_SIZE,
+			seg_len);
+		return block_size;
+	}
 
 	if (odp_global_rw->dpdk_initialized == 0) {
 		if (dpdk_pktio_init()) {
@@ -856,7 +879,7 @@ static inline int mbuf_to_pkt_zero(pktio_entry_t *pktio_entry,
 	uint8_t set_flow_hash;
 	struct rte_mbuf *mbuf;
 	void *data;
-	int i, nb_pkts;
+	int i, nb_pkts, ret;
 	odp_pool_t pool;
 	odp_pktin_config_opt_t pktin_cfg;
 	odp_proto_layer_t parse_layer;
@@ -908,11 +931,13 @@ static inline int mbuf_to_pkt_zero(pktio_entry_t *pktio_entry,
 				rte_pktmbuf_free(mbuf);
 				continue;
 			}
-			if (_odp_cls_classify_packet(pktio_entry,
-						     (const uint8_t *)data,
-						     pkt_len, pkt_len, &pool,
-						     &parsed_hdr, false)) {
-				ODP_ERR("Unable to classify packet\n");
+			ret = _odp_cls_classify_packet(pktio_entry,
+						       (const uint8_t *)data,
+						       pkt_len, pkt_len, &pool,
+						       &parsed_hdr, false);
+			if (ret) {
+				if (ret < 0)
+					ODP_ERR("Unable to classify packet\n");
 				rte_pktmbuf_free(mbuf);
 				continue;
 			}
@@ -949,6 +974,14 @@ static inline int mbuf_to_pkt_zero(pktio_entry_t *pktio_entry,
 	return nb_pkts;
 }
 
+/* Packet can be passed to DPDK without copy */
+static inline int pkt_zero_copy_ok(odp_packet_hdr_t *pkt_hdr)
+{
+	pool_t *pool = pkt_hdr->buf_hdr.pool_ptr;
+
+	return pkt_hdr->seg_count == 1 && pool->ext_desc != NULL;
+}
+
 static inline int pkt_to_mbuf_zero(pktio_entry_t *pktio_entry,
 				   struct rte_mbuf *mbuf_table[],
 				   const odp_packet_t pkt_table[], uint16_t num,
@@ -973,7 +1006,7 @@ static inline int pkt_to_mbuf_zero(pktio_entry_t *pktio_entry,
 		if (odp_unlikely(pkt_len > mtu))
 			goto fail;
 
-		if (odp_likely(pkt_hdr->seg_count == 1)) {
+		if (odp_likely(pkt_zero_copy_ok(pkt_hdr))) {
 			mbuf_update(mbuf, pkt_hdr, pkt_len);
 
 			if (odp_unlikely(chksum_enabled))
@@ -1389,6 +1422,10 @@ static int dpdk_pktio_init_local(void)
 
 static void dpdk_mempool_free(struct rte_mempool *mp, void *arg ODP_UNUSED)
 {
+	/* Zero-copy pools are freed on ODP pool destroy */
+	if (strcmp(rte_mempool_get_ops(mp->ops_index)->name, "odp_pool") == 0)
+		return;
+
 	rte_mempool_free(mp);
 }
 
@@ -1417,8 +1454,7 @@ static int dpdk_pktio_term(void)
 	}
 #endif
 
-	if (!_ODP_DPDK_ZERO_COPY)
-		rte_mempool_walk(dpdk_mempool_free, NULL);
+	rte_mempool_walk(dpdk_mempool_free, NULL);
 
 	return 0;
 }
@@ -1742,7 +1778,14 @@ static int dpdk_open(odp_pktio_t id ODP_UNUSED,
 	else
 		pkt_dpdk->min_rx_burst = 0;
 
-	if (_ODP_DPDK_ZERO_COPY) {
+	/* Zero-copy requires that the pool has DPDK compatible layout */
+	pkt_dpdk->zero_copy = pkt_dpdk->opt.zero_copy &&
+			      pool_entry->ext_desc != NULL;
+	if (pkt_dpdk->opt.zero_copy && !pkt_dpdk->zero_copy)
+		ODP_DBG("%s: pool %s not zero-copy compatible, using copy "
+			"mode\n", netdev, pool_entry->name);
+
+	if (pkt_dpdk->zero_copy) {
 		pkt_pool = (struct rte_mempool *)pool_entry->ext_desc;
 	} else {
 		snprintf(pool_name, sizeof(pool_name), "pktpool_%s", netdev);
@@ -2004,7 +2047,7 @@ static int dpdk_recv(pktio_entry_t *pktio_entry, int index,
 			ts_val = odp_time_global();
 			ts = &ts_val;
 		}
-		if (_ODP_DPDK_ZERO_COPY)
+		if (pkt_dpdk->zero_copy)
 			nb_rx = mbuf_to_pkt_zero(pktio_entry, pkt_table,
 						 rx_mbufs, nb_rx, ts);
 		else
@@ -2026,7 +2069,7 @@ static int dpdk_send(pktio_entry_t *pktio_entry, int index,
 	int mbufs;
 	int tx_ts_idx = 0;
 
-	if (_ODP_DPDK_ZERO_COPY)
+	if (pkt_dpdk->zero_copy)
 		mbufs = pkt_to_mbuf_zero(pktio_entry, tx_mbufs, pkt_table, num,
 					 &copy_count, &tx_ts_idx);
 	else
@@ -2045,7 +2088,7 @@ static int dpdk_send(pktio_entry_t *pktio_entry, int index,
 	if (odp_unlikely(tx_ts_idx && tx_pkts >= tx_ts_idx))
 		_odp_pktio_tx_ts_set(pktio_entry);
 
-	if (_ODP_DPDK_ZERO_COPY) {
+	if (pkt_dpdk->zero_copy) {
 		/* Free copied packets */
 		if (odp_unlikely(copy_count)) {
 			uint16_t freed = 0;
@@ -2054,7 +2097,7 @@ static int dpdk_send(pktio_entry_t *pktio_entry, int index,
 				odp_packet_t pkt = pkt_table[i];
 				odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
 
-				if (pkt_hdr->seg_count > 1) {
+				if (!pkt_zero_copy_ok(pkt_hdr)) {
 					if (odp_likely(i < tx_pkts))
 						odp_packet_free(pkt);
 					else
@@ -2227,6 +2270,17 @@ static int dpdk_stats_reset(pktio_entry_t *pktio_entry)
 	return 0;
 }
 
+static void dpdk_print(pktio_entry_t *pktio_entry)
+{
+	pkt_dpdk_t *pkt_dpdk = pkt_priv(pktio_entry);
+
+	ODP_PRINT("  zero-copy       %s\n", pkt_dpdk->zero_copy ? "yes" :
+		  (pkt_dpdk->opt.zero_copy ? "no (pool not compatible)" :
+		   "no"));
+	ODP_PRINT("  num_rx_desc     %d\n", pkt_dpdk->opt.num_rx_desc);
+	ODP_PRINT("  num_tx_desc     %d\n", pkt_dpdk->opt.num_tx_desc);
+}
+
 const pktio_if_ops_t _odp_dpdk_pktio_ops = {
 	.name = "dpdk",
 	.init_global = dpdk_pktio_init_global,
@@ -2238,6 +2292,7 @@ const pktio_if_ops_t _odp_dpdk_pktio_ops = {
 	.stop = dpdk_stop,
 	.stats = dpdk_stats,
 	.stats_reset = dpdk_stats_reset,
+	.print = dpdk_print,
 	.recv = dpdk_recv,
 	.send = dpdk_send,
 	.link_status = dpdk_link_status,
@@ -2270,7 +2325,8 @@ const pktio_if_ops_t _odp_dpdk_pktio_ops = {
  * Dummy functions for pool_create()
  */
 
-uint32_t _odp_dpdk_pool_obj_size(pool_t *pool ODP_UNUSED, uint32_t block_size)
+uint32_t _odp_dpdk_pool_obj_size(pool_t *pool ODP_UNUSED, uint32_t block_size,
+				 uint32_t seg_len ODP_UNUSED)
 {
 	return block_size;
 }
@@ -26,6 +26,9 @@ const pktio_if_ops_t * const _odp_pktio_if_ops[]  = {
 	&_odp_tap_pktio_ops,
 	&_odp_null_pktio_ops,
 	&_odp_sock_mmap_pktio_ops,
+#ifdef _ODP_PKTIO_SOCKET_URING
+	&_odp_sock_uring_pktio_ops,
+#endif
 	&_odp_sock_mmsg_pktio_ops,
 	NULL
 };
@@ -540,6 +540,18 @@ static int ipc_pktio_open(odp_pktio_t id ODP_UNUSED,
 	if (strncmp(dev, "ipc", 3))
 		return -1;
 
+	/* Packets are passed as offsets into a single pool memory area */
+	if (pool_entry_from_hdl(pool)->num_class > 1) {
+		ODP_ERR("Multi-size packet pools not supported\n");
+		return -1;
+	}
+
+	/* Packet headers must precede data in pool blocks */
+	if (pool_entry_from_hdl(pool)->separate_hdr) {
+		ODP_ERR("Separate packet header layout not supported\n");
+		return -1;
+	}
+
 	odp_atomic_init_u32(&pktio_ipc->ready, 0);
 
 	/* Shared info about remote pktio */
@@ -153,7 +153,8 @@ static int loopback_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 						       pkt_len, seg_len,
 						       &new_pool, pkt_hdr, true);
 			if (ret) {
-				failed++;
+				if (ret < 0)
+					failed++;
 				odp_packet_free(pkt);
 				continue;
 			}
@@ -1087,6 +1087,20 @@ static int netmap_recv_mq_tmo(pktio_entry_t *pktio_entry[], int index[],
 	return 0;
 }
 
+static int netmap_tx_free_slots(pktio_entry_t *pktio_entry, int index)
+{
+	pkt_netmap_t *pkt_nm = pkt_priv(pktio_entry);
+	struct nm_desc *desc;
+	struct netmap_ring *ring;
+	int desc_id;
+
+	desc_id = pkt_nm->tx_desc_ring[index].s.cur;
+	desc = pkt_nm->tx_desc_ring[index].s.desc[desc_id];
+	ring = NETMAP_TXRING(desc->nifp, desc->cur_tx_ring);
+
+	return nm_ring_space(ring);
+}
+
 static int netmap_send(pktio_entry_t *pktio_entry, int index,
 		       const odp_packet_t pkt_table[], int num)
 {
@@ -1304,6 +1318,7 @@ const pktio_if_ops_t _odp_netmap_pktio_ops = {
 	.recv_tmo = netmap_recv_tmo,
 	.recv_mq_tmo = netmap_recv_mq_tmo,
 	.send = netmap_send,
+	.tx_free_slots = netmap_tx_free_slots,
 	.fd_set = netmap_fd_set
 };
 
@@ -82,8 +82,9 @@ int _odp_sock_recv_mq_tmo_try_int_driven(const struct odp_pktin_queue_t queues[]
 			return 0;
 		}
 
-		if (entry[i]->s.ops->recv_mq_tmo == NULL &&
-		    entry[i]->s.ops->fd_set == NULL) {
+		if ((entry[i]->s.ops->recv_mq_tmo == NULL &&
+		     entry[i]->s.ops->fd_set == NULL) ||
+		    entry[i]->s.sw_rss != NULL) {
 			*trial_successful = 0;
 			return 0;
 		}
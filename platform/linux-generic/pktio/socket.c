@@ -268,10 +268,12 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 			if (msgvec[i].msg_hdr.msg_iov->iov_len < pkt_len)
 				seg_len = msgvec[i].msg_hdr.msg_iov->iov_len;
 
-			if (_odp_cls_classify_packet(pktio_entry, base, pkt_len,
-						     seg_len, &pool, pkt_hdr,
-						     true)) {
-				ODP_ERR("_odp_cls_classify_packet failed");
+			ret = _odp_cls_classify_packet(pktio_entry, base,
+						       pkt_len, seg_len, &pool,
+						       pkt_hdr, true);
+			if (ret) {
+				if (ret < 0)
+					ODP_ERR("_odp_cls_classify_packet failed");
 				odp_packet_free(pkt);
 				continue;
 			}
@@ -52,6 +52,9 @@
 #define FRAME_MEM_SIZE (4 * 1024 * 1024)
 #define BLOCK_SIZE     (4 * 1024)
 
+/* Maximum number of TX frames checked by a free slots query */
+#define MMAP_TX_FREE_MAX 256
+
 /** packet mmap ring */
 struct ring {
 	odp_ticketlock_t lock;
@@ -776,6 +779,37 @@ static int sock_mmap_recv_mq_tmo(pktio_entry_t *pktio_entry[], int index[],
 	}
 }
 
+/* Count available TX ring frames. Scan is limited to MMAP_TX_FREE_MAX frames
+ * ahead, since each frame header is on a separate cache line. */
+static int sock_mmap_tx_free_slots(pktio_entry_t *pktio_entry,
+				   int index ODP_UNUSED)
+{
+	pkt_sock_mmap_t *const pkt_sock = pkt_priv(pktio_entry);
+	struct ring *ring = &pkt_sock->tx_ring;
+	struct tpacket2_hdr *tp_hdr;
+	unsigned int frame_num;
+	int i, max;
+
+	max = ring->rd_num < MMAP_TX_FREE_MAX ? ring->rd_num : MMAP_TX_FREE_MAX;
+
+	odp_ticketlock_lock(&ring->lock);
+
+	frame_num = ring->frame_num;
+
+	for (i = 0; i < max; i++) {
+		tp_hdr = ring->rd[frame_num].iov_base;
+
+		if ((tp_hdr->tp_status & 0x7) != TP_STATUS_AVAILABLE)
+			break;
+
+		frame_num = next_frame(frame_num, ring->rd_num);
+	}
+
+	odp_ticketlock_unlock(&ring->lock);
+
+	return i;
+}
+
 static int sock_mmap_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 			  const odp_packet_t pkt_table[], int num)
 {
@@ -922,6 +956,7 @@ const pktio_if_ops_t _odp_sock_mmap_pktio_ops = {
 	.recv_tmo = sock_mmap_recv_tmo,
 	.recv_mq_tmo = sock_mmap_recv_mq_tmo,
 	.send = sock_mmap_send,
+	.tx_free_slots = sock_mmap_tx_free_slots,
 	.fd_set = sock_mmap_fd_set,
 	.maxlen_get = sock_mmap_mtu_get,
 	.maxlen_set = sock_mmap_mtu_set,
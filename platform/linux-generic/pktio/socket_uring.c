@@ -0,0 +1,1401 @@
+/* Copyright (c) 2021, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * AF_PACKET socket packet IO over io_uring
+ *
+ * Frames are received with a multishot receive request, which picks buffers
+ * from a provided buffer ring. The buffer ring is filled with packet pool
+ * segments, so frames are written directly into packets. Packets are sent
+ * asynchronously and freed on completion. Packet pool memory is registered as
+ * fixed buffers for packet output. Optionally, a kernel thread polls the
+ * output submission queue, so that steady state receive and transmit need no
+ * system calls.
+ */
+
+#include <odp/autoheader_internal.h>
+
+#ifdef _ODP_PKTIO_SOCKET_URING
+
+#include <odp_posix_extensions.h>
+
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/select.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <linux/if_packet.h>
+#include <linux/io_uring.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <string.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <errno.h>
+
+#include <odp_api.h>
+#include <odp_socket_common.h>
+#include <odp_packet_internal.h>
+#include <odp_packet_io_internal.h>
+#include <odp_packet_io_stats.h>
+#include <odp_pool_internal.h>
+#include <odp_debug_internal.h>
+#include <odp_errno_define.h>
+#include <odp_classification_internal.h>
+#include <odp_libconfig_internal.h>
+
+/* Provided buffer group of the receive ring */
+#define URING_BUF_GROUP 0
+
+/* Request user data values */
+#define URING_RX_RECV   UINT64_MAX
+#define URING_RX_CANCEL (UINT64_MAX - 1)
+
+/* Number of receive submission queue entries (only control requests) */
+#define URING_RX_SQ_SIZE 8
+
+/* Ring size limits */
+#define URING_MIN_RING_SIZE 64
+#define URING_MAX_RX_RING_SIZE (32 * 1024)
+#define URING_MAX_TX_RING_SIZE 1024
+
+/* Max number of pool memory areas registered as fixed buffers */
+#define URING_MAX_FIXED_BUFS POOL_MAX_CLASSES
+
+/* Max length of a fixed buffer */
+#define URING_MAX_FIXED_BUF_LEN (1024 * 1024 * 1024)
+
+typedef struct {
+	int rx_ring_size;
+	int tx_ring_size;
+	int sqpoll;
+	int sqpoll_idle;
+	int sqpoll_cpu;
+} uring_opt_t;
+
+typedef struct {
+	int fd;
+	uint32_t setup_flags;
+
+	/* Submission queue */
+	uint32_t *sq_head;
+	uint32_t *sq_tail;
+	uint32_t *sq_flags;
+	uint32_t sq_mask;
+	uint32_t sq_size;
+	uint32_t sqe_tail;
+	struct io_uring_sqe *sqes;
+
+	/* Completion queue */
+	uint32_t *cq_head;
+	uint32_t *cq_tail;
+	uint32_t cq_mask;
+	struct io_uring_cqe *cqes;
+
+	void *sq_ptr;
+	void *cq_ptr;
+	size_t sq_map_len;
+	size_t cq_map_len;
+	size_t sqes_map_len;
+
+} uring_t;
+
+/* Driver context in shared memory */
+typedef struct {
+	/* Provided receive buffer ring. Located in the beginning of the
+	 * context shm, as it needs to be page aligned. */
+	struct io_uring_buf_ring *buf_ring;
+	uint32_t buf_mask;
+	uint16_t buf_tail;
+	uint8_t rx_armed;
+	uint8_t buf_ring_reg;
+
+	uring_t rx;
+	uring_t tx;
+
+	/* Packets owned by the receive buffer ring, indexed by buffer id */
+	odp_packet_t *rx_pkt;
+	uint32_t rx_buf_len;
+
+	/* Packets in flight, indexed by output slot */
+	odp_packet_t *tx_pkt;
+	struct iovec *tx_iov;
+	uint32_t *tx_free;
+	uint32_t tx_free_num;
+	uint32_t tx_ring_size;
+
+	/* Packet pool areas registered as fixed buffers */
+	struct iovec fixed_buf[URING_MAX_FIXED_BUFS];
+	uint32_t num_fixed_buf;
+
+} uring_ctx_t;
+
+typedef struct {
+	odp_ticketlock_t rx_lock ODP_ALIGNED_CACHE;
+	odp_ticketlock_t tx_lock ODP_ALIGNED_CACHE;
+	int sockfd; /**< socket descriptor */
+	odp_pool_t pool; /**< pool to alloc packets from */
+	uint32_t mtu;    /**< maximum transmission unit */
+	uint32_t mtu_max; /**< maximum supported MTU value */
+	unsigned char if_mac[ETH_ALEN];	/**< IF eth mac addr */
+	uring_opt_t opt; /**< options */
+	odp_shm_t shm; /**< context shm */
+	uring_ctx_t *ctx; /**< context */
+} pkt_sock_uring_t;
+
+ODP_STATIC_ASSERT(PKTIO_PRIVATE_SIZE >= sizeof(pkt_sock_uring_t),
+		  "PKTIO_PRIVATE_SIZE too small");
+
+static inline pkt_sock_uring_t *pkt_priv(pktio_entry_t *pktio_entry)
+{
+	return (pkt_sock_uring_t *)(uintptr_t)(pktio_entry->s.pkt_priv);
+}
+
+static int disable_pktio; /** !0 this pktio disabled, 0 enabled */
+
+static int sock_uring_stats_reset(pktio_entry_t *pktio_entry);
+
+static inline int sys_io_uring_setup(uint32_t entries,
+				     struct io_uring_params *p)
+{
+	return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static inline int sys_io_uring_enter(int fd, uint32_t to_submit,
+				     uint32_t min_complete, uint32_t flags)
+{
+	return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+			    flags, NULL, 0);
+}
+
+static inline int sys_io_uring_register(int fd, uint32_t opcode,
+					void *arg, uint32_t nr_args)
+{
+	return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static void uring_term(uring_t *ring)
+{
+	if (ring->sqes)
+		munmap(ring->sqes, ring->sqes_map_len);
+	if (ring->cq_ptr && ring->cq_ptr != ring->sq_ptr)
+		munmap(ring->cq_ptr, ring->cq_map_len);
+	if (ring->sq_ptr)
+		munmap(ring->sq_ptr, ring->sq_map_len);
+	if (ring->fd >= 0)
+		close(ring->fd);
+
+	memset(ring, 0, sizeof(uring_t));
+	ring->fd = -1;
+}
+
+static int uring_init(uring_t *ring, uint32_t sq_entries, uint32_t cq_entries,
+		      const uring_opt_t *opt)
+{
+	struct io_uring_params p;
+	uint8_t *sq_ptr, *cq_ptr;
+	uint32_t i, *sq_array;
+
+	memset(ring, 0, sizeof(uring_t));
+	memset(&p, 0, sizeof(p));
+
+	p.flags = IORING_SETUP_CQSIZE;
+	p.cq_entries = cq_entries;
+
+	if (opt && opt->sqpoll) {
+		p.flags |= IORING_SETUP_SQPOLL;
+		p.sq_thread_idle = opt->sqpoll_idle;
+
+		if (opt->sqpoll_cpu >= 0) {
+			p.flags |= IORING_SETUP_SQ_AFF;
+			p.sq_thread_cpu = opt->sqpoll_cpu;
+		}
+	}
+
+	ring->fd = sys_io_uring_setup(sq_entries, &p);
+	if (ring->fd < 0) {
+		_odp_errno = errno;
+		ODP_DBG("io_uring_setup(): %s\n", strerror(errno));
+		return -1;
+	}
+
+	ring->setup_flags = p.flags;
+	ring->sq_map_len = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+	ring->cq_map_len = p.cq_off.cqes +
+			   p.cq_entries * sizeof(struct io_uring_cqe);
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		if (ring->cq_map_len > ring->sq_map_len)
+			ring->sq_map_len = ring->cq_map_len;
+		ring->cq_map_len = ring->sq_map_len;
+	}
+
+	sq_ptr = mmap(NULL, ring->sq_map_len, PROT_READ | PROT_WRITE,
+		      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	if (sq_ptr == MAP_FAILED)
+		goto error;
+	ring->sq_ptr = sq_ptr;
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		cq_ptr = sq_ptr;
+	} else {
+		cq_ptr = mmap(NULL, ring->cq_map_len, PROT_READ | PROT_WRITE,
+			      MAP_SHARED | MAP_POPULATE, ring->fd,
+			      IORING_OFF_CQ_RING);
+		if (cq_ptr == MAP_FAILED)
+			goto error;
+	}
+	ring->cq_ptr = cq_ptr;
+
+	ring->sqes_map_len = p.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = mmap(NULL, ring->sqes_map_len, PROT_READ | PROT_WRITE,
+			  MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED) {
+		ring->sqes = NULL;
+		goto error;
+	}
+
+	ring->sq_head  = (uint32_t *)(uintptr_t)(sq_ptr + p.sq_off.head);
+	ring->sq_tail  = (uint32_t *)(uintptr_t)(sq_ptr + p.sq_off.tail);
+	ring->sq_flags = (uint32_t *)(uintptr_t)(sq_ptr + p.sq_off.flags);
+	ring->sq_mask  = *(uint32_t *)(uintptr_t)(sq_ptr + p.sq_off.ring_mask);
+	ring->sq_size  = p.sq_entries;
+	ring->sqe_tail = *ring->sq_tail;
+	sq_array = (uint32_t *)(uintptr_t)(sq_ptr + p.sq_off.array);
+
+	/* Submission queue entries are used in order */
+	for (i = 0; i < p.sq_entries; i++)
+		sq_array[i] = i;
+
+	ring->cq_head = (uint32_t *)(uintptr_t)(cq_ptr + p.cq_off.head);
+	ring->cq_tail = (uint32_t *)(uintptr_t)(cq_ptr + p.cq_off.tail);
+	ring->cq_mask = *(uint32_t *)(uintptr_t)(cq_ptr + p.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(uintptr_t)(cq_ptr + p.cq_off.cqes);
+
+	return 0;
+
+error:
+	_odp_errno = errno;
+	ODP_ERR("io_uring mmap(): %s\n", strerror(errno));
+	uring_term(ring);
+	return -1;
+}
+
+static inline struct io_uring_sqe *uring_get_sqe(uring_t *ring)
+{
+	struct io_uring_sqe *sqe;
+	uint32_t head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+	if (odp_unlikely(ring->sqe_tail - head >= ring->sq_size))
+		return NULL;
+
+	sqe = &ring->sqes[ring->sqe_tail & ring->sq_mask];
+	ring->sqe_tail++;
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+	return sqe;
+}
+
+static inline int uring_submit(uring_t *ring)
+{
+	uint32_t tail = *ring->sq_tail;
+	uint32_t num = ring->sqe_tail - tail;
+	int ret;
+
+	if (num == 0)
+		return 0;
+
+	__atomic_store_n(ring->sq_tail, ring->sqe_tail, __ATOMIC_RELEASE);
+
+	if (ring->setup_flags & IORING_SETUP_SQPOLL) {
+		/* Wake up the polling thread only when it sleeps. Tail store
+		 * must be visible before the flags check. */
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		if (odp_likely(!(__atomic_load_n(ring->sq_flags, __ATOMIC_RELAXED) &
+				 IORING_SQ_NEED_WAKEUP)))
+			return 0;
+
+		ret = sys_io_uring_enter(ring->fd, 0, 0,
+					 IORING_ENTER_SQ_WAKEUP);
+	} else {
+		ret = sys_io_uring_enter(ring->fd, num, 0, 0);
+	}
+
+	if (odp_unlikely(ret < 0 && errno != EAGAIN && errno != EBUSY &&
+			 errno != EINTR)) {
+		_odp_errno = errno;
+		ODP_ERR("io_uring_enter(): %s\n", strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+static inline uint32_t uring_cq_ready(uring_t *ring)
+{
+	return __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE) -
+	       *ring->cq_head;
+}
+
+static inline struct io_uring_cqe *uring_cqe(uring_t *ring, uint32_t i)
+{
+	return &ring->cqes[(*ring->cq_head + i) & ring->cq_mask];
+}
+
+static inline void uring_cq_advance(uring_t *ring, uint32_t num)
+{
+	__atomic_store_n(ring->cq_head, *ring->cq_head + num,
+			 __ATOMIC_RELEASE);
+}
+
+static inline void uring_wait_cqe(uring_t *ring)
+{
+	if (sys_io_uring_enter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+	    errno != EINTR)
+		ODP_ERR("io_uring_enter(): %s\n", strerror(errno));
+}
+
+static inline void buf_ring_add(uring_ctx_t *ctx, odp_packet_t pkt,
+				uint16_t bid, uint32_t offset)
+{
+	struct io_uring_buf *buf;
+
+	buf = &ctx->buf_ring->bufs[(ctx->buf_tail + offset) & ctx->buf_mask];
+	buf->addr = (uintptr_t)odp_packet_data(pkt);
+	buf->len  = ctx->rx_buf_len;
+	buf->bid  = bid;
+}
+
+static inline void buf_ring_commit(uring_ctx_t *ctx, uint32_t num)
+{
+	ctx->buf_tail += num;
+	__atomic_store_n(&ctx->buf_ring->tail, ctx->buf_tail,
+			 __ATOMIC_RELEASE);
+}
+
+static int buf_ring_register(uring_ctx_t *ctx)
+{
+	struct io_uring_buf_reg reg;
+
+	memset(&reg, 0, sizeof(reg));
+	reg.ring_addr    = (uintptr_t)ctx->buf_ring;
+	reg.ring_entries = ctx->buf_mask + 1;
+	reg.bgid         = URING_BUF_GROUP;
+
+	if (sys_io_uring_register(ctx->rx.fd, IORING_REGISTER_PBUF_RING,
+				  &reg, 1) < 0) {
+		_odp_errno = errno;
+		ODP_DBG("IORING_REGISTER_PBUF_RING: %s\n", strerror(errno));
+		return -1;
+	}
+
+	ctx->buf_tail = 0;
+	ctx->buf_ring->tail = 0;
+	ctx->buf_ring_reg = 1;
+
+	return 0;
+}
+
+static void buf_ring_unregister(uring_ctx_t *ctx)
+{
+	struct io_uring_buf_reg reg;
+
+	if (!ctx->buf_ring_reg)
+		return;
+
+	memset(&reg, 0, sizeof(reg));
+	reg.bgid = URING_BUF_GROUP;
+
+	if (sys_io_uring_register(ctx->rx.fd, IORING_UNREGISTER_PBUF_RING,
+				  &reg, 1) < 0)
+		ODP_ERR("IORING_UNREGISTER_PBUF_RING: %s\n", strerror(errno));
+
+	ctx->buf_ring_reg = 0;
+}
+
+/* Register packet pool memory for fixed buffer output */
+static void fixed_buf_register(pkt_sock_uring_t *pkt_sock)
+{
+	uring_ctx_t *ctx = pkt_sock->ctx;
+	pool_t *pool = pool_entry_from_hdl(pkt_sock->pool);
+	uint32_t i, num = 0;
+
+	for (i = 0; i < pool->num_class && num < URING_MAX_FIXED_BUFS; i++) {
+		pool_t *class_pool = pool->class_pool[i];
+		uint64_t len = class_pool->max_addr - class_pool->base_addr + 1;
+
+		if (len > URING_MAX_FIXED_BUF_LEN)
+			continue;
+
+		ctx->fixed_buf[num].iov_base = class_pool->base_addr;
+		ctx->fixed_buf[num].iov_len  = len;
+		num++;
+	}
+
+	if (num == 0)
+		return;
+
+	/* Locked memory limits may prevent registration. Packets are then
+	 * sent from unregistered memory. */
+	if (sys_io_uring_register(ctx->tx.fd, IORING_REGISTER_BUFFERS,
+				  ctx->fixed_buf, num) < 0) {
+		ODP_DBG("IORING_REGISTER_BUFFERS: %s\n", strerror(errno));
+		return;
+	}
+
+	ctx->num_fixed_buf = num;
+}
+
+static inline int fixed_buf_index(uring_ctx_t *ctx, const uint8_t *data,
+				  uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < ctx->num_fixed_buf; i++) {
+		const uint8_t *base = ctx->fixed_buf[i].iov_base;
+
+		if (data >= base && data + len <= base + ctx->fixed_buf[i].iov_len)
+			return i;
+	}
+
+	return -1;
+}
+
+static int lookup_opt(const char *opt_name, const char *drv_name, int *val)
+{
+	const char *base = "pktio_socket_uring";
+	int ret;
+
+	ret = _odp_libconfig_lookup_ext_int(base, drv_name, opt_name, val);
+	if (ret == 0)
+		ODP_ERR("Unable to find socket_uring configuration option: %s\n",
+			opt_name);
+
+	return ret;
+}
+
+static int init_options(pktio_entry_t *pktio_entry, const char *netdev)
+{
+	uring_opt_t *opt = &pkt_priv(pktio_entry)->opt;
+
+	if (!lookup_opt("rx_ring_size", netdev, &opt->rx_ring_size))
+		return -1;
+	if (opt->rx_ring_size < URING_MIN_RING_SIZE ||
+	    opt->rx_ring_size > URING_MAX_RX_RING_SIZE) {
+		ODP_ERR("Invalid RX ring size\n");
+		return -1;
+	}
+	opt->rx_ring_size = ROUNDUP_POWER2_U32((uint32_t)opt->rx_ring_size);
+
+	if (!lookup_opt("tx_ring_size", netdev, &opt->tx_ring_size))
+		return -1;
+	if (opt->tx_ring_size < URING_MIN_RING_SIZE ||
+	    opt->tx_ring_size > URING_MAX_TX_RING_SIZE) {
+		ODP_ERR("Invalid TX ring size\n");
+		return -1;
+	}
+	opt->tx_ring_size = ROUNDUP_POWER2_U32((uint32_t)opt->tx_ring_size);
+
+	if (!lookup_opt("sqpoll", netdev, &opt->sqpoll))
+		return -1;
+
+	if (!lookup_opt("sqpoll_idle", netdev, &opt->sqpoll_idle))
+		return -1;
+	if (opt->sqpoll_idle < 0) {
+		ODP_ERR("Invalid SQ poll idle time\n");
+		return -1;
+	}
+
+	if (!lookup_opt("sqpoll_cpu", netdev, &opt->sqpoll_cpu))
+		return -1;
+
+	ODP_DBG("socket_uring interface: %s\n", netdev);
+	ODP_DBG("  rx_ring_size: %d\n", opt->rx_ring_size);
+	ODP_DBG("  tx_ring_size: %d\n", opt->tx_ring_size);
+	ODP_DBG("  sqpoll: %d\n", opt->sqpoll);
+	ODP_DBG("  sqpoll_idle: %d\n", opt->sqpoll_idle);
+	ODP_DBG("  sqpoll_cpu: %d\n", opt->sqpoll_cpu);
+
+	return 0;
+}
+
+static int ctx_create(pktio_entry_t *pktio_entry)
+{
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+	uint32_t rx_size = pkt_sock->opt.rx_ring_size;
+	uint32_t tx_size = pkt_sock->opt.tx_ring_size;
+	char shm_name[ODP_SHM_NAME_LEN];
+	uint64_t buf_ring_len, ctx_off, rx_pkt_off, tx_pkt_off, tx_iov_off;
+	uint64_t tx_free_off, shm_size;
+	uring_ctx_t *ctx;
+	uint8_t *base;
+	odp_shm_t shm;
+
+	buf_ring_len = ROUNDUP_ALIGN(rx_size * sizeof(struct io_uring_buf),
+				     ODP_CACHE_LINE_SIZE);
+	ctx_off     = buf_ring_len;
+	rx_pkt_off  = ctx_off + ROUNDUP_CACHE_LINE(sizeof(uring_ctx_t));
+	tx_pkt_off  = rx_pkt_off + ROUNDUP_CACHE_LINE(rx_size * sizeof(odp_packet_t));
+	tx_iov_off  = tx_pkt_off + ROUNDUP_CACHE_LINE(tx_size * sizeof(odp_packet_t));
+	tx_free_off = tx_iov_off + (uint64_t)tx_size * PKT_MAX_SEGS *
+				   sizeof(struct iovec);
+	shm_size    = tx_free_off + tx_size * sizeof(uint32_t);
+
+	snprintf(shm_name, ODP_SHM_NAME_LEN, "_odp_sock_uring_%i",
+		 odp_pktio_index(pktio_entry->s.handle));
+
+	/* Buffer ring must be page aligned */
+	shm = odp_shm_reserve(shm_name, shm_size, ODP_PAGE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		ODP_ERR("shm reserve failed: %s\n", shm_name);
+		return -1;
+	}
+
+	base = odp_shm_addr(shm);
+	ctx = (uring_ctx_t *)(uintptr_t)(base + ctx_off);
+	memset(ctx, 0, sizeof(uring_ctx_t));
+
+	ctx->buf_ring = (struct io_uring_buf_ring *)(uintptr_t)base;
+	ctx->buf_mask = rx_size - 1;
+	ctx->rx_pkt   = (odp_packet_t *)(uintptr_t)(base + rx_pkt_off);
+	ctx->tx_pkt   = (odp_packet_t *)(uintptr_t)(base + tx_pkt_off);
+	ctx->tx_iov   = (struct iovec *)(uintptr_t)(base + tx_iov_off);
+	ctx->tx_free  = (uint32_t *)(uintptr_t)(base + tx_free_off);
+	ctx->tx_ring_size = tx_size;
+	ctx->rx.fd = -1;
+	ctx->tx.fd = -1;
+
+	pkt_sock->shm = shm;
+	pkt_sock->ctx = ctx;
+
+	return 0;
+}
+
+static int sock_uring_close(pktio_entry_t *pktio_entry)
+{
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+	uring_ctx_t *ctx = pkt_sock->ctx;
+	int ret = 0;
+
+	if (ctx) {
+		uring_term(&ctx->rx);
+		uring_term(&ctx->tx);
+
+		if (odp_shm_free(pkt_sock->shm)) {
+			ODP_ERR("shm free failed\n");
+			ret = -1;
+		}
+
+		pkt_sock->ctx = NULL;
+	}
+
+	if (pkt_sock->sockfd != -1 && close(pkt_sock->sockfd) != 0) {
+		_odp_errno = errno;
+		ODP_ERR("close(sockfd): %s\n", strerror(errno));
+		return -1;
+	}
+
+	return ret;
+}
+
+static int sock_uring_setup_pkt(pktio_entry_t *pktio_entry, const char *netdev,
+				odp_pool_t pool)
+{
+	int sockfd;
+	int err;
+	unsigned int if_idx;
+	struct ifreq ethreq;
+	struct sockaddr_ll sa_ll;
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+	uring_ctx_t *ctx;
+
+	/* Init pktio entry */
+	memset(pkt_sock, 0, sizeof(*pkt_sock));
+	/* set sockfd to -1, because a valid socked might be initialized to 0 */
+	pkt_sock->sockfd = -1;
+
+	if (pool == ODP_POOL_INVALID)
+		return -1;
+	pkt_sock->pool = pool;
+
+	if (init_options(pktio_entry, netdev))
+		return -1;
+
+	sockfd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+	if (sockfd == -1) {
+		_odp_errno = errno;
+		ODP_ERR("socket(): %s\n", strerror(errno));
+		goto error;
+	}
+	pkt_sock->sockfd = sockfd;
+
+	/* get if index */
+	memset(&ethreq, 0, sizeof(struct ifreq));
+	snprintf(ethreq.ifr_name, IF_NAMESIZE, "%s", netdev);
+	err = ioctl(sockfd, SIOCGIFINDEX, &ethreq);
+	if (err != 0) {
+		_odp_errno = errno;
+		ODP_ERR("ioctl(SIOCGIFINDEX): %s: \"%s\".\n", strerror(errno),
+			ethreq.ifr_name);
+		goto error;
+	}
+	if_idx = ethreq.ifr_ifindex;
+
+	err = _odp_mac_addr_get_fd(sockfd, netdev, pkt_sock->if_mac);
+	if (err != 0)
+		goto error;
+
+	pkt_sock->mtu = _odp_mtu_get_fd(sockfd, netdev);
+	if (!pkt_sock->mtu)
+		goto error;
+	pkt_sock->mtu_max = _ODP_SOCKET_MTU_MAX;
+	if (pkt_sock->mtu > pkt_sock->mtu_max)
+		pkt_sock->mtu_max =  pkt_sock->mtu;
+
+	/* bind socket to if */
+	memset(&sa_ll, 0, sizeof(sa_ll));
+	sa_ll.sll_family = AF_PACKET;
+	sa_ll.sll_ifindex = if_idx;
+	sa_ll.sll_protocol = htons(ETH_P_ALL);
+	if (bind(sockfd, (struct sockaddr *)&sa_ll, sizeof(sa_ll)) < 0) {
+		_odp_errno = errno;
+		ODP_ERR("bind(to IF): %s\n", strerror(errno));
+		goto error;
+	}
+
+	if (ctx_create(pktio_entry))
+		goto error;
+	ctx = pkt_sock->ctx;
+
+	/* Receive ring completion queue holds a completion per buffer */
+	if (uring_init(&ctx->rx, URING_RX_SQ_SIZE, 2 * pkt_sock->opt.rx_ring_size,
+		       NULL))
+		goto error;
+
+	if (uring_init(&ctx->tx, ctx->tx_ring_size, 2 * ctx->tx_ring_size,
+		       &pkt_sock->opt))
+		goto error;
+
+	/* Check that the kernel supports provided buffer rings */
+	if (buf_ring_register(ctx))
+		goto error;
+	buf_ring_unregister(ctx);
+
+	fixed_buf_register(pkt_sock);
+
+	pktio_entry->s.stats_type = _odp_sock_stats_type_fd(pktio_entry,
+							    pkt_sock->sockfd);
+	if (pktio_entry->s.stats_type == STATS_UNSUPPORTED)
+		ODP_DBG("pktio: %s unsupported stats\n", pktio_entry->s.name);
+
+	err = sock_uring_stats_reset(pktio_entry);
+	if (err != 0)
+		goto error;
+
+	odp_ticketlock_init(&pkt_sock->rx_lock);
+	odp_ticketlock_init(&pkt_sock->tx_lock);
+
+	return 0;
+
+error:
+	sock_uring_close(pktio_entry);
+
+	return -1;
+}
+
+static int sock_uring_open(odp_pktio_t id ODP_UNUSED,
+			   pktio_entry_t *pktio_entry,
+			   const char *devname, odp_pool_t pool)
+{
+	if (disable_pktio)
+		return -1;
+	return sock_uring_setup_pkt(pktio_entry, devname, pool);
+}
+
+static int rx_arm(uring_ctx_t *ctx, int sockfd)
+{
+	struct io_uring_sqe *sqe = uring_get_sqe(&ctx->rx);
+
+	if (odp_unlikely(sqe == NULL))
+		return -1;
+
+	sqe->opcode    = IORING_OP_RECV;
+	sqe->fd        = sockfd;
+	sqe->ioprio    = IORING_RECV_MULTISHOT;
+	sqe->flags     = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = URING_BUF_GROUP;
+	/* Report original length of truncated frames */
+	sqe->msg_flags = MSG_TRUNC;
+	sqe->user_data = URING_RX_RECV;
+
+	if (odp_unlikely(uring_submit(&ctx->rx)))
+		return -1;
+
+	ctx->rx_armed = 1;
+
+	return 0;
+}
+
+static int sock_uring_start(pktio_entry_t *pktio_entry)
+{
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+	uring_ctx_t *ctx = pkt_sock->ctx;
+	uint32_t i, num = ctx->buf_mask + 1;
+	uint16_t frame_offset = pktio_entry->s.pktin_frame_offset;
+	uint32_t alloc_len = pkt_sock->mtu + frame_offset;
+	int ret;
+
+	ctx->rx_buf_len = pkt_sock->mtu;
+
+	if (buf_ring_register(ctx))
+		return -1;
+
+	/* Fill the buffer ring with single segment packets */
+	ret = _odp_packet_alloc_multi(pkt_sock->pool, alloc_len, ctx->rx_pkt,
+				      num);
+	if (ret != (int)num) {
+		ODP_ERR("Packet alloc failed\n");
+		if (ret > 0)
+			odp_packet_free_multi(ctx->rx_pkt, ret);
+		buf_ring_unregister(ctx);
+		return -1;
+	}
+
+	for (i = 0; i < num; i++) {
+		odp_packet_t pkt = ctx->rx_pkt[i];
+
+		if (frame_offset)
+			pull_head(packet_hdr(pkt), frame_offset);
+
+		if (odp_packet_num_segs(pkt) != 1) {
+			ODP_ERR("Pool segment too small for MTU %u\n",
+				pkt_sock->mtu);
+			odp_packet_free_multi(ctx->rx_pkt, num);
+			buf_ring_unregister(ctx);
+			return -1;
+		}
+
+		buf_ring_add(ctx, pkt, i, i);
+	}
+
+	buf_ring_commit(ctx, num);
+
+	ctx->tx_free_num = ctx->tx_ring_size;
+	for (i = 0; i < ctx->tx_ring_size; i++)
+		ctx->tx_free[i] = i;
+
+	if (rx_arm(ctx, pkt_sock->sockfd)) {
+		odp_packet_free_multi(ctx->rx_pkt, num);
+		buf_ring_unregister(ctx);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void tx_reap(pktio_entry_t *pktio_entry, uring_ctx_t *ctx)
+{
+	uring_t *ring = &ctx->tx;
+	uint32_t i, num = uring_cq_ready(ring);
+	odp_packet_t pkt_tbl[num];
+
+	if (num == 0)
+		return;
+
+	for (i = 0; i < num; i++) {
+		struct io_uring_cqe *cqe = uring_cqe(ring, i);
+		uint32_t slot = (uint32_t)cqe->user_data;
+
+		if (odp_unlikely(cqe->res < 0))
+			odp_atomic_inc_u64(&pktio_entry->s.stats_extra.out_discards);
+
+		pkt_tbl[i] = ctx->tx_pkt[slot];
+		ctx->tx_free[ctx->tx_free_num++] = slot;
+	}
+
+	uring_cq_advance(ring, num);
+
+	odp_packet_free_multi(pkt_tbl, num);
+}
+
+static int sock_uring_stop(pktio_entry_t *pktio_entry)
+{
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+	uring_ctx_t *ctx = pkt_sock->ctx;
+	struct io_uring_sqe *sqe;
+
+	odp_ticketlock_lock(&pkt_sock->rx_lock);
+
+	/* Cancel the multishot receive and wait until it has terminated */
+	if (ctx->rx_armed) {
+		sqe = uring_get_sqe(&ctx->rx);
+		if (sqe) {
+			sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+			sqe->addr      = URING_RX_RECV;
+			sqe->user_data = URING_RX_CANCEL;
+			uring_submit(&ctx->rx);
+		}
+	}
+
+	while (ctx->rx_armed) {
+		uint32_t i, num = uring_cq_ready(&ctx->rx);
+
+		if (num == 0) {
+			uring_wait_cqe(&ctx->rx);
+			continue;
+		}
+
+		for (i = 0; i < num; i++) {
+			struct io_uring_cqe *cqe = uring_cqe(&ctx->rx, i);
+
+			if (cqe->user_data == URING_RX_RECV &&
+			    !(cqe->flags & IORING_CQE_F_MORE))
+				ctx->rx_armed = 0;
+		}
+
+		uring_cq_advance(&ctx->rx, num);
+	}
+
+	/* Consume remaining completions */
+	uring_cq_advance(&ctx->rx, uring_cq_ready(&ctx->rx));
+
+	buf_ring_unregister(ctx);
+	odp_packet_free_multi(ctx->rx_pkt, ctx->buf_mask + 1);
+
+	odp_ticketlock_unlock(&pkt_sock->rx_lock);
+
+	/* Wait for packets in flight */
+	odp_ticketlock_lock(&pkt_sock->tx_lock);
+
+	uring_submit(&ctx->tx);
+	tx_reap(pktio_entry, ctx);
+
+	while (ctx->tx_free_num < ctx->tx_ring_size) {
+		uring_wait_cqe(&ctx->tx);
+		tx_reap(pktio_entry, ctx);
+	}
+
+	odp_ticketlock_unlock(&pkt_sock->tx_lock);
+
+	return 0;
+}
+
+static int sock_uring_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+			   odp_packet_t pkt_table[], int num)
+{
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+	uring_ctx_t *ctx = pkt_sock->ctx;
+	odp_pool_t pool = pkt_sock->pool;
+	odp_time_t ts_val;
+	odp_time_t *ts = NULL;
+	uint16_t frame_offset = pktio_entry->s.pktin_frame_offset;
+	uint32_t alloc_len = pkt_sock->mtu + frame_offset;
+	uint32_t num_cqe, num_buf, num_used, i;
+	int num_new, nb_rx = 0;
+	odp_packet_t new_pkt[num];
+
+	odp_ticketlock_lock(&pkt_sock->rx_lock);
+
+	num_cqe = uring_cq_ready(&ctx->rx);
+	if (num_cqe > (uint32_t)num)
+		num_cqe = num;
+
+	if (odp_unlikely(num_cqe == 0)) {
+		if (odp_unlikely(!ctx->rx_armed))
+			rx_arm(ctx, pkt_sock->sockfd);
+
+		odp_ticketlock_unlock(&pkt_sock->rx_lock);
+		return 0;
+	}
+
+	/* Replacement packets for the buffer ring */
+	num_new = _odp_packet_alloc_multi(pool, alloc_len, new_pkt, num_cqe);
+	if (num_new < 0)
+		num_new = 0;
+
+	if (pktio_entry->s.config.pktin.bit.ts_all ||
+	    pktio_entry->s.config.pktin.bit.ts_ptp) {
+		ts_val = odp_time_global();
+		ts = &ts_val;
+	}
+
+	num_buf = 0;
+	num_used = 0;
+
+	for (i = 0; i < num_cqe; i++) {
+		struct io_uring_cqe *cqe = uring_cqe(&ctx->rx, i);
+		int32_t res = cqe->res;
+		uint32_t flags = cqe->flags;
+		odp_packet_t pkt;
+		odp_packet_hdr_t *pkt_hdr;
+		struct ethhdr *eth_hdr;
+		uint8_t *base;
+		uint16_t bid;
+		int ret;
+
+		if (odp_unlikely(cqe->user_data != URING_RX_RECV))
+			continue;
+
+		if (odp_unlikely(!(flags & IORING_CQE_F_MORE)))
+			ctx->rx_armed = 0;
+
+		if (odp_unlikely(!(flags & IORING_CQE_F_BUFFER))) {
+			/* Buffer ring empty (-ENOBUFS) or request terminated.
+			 * Receive is armed again below. */
+			if (res < 0 && res != -ENOBUFS && res != -ECANCELED)
+				ODP_DBG("recv: %s\n", strerror(-res));
+			continue;
+		}
+
+		bid = flags >> IORING_CQE_BUFFER_SHIFT;
+		pkt = ctx->rx_pkt[bid];
+
+		if (odp_unlikely(num_used >= (uint32_t)num_new)) {
+			/* No replacement packet, drop frame and reuse the
+			 * buffer */
+			buf_ring_add(ctx, pkt, bid, num_buf++);
+			odp_atomic_inc_u64(&pktio_entry->s.stats_extra.in_discards);
+			continue;
+		}
+
+		/* Give a new packet to the buffer ring */
+		if (frame_offset)
+			pull_head(packet_hdr(new_pkt[num_used]), frame_offset);
+		ctx->rx_pkt[bid] = new_pkt[num_used];
+		buf_ring_add(ctx, new_pkt[num_used], bid, num_buf++);
+		num_used++;
+
+		if (odp_unlikely(res <= 0 || (uint32_t)res > ctx->rx_buf_len)) {
+			odp_packet_free(pkt);
+			ODP_DBG("dropped truncated packet\n");
+			continue;
+		}
+
+		pkt_hdr = packet_hdr(pkt);
+		base = odp_packet_data(pkt);
+		eth_hdr = (struct ethhdr *)(uintptr_t)base;
+
+		if (pktio_cls_enabled(pktio_entry)) {
+			int ret = _odp_cls_classify_packet(pktio_entry, base,
+							   res, res, &pool,
+							   pkt_hdr, true);
+
+			if (ret) {
+				if (ret < 0)
+					ODP_ERR("_odp_cls_classify_packet failed");
+				odp_packet_free(pkt);
+				continue;
+			}
+		}
+
+		/* Don't receive packets sent by ourselves */
+		if (odp_unlikely(ethaddrs_equal(pkt_sock->if_mac,
+						eth_hdr->h_source))) {
+			odp_packet_free(pkt);
+			continue;
+		}
+
+		ret = odp_packet_trunc_tail(&pkt, odp_packet_len(pkt) - res,
+					    NULL, NULL);
+		if (ret < 0) {
+			ODP_ERR("trunk_tail failed");
+			odp_packet_free(pkt);
+			continue;
+		}
+
+		pkt_hdr->input = pktio_entry->s.handle;
+
+		if (!pktio_cls_enabled(pktio_entry))
+			_odp_packet_parse_layer(pkt_hdr,
+						pktio_entry->s.config.parser.layer,
+						pktio_entry->s.in_chksums);
+
+		packet_set_ts(pkt_hdr, ts);
+
+		pkt_table[nb_rx++] = pkt;
+	}
+
+	uring_cq_advance(&ctx->rx, num_cqe);
+	buf_ring_commit(ctx, num_buf);
+
+	if (odp_unlikely(!ctx->rx_armed))
+		rx_arm(ctx, pkt_sock->sockfd);
+
+	odp_ticketlock_unlock(&pkt_sock->rx_lock);
+
+	/* Free unused replacement packets */
+	if (num_used < (uint32_t)num_new)
+		odp_packet_free_multi(&new_pkt[num_used], num_new - num_used);
+
+	return nb_rx;
+}
+
+static int sock_uring_fd_set(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+			     fd_set *readfds)
+{
+	/* Ring file descriptor is readable when completions are available */
+	const int fd = pkt_priv(pktio_entry)->ctx->rx.fd;
+
+	FD_SET(fd, readfds);
+	return fd;
+}
+
+static int sock_uring_recv_tmo(pktio_entry_t *pktio_entry, int index,
+			       odp_packet_t pkt_table[], int num,
+			       uint64_t usecs)
+{
+	struct timeval timeout;
+	int ret;
+	int maxfd;
+	fd_set readfds;
+
+	ret = sock_uring_recv(pktio_entry, index, pkt_table, num);
+	if (ret != 0)
+		return ret;
+
+	timeout.tv_sec = usecs / (1000 * 1000);
+	timeout.tv_usec = usecs - timeout.tv_sec * (1000ULL * 1000ULL);
+
+	FD_ZERO(&readfds);
+	maxfd = sock_uring_fd_set(pktio_entry, index, &readfds);
+
+	while (1) {
+		ret = select(maxfd + 1, &readfds, NULL, NULL, &timeout);
+		if (ret <= 0)
+			return 0;
+
+		ret = sock_uring_recv(pktio_entry, index, pkt_table, num);
+		if (odp_likely(ret))
+			return ret;
+
+		/* If no packets, continue wait until timeout expires */
+	}
+}
+
+static int sock_uring_recv_mq_tmo(pktio_entry_t *pktio_entry[], int index[],
+				  int num_q, odp_packet_t pkt_table[], int num,
+				  unsigned *from, uint64_t usecs)
+{
+	struct timeval timeout;
+	int i;
+	int ret;
+	int maxfd = -1, maxfd2;
+	fd_set readfds;
+
+	for (i = 0; i < num_q; i++) {
+		ret = sock_uring_recv(pktio_entry[i], index[i], pkt_table, num);
+
+		if (ret > 0 && from)
+			*from = i;
+
+		if (ret != 0)
+			return ret;
+	}
+
+	FD_ZERO(&readfds);
+
+	for (i = 0; i < num_q; i++) {
+		maxfd2 = sock_uring_fd_set(pktio_entry[i], index[i], &readfds);
+		if (maxfd2 > maxfd)
+			maxfd = maxfd2;
+	}
+
+	timeout.tv_sec = usecs / (1000 * 1000);
+	timeout.tv_usec = usecs - timeout.tv_sec * (1000ULL * 1000ULL);
+
+	while (1) {
+		ret = select(maxfd + 1, &readfds, NULL, NULL, &timeout);
+		if (ret <= 0)
+			return ret;
+
+		for (i = 0; i < num_q; i++) {
+			ret = sock_uring_recv(pktio_entry[i], index[i],
+					      pkt_table, num);
+
+			if (ret > 0 && from)
+				*from = i;
+
+			if (ret)
+				return ret;
+		}
+
+		/* If no packets, continue wait until timeout expires */
+	}
+}
+
+static inline uint32_t _tx_pkt_to_iovec(odp_packet_t pkt, struct iovec *iovecs)
+{
+	odp_packet_seg_t seg;
+	int seg_count = odp_packet_num_segs(pkt);
+	int i;
+
+	seg = odp_packet_first_seg(pkt);
+	for (i = 0; i < seg_count; i++) {
+		iovecs[i].iov_base = odp_packet_seg_data(pkt, seg);
+		iovecs[i].iov_len = odp_packet_seg_data_len(pkt, seg);
+		seg = odp_packet_next_seg(pkt, seg);
+	}
+	return i;
+}
+
+static int sock_uring_tx_free_slots(pktio_entry_t *pktio_entry,
+				    int index ODP_UNUSED)
+{
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+	int free_slots;
+
+	odp_ticketlock_lock(&pkt_sock->tx_lock);
+
+	/* Free completed packets */
+	tx_reap(pktio_entry, pkt_sock->ctx);
+	free_slots = pkt_sock->ctx->tx_free_num;
+
+	odp_ticketlock_unlock(&pkt_sock->tx_lock);
+
+	return free_slots;
+}
+
+static int sock_uring_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+			   const odp_packet_t pkt_table[], int num)
+{
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+	uring_ctx_t *ctx = pkt_sock->ctx;
+	int sockfd = pkt_sock->sockfd;
+	int i;
+	int tx_ts_idx = 0;
+	uint8_t tx_ts_enabled = _odp_pktio_tx_ts_enabled(pktio_entry);
+
+	odp_ticketlock_lock(&pkt_sock->tx_lock);
+
+	/* Free completed packets */
+	tx_reap(pktio_entry, ctx);
+
+	for (i = 0; i < num; i++) {
+		odp_packet_t pkt = pkt_table[i];
+		struct io_uring_sqe *sqe;
+		uint32_t slot;
+
+		if (odp_unlikely(ctx->tx_free_num == 0))
+			break;
+
+		sqe = uring_get_sqe(&ctx->tx);
+		if (odp_unlikely(sqe == NULL))
+			break;
+
+		slot = ctx->tx_free[--ctx->tx_free_num];
+		ctx->tx_pkt[slot] = pkt;
+
+		sqe->fd = sockfd;
+		sqe->user_data = slot;
+
+		if (odp_likely(odp_packet_num_segs(pkt) == 1)) {
+			uint8_t *data = odp_packet_data(pkt);
+			uint32_t len = odp_packet_len(pkt);
+			int buf_idx = fixed_buf_index(ctx, data, len);
+
+			sqe->addr = (uintptr_t)data;
+			sqe->len  = len;
+
+			if (odp_likely(buf_idx >= 0)) {
+				sqe->opcode    = IORING_OP_WRITE_FIXED;
+				sqe->buf_index = buf_idx;
+			} else {
+				sqe->opcode = IORING_OP_SEND;
+			}
+		} else {
+			struct iovec *iov = &ctx->tx_iov[slot * PKT_MAX_SEGS];
+
+			sqe->opcode = IORING_OP_WRITEV;
+			sqe->addr   = (uintptr_t)iov;
+			sqe->len    = _tx_pkt_to_iovec(pkt, iov);
+		}
+
+		if (tx_ts_enabled && tx_ts_idx == 0) {
+			if (odp_unlikely(packet_hdr(pkt)->p.flags.ts_set))
+				tx_ts_idx = i + 1;
+		}
+	}
+
+	if (odp_unlikely(i > 0 && uring_submit(&ctx->tx))) {
+		/* Requests remain in the submission queue and are submitted
+		 * on the next call. */
+		ODP_DBG("submit failed\n");
+	}
+
+	if (odp_unlikely(tx_ts_idx && i >= tx_ts_idx))
+		_odp_pktio_tx_ts_set(pktio_entry);
+
+	odp_ticketlock_unlock(&pkt_sock->tx_lock);
+
+	return i;
+}
+
+static uint32_t sock_uring_mtu_get(pktio_entry_t *pktio_entry)
+{
+	return pkt_priv(pktio_entry)->mtu;
+}
+
+static int sock_uring_mtu_set(pktio_entry_t *pktio_entry, uint32_t maxlen_input,
+			      uint32_t maxlen_output ODP_UNUSED)
+{
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+	int ret;
+
+	ret = _odp_mtu_set_fd(pkt_sock->sockfd, pktio_entry->s.name, maxlen_input);
+	if (ret)
+		return ret;
+
+	pkt_sock->mtu = maxlen_input;
+
+	return 0;
+}
+
+static int sock_uring_mac_addr_get(pktio_entry_t *pktio_entry,
+				   void *mac_addr)
+{
+	memcpy(mac_addr, pkt_priv(pktio_entry)->if_mac, ETH_ALEN);
+	return ETH_ALEN;
+}
+
+static int sock_uring_promisc_mode_set(pktio_entry_t *pktio_entry,
+				       odp_bool_t enable)
+{
+	return _odp_promisc_mode_set_fd(pkt_priv(pktio_entry)->sockfd,
+					pktio_entry->s.name, enable);
+}
+
+static int sock_uring_promisc_mode_get(pktio_entry_t *pktio_entry)
+{
+	return _odp_promisc_mode_get_fd(pkt_priv(pktio_entry)->sockfd,
+					pktio_entry->s.name);
+}
+
+static int sock_uring_link_status(pktio_entry_t *pktio_entry)
+{
+	return _odp_link_status_fd(pkt_priv(pktio_entry)->sockfd,
+				   pktio_entry->s.name);
+}
+
+static int sock_uring_link_info(pktio_entry_t *pktio_entry,
+				odp_pktio_link_info_t *info)
+{
+	return _odp_link_info_fd(pkt_priv(pktio_entry)->sockfd,
+				 pktio_entry->s.name, info);
+}
+
+static int sock_uring_capability(pktio_entry_t *pktio_entry,
+				 odp_pktio_capability_t *capa)
+{
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+
+	memset(capa, 0, sizeof(odp_pktio_capability_t));
+
+	capa->max_input_queues  = 1;
+	capa->max_output_queues = 1;
+	capa->set_op.op.promisc_mode = 1;
+	capa->set_op.op.maxlen = 1;
+
+	capa->maxlen.equal = true;
+	capa->maxlen.min_input = _ODP_SOCKET_MTU_MIN;
+	capa->maxlen.max_input = pkt_sock->mtu_max;
+	capa->maxlen.min_output = _ODP_SOCKET_MTU_MIN;
+	capa->maxlen.max_output = pkt_sock->mtu_max;
+
+	odp_pktio_config_init(&capa->config);
+	capa->config.pktin.bit.ts_all = 1;
+	capa->config.pktin.bit.ts_ptp = 1;
+
+	capa->config.pktout.bit.ts_ena = 1;
+
+	return 0;
+}
+
+static int sock_uring_stats(pktio_entry_t *pktio_entry,
+			    odp_pktio_stats_t *stats)
+{
+	if (pktio_entry->s.stats_type == STATS_UNSUPPORTED) {
+		memset(stats, 0, sizeof(*stats));
+		return 0;
+	}
+
+	return _odp_sock_stats_fd(pktio_entry, stats, pkt_priv(pktio_entry)->sockfd);
+}
+
+static int sock_uring_stats_reset(pktio_entry_t *pktio_entry)
+{
+	if (pktio_entry->s.stats_type == STATS_UNSUPPORTED) {
+		memset(&pktio_entry->s.stats, 0,
+		       sizeof(odp_pktio_stats_t));
+		return 0;
+	}
+
+	return _odp_sock_stats_reset_fd(pktio_entry, pkt_priv(pktio_entry)->sockfd);
+}
+
+static void sock_uring_print(pktio_entry_t *pktio_entry)
+{
+	pkt_sock_uring_t *pkt_sock = pkt_priv(pktio_entry);
+
+	ODP_PRINT("  rx_ring_size    %d\n", pkt_sock->opt.rx_ring_size);
+	ODP_PRINT("  tx_ring_size    %d\n", pkt_sock->opt.tx_ring_size);
+	ODP_PRINT("  sqpoll          %d\n", pkt_sock->opt.sqpoll);
+	ODP_PRINT("  fixed buffers   %u\n", pkt_sock->ctx->num_fixed_buf);
+}
+
+static int sock_uring_init_global(void)
+{
+	if (getenv("ODP_PKTIO_DISABLE_SOCKET_URING")) {
+		ODP_PRINT("PKTIO: socket io_uring skipped,"
+			  " enabled export ODP_PKTIO_DISABLE_SOCKET_URING=1.\n");
+		disable_pktio = 1;
+	} else {
+		ODP_PRINT("PKTIO: initialized socket io_uring,"
+			  " use export ODP_PKTIO_DISABLE_SOCKET_URING=1 to disable.\n");
+	}
+	return 0;
+}
+
+const pktio_if_ops_t _odp_sock_uring_pktio_ops = {
+	.name = "socket_uring",
+	.print = sock_uring_print,
+	.init_global = sock_uring_init_global,
+	.init_local = NULL,
+	.term = NULL,
+	.open = sock_uring_open,
+	.close = sock_uring_close,
+	.start = sock_uring_start,
+	.stop = sock_uring_stop,
+	.stats = sock_uring_stats,
+	.stats_reset = sock_uring_stats_reset,
+	.recv = sock_uring_recv,
+	.recv_tmo = sock_uring_recv_tmo,
+	.recv_mq_tmo = sock_uring_recv_mq_tmo,
+	.fd_set = sock_uring_fd_set,
+	.send = sock_uring_send,
+	.tx_free_slots = sock_uring_tx_free_slots,
+	.maxlen_get = sock_uring_mtu_get,
+	.maxlen_set = sock_uring_mtu_set,
+	.promisc_mode_set = sock_uring_promisc_mode_set,
+	.promisc_mode_get = sock_uring_promisc_mode_get,
+	.mac_get = sock_uring_mac_addr_get,
+	.mac_set = NULL,
+	.link_status = sock_uring_link_status,
+	.link_info = sock_uring_link_info,
+	.capability = sock_uring_capability,
+	.pktio_ts_res = NULL,
+	.pktio_ts_from_ns = NULL,
+	.pktio_time = NULL,
+	.config = NULL,
+	.input_queues_config = NULL,
+	.output_queues_config = NULL,
+};
+
+#endif /* _ODP_PKTIO_SOCKET_URING */
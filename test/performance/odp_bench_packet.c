@@ -391,6 +391,23 @@ static void alloc_parse_packets_ipv6_udp(void)
 	alloc_parse_packets(test_packet_ipv6_udp, sizeof(test_packet_ipv6_udp));
 }
 
+static void alloc_parsed_packets_ipv4_udp(void)
+{
+	odp_packet_parse_param_t param;
+	int i;
+
+	alloc_parse_packets_ipv4_udp();
+
+	memset(&param, 0, sizeof(odp_packet_parse_param_t));
+	param.proto = ODP_PROTO_ETH;
+	param.last_layer = ODP_PROTO_LAYER_ALL;
+
+	for (i = 0; i < TEST_REPEAT_COUNT; i++) {
+		if (odp_packet_parse(gbl_args->pkt_tbl[i], 0, &param))
+			ODPH_ABORT("Parsing test packet failed\n");
+	}
+}
+
 static void alloc_parse_packets_multi(const void *pkt_data, uint32_t len)
 {
 	int i;
@@ -1445,6 +1462,23 @@ static int bench_packet_parse(void)
 	return !ret;
 }
 
+/* Reads only packet metadata. Results depend on the number of cache lines the
+ * implementation needs to touch per packet. */
+static int bench_packet_parse_result(void)
+{
+	odp_packet_parse_result_t result;
+	odp_packet_t *pkt_tbl = gbl_args->pkt_tbl;
+	int ret = 0;
+	int i;
+
+	for (i = 0; i < TEST_REPEAT_COUNT; i++) {
+		odp_packet_parse_result(pkt_tbl[i], &result);
+		ret += result.flag.has_udp;
+	}
+
+	return ret == TEST_REPEAT_COUNT;
+}
+
 static int bench_packet_parse_multi(void)
 {
 	int burst_size = gbl_args->appl.burst_size;
@@ -1714,6 +1748,8 @@ bench_info_t test_suite[] = {
 			   free_packets, "bench_packet_parse_ipv6_tcp"),
 		BENCH_INFO(bench_packet_parse, alloc_parse_packets_ipv6_udp,
 			   free_packets, "bench_packet_parse_ipv6_udp"),
+		BENCH_INFO(bench_packet_parse_result,
+			   alloc_parsed_packets_ipv4_udp, free_packets, NULL),
 		BENCH_INFO(bench_packet_parse_multi,
 			   alloc_parse_packets_multi_ipv4_tcp,
 			   free_packets_multi,
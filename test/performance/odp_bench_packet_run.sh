@@ -0,0 +1,41 @@
+#!/bin/sh
+#
+# Copyright (c) 2021, Nokia
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+
+TEST_DIR="${TEST_DIR:-$(dirname $0)}"
+TEST_SRC_DIR=$(dirname $0)
+
+# Platform config file for the alternative packet pool layout
+LAYOUT_CONF=${TEST_SRC_DIR}/../../platform/$ODP_PLATFORM/test/packet_hdr.conf
+
+echo odp_bench_packet: default packet pool layout
+echo ===============================================
+
+$TEST_DIR/odp_bench_packet${EXEEXT}
+
+RET_VAL=$?
+if [ $RET_VAL -ne 0 ]; then
+	echo odp_bench_packet: FAILED
+	exit $RET_VAL
+fi
+
+if [ ! -f ${LAYOUT_CONF} ]; then
+	exit 0
+fi
+
+echo odp_bench_packet: separate packet header layout
+echo ===============================================
+
+ODP_CONFIG_FILE=${LAYOUT_CONF} $TEST_DIR/odp_bench_packet${EXEEXT}
+
+RET_VAL=$?
+if [ $RET_VAL -ne 0 ]; then
+	echo odp_bench_packet separate header layout: FAILED
+	exit $RET_VAL
+fi
+
+exit 0
@@ -0,0 +1,658 @@
+/* Copyright (c) 2021, Nokia
+ *
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+#include <odp_api.h>
+#include <odp/helper/odph_api.h>
+
+#define MAX_PKTS  1024
+#define MAX_BURST 32
+
+/* Output space reserved on top of input length */
+#define OUT_EXTRA(len) ((len) / 8 + 64)
+
+typedef struct test_options_t {
+	uint32_t num_pkt;
+	uint32_t pkt_len;
+	uint32_t num_round;
+	uint32_t level;
+	int alg;
+	int data;
+	int mode;
+
+} test_options_t;
+
+typedef struct test_stat_t {
+	uint64_t in_bytes;
+	uint64_t out_bytes;
+	uint64_t comp_nsec;
+	uint64_t decomp_nsec;
+	uint32_t failed;
+
+} test_stat_t;
+
+typedef struct test_global_t {
+	test_options_t test_options;
+	odp_pool_t pool;
+	odp_queue_t queue;
+	odp_comp_capability_t capa;
+	odp_packet_t pkt_in[MAX_PKTS];
+	odp_packet_t pkt_comp[MAX_PKTS];
+	odp_packet_t pkt_out[MAX_PKTS];
+	uint32_t comp_len[MAX_PKTS];
+	uint8_t *data;
+
+} test_global_t;
+
+typedef struct {
+	const char *name;
+	odp_comp_alg_t alg;
+
+} alg_info_t;
+
+static const alg_info_t alg_info[] = {
+	{"deflate", ODP_COMP_ALG_DEFLATE},
+	{"zlib",    ODP_COMP_ALG_ZLIB},
+	{"lzs",     ODP_COMP_ALG_LZS}
+};
+
+#define NUM_ALG (sizeof(alg_info) / sizeof(alg_info[0]))
+
+static test_global_t test_global;
+
+static void print_usage(void)
+{
+	printf("\n"
+	       "Compression performance test\n"
+	       "\n"
+	       "Reports compression ratio and compression/decompression throughput per\n"
+	       "algorithm and compression level.\n"
+	       "\n"
+	       "Usage: odp_comp_perf [options]\n"
+	       "\n"
+	       "  -a, --alg              Algorithm. Default 0.\n"
+	       "                         0: All supported algorithms\n"
+	       "                         1: Deflate\n"
+	       "                         2: Zlib\n"
+	       "                         3: LZS\n"
+	       "  -l, --level            Compression level. 0: All levels (default).\n"
+	       "  -n, --num_pkt          Number of packets. Default 32.\n"
+	       "  -s, --pkt_len          Packet data length in bytes. Default 1024.\n"
+	       "  -r, --num_round        Number of rounds. Default 100.\n"
+	       "  -d, --data             Test data. Default 0.\n"
+	       "                         0: Text log records\n"
+	       "                         1: Random bytes\n"
+	       "  -m, --mode             Operation mode. Default 0.\n"
+	       "                         0: Synchronous (odp_comp_op())\n"
+	       "                         1: Asynchronous (odp_comp_op_enq())\n"
+	       "  -h, --help             This help\n"
+	       "\n");
+}
+
+static int parse_options(int argc, char *argv[], test_options_t *test_options)
+{
+	int opt;
+	int long_index;
+	int ret = 0;
+
+	static const struct option longopts[] = {
+		{"alg",       required_argument, NULL, 'a'},
+		{"level",     required_argument, NULL, 'l'},
+		{"num_pkt",   required_argument, NULL, 'n'},
+		{"pkt_len",   required_argument, NULL, 's'},
+		{"num_round", required_argument, NULL, 'r'},
+		{"data",      required_argument, NULL, 'd'},
+		{"mode",      required_argument, NULL, 'm'},
+		{"help",      no_argument,       NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+a:l:n:s:r:d:m:h";
+
+	test_options->alg       = 0;
+	test_options->level     = 0;
+	test_options->num_pkt   = 32;
+	test_options->pkt_len   = 1024;
+	test_options->num_round = 100;
+	test_options->data      = 0;
+	test_options->mode      = 0;
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case 'a':
+			test_options->alg = atoi(optarg);
+			break;
+		case 'l':
+			test_options->level = atoi(optarg);
+			break;
+		case 'n':
+			test_options->num_pkt = atoi(optarg);
+			break;
+		case 's':
+			test_options->pkt_len = atoi(optarg);
+			break;
+		case 'r':
+			test_options->num_round = atoi(optarg);
+			break;
+		case 'd':
+			test_options->data = atoi(optarg);
+			break;
+		case 'm':
+			test_options->mode = atoi(optarg);
+			break;
+		case 'h':
+			/* fall through */
+		default:
+			print_usage();
+			ret = -1;
+			break;
+		}
+	}
+
+	if (test_options->num_pkt == 0 || test_options->num_pkt > MAX_PKTS) {
+		ODPH_ERR("Bad number of packets. Max %u.\n", MAX_PKTS);
+		ret = -1;
+	}
+
+	if (test_options->pkt_len == 0) {
+		ODPH_ERR("Bad packet length\n");
+		ret = -1;
+	}
+
+	if (test_options->alg < 0 || test_options->alg > (int)NUM_ALG) {
+		ODPH_ERR("Bad algorithm\n");
+		ret = -1;
+	}
+
+	return ret;
+}
+
+/* Generate log records with varying field values */
+static void gen_data(uint8_t *data, uint32_t len, int random, uint32_t seed)
+{
+	static const char * const level[] = {"info", "warn", "error", "debug"};
+	static const char * const msg[] = {"packet dropped", "flow created",
+					   "flow expired", "queue full"};
+	uint32_t pos = 0;
+	uint32_t i;
+
+	if (random) {
+		for (i = 0; i < len; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = seed >> 16;
+		}
+		return;
+	}
+
+	while (pos < len) {
+		char rec[160];
+		int n;
+
+		seed = seed * 1103515245 + 12345;
+		n = snprintf(rec, sizeof(rec),
+			     "ts=%u.%06u level=%s if=eth%u src=10.%u.%u.%u dst=192.168.%u.%u msg=\"%s\"\n",
+			     1600000000 + (seed >> 20), (seed >> 4) % 1000000,
+			     level[(seed >> 8) & 0x3], (seed >> 12) & 0x3,
+			     (seed >> 3) & 0xf, (seed >> 9) & 0xff, (seed >> 17) & 0xff,
+			     (seed >> 5) & 0x3, (seed >> 13) & 0xff, msg[(seed >> 24) & 0x3]);
+
+		if (n > (int)(len - pos))
+			n = len - pos;
+
+		memcpy(&data[pos], rec, n);
+		pos += n;
+	}
+}
+
+static int create_resources(test_global_t *global)
+{
+	odp_pool_capability_t pool_capa;
+	odp_pool_param_t pool_param;
+	odp_queue_param_t queue_param;
+	test_options_t *test_options = &global->test_options;
+	uint32_t num_pkt = test_options->num_pkt;
+	uint32_t pkt_len = test_options->pkt_len;
+	uint32_t max_len = pkt_len + OUT_EXTRA(pkt_len);
+	uint32_t i;
+
+	printf("\nCompression performance test\n");
+	printf("  num packets      %u\n", num_pkt);
+	printf("  packet length    %u\n", pkt_len);
+	printf("  num rounds       %u\n", test_options->num_round);
+	printf("  data             %s\n", test_options->data ? "random" : "text");
+	printf("  mode             %s\n\n", test_options->mode ? "async" : "sync");
+
+	if (odp_comp_capability(&global->capa)) {
+		ODPH_ERR("Comp capability failed\n");
+		return -1;
+	}
+
+	if (test_options->mode == 0 && global->capa.sync == ODP_SUPPORT_NO) {
+		ODPH_ERR("Sync mode not supported\n");
+		return -1;
+	}
+
+	if (test_options->mode && global->capa.async == ODP_SUPPORT_NO) {
+		ODPH_ERR("Async mode not supported\n");
+		return -1;
+	}
+
+	if (odp_pool_capability(&pool_capa)) {
+		ODPH_ERR("Pool capability failed\n");
+		return -1;
+	}
+
+	if (pool_capa.pkt.max_len && max_len > pool_capa.pkt.max_len) {
+		ODPH_ERR("Too long packets. Max %u.\n", pool_capa.pkt.max_len);
+		return -1;
+	}
+
+	odp_pool_param_init(&pool_param);
+	pool_param.type    = ODP_POOL_PACKET;
+	pool_param.pkt.num = 3 * num_pkt;
+	pool_param.pkt.len = max_len;
+
+	global->pool = odp_pool_create("comp_perf", &pool_param);
+	if (global->pool == ODP_POOL_INVALID) {
+		ODPH_ERR("Pool create failed\n");
+		return -1;
+	}
+
+	odp_queue_param_init(&queue_param);
+	queue_param.type = ODP_QUEUE_TYPE_PLAIN;
+
+	global->queue = odp_queue_create("comp_perf", &queue_param);
+	if (global->queue == ODP_QUEUE_INVALID) {
+		ODPH_ERR("Queue create failed\n");
+		return -1;
+	}
+
+	global->data = malloc(pkt_len);
+	if (global->data == NULL) {
+		ODPH_ERR("Malloc failed\n");
+		return -1;
+	}
+
+	for (i = 0; i < num_pkt; i++) {
+		global->pkt_in[i]   = odp_packet_alloc(global->pool, pkt_len);
+		global->pkt_comp[i] = odp_packet_alloc(global->pool, max_len);
+		global->pkt_out[i]  = odp_packet_alloc(global->pool, max_len);
+
+		if (global->pkt_in[i] == ODP_PACKET_INVALID ||
+		    global->pkt_comp[i] == ODP_PACKET_INVALID ||
+		    global->pkt_out[i] == ODP_PACKET_INVALID) {
+			ODPH_ERR("Packet alloc failed\n");
+			return -1;
+		}
+
+		/* Each packet has different data */
+		gen_data(global->data, pkt_len, test_options->data, i + 1);
+
+		if (odp_packet_copy_from_mem(global->pkt_in[i], 0, pkt_len,
+					     global->data)) {
+			ODPH_ERR("Packet copy failed\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void destroy_resources(test_global_t *global)
+{
+	uint32_t i;
+
+	for (i = 0; i < global->test_options.num_pkt; i++) {
+		if (global->pkt_in[i] != ODP_PACKET_INVALID)
+			odp_packet_free(global->pkt_in[i]);
+		if (global->pkt_comp[i] != ODP_PACKET_INVALID)
+			odp_packet_free(global->pkt_comp[i]);
+		if (global->pkt_out[i] != ODP_PACKET_INVALID)
+			odp_packet_free(global->pkt_out[i]);
+	}
+
+	free(global->data);
+
+	if (global->queue != ODP_QUEUE_INVALID)
+		odp_queue_destroy(global->queue);
+
+	if (global->pool != ODP_POOL_INVALID)
+		odp_pool_destroy(global->pool);
+}
+
+static odp_comp_session_t session_create(test_global_t *global, odp_comp_alg_t alg,
+					 uint32_t level, odp_comp_op_t op)
+{
+	odp_comp_session_param_t param;
+
+	odp_comp_session_param_init(&param);
+	param.op          = op;
+	param.comp_algo   = alg;
+	param.hash_algo   = ODP_COMP_HASH_ALG_NONE;
+	param.compl_queue = global->queue;
+	param.mode        = global->test_options.mode ? ODP_COMP_OP_MODE_ASYNC :
+							ODP_COMP_OP_MODE_SYNC;
+
+	if (alg == ODP_COMP_ALG_DEFLATE)
+		param.alg_param.deflate.comp_level = level;
+	else if (alg == ODP_COMP_ALG_ZLIB)
+		param.alg_param.zlib.deflate.comp_level = level;
+	else if (alg == ODP_COMP_ALG_LZS)
+		param.alg_param.lzs.comp_level = level;
+
+	return odp_comp_session_create(&param);
+}
+
+/* Process all packets once. Returns number of failed operations. */
+static uint32_t run_round(test_global_t *global, odp_comp_session_t session,
+			  odp_packet_t pkt_in[], odp_packet_t pkt_out[],
+			  const uint32_t in_len[], uint32_t out_len, uint32_t res_len[])
+{
+	odp_comp_packet_op_param_t param[MAX_BURST];
+	odp_comp_packet_result_t result;
+	uint32_t num_pkt = global->test_options.num_pkt;
+	int async = global->test_options.mode;
+	uint32_t failed = 0;
+	uint32_t i, j, num, num_res;
+	int ret;
+
+	for (i = 0; i < num_pkt; i += num) {
+		num = num_pkt - i;
+		if (num > MAX_BURST)
+			num = MAX_BURST;
+
+		for (j = 0; j < num; j++) {
+			param[j].session = session;
+			param[j].in_data_range.offset  = 0;
+			param[j].in_data_range.length  = in_len[i + j];
+			param[j].out_data_range.offset = 0;
+			param[j].out_data_range.length = out_len;
+		}
+
+		if (async) {
+			ret = odp_comp_op_enq(&pkt_in[i], &pkt_out[i], num, param);
+			if (ret < 0)
+				ret = 0;
+
+			/* Results are received in order */
+			num_res = 0;
+			while (num_res < (uint32_t)ret) {
+				odp_event_t ev = odp_queue_deq(global->queue);
+
+				if (ev == ODP_EVENT_INVALID)
+					continue;
+
+				pkt_out[i + num_res] = odp_comp_packet_from_event(ev);
+				num_res++;
+			}
+		} else {
+			ret = odp_comp_op(&pkt_in[i], &pkt_out[i], num, param);
+			if (ret < 0)
+				ret = 0;
+		}
+
+		/* Operations that were not started */
+		for (j = ret; j < num; j++) {
+			failed++;
+			res_len[i + j] = 0;
+		}
+
+		for (j = 0; j < (uint32_t)ret; j++) {
+			odp_comp_result(&result, pkt_out[i + j]);
+
+			if (result.status != ODP_COMP_STATUS_SUCCESS) {
+				failed++;
+				res_len[i + j] = 0;
+				continue;
+			}
+
+			res_len[i + j] = result.output_data_range.length;
+		}
+	}
+
+	return failed;
+}
+
+static int run_test(test_global_t *global, odp_comp_alg_t alg, uint32_t level,
+		    test_stat_t *stat)
+{
+	odp_comp_session_t comp, decomp;
+	odp_time_t t1, t2;
+	test_options_t *test_options = &global->test_options;
+	uint32_t num_pkt = test_options->num_pkt;
+	uint32_t pkt_len = test_options->pkt_len;
+	uint32_t out_len = pkt_len + OUT_EXTRA(pkt_len);
+	uint32_t in_len[MAX_PKTS];
+	uint32_t res_len[MAX_PKTS];
+	uint32_t i;
+
+	memset(stat, 0, sizeof(test_stat_t));
+
+	for (i = 0; i < num_pkt; i++)
+		in_len[i] = pkt_len;
+
+	comp = session_create(global, alg, level, ODP_COMP_OP_COMPRESS);
+	if (comp == ODP_COMP_SESSION_INVALID) {
+		ODPH_ERR("Compress session create failed\n");
+		return -1;
+	}
+
+	decomp = session_create(global, alg, level, ODP_COMP_OP_DECOMPRESS);
+	if (decomp == ODP_COMP_SESSION_INVALID) {
+		ODPH_ERR("Decompress session create failed\n");
+		odp_comp_session_destroy(comp);
+		return -1;
+	}
+
+	t1 = odp_time_local();
+
+	for (i = 0; i < test_options->num_round; i++)
+		stat->failed += run_round(global, comp, global->pkt_in, global->pkt_comp,
+					  in_len, out_len, global->comp_len);
+
+	t2 = odp_time_local();
+	stat->comp_nsec = odp_time_diff_ns(t2, t1);
+
+	for (i = 0; i < num_pkt; i++) {
+		stat->in_bytes  += pkt_len;
+		stat->out_bytes += global->comp_len[i];
+	}
+
+	t1 = odp_time_local();
+
+	for (i = 0; i < test_options->num_round; i++)
+		stat->failed += run_round(global, decomp, global->pkt_comp, global->pkt_out,
+					  global->comp_len, out_len, res_len);
+
+	t2 = odp_time_local();
+	stat->decomp_nsec = odp_time_diff_ns(t2, t1);
+
+	/* Check decompressed data */
+	for (i = 0; i < num_pkt; i++) {
+		uint8_t a[64], b[64];
+		uint32_t off, len;
+
+		if (res_len[i] != pkt_len) {
+			stat->failed++;
+			continue;
+		}
+
+		for (off = 0; off < pkt_len; off += len) {
+			len = pkt_len - off;
+			if (len > sizeof(a))
+				len = sizeof(a);
+
+			odp_packet_copy_to_mem(global->pkt_in[i], off, len, a);
+			odp_packet_copy_to_mem(global->pkt_out[i], off, len, b);
+
+			if (memcmp(a, b, len)) {
+				ODPH_ERR("Data mismatch: packet %u, offset %u\n", i, off);
+				stat->failed++;
+				break;
+			}
+		}
+	}
+
+	if (odp_comp_session_destroy(comp) || odp_comp_session_destroy(decomp)) {
+		ODPH_ERR("Session destroy failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void print_stat(const char *name, uint32_t level, test_stat_t *stat,
+		       uint32_t num_round)
+{
+	double bytes = (double)stat->in_bytes * num_round;
+	double ratio = 0.0;
+	double comp_gbps = 0.0;
+	double decomp_gbps = 0.0;
+
+	if (stat->in_bytes)
+		ratio = (double)stat->out_bytes / stat->in_bytes;
+
+	/* Bytes per nsec equals GB per sec */
+	if (stat->comp_nsec)
+		comp_gbps = bytes / stat->comp_nsec;
+
+	if (stat->decomp_nsec)
+		decomp_gbps = bytes / stat->decomp_nsec;
+
+	printf("  %-8s %5u %9.3f %12.3f %14.3f %8u\n", name, level, ratio,
+	       comp_gbps, decomp_gbps, stat->failed);
+}
+
+static int run_all(test_global_t *global)
+{
+	odp_comp_alg_capability_t alg_capa;
+	test_options_t *test_options = &global->test_options;
+	test_stat_t stat;
+	uint32_t i, level, max_level;
+	int ret = 0;
+
+	printf("RESULTS\n");
+	printf("  algo     level     ratio  comp (GB/s)  decomp (GB/s)   failed\n");
+
+	for (i = 0; i < NUM_ALG; i++) {
+		odp_comp_alg_t alg = alg_info[i].alg;
+
+		if (test_options->alg && test_options->alg != (int)i + 1)
+			continue;
+
+		if ((alg == ODP_COMP_ALG_DEFLATE && !global->capa.comp_algos.bit.deflate) ||
+		    (alg == ODP_COMP_ALG_ZLIB && !global->capa.comp_algos.bit.zlib) ||
+		    (alg == ODP_COMP_ALG_LZS && !global->capa.comp_algos.bit.lzs)) {
+			printf("  %-8s not supported\n", alg_info[i].name);
+			continue;
+		}
+
+		if (odp_comp_alg_capability(alg, &alg_capa)) {
+			ODPH_ERR("Alg capability failed: %s\n", alg_info[i].name);
+			ret = -1;
+			continue;
+		}
+
+		max_level = alg_capa.max_level;
+		level = 1;
+
+		if (test_options->level) {
+			if (test_options->level > max_level) {
+				printf("  %-8s max level %u\n", alg_info[i].name, max_level);
+				continue;
+			}
+
+			level = test_options->level;
+			max_level = level;
+		}
+
+		for (; level <= max_level; level++) {
+			if (run_test(global, alg, level, &stat)) {
+				ret = -1;
+				break;
+			}
+
+			print_stat(alg_info[i].name, level, &stat, test_options->num_round);
+
+			if (stat.failed)
+				ret = -1;
+		}
+	}
+
+	printf("\n");
+
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	odp_instance_t instance;
+	odp_init_t init;
+	test_global_t *global;
+	int ret = 0;
+
+	global = &test_global;
+	memset(global, 0, sizeof(test_global_t));
+	global->pool  = ODP_POOL_INVALID;
+	global->queue = ODP_QUEUE_INVALID;
+
+	if (parse_options(argc, argv, &global->test_options))
+		return -1;
+
+	/* List features not to be used */
+	odp_init_param_init(&init);
+	init.not_used.feat.cls      = 1;
+	init.not_used.feat.crypto   = 1;
+	init.not_used.feat.ipsec    = 1;
+	init.not_used.feat.schedule = 1;
+	init.not_used.feat.timer    = 1;
+	init.not_used.feat.tm       = 1;
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, &init, NULL)) {
+		ODPH_ERR("Global init failed.\n");
+		return -1;
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		ODPH_ERR("Local init failed.\n");
+		return -1;
+	}
+
+	odp_sys_info_print();
+
+	if (create_resources(global))
+		ret = -1;
+	else if (run_all(global))
+		ret = -1;
+
+	destroy_resources(global);
+
+	if (odp_term_local()) {
+		ODPH_ERR("term local failed.\n");
+		return -1;
+	}
+
+	if (odp_term_global(instance)) {
+		ODPH_ERR("term global failed.\n");
+		return -1;
+	}
+
+	return ret;
+}
@@ -0,0 +1,516 @@
+/* Copyright (c) 2021, Nokia
+ *
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+#include <odp_api.h>
+#include <odp/helper/odph_api.h>
+
+typedef struct test_options_t {
+	uint32_t num_cpu;
+	uint32_t num_flow;
+	uint32_t num_round;
+	uint32_t burst;
+	uint32_t idle_tmo_ms;
+
+} test_options_t;
+
+typedef struct test_global_t test_global_t;
+
+typedef struct test_thread_ctx_t {
+	test_global_t *global;
+	uint32_t idx;
+	uint64_t insert_nsec;
+	uint64_t inserts;
+	uint64_t insert_fails;
+	uint64_t lookup_nsec;
+	uint64_t lookups;
+	uint64_t hits;
+
+} test_thread_ctx_t;
+
+struct test_global_t {
+	test_options_t test_options;
+
+	odp_barrier_t barrier;
+	odp_cpumask_t cpumask;
+	odph_flow_table_t table;
+	uint64_t age_nsec;
+	uint64_t aged;
+	odph_thread_t thread_tbl[ODP_THREAD_COUNT_MAX];
+	test_thread_ctx_t thread_ctx[ODP_THREAD_COUNT_MAX];
+
+};
+
+static test_global_t test_global;
+
+static void print_usage(void)
+{
+	printf("\n"
+	       "Flow table helper performance test\n"
+	       "\n"
+	       "Usage: odp_flowtable_perf [options]\n"
+	       "\n"
+	       "  -c, --num_cpu          Number of CPUs (worker threads). 0: all available CPUs. Default 1.\n"
+	       "  -f, --num_flow         Number of flows. Default 1000000.\n"
+	       "  -r, --num_round        Number of lookup rounds over all flows. Default 10.\n"
+	       "  -b, --burst            Number of keys per lookup call. Value 1 uses single key lookup\n"
+	       "                         calls, other values bulk lookup calls. Default 32.\n"
+	       "  -t, --idle_tmo         Idle timeout in msec. When non-zero, measures also aging of\n"
+	       "                         all flows after the lookup rounds. Default 0.\n"
+	       "  -h, --help             This help\n"
+	       "\n");
+}
+
+static int parse_options(int argc, char *argv[], test_options_t *test_options)
+{
+	int opt;
+	int long_index;
+	int ret = 0;
+
+	static const struct option longopts[] = {
+		{"num_cpu",   required_argument, NULL, 'c'},
+		{"num_flow",  required_argument, NULL, 'f'},
+		{"num_round", required_argument, NULL, 'r'},
+		{"burst",     required_argument, NULL, 'b'},
+		{"idle_tmo",  required_argument, NULL, 't'},
+		{"help",      no_argument,       NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+c:f:r:b:t:h";
+
+	test_options->num_cpu     = 1;
+	test_options->num_flow    = 1000000;
+	test_options->num_round   = 10;
+	test_options->burst       = 32;
+	test_options->idle_tmo_ms = 0;
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case 'c':
+			test_options->num_cpu = atoi(optarg);
+			break;
+		case 'f':
+			test_options->num_flow = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			test_options->num_round = atoi(optarg);
+			break;
+		case 'b':
+			test_options->burst = atoi(optarg);
+			break;
+		case 't':
+			test_options->idle_tmo_ms = atoi(optarg);
+			break;
+		case 'h':
+			/* fall through */
+		default:
+			print_usage();
+			ret = -1;
+			break;
+		}
+	}
+
+	if (test_options->burst < 1 || test_options->burst > ODPH_FLOW_TABLE_BULK_MAX) {
+		ODPH_ERR("Bad burst size %u. Max is %i.\n", test_options->burst,
+			 ODPH_FLOW_TABLE_BULK_MAX);
+		ret = -1;
+	}
+
+	if (test_options->num_flow == 0) {
+		ODPH_ERR("Number of flows must be non-zero\n");
+		ret = -1;
+	}
+
+	return ret;
+}
+
+static int set_num_cpu(test_global_t *global)
+{
+	int ret, max_num;
+	test_options_t *test_options = &global->test_options;
+	int num_cpu = test_options->num_cpu;
+
+	/* One thread used for the main thread */
+	if (num_cpu > ODP_THREAD_COUNT_MAX - 1) {
+		ODPH_ERR("Too many workers. Maximum is %i.\n", ODP_THREAD_COUNT_MAX - 1);
+		return -1;
+	}
+
+	max_num = num_cpu;
+	if (num_cpu == 0)
+		max_num = ODP_THREAD_COUNT_MAX - 1;
+
+	ret = odp_cpumask_default_worker(&global->cpumask, max_num);
+
+	if (num_cpu && ret != num_cpu) {
+		ODPH_ERR("Too many workers. Max supported %i.\n", ret);
+		return -1;
+	}
+
+	/* Zero: all available workers */
+	if (num_cpu == 0) {
+		if (ret > max_num) {
+			ODPH_ERR("Too many cpus from odp_cpumask_default_worker(): %i\n", ret);
+			return -1;
+		}
+
+		num_cpu = ret;
+		test_options->num_cpu = num_cpu;
+	}
+
+	odp_barrier_init(&global->barrier, num_cpu);
+
+	return 0;
+}
+
+static int create_table(test_global_t *global)
+{
+	odph_flow_table_param_t param;
+	test_options_t *test_options = &global->test_options;
+
+	printf("\nFlow table performance test\n");
+	printf("  num cpu          %u\n", test_options->num_cpu);
+	printf("  num flows        %u\n", test_options->num_flow);
+	printf("  num rounds       %u\n", test_options->num_round);
+	printf("  burst size       %u\n", test_options->burst);
+	printf("  idle timeout     %u msec\n\n", test_options->idle_tmo_ms);
+
+	odph_flow_table_param_init(&param);
+	param.max_flows = test_options->num_flow;
+	param.idle_timeout_ns = test_options->idle_tmo_ms * ODP_TIME_MSEC_IN_NS;
+
+	global->table = odph_flow_table_create("flowtable_perf", &param);
+	if (global->table == ODPH_FLOW_TABLE_INVALID) {
+		ODPH_ERR("Flow table create failed.\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static inline void make_key(odph_flow_key_t *key, uint32_t i)
+{
+	memset(key, 0, sizeof(odph_flow_key_t));
+	key->src_ip   = 0x0a000000 + (i >> 8);
+	key->dst_ip   = 0xc0a80000 + (i & 0xff);
+	key->src_port = 1024 + (i & 0x3fff);
+	key->dst_port = 80 + (i >> 24);
+	key->proto    = 17;
+}
+
+static inline uint32_t rand_u32(uint32_t *state)
+{
+	uint32_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+
+	return x;
+}
+
+static void insert_flows(test_thread_ctx_t *ctx, odph_flow_table_t table, uint32_t first,
+			 uint32_t num)
+{
+	odph_flow_key_t key;
+	odp_time_t t1, t2;
+	uint32_t i;
+	int ret;
+
+	t1 = odp_time_local();
+
+	for (i = first; i < first + num; i++) {
+		make_key(&key, i);
+
+		if (odph_flow_table_insert(table, &key, i))
+			ctx->insert_fails++;
+	}
+
+	ret = odph_flow_table_flush(table);
+	if (ret > 0)
+		ctx->insert_fails += ret;
+
+	t2 = odp_time_local();
+
+	ctx->insert_nsec = odp_time_diff_ns(t2, t1);
+	ctx->inserts     = num;
+}
+
+static void lookup_flows(test_thread_ctx_t *ctx, odph_flow_table_t table)
+{
+	test_options_t *test_options = &ctx->global->test_options;
+	uint32_t num_flow = test_options->num_flow;
+	uint32_t burst = test_options->burst;
+	uint64_t num = (uint64_t)test_options->num_round * num_flow;
+	uint32_t seed = 0x12345678 + ctx->idx;
+	odph_flow_key_t key[burst];
+	uint64_t value[burst];
+	uint64_t mask, i;
+	uint64_t hits = 0;
+	odp_time_t t1, t2;
+	uint32_t j;
+
+	num -= num % burst;
+
+	t1 = odp_time_local();
+
+	for (i = 0; i < num; i += burst) {
+		for (j = 0; j < burst; j++)
+			make_key(&key[j], rand_u32(&seed) % num_flow);
+
+		if (burst == 1) {
+			if (odph_flow_table_lookup(table, &key[0], &value[0]) == 0)
+				hits++;
+		} else {
+			hits += odph_flow_table_lookup_bulk(table, key, value, burst, &mask);
+		}
+	}
+
+	t2 = odp_time_local();
+
+	ctx->lookup_nsec = odp_time_diff_ns(t2, t1);
+	ctx->lookups     = num;
+	ctx->hits        = hits;
+}
+
+static void age_flows(test_global_t *global)
+{
+	odph_flow_key_t key[ODPH_FLOW_TABLE_BULK_MAX];
+	uint64_t value[ODPH_FLOW_TABLE_BULK_MAX];
+	uint64_t tmo_ns = global->test_options.idle_tmo_ms * ODP_TIME_MSEC_IN_NS;
+	odp_time_t t1, t2, end;
+	uint64_t nsec = 0;
+	int num;
+
+	/* Wait until all flows have been idle long enough */
+	odp_time_wait_ns(tmo_ns + tmo_ns / 10);
+
+	end = odp_time_sum(odp_time_local(), odp_time_local_from_ns(2 * tmo_ns));
+
+	while (odph_flow_table_count(global->table) &&
+	       odp_time_cmp(end, odp_time_local()) > 0) {
+		t1 = odp_time_local();
+		num = odph_flow_table_age(global->table, key, value, ODPH_FLOW_TABLE_BULK_MAX);
+		t2 = odp_time_local();
+
+		nsec += odp_time_diff_ns(t2, t1);
+		global->aged += num;
+
+		/* Remaining flows expire on later timer wheel ticks */
+		if (num == 0)
+			odp_time_wait_ns(tmo_ns / 100);
+	}
+
+	global->age_nsec = nsec;
+}
+
+static int run_test(void *arg)
+{
+	test_thread_ctx_t *ctx = arg;
+	test_global_t *global = ctx->global;
+	test_options_t *test_options = &global->test_options;
+	odph_flow_table_t table = global->table;
+	uint32_t num_cpu = test_options->num_cpu;
+	uint32_t num_flow = test_options->num_flow;
+	uint32_t first = ((uint64_t)num_flow * ctx->idx) / num_cpu;
+	uint32_t last = ((uint64_t)num_flow * (ctx->idx + 1)) / num_cpu;
+
+	/* Start all workers at the same time */
+	odp_barrier_wait(&global->barrier);
+
+	insert_flows(ctx, table, first, last - first);
+
+	/* All flows have been inserted */
+	odp_barrier_wait(&global->barrier);
+
+	lookup_flows(ctx, table);
+
+	odp_barrier_wait(&global->barrier);
+
+	if (ctx->idx == 0 && test_options->idle_tmo_ms)
+		age_flows(global);
+
+	return 0;
+}
+
+static int start_workers(test_global_t *global, odp_instance_t instance)
+{
+	odph_thread_common_param_t param;
+	int i, ret;
+	test_options_t *test_options = &global->test_options;
+	int num_cpu = test_options->num_cpu;
+	odph_thread_param_t thr_param[num_cpu];
+
+	memset(&param, 0, sizeof(odph_thread_common_param_t));
+	param.instance = instance;
+	param.cpumask  = &global->cpumask;
+
+	memset(thr_param, 0, sizeof(thr_param));
+	for (i = 0; i < num_cpu; i++) {
+		test_thread_ctx_t *thread_ctx = &global->thread_ctx[i];
+
+		thread_ctx->global = global;
+		thread_ctx->idx    = i;
+
+		thr_param[i].thr_type = ODP_THREAD_WORKER;
+		thr_param[i].start    = run_test;
+		thr_param[i].arg      = thread_ctx;
+	}
+
+	ret = odph_thread_create(global->thread_tbl, &param, thr_param, num_cpu);
+	if (ret != num_cpu) {
+		ODPH_ERR("Failed to create all threads %i\n", ret);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int print_stat(test_global_t *global)
+{
+	int i;
+	test_options_t *test_options = &global->test_options;
+	int num_cpu = test_options->num_cpu;
+	uint64_t insert_nsec = 0, inserts = 0, insert_fails = 0;
+	uint64_t lookup_nsec = 0, lookups = 0, hits = 0;
+	double insert_ave, lookup_ave;
+
+	for (i = 0; i < num_cpu; i++) {
+		test_thread_ctx_t *ctx = &global->thread_ctx[i];
+
+		insert_nsec  += ctx->insert_nsec;
+		inserts      += ctx->inserts;
+		insert_fails += ctx->insert_fails;
+		lookup_nsec  += ctx->lookup_nsec;
+		lookups      += ctx->lookups;
+		hits         += ctx->hits;
+	}
+
+	if (insert_nsec == 0 || lookup_nsec == 0) {
+		printf("No results.\n");
+		return -1;
+	}
+
+	insert_ave = (double)insert_nsec / num_cpu;
+	lookup_ave = (double)lookup_nsec / num_cpu;
+
+	printf("RESULTS - average over %i threads:\n", num_cpu);
+	printf("----------------------------------\n");
+	printf("  inserts:              %" PRIu64 "\n", inserts);
+	printf("  insert failures:      %" PRIu64 "\n", insert_fails);
+	printf("  insert duration:      %.6f sec\n", insert_ave / 1000000000);
+	printf("  inserts per cpu:      %.3f M/s\n", (inserts / num_cpu) / (insert_ave / 1000.0));
+	printf("  total inserts:        %.3f M/s\n", inserts / (insert_ave / 1000.0));
+	printf("\n");
+	printf("  lookups:              %" PRIu64 "\n", lookups);
+	printf("  lookup hits:          %" PRIu64 "\n", hits);
+	printf("  lookup duration:      %.6f sec\n", lookup_ave / 1000000000);
+	printf("  lookups per cpu:      %.3f M/s\n", (lookups / num_cpu) / (lookup_ave / 1000.0));
+	printf("  total lookups:        %.3f M/s\n", lookups / (lookup_ave / 1000.0));
+	printf("  nsec per lookup:      %.1f\n", lookup_ave / (lookups / num_cpu));
+	printf("\n");
+
+	if (test_options->idle_tmo_ms) {
+		printf("  aged flows:           %" PRIu64 "\n", global->aged);
+		printf("  aging duration:       %.6f sec\n", global->age_nsec / 1000000000.0);
+		if (global->aged)
+			printf("  nsec per aged flow:   %.1f\n",
+			       (double)global->age_nsec / global->aged);
+		printf("\n");
+	}
+
+	if (insert_fails || hits != lookups) {
+		ODPH_ERR("Not all flows were inserted or found\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	odp_instance_t instance;
+	odp_init_t init;
+	test_global_t *global;
+	int ret = 0;
+
+	global = &test_global;
+	memset(global, 0, sizeof(test_global_t));
+
+	if (parse_options(argc, argv, &global->test_options))
+		return -1;
+
+	/* List features not to be used */
+	odp_init_param_init(&init);
+	init.not_used.feat.cls      = 1;
+	init.not_used.feat.compress = 1;
+	init.not_used.feat.crypto   = 1;
+	init.not_used.feat.ipsec    = 1;
+	init.not_used.feat.schedule = 1;
+	init.not_used.feat.timer    = 1;
+	init.not_used.feat.tm       = 1;
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, &init, NULL)) {
+		ODPH_ERR("Global init failed.\n");
+		return -1;
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		ODPH_ERR("Local init failed.\n");
+		return -1;
+	}
+
+	odp_sys_info_print();
+
+	if (set_num_cpu(global))
+		return -1;
+
+	if (create_table(global))
+		return -1;
+
+	/* Start workers */
+	if (start_workers(global, instance))
+		return -1;
+
+	/* Wait workers to exit */
+	odph_thread_join(global->thread_tbl, global->test_options.num_cpu);
+
+	if (print_stat(global))
+		ret = -1;
+
+	if (odph_flow_table_destroy(global->table)) {
+		ODPH_ERR("Flow table destroy failed.\n");
+		return -1;
+	}
+
+	if (odp_term_local()) {
+		ODPH_ERR("term local failed.\n");
+		return -1;
+	}
+
+	if (odp_term_global(instance)) {
+		ODPH_ERR("term global failed.\n");
+		return -1;
+	}
+
+	return ret;
+}
@@ -28,6 +28,16 @@
  */
 #define POOL_NUM_PKT  64
 
+/** @def MAX_BURST
+ * Maximum number of packets per odp_ipsec_out() call
+ */
+#define MAX_BURST     32
+
+/** @def MAX_SA
+ * Maximum number of SAs
+ */
+#define MAX_SA        16
+
 static uint8_t test_salt[16] = "0123456789abcdef";
 
 static uint8_t test_key16[16] = { 0x01, 0x02, 0x03, 0x04, 0x05,
@@ -143,6 +153,19 @@ typedef struct {
 	 * Specified through -u argument.
 	 */
 	int ah;
+
+	/*
+	 * Number of packets per odp_ipsec_out() call. When larger than one,
+	 * results are reported also for single packet calls for comparison.
+	 * Specified through -b argument.
+	 */
+	int burst;
+
+	/*
+	 * Number of SAs that packets of a burst are spread over.
+	 * Specified through -n argument.
+	 */
+	int num_sa;
 } ipsec_args_t;
 
 /*
@@ -691,6 +714,91 @@ run_measure_one(ipsec_args_t *cargs,
 	return rc < 0 ? rc : 0;
 }
 
+/**
+ * Run measurement iterations with bursts of packets. Consecutive packets of
+ * a burst use different SAs. Result of run returned in 'result' out
+ * parameter.
+ */
+static int
+run_measure_one_burst(ipsec_args_t *cargs,
+		      odp_ipsec_sa_t sa[],
+		      unsigned int payload_length,
+		      time_record_t *start,
+		      time_record_t *end)
+{
+	odp_ipsec_out_param_t param;
+	odp_pool_t pkt_pool;
+	odp_ipsec_sa_t sa_tbl[MAX_BURST];
+	odp_packet_t pkt[MAX_BURST];
+	odp_packet_t out_pkt[MAX_BURST];
+	int burst = cargs->burst;
+	int packets_sent = 0;
+	int rc = 0;
+	int i;
+
+	pkt_pool = odp_pool_lookup("packet_pool");
+	if (pkt_pool == ODP_POOL_INVALID) {
+		app_err("pkt_pool not found\n");
+		return -1;
+	}
+
+	for (i = 0; i < burst; i++)
+		sa_tbl[i] = sa[i % cargs->num_sa];
+
+	/* Initialize parameters block */
+	memset(&param, 0, sizeof(param));
+	param.num_sa = cargs->num_sa > 1 ? burst : 1;
+	param.num_opt = 0;
+	param.sa = sa_tbl;
+
+	fill_time_record(start);
+
+	while (packets_sent < cargs->iteration_count) {
+		int num_out = burst;
+
+		for (i = 0; i < burst; i++) {
+			pkt[i] = make_packet(pkt_pool, payload_length);
+			if (ODP_PACKET_INVALID == pkt[i]) {
+				if (i)
+					odp_packet_free_multi(pkt, i);
+				return -1;
+			}
+		}
+
+		rc = odp_ipsec_out(pkt, burst, out_pkt, &num_out, &param);
+		if (rc < burst) {
+			app_err("failed odp_ipsec_out: rc = %d\n", rc);
+			if (rc < 0)
+				rc = 0;
+			odp_packet_free_multi(out_pkt, rc);
+			odp_packet_free_multi(&pkt[rc], burst - rc);
+			rc = -1;
+			break;
+		}
+
+		for (i = 0; i < num_out; i++) {
+			if (odp_packet_has_error(out_pkt[i])) {
+				odp_ipsec_packet_result_t result;
+
+				odp_ipsec_result(&result, out_pkt[i]);
+				app_err("Received error packet: %d\n",
+					result.status.error.all);
+			}
+
+			if (cargs->debug_packets)
+				odp_packet_print_data(out_pkt[i], 0,
+						      odp_packet_len(out_pkt[i]));
+		}
+
+		odp_packet_free_multi(out_pkt, num_out);
+		packets_sent += rc;
+	}
+
+	fill_time_record(end);
+
+	return rc < 0 ? rc : 0;
+}
+
 static int
 run_measure_one_async(ipsec_args_t *cargs,
 		      odp_ipsec_sa_t sa,
@@ -795,9 +903,11 @@ run_measure_one_config(ipsec_args_t *cargs,
 	unsigned int num_payloads = global_num_payloads;
 	unsigned int *payloads = global_payloads;
 	odp_ipsec_capability_t capa;
-	odp_ipsec_sa_t sa;
+	odp_ipsec_sa_t sa[MAX_SA];
 	unsigned int i;
+	int num_sa = cargs->num_sa;
 	int rc = 0;
+	int j;
 
 	if (odp_ipsec_capability(&capa) < 0) {
 		app_err("IPSEC capability call failed.\n");
@@ -819,10 +929,16 @@ run_measure_one_config(ipsec_args_t *cargs,
 		return 0;
 	}
 
-	sa = create_sa_from_config(config, cargs);
-	if (sa == ODP_IPSEC_SA_INVALID) {
-		app_err("IPsec SA create failed.\n");
-		return -1;
+	for (j = 0; j < num_sa; j++) {
+		sa[j] = create_sa_from_config(config, cargs);
+		if (sa[j] == ODP_IPSEC_SA_INVALID) {
+			app_err("IPsec SA create failed.\n");
+			while (--j >= 0) {
+				odp_ipsec_sa_disable(sa[j]);
+				odp_ipsec_sa_destroy(sa[j]);
+			}
+			return -1;
+		}
 	}
 
 	print_result_header();
@@ -837,11 +953,11 @@ run_measure_one_config(ipsec_args_t *cargs,
 		time_record_t start, end;
 
 		if (cargs->schedule || cargs->poll)
-			rc = run_measure_one_async(cargs, sa,
+			rc = run_measure_one_async(cargs, sa[0],
 						   payloads[i],
 						   &start, &end);
 		else
-			rc = run_measure_one(cargs, sa,
+			rc = run_measure_one(cargs, sa[0],
 					     payloads[i],
 					     &start, &end);
 		if (rc)
@@ -858,9 +974,38 @@ run_measure_one_config(ipsec_args_t *cargs,
 
 		print_result(cargs, payloads[i],
 			     config, &result);
+
+		if (cargs->burst > 1) {
+			ipsec_run_result_t burst_result;
+
+			rc = run_measure_one_burst(cargs, sa, payloads[i],
+						   &start, &end);
+			if (rc)
+				break;
+
+			count = get_elapsed_usec(&start, &end);
+			burst_result.elapsed = count / cargs->iteration_count;
+
+			count = get_rusage_self_diff(&start, &end);
+			burst_result.rusage_self = count / cargs->iteration_count;
+
+			count = get_rusage_thread_diff(&start, &end);
+			burst_result.rusage_thread = count / cargs->iteration_count;
+
+			print_result(cargs, payloads[i],
+				     config, &burst_result);
+			printf("%30.30s burst of %i over %i SAs: %.2fx speedup\n",
+			       "", cargs->burst, num_sa,
+			       result.elapsed / burst_result.elapsed);
+		}
+	}
+
+	for (j = 1; j < num_sa; j++) {
+		odp_ipsec_sa_disable(sa[j]);
+		odp_ipsec_sa_destroy(sa[j]);
 	}
 
-	odp_ipsec_sa_disable(sa);
+	odp_ipsec_sa_disable(sa[0]);
 	if (cargs->schedule || cargs->poll) {
 		odp_queue_t out_queue = odp_queue_lookup("ipsec-out");
 		odp_ipsec_status_t status;
@@ -872,11 +1017,11 @@ run_measure_one_config(ipsec_args_t *cargs,
 			    odp_event_type(event) == ODP_EVENT_IPSEC_STATUS &&
 			    odp_ipsec_status(&status, event) == ODP_IPSEC_OK &&
 			    status.id == ODP_IPSEC_STATUS_SA_DISABLE &&
-			    status.sa == sa)
+			    status.sa == sa[0])
 				break;
 		}
 	}
-	odp_ipsec_sa_destroy(sa);
+	odp_ipsec_sa_destroy(sa[0]);
 
 	return rc;
 }
@@ -911,7 +1056,11 @@ static void usage(char *progname)
 	       progname, progname);
 
 	print_config_names("				      ");
-	printf("  -d, --debug	       Enable dump of processed packets.\n"
+	printf("  -b, --burst <number> Packets per odp_ipsec_out() call, max %i (default 1).\n"
+	       "                       Results of single packet calls are printed for comparison.\n"
+	       "  -n, --num_sa <number> Number of SAs packets of a burst are spread over,\n"
+	       "                       max %i (default 1).\n"
+	       "  -d, --debug	       Enable dump of processed packets.\n"
 	       "  -f, --flight <number> Max number of packet processed in parallel (default 1)\n"
 	       "  -i, --iterations <number> Number of iterations.\n"
 	       "  -l, --payload	       Payload length.\n"
@@ -920,7 +1069,7 @@ static void usage(char *progname)
 	       "  -t, --tunnel         Use tunnel-mode IPsec transformation.\n"
 	       "  -u, --ah             Use AH transformation instead of ESP.\n"
 	       "  -h, --help	       Display help and exit.\n"
-	       "\n");
+	       "\n", MAX_BURST, MAX_SA);
 }
 
 static void parse_args(int argc, char *argv[], ipsec_args_t *cargs)
@@ -929,11 +1078,13 @@ static void parse_args(int argc, char *argv[], ipsec_args_t *cargs)
 	int long_index;
 	static const struct option longopts[] = {
 		{"algorithm", optional_argument, NULL, 'a'},
+		{"burst", optional_argument, NULL, 'b'},
 		{"debug",  no_argument, NULL, 'd'},
 		{"flight", optional_argument, NULL, 'f'},
 		{"help", no_argument, NULL, 'h'},
 		{"iterations", optional_argument, NULL, 'i'},
 		{"payload", optional_argument, NULL, 'l'},
+		{"num_sa", optional_argument, NULL, 'n'},
 		{"sessions", optional_argument, NULL, 'm'},
 		{"poll", no_argument, NULL, 'p'},
 		{"schedule", no_argument, NULL, 's'},
@@ -942,7 +1093,7 @@ static void parse_args(int argc, char *argv[], ipsec_args_t *cargs)
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts = "+a:c:df:hi:m:nl:sptu";
+	static const char *shortopts = "+a:b:c:df:hi:m:n:l:sptu";
 
 	cargs->in_flight = 1;
 	cargs->debug_packets = 0;
@@ -951,6 +1102,8 @@ static void parse_args(int argc, char *argv[], ipsec_args_t *cargs)
 	cargs->alg_config = NULL;
 	cargs->schedule = 0;
 	cargs->ah = 0;
+	cargs->burst = 1;
+	cargs->num_sa = 1;
 
 	while (1) {
 		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
@@ -968,6 +1121,9 @@ static void parse_args(int argc, char *argv[], ipsec_args_t *cargs)
 				exit(-1);
 			}
 			break;
+		case 'b':
+			cargs->burst = atoi(optarg);
+			break;
 		case 'd':
 			cargs->debug_packets = 1;
 			break;
@@ -984,6 +1140,9 @@ static void parse_args(int argc, char *argv[], ipsec_args_t *cargs)
 		case 'l':
 			cargs->payload_length = atoi(optarg);
 			break;
+		case 'n':
+			cargs->num_sa = atoi(optarg);
+			break;
 		case 's':
 			cargs->schedule = 1;
 			break;
@@ -1003,6 +1162,20 @@ static void parse_args(int argc, char *argv[], ipsec_args_t *cargs)
 
 	optind = 1;		/* reset 'extern optind' from the getopt lib */
 
+	if (cargs->burst < 1 || cargs->burst > MAX_BURST ||
+	    cargs->num_sa < 1 || cargs->num_sa > MAX_SA) {
+		printf("bad burst size or number of SAs\n");
+		usage(argv[0]);
+		exit(-1);
+	}
+
+	if ((cargs->burst > 1 || cargs->num_sa > 1) &&
+	    (cargs->schedule || cargs->poll)) {
+		printf("-b (burst) and -n (num_sa) are supported only in synchronous mode\n");
+		usage(argv[0]);
+		exit(-1);
+	}
+
 	if (cargs->schedule && cargs->poll) {
 		printf("-s (schedule) and -p (poll) options are not compatible\n");
 		usage(argv[0]);
@@ -34,6 +34,16 @@
 /* Minimum number of packets to receive in CI test */
 #define MIN_RX_PACKETS_CI 800
 
+/* Latency measurement: max number of flows (tx thread and pktio pairs) */
+#define MAX_LAT_FLOWS     64
+/* Latency payload header magic */
+#define LAT_MAGIC         0x4c415447
+/* Latency histogram: sub-buckets per power of two and max latency exponent */
+#define LAT_SUB_BITS      4
+#define LAT_SUB           (1 << LAT_SUB_BITS)
+#define LAT_MAX_EXP       40
+#define LAT_BUCKETS       ((LAT_MAX_EXP - LAT_SUB_BITS + 2) * LAT_SUB)
+
 typedef struct test_options_t {
 	uint64_t gap_nsec;
 	uint64_t quit;
@@ -58,6 +68,7 @@ typedef struct test_options_t {
 	uint16_t udp_dst;
 	uint32_t wait_sec;
 	uint32_t mtu;
+	uint8_t  latency;
 
 	struct vlan_hdr {
 		uint16_t tpid;
@@ -75,6 +86,24 @@ typedef struct test_options_t {
 
 } test_options_t;
 
+/* Written into UDP payload of each packet in latency measurement mode */
+typedef struct latency_hdr_t {
+	uint32_t magic;
+	uint32_t flow;
+	uint64_t seq;
+	uint64_t tx_nsec;
+
+} latency_hdr_t;
+
+/* Per transmit thread latency measurement state */
+typedef struct tx_latency_t {
+	odp_pool_t pool;
+	uint32_t hdr_offset;
+	uint32_t flow;
+	uint64_t seq;
+
+} tx_latency_t;
+
 typedef struct thread_arg_t {
 	void *global;
 	int tx_thr;
@@ -103,6 +132,23 @@ typedef struct ODP_ALIGNED_CACHE thread_stat_t {
 
 	} pktio[MAX_PKTIOS];
 
+	/* Receive side latency statistics */
+	struct {
+		uint64_t packets;
+		uint64_t sum_nsec;
+		uint64_t min_nsec;
+		uint64_t max_nsec;
+		uint64_t hist[LAT_BUCKETS];
+
+		struct {
+			uint64_t rx_packets;
+			uint64_t reorder;
+			uint64_t next_seq;
+
+		} flow[MAX_LAT_FLOWS];
+
+	} lat;
+
 } thread_stat_t;
 
 typedef struct test_global_t {
@@ -116,6 +162,9 @@ typedef struct test_global_t {
 	thread_stat_t stat[ODP_THREAD_COUNT_MAX];
 	thread_arg_t thread_arg[ODP_THREAD_COUNT_MAX];
 
+	/* Number of packets sent per latency measurement flow */
+	uint64_t lat_tx_packets[MAX_LAT_FLOWS];
+
 	struct {
 		odph_ethaddr_t eth_src;
 		odph_ethaddr_t eth_dst;
@@ -178,6 +227,12 @@ static void print_usage(void)
 	       "                            udp_src/udp_dst. Comma-separated (no spaces) list of\n"
 	       "                            count values: <udp_src count>,<udp_dst count>\n"
 	       "                            Default value: 0,0\n"
+	       "  -T, --latency             Latency measurement mode. Each packet carries a flow ID,\n"
+	       "                            a sequence number and a global time stamp in its UDP\n"
+	       "                            payload. Receive side reports latency distribution, lost\n"
+	       "                            and reordered packets per flow (tx thread and interface\n"
+	       "                            pair). Packets are copied instead of referenced on\n"
+	       "                            transmit, and UDP checksum is not used.\n"
 	       "  -q, --quit                Quit after this many transmit rounds.\n"
 	       "                            Default: 0 (don't quit)\n"
 	       "  -u, --update_stat <msec>  Update and print statistics every <msec> milliseconds.\n"
@@ -256,6 +311,7 @@ static int parse_options(int argc, char *argv[], test_global_t *global)
 		{"udp_dst",     required_argument, NULL, 'p'},
 		{"c_mode",      required_argument, NULL, 'c'},
 		{"mtu",         required_argument, NULL, 'M'},
+		{"latency",     no_argument,       NULL, 'T'},
 		{"quit",        required_argument, NULL, 'q'},
 		{"wait",        required_argument, NULL, 'w'},
 		{"update_stat", required_argument, NULL, 'u'},
@@ -263,7 +319,7 @@ static int parse_options(int argc, char *argv[], test_global_t *global)
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts = "+i:e:r:t:n:l:L:M:b:x:g:v:s:d:o:p:c:q:u:w:h";
+	static const char *shortopts = "+i:e:r:t:n:l:L:M:b:x:g:v:s:d:o:p:c:Tq:u:w:h";
 
 	test_options->num_pktio  = 0;
 	test_options->num_rx     = 1;
@@ -289,6 +345,7 @@ static int parse_options(int argc, char *argv[], test_global_t *global)
 	test_options->update_msec = 0;
 	test_options->wait_sec = 0;
 	test_options->mtu = 0;
+	test_options->latency = 0;
 
 	for (i = 0; i < MAX_PKTIOS; i++) {
 		memcpy(global->pktio[i].eth_dst.addr, default_eth_dst, 6);
@@ -449,6 +506,9 @@ static int parse_options(int argc, char *argv[], test_global_t *global)
 			count = strtoul(end, NULL, 0);
 			test_options->c_mode.udp_dst = count;
 			break;
+		case 'T':
+			test_options->latency = 1;
+			break;
 		case 'q':
 			test_options->quit = atoll(optarg);
 			break;
@@ -517,6 +577,12 @@ static int parse_options(int argc, char *argv[], test_global_t *global)
 		      (test_options->num_pktio * test_options->num_rx *
 		      test_options->burst_size);
 
+	/* Packets are copied on transmit in latency mode. Reserve space for
+	 * one transmit round of copies. */
+	if (test_options->latency)
+		min_packets += test_options->num_pktio * test_options->num_tx *
+			       num_tx_pkt;
+
 	if (test_options->num_pkt < min_packets) {
 		printf("Error: Pool needs to have at least %u packets\n",
 		       min_packets);
@@ -551,6 +617,20 @@ static int parse_options(int argc, char *argv[], test_global_t *global)
 		ret = -1;
 	}
 
+	if (test_options->latency) {
+		if (test_options->hdr_len + sizeof(latency_hdr_t) > pkt_len) {
+			printf("Error: Latency header does not fit into packet length %" PRIu32 "\n",
+			       pkt_len);
+			ret = -1;
+		}
+
+		if (test_options->num_tx * test_options->num_pktio > MAX_LAT_FLOWS) {
+			printf("Error: Too many latency flows (num_tx * num_pktio), max %i\n",
+			       MAX_LAT_FLOWS);
+			ret = -1;
+		}
+	}
+
 	return ret;
 }
 
@@ -971,6 +1051,76 @@ static int close_pktios(test_global_t *global)
 	return ret;
 }
 
+/* Log-linear histogram bucket of a latency value */
+static inline uint32_t lat_bucket(uint64_t nsec)
+{
+	uint32_t exp;
+
+	if (nsec < LAT_SUB)
+		return nsec;
+
+	exp = 63 - __builtin_clzll(nsec);
+	if (exp > LAT_MAX_EXP)
+		return LAT_BUCKETS - 1;
+
+	return (exp - LAT_SUB_BITS + 1) * LAT_SUB +
+	       ((nsec >> (exp - LAT_SUB_BITS)) & (LAT_SUB - 1));
+}
+
+/* Largest latency value of a histogram bucket */
+static uint64_t lat_bucket_max(uint32_t bucket)
+{
+	uint32_t exp, sub;
+
+	if (bucket < LAT_SUB)
+		return bucket;
+
+	exp = bucket / LAT_SUB + LAT_SUB_BITS - 1;
+	sub = bucket % LAT_SUB;
+
+	return ((uint64_t)(LAT_SUB + sub + 1) << (exp - LAT_SUB_BITS)) - 1;
+}
+
+static inline void update_latency(thread_stat_t *stat, odp_packet_t pkt[], int num,
+				  uint32_t hdr_offset)
+{
+	int i;
+	latency_hdr_t hdr;
+	uint64_t lat_nsec;
+	uint64_t now = odp_time_to_ns(odp_time_global());
+
+	for (i = 0; i < num; i++) {
+		if (odp_packet_len(pkt[i]) < hdr_offset + sizeof(latency_hdr_t))
+			continue;
+
+		if (odp_packet_copy_to_mem(pkt[i], hdr_offset, sizeof(latency_hdr_t), &hdr))
+			continue;
+
+		if (hdr.magic != LAT_MAGIC || hdr.flow >= MAX_LAT_FLOWS)
+			continue;
+
+		lat_nsec = now > hdr.tx_nsec ? now - hdr.tx_nsec : 0;
+
+		stat->lat.packets++;
+		stat->lat.sum_nsec += lat_nsec;
+		stat->lat.hist[lat_bucket(lat_nsec)]++;
+
+		if (lat_nsec < stat->lat.min_nsec)
+			stat->lat.min_nsec = lat_nsec;
+
+		if (lat_nsec > stat->lat.max_nsec)
+			stat->lat.max_nsec = lat_nsec;
+
+		stat->lat.flow[hdr.flow].rx_packets++;
+
+		/* Packets older than the newest one received are reordered */
+		if (hdr.seq < stat->lat.flow[hdr.flow].next_seq)
+			stat->lat.flow[hdr.flow].reorder++;
+		else
+			stat->lat.flow[hdr.flow].next_seq = hdr.seq + 1;
+	}
+}
+
 static int rx_thread(void *arg)
 {
 	int i, thr, num;
@@ -991,9 +1141,13 @@ static int rx_thread(void *arg)
 	int paused = 0;
 	int max_num = 32;
 	odp_event_t ev[max_num];
+	odp_packet_t pkt_tbl[max_num];
+	int latency = global->test_options.latency;
+	uint32_t hdr_len = global->test_options.hdr_len;
 
 	thr = odp_thread_id();
 	global->stat[thr].thread_type = RX_THREAD;
+	global->stat[thr].lat.min_nsec = UINT64_MAX;
 
 	/* Start all workers at the same time */
 	odp_barrier_wait(&global->barrier);
@@ -1040,9 +1194,13 @@ static int rx_thread(void *arg)
 		bytes = 0;
 		for (i = 0; i < num; i++) {
 			pkt = odp_packet_from_event(ev[i]);
+			pkt_tbl[i] = pkt;
 			bytes += odp_packet_len(pkt);
 		}
 
+		if (latency)
+			update_latency(&global->stat[thr], pkt_tbl, num, hdr_len);
+
 		rx_packets += num;
 		rx_bytes   += bytes;
 
@@ -1175,7 +1333,10 @@ static int init_packets(test_global_t *global, int pktio,
 		odp_packet_has_eth_set(pkt, 1);
 		odp_packet_has_ipv4_set(pkt, 1);
 		odp_packet_has_udp_set(pkt, 1);
-		udp->chksum = odph_ipv4_udp_chksum(pkt);
+
+		/* Payload is modified per packet in latency mode */
+		if (!test_options->latency)
+			udp->chksum = odph_ipv4_udp_chksum(pkt);
 
 		/* Increment port numbers */
 		if (test_options->c_mode.udp_src) {
@@ -1228,7 +1389,7 @@ static inline int update_rand_data(uint8_t *data, uint32_t data_len)
 
 static inline int send_burst(odp_pktout_queue_t pktout, odp_packet_t pkt[],
 			     int burst_size, odp_bool_t use_rand_len, uint32_t pkts_per_pktio,
-			     uint64_t *sent_bytes) {
+			     tx_latency_t *lat, uint64_t *sent_bytes) {
 	int i, sent;
 	int ret = 0;
 	int num = burst_size;
@@ -1253,7 +1414,11 @@ static inline int send_burst(odp_pktout_queue_t pktout, odp_packet_t pkt[],
 			idx = rand_data[rand_idx++] % pkts_per_pktio;
 		}
 
-		pkt_ref[i] = odp_packet_ref_static(pkt[idx]);
+		if (odp_unlikely(lat != NULL))
+			pkt_ref[i] = odp_packet_copy(pkt[idx], lat->pool);
+		else
+			pkt_ref[i] = odp_packet_ref_static(pkt[idx]);
+
 		if (odp_unlikely(pkt_ref[i] == ODP_PACKET_INVALID)) {
 			num = i;
 			break;
@@ -1266,11 +1431,30 @@ static inline int send_burst(odp_pktout_queue_t pktout, odp_packet_t pkt[],
 		return ret;
 	}
 
+	if (odp_unlikely(lat != NULL)) {
+		latency_hdr_t hdr;
+
+		hdr.magic   = LAT_MAGIC;
+		hdr.flow    = lat->flow;
+		hdr.tx_nsec = odp_time_to_ns(odp_time_global());
+
+		for (i = 0; i < num; i++) {
+			hdr.seq = lat->seq + i;
+			odp_packet_copy_from_mem(pkt_ref[i], lat->hdr_offset,
+						 sizeof(latency_hdr_t), &hdr);
+		}
+	}
+
 	sent = odp_pktout_send(pktout, pkt_ref, num);
 
 	if (odp_unlikely(sent < 0))
 		sent = 0;
 
+	/* Unsent packets are at the end of the burst, so that sequence
+	 * numbers stay contiguous */
+	if (odp_unlikely(lat != NULL))
+		lat->seq += sent;
+
 	if (odp_unlikely(sent != num)) {
 		uint32_t num_drop = num - sent;
 
@@ -1362,6 +1546,8 @@ static int tx_thread(void *arg)
 	int num_pktio = test_options->num_pktio;
 	int num_pkt;
 	odp_pktout_queue_t pktout[num_pktio];
+	tx_latency_t lat[num_pktio];
+	int latency = test_options->latency;
 	uint32_t pkts_per_pktio = bursts * burst_size;
 
 	if (use_rand_len) {
@@ -1386,6 +1572,14 @@ static int tx_thread(void *arg)
 	if (num_alloc != num_pkt)
 		ret = -1;
 
+	/* Latency measurement flow per pktio interface */
+	for (i = 0; i < num_pktio; i++) {
+		lat[i].pool = pool;
+		lat[i].hdr_offset = test_options->hdr_len;
+		lat[i].flow = tx_thr * num_pktio + i;
+		lat[i].seq = 0;
+	}
+
 	/* Initialize packets per pktio interface */
 	for (i = 0; ret == 0 && i < num_pktio; i++) {
 		int f = i * pkts_per_pktio;
@@ -1433,7 +1627,9 @@ static int tx_thread(void *arg)
 				sent = send_burst(pktout[i],
 						  &pkt[first + j * burst_size],
 						  burst_size, use_rand_len,
-						  pkts_per_pktio, &sent_bytes);
+						  pkts_per_pktio,
+						  latency ? &lat[i] : NULL,
+						  &sent_bytes);
 
 				if (odp_unlikely(sent < 0)) {
 					ret = -1;
@@ -1459,6 +1655,11 @@ static int tx_thread(void *arg)
 	if (num_alloc > 0)
 		odp_packet_free_multi(pkt, num_alloc);
 
+	if (latency) {
+		for (i = 0; i < num_pktio; i++)
+			global->lat_tx_packets[lat[i].flow] = lat[i].seq;
+	}
+
 	/* Update stats */
 	global->stat[thr].time_nsec   = diff_ns;
 	global->stat[thr].tx_timeouts = tx_timeouts;
@@ -1582,6 +1783,110 @@ static void periodic_print_loop(test_global_t *global)
 	}
 }
 
+static uint64_t lat_percentile(const uint64_t hist[], uint64_t num, uint64_t max_nsec,
+			       double percentile)
+{
+	uint32_t i;
+	uint64_t sum = 0;
+	uint64_t target = (uint64_t)(percentile * num / 100.0);
+
+	if (target == 0)
+		target = 1;
+
+	for (i = 0; i < LAT_BUCKETS; i++) {
+		sum += hist[i];
+
+		if (sum >= target)
+			break;
+	}
+
+	if (i == LAT_BUCKETS || lat_bucket_max(i) > max_nsec)
+		return max_nsec;
+
+	return lat_bucket_max(i);
+}
+
+static void print_latency_stat(test_global_t *global)
+{
+	int i, j;
+	int num_flow = global->test_options.num_tx * global->test_options.num_pktio;
+	uint64_t hist[LAT_BUCKETS];
+	uint64_t num = 0;
+	uint64_t sum_nsec = 0;
+	uint64_t min_nsec = UINT64_MAX;
+	uint64_t max_nsec = 0;
+	uint64_t lost_sum = 0;
+	uint64_t reorder_sum = 0;
+
+	memset(hist, 0, sizeof(hist));
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		thread_stat_t *stat = &global->stat[i];
+
+		if (stat->thread_type != RX_THREAD || stat->lat.packets == 0)
+			continue;
+
+		num      += stat->lat.packets;
+		sum_nsec += stat->lat.sum_nsec;
+
+		if (stat->lat.min_nsec < min_nsec)
+			min_nsec = stat->lat.min_nsec;
+
+		if (stat->lat.max_nsec > max_nsec)
+			max_nsec = stat->lat.max_nsec;
+
+		for (j = 0; j < LAT_BUCKETS; j++)
+			hist[j] += stat->lat.hist[j];
+	}
+
+	printf("LATENCY\n");
+	printf("  flow  tx thr  pktio  tx packets  rx packets        lost   reordered\n");
+	printf("  -------------------------------------------------------------------\n");
+
+	for (i = 0; i < num_flow; i++) {
+		uint64_t tx_packets = global->lat_tx_packets[i];
+		uint64_t rx_packets = 0;
+		uint64_t reorder = 0;
+		uint64_t lost;
+
+		for (j = 0; j < ODP_THREAD_COUNT_MAX; j++) {
+			if (global->stat[j].thread_type != RX_THREAD)
+				continue;
+
+			rx_packets += global->stat[j].lat.flow[i].rx_packets;
+			reorder    += global->stat[j].lat.flow[i].reorder;
+		}
+
+		lost = tx_packets > rx_packets ? tx_packets - rx_packets : 0;
+		lost_sum    += lost;
+		reorder_sum += reorder;
+
+		printf("  %4i  %6i  %5i  %10" PRIu64 "  %10" PRIu64 "  %10" PRIu64 "  %10" PRIu64 "\n",
+		       i, i / (int)global->test_options.num_pktio,
+		       i % (int)global->test_options.num_pktio,
+		       tx_packets, rx_packets, lost, reorder);
+	}
+
+	printf("\n");
+	printf("  packets:                    %" PRIu64 "\n", num);
+	printf("  lost packets:               %" PRIu64 "\n", lost_sum);
+	printf("  reordered packets:          %" PRIu64 "\n", reorder_sum);
+
+	if (num) {
+		printf("  min latency (nsec):         %" PRIu64 "\n", min_nsec);
+		printf("  ave latency (nsec):         %" PRIu64 "\n", sum_nsec / num);
+		printf("  p50 latency (nsec):         %" PRIu64 "\n",
+		       lat_percentile(hist, num, max_nsec, 50.0));
+		printf("  p99 latency (nsec):         %" PRIu64 "\n",
+		       lat_percentile(hist, num, max_nsec, 99.0));
+		printf("  p99.9 latency (nsec):       %" PRIu64 "\n",
+		       lat_percentile(hist, num, max_nsec, 99.9));
+		printf("  max latency (nsec):         %" PRIu64 "\n", max_nsec);
+	}
+
+	printf("\n");
+}
+
 static int print_final_stat(test_global_t *global)
 {
 	int i, num_thr;
@@ -1711,6 +2016,9 @@ static int print_final_stat(test_global_t *global)
 	printf("  tx Mbit/s:                  %.1f\n", tx_mbit_per_sec);
 	printf("\n");
 
+	if (test_options->latency)
+		print_latency_stat(global);
+
 	if (rx_pkt_sum < MIN_RX_PACKETS_CI)
 		return -1;
 
@@ -66,6 +66,19 @@ run_packet_gen()
 	odp_packet_gen${EXEEXT} -i $IF0,$IF1 -b 1 -g 10000000 -q 500 -L 60,1514,10 -w 10
 	ret=$?
 
+	if [ $ret -eq 2 ]; then
+		echo "FAIL: too few packets received"
+	fi
+	if [ $ret -ne 0 ]; then
+		echo "FAIL: test failed: $ret"
+		cleanup_pktio_env
+		exit $ret
+	fi
+
+	# Latency measurement
+	odp_packet_gen${EXEEXT} -i $IF0,$IF1 -b 1 -g 10000000 -q 500 -T -w 10
+	ret=$?
+
 	if [ $ret -eq 2 ]; then
 		echo "FAIL: too few packets received"
 	fi
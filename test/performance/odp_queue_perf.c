@@ -23,6 +23,8 @@ typedef struct test_options_t {
 	uint32_t max_burst;
 	odp_nonblocking_t nonblock;
 	int single;
+	int fan_in;
+	int sched;
 	int num_cpu;
 
 } test_options_t;
@@ -43,6 +45,9 @@ typedef struct test_global_t {
 	odp_shm_t        shm;
 	odp_pool_t       pool;
 	odp_queue_t      queue[MAX_QUEUES];
+	odp_atomic_u32_t worker_idx;
+	odp_atomic_u32_t producers_done;
+	int              consumer_thr;
 	odph_odpthread_t thread_tbl[ODP_THREAD_COUNT_MAX];
 	test_stat_t      stat[ODP_THREAD_COUNT_MAX];
 
@@ -53,7 +58,7 @@ static test_global_t test_global;
 static void print_usage(void)
 {
 	printf("\n"
-	       "Plain queue performance test\n"
+	       "Plain and scheduled queue performance test\n"
 	       "\n"
 	       "Usage: odp_queue_perf [options]\n"
 	       "\n"
@@ -65,6 +70,12 @@ static void print_usage(void)
 	       "  -l, --lockfree         Lockfree queues\n"
 	       "  -w, --waitfree         Waitfree queues\n"
 	       "  -s, --single           Single producer, single consumer\n"
+	       "  -f, --fan_in           Many producers, single queue. One worker dequeues\n"
+	       "                         from the shared queue and returns events to\n"
+	       "                         the other workers, which enqueue those back into\n"
+	       "                         the shared queue. Number of queues is set to\n"
+	       "                         the number of workers.\n"
+	       "  -S, --sched            Shared queue of fan-in test is a scheduled queue\n"
 	       "  -h, --help             This help\n"
 	       "\n");
 }
@@ -84,11 +95,13 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		{"lockfree",   no_argument,       NULL, 'l'},
 		{"waitfree",   no_argument,       NULL, 'w'},
 		{"single",     no_argument,       NULL, 's'},
+		{"fan_in",     no_argument,       NULL, 'f'},
+		{"sched",      no_argument,       NULL, 'S'},
 		{"help",       no_argument,       NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts = "+c:q:e:b:r:lwsh";
+	static const char *shortopts = "+c:q:e:b:r:lwsfSh";
 
 	test_options->num_cpu   = 1;
 	test_options->num_queue = 1;
@@ -97,6 +110,8 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 	test_options->num_round = 1000;
 	test_options->nonblock  = ODP_BLOCKING;
 	test_options->single    = 0;
+	test_options->fan_in    = 0;
+	test_options->sched     = 0;
 
 	while (1) {
 		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
@@ -129,6 +144,12 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		case 's':
 			test_options->single = 1;
 			break;
+		case 'f':
+			test_options->fan_in = 1;
+			break;
+		case 'S':
+			test_options->sched = 1;
+			break;
 		case 'h':
 			/* fall through */
 		default:
@@ -138,6 +159,23 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		}
 	}
 
+	if (test_options->fan_in) {
+		if (test_options->num_cpu < 2 || test_options->single) {
+			printf("Fan-in test needs at least two workers and "
+			       "multi-producer queues\n");
+			return -1;
+		}
+
+		/* Shared queue and one queue per producer */
+		test_options->num_queue = test_options->num_cpu;
+	}
+
+	if (test_options->sched &&
+	    (!test_options->fan_in || test_options->nonblock != ODP_BLOCKING)) {
+		printf("Scheduled queue is supported only in normal fan-in test\n");
+		return -1;
+	}
+
 	if (test_options->num_queue > MAX_QUEUES) {
 		printf("Too many queues %u. Test maximum %u.\n",
 		       test_options->num_queue, MAX_QUEUES);
@@ -161,14 +199,21 @@ static int create_queues(test_global_t *global)
 	uint32_t num_event = test_options->num_event;
 	uint32_t num_round = test_options->num_round;
 	uint32_t tot_event = num_queue * num_event;
+	uint32_t queue_size = num_event;
 	int ret = 0;
 	odp_queue_t *queue = global->queue;
 	odp_event_t event[tot_event];
 
-	printf("\nTesting %s queues\n",
+	/* Any queue may hold all events in fan-in test */
+	if (test_options->fan_in)
+		queue_size = tot_event;
+
+	printf("\nTesting %s queues%s\n",
 	       nonblock == ODP_BLOCKING ? "NORMAL" :
 	       (nonblock == ODP_NONBLOCKING_LF ? "LOCKFREE" :
-	       (nonblock == ODP_NONBLOCKING_WF ? "WAITFREE" : "???")));
+	       (nonblock == ODP_NONBLOCKING_WF ? "WAITFREE" : "???")),
+	       test_options->fan_in ? (test_options->sched ?
+	       ", FAN-IN into a SCHEDULED queue" : ", FAN-IN") : "");
 	printf("  num rounds           %u\n", num_round);
 	printf("  num queues           %u\n", num_queue);
 	printf("  num events per queue %u\n", num_event);
@@ -198,7 +243,7 @@ static int create_queues(test_global_t *global)
 		}
 
 		max_size = queue_capa.plain.max_size;
-		if (max_size && num_event > max_size) {
+		if (max_size && queue_size > max_size) {
 			printf("Max queue size supported %u\n", max_size);
 			return -1;
 		}
@@ -215,7 +260,7 @@ static int create_queues(test_global_t *global)
 		}
 
 		max_size = queue_capa.plain.lockfree.max_size;
-		if (max_size && num_event > max_size) {
+		if (max_size && queue_size > max_size) {
 			printf("Max lockfree queue size supported %u\n",
 			       max_size);
 			return -1;
@@ -233,7 +278,7 @@ static int create_queues(test_global_t *global)
 		}
 
 		max_size = queue_capa.plain.waitfree.max_size;
-		if (max_size && num_event > max_size) {
+		if (max_size && queue_size > max_size) {
 			printf("Max waitfree queue size supported %u\n",
 			       max_size);
 			return -1;
@@ -266,7 +311,7 @@ static int create_queues(test_global_t *global)
 	odp_queue_param_init(&queue_param);
 	queue_param.type        = ODP_QUEUE_TYPE_PLAIN;
 	queue_param.nonblocking = nonblock;
-	queue_param.size        = num_event;
+	queue_param.size        = queue_size;
 
 	if (test_options->single) {
 		queue_param.enq_mode = ODP_QUEUE_OP_MT_UNSAFE;
@@ -274,7 +319,16 @@ static int create_queues(test_global_t *global)
 	}
 
 	for (i = 0; i < num_queue; i++) {
-		queue[i] = odp_queue_create(NULL, &queue_param);
+		odp_queue_param_t sched_param = queue_param;
+
+		/* Shared queue is the first one */
+		if (i == 0 && test_options->sched) {
+			sched_param.type       = ODP_QUEUE_TYPE_SCHED;
+			sched_param.sched.sync = ODP_SCHED_SYNC_PARALLEL;
+			queue[i] = odp_queue_create(NULL, &sched_param);
+		} else {
+			queue[i] = odp_queue_create(NULL, &queue_param);
+		}
 
 		if (queue[i] == ODP_QUEUE_INVALID) {
 			printf("Error: Queue create failed %u.\n", i);
@@ -319,13 +373,13 @@ free_events:
 static int destroy_queues(test_global_t *global)
 {
 	odp_event_t ev;
-	uint32_t i, j;
+	uint32_t i;
 	int ret = 0;
 	test_options_t *test_options = &global->options;
 	uint32_t num_queue = test_options->num_queue;
-	uint32_t num_event = test_options->num_event;
 	odp_queue_t *queue = global->queue;
 	odp_pool_t pool    = global->pool;
+	uint64_t wait = odp_schedule_wait_time(100 * ODP_TIME_MSEC_IN_NS);
 
 	for (i = 0; i < num_queue; i++) {
 		if (queue[i] == ODP_QUEUE_INVALID) {
@@ -333,10 +387,13 @@ static int destroy_queues(test_global_t *global)
 			break;
 		}
 
-		for (j = 0; j < num_event; j++) {
-			ev = odp_queue_deq(queue[i]);
-
-			if (ev != ODP_EVENT_INVALID)
+		if (odp_queue_type(queue[i]) == ODP_QUEUE_TYPE_SCHED) {
+			while ((ev = odp_schedule(NULL, wait)) !=
+			       ODP_EVENT_INVALID)
+				odp_event_free(ev);
+		} else {
+			while ((ev = odp_queue_deq(queue[i])) !=
+			       ODP_EVENT_INVALID)
 				odp_event_free(ev);
 		}
 
@@ -422,6 +479,114 @@ error:
 	return ret;
 }
 
+/* Many-to-one test. Producers move events from their own queue into the
+ * shared queue. Consumer moves events from the shared queue back to
+ * producer queues, until all producers have run their rounds. */
+static int run_test_fan_in(void *arg)
+{
+	uint64_t c1, c2, cycles, nsec;
+	odp_time_t t1, t2;
+	uint32_t rounds = 0;
+	int num_ev;
+	test_stat_t *stat;
+	test_global_t *global = arg;
+	test_options_t *test_options = &global->options;
+	odp_queue_t queue;
+	uint64_t num_retry = 0;
+	uint64_t events = 0;
+	uint32_t num_queue = test_options->num_queue;
+	uint32_t num_round = test_options->num_round;
+	uint32_t num_prod = num_queue - 1;
+	odp_queue_t shared = global->queue[0];
+	int sched = test_options->sched;
+	int thr = odp_thread_id();
+	int ret = 0;
+	uint32_t idx = odp_atomic_fetch_inc_u32(&global->worker_idx);
+	uint32_t next = 1;
+	uint32_t max_burst = test_options->max_burst;
+	odp_event_t ev[max_burst];
+
+	stat = &global->stat[thr];
+
+	if (idx == 0)
+		global->consumer_thr = thr;
+
+	/* Start all workers at the same time */
+	odp_barrier_wait(&global->barrier);
+
+	t1 = odp_time_local();
+	c1 = odp_cpu_cycles();
+
+	if (idx == 0) {
+		while (odp_atomic_load_u32(&global->producers_done) < num_prod) {
+			if (sched)
+				num_ev = odp_schedule_multi_no_wait(NULL, ev,
+								    max_burst);
+			else
+				num_ev = odp_queue_deq_multi(shared, ev,
+							     max_burst);
+
+			if (odp_unlikely(num_ev <= 0)) {
+				num_retry++;
+				continue;
+			}
+
+			queue = global->queue[next++];
+
+			if (next == num_queue)
+				next = 1;
+
+			if (odp_queue_enq_multi(queue, ev, num_ev) != num_ev) {
+				printf("Error: Queue enq failed %u\n", next);
+				ret = -1;
+				goto error;
+			}
+
+			events += num_ev;
+			rounds++;
+		}
+	} else {
+		queue = global->queue[idx];
+
+		for (rounds = 0; rounds < num_round; rounds++) {
+			do {
+				num_ev = odp_queue_deq_multi(queue, ev,
+							     max_burst);
+
+				if (odp_unlikely(num_ev <= 0))
+					num_retry++;
+
+			} while (num_ev <= 0);
+
+			if (odp_queue_enq_multi(shared, ev, num_ev) != num_ev) {
+				printf("Error: Shared queue enq failed\n");
+				ret = -1;
+				goto error;
+			}
+
+			events += num_ev;
+		}
+	}
+
+	c2 = odp_cpu_cycles();
+	t2 = odp_time_local();
+
+	nsec   = odp_time_diff_ns(t2, t1);
+	cycles = odp_cpu_cycles_diff(c2, c1);
+
+	stat->rounds = rounds;
+	stat->events = events;
+	stat->nsec   = nsec;
+	stat->cycles = cycles;
+	stat->deq_retry = num_retry;
+
+error:
+	if (idx)
+		odp_atomic_inc_u32(&global->producers_done);
+
+	return ret;
+}
+
 static int start_workers(test_global_t *global)
 {
 	odph_odpthread_params_t thr_params;
@@ -433,7 +598,7 @@ static int start_workers(test_global_t *global)
 	memset(&thr_params, 0, sizeof(thr_params));
 	thr_params.thr_type = ODP_THREAD_WORKER;
 	thr_params.instance = global->instance;
-	thr_params.start    = run_test;
+	thr_params.start    = test_options->fan_in ? run_test_fan_in : run_test;
 	thr_params.arg      = global;
 
 	ret = odp_cpumask_default_worker(&cpumask, num_cpu);
@@ -524,6 +689,14 @@ static void print_stat(test_global_t *global)
 
 	printf("TOTAL events per sec:       %.3f M\n\n",
 	       (1000.0 * events_sum) / nsec_ave);
+
+	if (test_options->fan_in) {
+		test_stat_t *stat = &global->stat[global->consumer_thr];
+
+		if (stat->nsec)
+			printf("CONSUMER events per sec:    %.3f M\n\n",
+			       (1000.0 * stat->events) / stat->nsec);
+	}
 }
 
 int main(int argc, char **argv)
@@ -532,13 +705,19 @@ int main(int argc, char **argv)
 	odp_init_t init;
 	test_global_t *global;
 
+	global = &test_global;
+	memset(global, 0, sizeof(test_global_t));
+
+	if (parse_options(argc, argv, &global->options))
+		return -1;
+
 	/* List features not to be used */
 	odp_init_param_init(&init);
 	init.not_used.feat.cls      = 1;
 	init.not_used.feat.compress = 1;
 	init.not_used.feat.crypto   = 1;
 	init.not_used.feat.ipsec    = 1;
-	init.not_used.feat.schedule = 1;
+	init.not_used.feat.schedule = !global->options.sched;
 	init.not_used.feat.timer    = 1;
 	init.not_used.feat.tm       = 1;
 
@@ -554,15 +733,16 @@ int main(int argc, char **argv)
 		return -1;
 	}
 
-	global = &test_global;
-	memset(global, 0, sizeof(test_global_t));
-
-	if (parse_options(argc, argv, &global->options))
-		return -1;
-
 	odp_sys_info_print();
 
 	global->instance = instance;
+	odp_atomic_init_u32(&global->worker_idx, 0);
+	odp_atomic_init_u32(&global->producers_done, 0);
+
+	if (global->options.sched && odp_schedule_config(NULL)) {
+		printf("Error: Schedule config failed.\n");
+		return -1;
+	}
 
 	if (create_queues(global)) {
 		printf("Error: Create queues failed.\n");
@@ -17,6 +17,7 @@
 
 #define MAX_QUEUES  (256 * 1024)
 #define MAX_GROUPS  256
+#define MAX_PRIOS   32
 
 /* Max time to wait for new events in nanoseconds */
 #define MAX_SCHED_WAIT_NS (10 * ODP_TIME_SEC_IN_NS)
@@ -35,6 +36,7 @@ typedef struct test_options_t {
 	uint32_t num_sched;
 	uint32_t num_group;
 	uint32_t num_join;
+	uint32_t num_prio;
 	uint32_t max_burst;
 	int      queue_type;
 	int      forward;
@@ -45,12 +47,21 @@ typedef struct test_options_t {
 	uint32_t rd_words;
 	uint32_t rw_words;
 	uint32_t ctx_size;
+	uint32_t prio_offset;
 	uint32_t ctx_rd_words;
 	uint32_t ctx_rw_words;
 	uint64_t wait_ns;
 
 } test_options_t;
 
+typedef struct prio_stat_t {
+	uint64_t events;
+	uint64_t lat_num;
+	uint64_t lat_sum;
+	uint64_t lat_max;
+
+} prio_stat_t;
+
 typedef struct test_stat_t {
 	uint64_t rounds;
 	uint64_t enqueues;
@@ -61,6 +72,9 @@ typedef struct test_stat_t {
 	uint64_t dummy_sum;
 	uint8_t  failed;
 
+	/* Per priority statistics */
+	prio_stat_t prio[MAX_PRIOS];
+
 } test_stat_t;
 
 typedef struct thread_arg_t {
@@ -103,6 +117,9 @@ static void print_usage(void)
 	       "  -j, --num_join         Number of groups a thread joins. Threads are divide evenly into groups,\n"
 	       "                         if num_cpu is multiple of num_group and num_group is multiple of num_join.\n"
 	       "                         0: join all groups (default)\n"
+	       "  -p, --num_prio         Number of priority levels. Queues are divided round robin into priorities,\n"
+	       "                         starting from the highest priority. When > 1, per priority fairness and\n"
+	       "                         latency statistics are printed. Default: 1 (default priority).\n"
 	       "  -b, --burst            Maximum number of events per operation. Default: 100.\n"
 	       "  -t, --type             Queue type. 0: parallel, 1: atomic, 2: ordered. Default: 0.\n"
 	       "  -f, --forward          0: Keep event in the original queue, 1: Forward event to the next queue. Default: 0.\n"
@@ -131,6 +148,7 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		{"num_sched",    required_argument, NULL, 's'},
 		{"num_group",    required_argument, NULL, 'g'},
 		{"num_join",     required_argument, NULL, 'j'},
+		{"num_prio",     required_argument, NULL, 'p'},
 		{"burst",        required_argument, NULL, 'b'},
 		{"type",         required_argument, NULL, 't'},
 		{"forward",      required_argument, NULL, 'f'},
@@ -143,7 +161,7 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts = "+c:q:d:e:s:g:j:b:t:f:w:k:l:n:m:h";
+	static const char *shortopts = "+c:q:d:e:s:g:j:p:b:t:f:w:k:l:n:m:h";
 
 	test_options->num_cpu    = 1;
 	test_options->num_queue  = 1;
@@ -152,6 +170,7 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 	test_options->num_sched  = 100000;
 	test_options->num_group  = 0;
 	test_options->num_join   = 0;
+	test_options->num_prio   = 1;
 	test_options->max_burst  = 100;
 	test_options->queue_type = 0;
 	test_options->forward    = 0;
@@ -189,6 +208,9 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		case 'j':
 			test_options->num_join = atoi(optarg);
 			break;
+		case 'p':
+			test_options->num_prio = atoi(optarg);
+			break;
 		case 'b':
 			test_options->max_burst = atoi(optarg);
 			break;
@@ -231,6 +253,13 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		ret = -1;
 	}
 
+	if (test_options->num_prio == 0 ||
+	    test_options->num_prio > MAX_PRIOS) {
+		printf("Error: Bad number of priorities. Max supported %i.\n",
+		       MAX_PRIOS);
+		ret = -1;
+	}
+
 	num_group = test_options->num_group;
 	num_join  = test_options->num_join;
 	if (num_group > MAX_GROUPS) {
@@ -270,6 +299,13 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		ctx_size = sizeof(odp_queue_t);
 	}
 
+	/* Queue priority index is stored into queue context after the next
+	 * queue handle */
+	test_options->prio_offset = ROUNDUP(ctx_size, 8);
+
+	if (test_options->num_prio > 1)
+		ctx_size = test_options->prio_offset + 8;
+
 	if (test_options->ctx_rd_words || test_options->ctx_rw_words) {
 		/* Round up queue handle size to a multiple of 8 for correct
 		 * context data alignment */
@@ -337,6 +373,7 @@ static int create_pool(test_global_t *global)
 	uint32_t queue_size = test_options->queue_size;
 	uint32_t num_group = test_options->num_group;
 	uint32_t num_join = test_options->num_join;
+	uint32_t num_prio = test_options->num_prio;
 	int      forward   = test_options->forward;
 	uint64_t wait_ns = test_options->wait_ns;
 	uint32_t event_size = 16;
@@ -346,6 +383,10 @@ static int create_pool(test_global_t *global)
 	if (touch_data) {
 		event_size = test_options->rd_words + test_options->rw_words;
 		event_size = 8 * event_size;
+
+		/* Enqueue time stamp is stored in front of event data */
+		if (num_prio > 1)
+			event_size += 8;
 	}
 
 	printf("\nScheduler performance test\n");
@@ -356,6 +397,7 @@ static int create_pool(test_global_t *global)
 	printf("  total queues     %u\n", tot_queue);
 	printf("  num groups       %u\n", num_group);
 	printf("  num join         %u\n", num_join);
+	printf("  num priorities   %u\n", num_prio);
 	printf("  forward events   %i\n", forward ? 1 : 0);
 	printf("  wait nsec        %" PRIu64 "\n", wait_ns);
 	printf("  events per queue %u\n", num_event);
@@ -469,6 +511,7 @@ static int create_queues(test_global_t *global)
 	uint32_t queue_size = test_options->queue_size;
 	uint32_t tot_queue = test_options->tot_queue;
 	uint32_t num_group = test_options->num_group;
+	uint32_t num_prio = test_options->num_prio;
 	int type = test_options->queue_type;
 	odp_pool_t pool = global->pool;
 	uint8_t *ctx = NULL;
@@ -500,6 +543,12 @@ static int create_queues(test_global_t *global)
 		return -1;
 	}
 
+	if (num_prio > (uint32_t)odp_schedule_num_prio()) {
+		printf("Max priorities supported %i\n",
+		       odp_schedule_num_prio());
+		return -1;
+	}
+
 	if (ctx_size) {
 		ctx = odp_shm_addr(global->ctx_shm);
 		if (ctx == NULL) {
@@ -515,6 +564,8 @@ static int create_queues(test_global_t *global)
 	queue_param.sched.group = ODP_SCHED_GROUP_ALL;
 	queue_param.size = queue_size;
 
+	first = test_options->num_dummy;
+
 	for (i = 0; i < tot_queue; i++) {
 		if (num_group) {
 			odp_schedule_group_t group;
@@ -524,6 +575,13 @@ static int create_queues(test_global_t *global)
 			queue_param.sched.group = group;
 		}
 
+		if (num_prio > 1 && i >= first) {
+			/* Divide active queues evenly into priorities, starting
+			 * from the highest priority */
+			queue_param.sched.prio = odp_schedule_max_prio() -
+						 ((i - first) % num_prio);
+		}
+
 		queue = odp_queue_create(NULL, &queue_param);
 
 		global->queue[i] = queue;
@@ -534,8 +592,6 @@ static int create_queues(test_global_t *global)
 		}
 	}
 
-	first = test_options->num_dummy;
-
 	/* Store events into queues. Dummy queues are allocated from
 	 * the beginning of the array, so that usage of those affect allocation
 	 * of active queues. Dummy queues are left empty. */
@@ -554,6 +610,14 @@ static int create_queues(test_global_t *global)
 				*next_queue = global->queue[next];
 			}
 
+			if (num_prio > 1) {
+				uint32_t *prio;
+
+				prio  = (uint32_t *)(uintptr_t)
+					(ctx + test_options->prio_offset);
+				*prio = (i - first) % num_prio;
+			}
+
 			if (odp_queue_context_set(queue, ctx, ctx_size)) {
 				printf("Error: Context set failed %u\n", i);
 				return -1;
@@ -570,6 +634,10 @@ static int create_queues(test_global_t *global)
 				return -1;
 			}
 
+			/* Latency is not measured for initial events */
+			if (num_prio > 1)
+				*(uint64_t *)odp_buffer_addr(buf) = 0;
+
 			if (odp_queue_enq(queue, odp_buffer_to_event(buf))) {
 				printf("Error: Enqueue failed %u/%u\n", i, j);
 				return -1;
@@ -688,7 +756,7 @@ static inline uint64_t rw_ctx_data(void *ctx, uint32_t offset,
 	return sum;
 }
 
-static uint64_t rw_data(odp_event_t ev[], int num,
+static uint64_t rw_data(odp_event_t ev[], int num, uint32_t offset,
 			uint32_t rd_words, uint32_t rw_words)
 {
 	odp_buffer_t buf;
@@ -700,6 +768,7 @@ static uint64_t rw_data(odp_event_t ev[], int num,
 	for (i = 0; i < num; i++) {
 		buf  = odp_buffer_from_event(ev[i]);
 		data = odp_buffer_addr(buf);
+		data += offset;
 
 		for (j = 0; j < rd_words; j++)
 			sum += data[j];
@@ -713,6 +782,37 @@ static uint64_t rw_data(odp_event_t ev[], int num,
 	return sum;
 }
 
+/* Update priority statistics with latency from enqueue to schedule */
+static inline void prio_stat_update(prio_stat_t *stat, odp_event_t ev[],
+				    int num, uint64_t now)
+{
+	uint64_t ts, lat;
+	int i;
+
+	stat->events += num;
+
+	for (i = 0; i < num; i++) {
+		ts = *(uint64_t *)odp_buffer_addr(odp_buffer_from_event(ev[i]));
+
+		if (ts == 0 || ts > now)
+			continue;
+
+		lat = now - ts;
+		stat->lat_num++;
+		stat->lat_sum += lat;
+		if (lat > stat->lat_max)
+			stat->lat_max = lat;
+	}
+}
+
+static inline void stamp_events(odp_event_t ev[], int num, uint64_t now)
+{
+	int i;
+
+	for (i = 0; i < num; i++)
+		*(uint64_t *)odp_buffer_addr(odp_buffer_from_event(ev[i])) = now;
+}
+
 static int test_sched(void *arg)
 {
 	int num, num_enq, ret, thr;
@@ -728,6 +828,9 @@ static int test_sched(void *arg)
 	uint32_t num_sched = test_options->num_sched;
 	uint32_t max_burst = test_options->max_burst;
 	uint32_t num_group = test_options->num_group;
+	uint32_t num_prio = test_options->num_prio;
+	uint32_t prio_offset = test_options->prio_offset;
+	uint32_t data_offset = (num_prio > 1) ? 1 : 0;
 	int forward = test_options->forward;
 	int touch_data = test_options->touch_data;
 	uint32_t rd_words = test_options->rd_words;
@@ -741,13 +844,20 @@ static int test_sched(void *arg)
 	uint64_t data_sum = 0;
 	uint64_t ctx_sum = 0;
 	uint64_t wait_ns = test_options->wait_ns;
+	uint64_t now = 0;
 	odp_event_t ev[max_burst];
+	prio_stat_t prio_stat[MAX_PRIOS];
 
 	thr = odp_thread_id();
 
 	if (forward)
 		ctx_offset = ROUNDUP(sizeof(odp_queue_t), 8);
 
+	if (num_prio > 1)
+		ctx_offset = prio_offset + 8;
+
+	memset(prio_stat, 0, sizeof(prio_stat));
+
 	if (num_group) {
 		uint32_t num_join = test_options->num_join;
 
@@ -806,6 +916,16 @@ static int test_sched(void *arg)
 			if (odp_unlikely(ctx_size)) {
 				void *ctx = odp_queue_context(queue);
 
+				if (num_prio > 1) {
+					uint32_t prio;
+
+					prio = *(uint32_t *)(uintptr_t)
+					       ((uint8_t *)ctx + prio_offset);
+					now  = odp_time_global_ns();
+					prio_stat_update(&prio_stat[prio], ev,
+							 num, now);
+				}
+
 				if (forward) {
 					next  = ctx;
 					queue = *next;
@@ -818,14 +938,20 @@ static int test_sched(void *arg)
 			}
 
 			if (odp_unlikely(touch_data))
-				data_sum += rw_data(ev, num, rd_words,
-						    rw_words);
+				data_sum += rw_data(ev, num, data_offset,
+						    rd_words, rw_words);
 
 			if (odp_unlikely(wait_ns)) {
 				waits++;
 				odp_time_wait_ns(wait_ns);
+
+				if (num_prio > 1)
+					now = odp_time_global_ns();
 			}
 
+			if (odp_unlikely(num_prio > 1))
+				stamp_events(ev, num, now);
+
 			while (num) {
 				num_enq = odp_queue_enq_multi(queue, &ev[i],
 							      num);
@@ -891,6 +1017,7 @@ static int test_sched(void *arg)
 	global->stat[thr].waits    = waits;
 	global->stat[thr].dummy_sum = data_sum + ctx_sum;
 	global->stat[thr].failed = ret;
+	memcpy(global->stat[thr].prio, prio_stat, sizeof(prio_stat));
 
 	/* Pause scheduling before thread exit */
 	odp_schedule_pause();
@@ -987,6 +1114,63 @@ static double measure_wait_time_cycles(uint64_t wait_ns)
 	return wait_cycles;
 }
 
+static void print_prio_stat(test_global_t *global)
+{
+	int i;
+	uint32_t prio, num_queue;
+	test_options_t *test_options = &global->test_options;
+	uint32_t num_prio = test_options->num_prio;
+	uint64_t events_sum = 0;
+	prio_stat_t tot[MAX_PRIOS];
+
+	memset(tot, 0, sizeof(tot));
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		if (global->stat[i].failed)
+			continue;
+
+		for (prio = 0; prio < num_prio; prio++) {
+			prio_stat_t *stat = &global->stat[i].prio[prio];
+
+			tot[prio].events  += stat->events;
+			tot[prio].lat_num += stat->lat_num;
+			tot[prio].lat_sum += stat->lat_sum;
+			if (stat->lat_max > tot[prio].lat_max)
+				tot[prio].lat_max = stat->lat_max;
+		}
+	}
+
+	for (prio = 0; prio < num_prio; prio++)
+		events_sum += tot[prio].events;
+
+	if (events_sum == 0)
+		return;
+
+	printf("RESULTS - per priority (enqueue to schedule latency):\n");
+	printf("-----------------------------------------------------\n");
+	printf("  prio  api prio  queues        events  share %%  ave lat nsec  max lat nsec\n");
+
+	for (prio = 0; prio < num_prio; prio++) {
+		uint64_t lat_ave = 0;
+
+		num_queue = test_options->num_queue / num_prio;
+		if (prio < test_options->num_queue % num_prio)
+			num_queue++;
+
+		if (tot[prio].lat_num)
+			lat_ave = tot[prio].lat_sum / tot[prio].lat_num;
+
+		printf("  %4u  %8i  %6u  %12" PRIu64 "  %7.2f  %12" PRIu64
+		       "  %12" PRIu64 "\n", prio,
+		       odp_schedule_max_prio() - (int)prio, num_queue,
+		       tot[prio].events,
+		       (100.0 * tot[prio].events) / events_sum, lat_ave,
+		       tot[prio].lat_max);
+	}
+
+	printf("\n");
+}
+
 static void print_stat(test_global_t *global)
 {
 	int i, num;
@@ -1077,6 +1261,9 @@ static void print_stat(test_global_t *global)
 
 	printf("TOTAL events per sec:       %.3f M\n\n",
 	       (1000.0 * events_sum) / nsec_ave);
+
+	if (test_options->num_prio > 1)
+		print_prio_stat(global);
 }
 
 int main(int argc, char **argv)
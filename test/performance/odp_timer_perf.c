@@ -19,6 +19,7 @@
 #define MODE_SET_CANCEL   1
 #define MAX_TIMER_POOLS   32
 #define MAX_TIMERS        10000
+#define MAX_BURST         64
 #define START_NS          (100 * ODP_TIME_MSEC_IN_NS)
 
 typedef struct test_options_t {
@@ -29,6 +30,7 @@ typedef struct test_options_t {
 	uint64_t period_ns;
 	int      shared;
 	int      mode;
+	uint32_t burst;
 	uint64_t test_rounds;
 
 } test_options_t;
@@ -133,8 +135,11 @@ static void print_usage(void)
 	       "                           1: Measure timer set + cancel performance\n"
 	       "  -R, --rounds           Number of test rounds in timer set + cancel test.\n"
 	       "                           Default: 100000\n"
+	       "  -b, --burst            Timer cancel + set burst size in timer set + cancel test.\n"
+	       "                         Values larger than 1 use odp_timer_cancel_multi() and\n"
+	       "                         odp_timer_set_abs_multi() calls. Max %i. Default: 1\n"
 	       "  -h, --help             This help\n"
-	       "\n");
+	       "\n", MAX_BURST);
 }
 
 static int parse_options(int argc, char *argv[], test_options_t *test_options)
@@ -152,11 +157,12 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		{"shared",    required_argument, NULL, 's'},
 		{"mode",      required_argument, NULL, 'm'},
 		{"rounds",    required_argument, NULL, 'R'},
+		{"burst",     required_argument, NULL, 'b'},
 		{"help",      no_argument,       NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts = "+c:n:t:r:p:s:m:R:h";
+	static const char *shortopts = "+c:n:t:r:p:s:m:R:b:h";
 
 	test_options->num_cpu   = 1;
 	test_options->num_tp    = 1;
@@ -165,6 +171,7 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 	test_options->period_ns = 100 * ODP_TIME_MSEC_IN_NS;
 	test_options->shared    = 1;
 	test_options->mode      = 0;
+	test_options->burst     = 1;
 	test_options->test_rounds = 100000;
 
 	while (1) {
@@ -198,6 +205,9 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		case 'R':
 			test_options->test_rounds = atoll(optarg);
 			break;
+		case 'b':
+			test_options->burst = atoi(optarg);
+			break;
 		case 'h':
 			/* fall through */
 		default:
@@ -212,6 +222,11 @@ static int parse_options(int argc, char *argv[], test_options_t *test_options)
 		ret = -1;
 	}
 
+	if (test_options->burst == 0 || test_options->burst > MAX_BURST) {
+		ODPH_ERR("Bad burst size %u. Max %i\n", test_options->burst, MAX_BURST);
+		ret = -1;
+	}
+
 	return ret;
 }
 
@@ -297,6 +312,8 @@ static int create_timer_pools(test_global_t *global)
 		printf("  test duration    %.2f sec\n", (double)max_tmo_ns / ODP_TIME_SEC_IN_NS);
 	else
 		printf("  test rounds      %" PRIu64 "\n", test_options->test_rounds);
+	if (mode == MODE_SET_CANCEL)
+		printf("  burst size       %u\n", test_options->burst);
 
 	for (i = 0; i < MAX_TIMER_POOLS; i++) {
 		global->timer_pool[i].tp = ODP_TIMER_POOL_INVALID;
@@ -646,6 +663,88 @@ static void cancel_timers(test_global_t *global, uint32_t worker_idx)
 	}
 }
 
+/* Cancel and set again all timers of this worker, in bursts of multi-timer calls */
+static int set_cancel_burst(test_global_t *global, uint32_t worker_idx, uint64_t *num_cancel,
+			    uint64_t *num_set)
+{
+	odp_timer_t timer[MAX_BURST];
+	odp_timer_t set_timer[MAX_BURST];
+	odp_event_t ev[MAX_BURST];
+	uint64_t tick[MAX_BURST];
+	int result[MAX_BURST];
+	uint64_t start_tick, period_tick, cur_tick;
+	uint32_t i, j, num, k, num_ev;
+	odp_timer_pool_t tp;
+	test_options_t *test_options = &global->test_options;
+	uint32_t num_tp = test_options->num_tp;
+	uint32_t num_timer = test_options->num_timer;
+	uint32_t num_worker = test_options->num_cpu;
+	uint32_t burst = test_options->burst;
+	uint32_t idx[MAX_BURST];
+	int ret;
+
+	for (i = 0; i < num_tp; i++) {
+		tp = global->timer_pool[i].tp;
+		if (tp == ODP_TIMER_POOL_INVALID)
+			continue;
+
+		start_tick  = global->timer_pool[i].start_tick;
+		period_tick = global->timer_pool[i].period_tick;
+
+		cur_tick = odp_timer_current_tick(tp) + start_tick;
+
+		j = worker_idx;
+		while (j < num_timer) {
+			num = 0;
+
+			for (; j < num_timer && num < burst; j += num_worker) {
+				if (global->timer[i][j] == ODP_TIMER_INVALID)
+					continue;
+
+				timer[num] = global->timer[i][j];
+				idx[num] = j;
+				num++;
+			}
+
+			if (num == 0)
+				break;
+
+			odp_timer_cancel_multi(timer, ev, num);
+			*num_cancel += num;
+
+			/* Set again the timers which were cancelled */
+			num_ev = 0;
+			for (k = 0; k < num; k++) {
+				if (ev[k] == ODP_EVENT_INVALID)
+					continue;
+
+				set_timer[num_ev] = timer[k];
+				tick[num_ev] = cur_tick + idx[k] * period_tick;
+				ev[num_ev] = ev[k];
+				num_ev++;
+			}
+
+			if (num_ev == 0)
+				continue;
+
+			ret = odp_timer_set_abs_multi(set_timer, tick, ev, result, num_ev);
+			*num_set += num_ev;
+
+			if (ret != (int)num_ev) {
+				for (k = 0; k < num_ev; k++) {
+					if (result[k] != ODP_TIMER_SUCCESS)
+						break;
+				}
+
+				ODPH_ERR("Timer (%u) set failed (ret %i)\n", i, result[k]);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
 static int set_cancel_mode_worker(void *arg)
 {
 	uint64_t tick, start_tick, period_tick, nsec;
@@ -663,6 +762,7 @@ static int set_cancel_mode_worker(void *arg)
 	uint32_t num_tp = test_options->num_tp;
 	uint32_t num_timer = test_options->num_timer;
 	uint32_t num_worker = test_options->num_cpu;
+	uint32_t burst = test_options->burst;
 	int ret = 0;
 	int started = 0;
 	uint64_t test_rounds = test_options->test_rounds;
@@ -723,6 +823,15 @@ static int set_cancel_mode_worker(void *arg)
 		}
 
 		/* Cancel and set timers again */
+		if (burst > 1) {
+			if (set_cancel_burst(global, worker_idx, &num_cancel, &num_set)) {
+				ret = -1;
+				break;
+			}
+
+			goto round_done;
+		}
+
 		for (i = 0; i < num_tp; i++) {
 			tp = global->timer_pool[i].tp;
 			if (tp == ODP_TIMER_POOL_INVALID)
@@ -759,6 +868,7 @@ static int set_cancel_mode_worker(void *arg)
 			}
 		}
 
+round_done:
 		if (test_rounds) {
 			test_rounds--;
 			if (test_rounds == 0)
@@ -30,4 +30,15 @@ if [ $RET_VAL -ne 0 ]; then
 	exit $RET_VAL
 fi
 
+echo odp_timer_perf: timer set + cancel mode, burst
+echo ===============================================
+
+$TEST_DIR/odp_timer_perf${EXEEXT} -m 1 -c 1 -t 100 -b 32 -R 50
+
+RET_VAL=$?
+if [ $RET_VAL -ne 0 ]; then
+	echo odp_timer_perf -m 1 -b 32: FAILED
+	exit $RET_VAL
+fi
+
 exit 0
@@ -1778,6 +1778,137 @@ static void classification_test_pmr_term_custom_l3(void)
 	test_pmr_term_custom(1);
 }
 
+static void test_cos_meter(odp_bool_t hierarchy)
+{
+	odp_packet_t pkt;
+	odp_pktio_t pktio;
+	odp_queue_t queue, retqueue;
+	odp_pool_t pool;
+	odp_cos_t cos, parent = ODP_COS_INVALID;
+	odp_cls_cos_param_t cls_param;
+	odph_ethhdr_t *eth;
+	uint64_t len;
+	uint32_t seqno[3];
+	int i, j;
+
+	/* All packets are sent before receiving any, so that the buckets do
+	 * not refill between them even when receive is slow */
+	const odp_packet_color_t expected[] = {ODP_PACKET_GREEN,
+					      ODP_PACKET_YELLOW};
+
+	pktio = create_pktio(ODP_QUEUE_TYPE_SCHED, pkt_pool, true);
+	CU_ASSERT_FATAL(pktio != ODP_PKTIO_INVALID);
+	CU_ASSERT(start_pktio(pktio) == 0);
+
+	queue = queue_create("meter_queue", true);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	pool = pool_create("meter_pool");
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	pkt = create_packet(default_pkt_info);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	len = odp_packet_len(pkt);
+	odp_packet_free(pkt);
+
+	/* Two packets fit into the peak bucket, one into the committed. With
+	 * a hierarchy, the same limits are set by srTCM meter of the parent. */
+	odp_cls_cos_param_init(&cls_param);
+	cls_param.pool = pool;
+	cls_param.queue = queue;
+	cls_param.meter.mode = ODP_CLS_METER_TRTCM;
+	cls_param.meter.cir = cls_capa.meter.min_rate;
+	cls_param.meter.pir = cls_capa.meter.min_rate;
+	cls_param.meter.cbs = len;
+	cls_param.meter.pbs = 2 * len;
+
+	if (hierarchy) {
+		odp_cls_cos_param_t parent_param;
+
+		odp_cls_cos_param_init(&parent_param);
+		parent_param.pool = pool;
+		parent_param.queue = queue;
+		parent_param.meter.mode = ODP_CLS_METER_SRTCM;
+		parent_param.meter.cir = cls_capa.meter.min_rate;
+		parent_param.meter.cbs = len;
+		parent_param.meter.ebs = len;
+
+		parent = odp_cls_cos_create("meter_parent", &parent_param);
+		CU_ASSERT_FATAL(parent != ODP_COS_INVALID);
+
+		cls_param.meter.cbs = 100 * len;
+		cls_param.meter.pbs = 100 * len;
+		cls_param.meter.parent = parent;
+	}
+
+	cos = odp_cls_cos_create("meter_cos", &cls_param);
+	CU_ASSERT_FATAL(cos != ODP_COS_INVALID);
+	CU_ASSERT(odp_pktio_default_cos_set(pktio, cos) == 0);
+
+	for (i = 0; i < 3; i++) {
+		pkt = create_packet(default_pkt_info);
+		CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+		seqno[i] = cls_pkt_get_seq(pkt);
+		CU_ASSERT(seqno[i] != TEST_SEQ_INVALID);
+		eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
+		odp_pktio_mac_addr(pktio, eth->src.addr, ODPH_ETHADDR_LEN);
+		odp_pktio_mac_addr(pktio, eth->dst.addr, ODPH_ETHADDR_LEN);
+
+		enqueue_pktio_interface(pkt, pktio);
+	}
+
+	for (i = 0; i < 2; i++) {
+		pkt = receive_packet(&retqueue, ODP_TIME_SEC_IN_NS, false);
+		CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+		CU_ASSERT(retqueue == queue);
+
+		for (j = 0; j < 2; j++)
+			if (seqno[j] == cls_pkt_get_seq(pkt))
+				break;
+
+		CU_ASSERT(j < 2);
+		if (j < 2)
+			CU_ASSERT(odp_packet_color(pkt) == expected[j]);
+		odp_packet_free(pkt);
+	}
+
+	/* Third packet is red and dropped */
+	pkt = receive_packet(&retqueue, ODP_TIME_SEC_IN_NS, false);
+	CU_ASSERT(pkt == ODP_PACKET_INVALID);
+	if (pkt != ODP_PACKET_INVALID)
+		odp_packet_free(pkt);
+
+	stop_pktio(pktio);
+	CU_ASSERT(odp_cos_destroy(cos) == 0);
+	if (hierarchy)
+		CU_ASSERT(odp_cos_destroy(parent) == 0);
+	CU_ASSERT(odp_pktio_close(pktio) == 0);
+	CU_ASSERT(odp_queue_destroy(queue) == 0);
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
+static void classification_test_cos_meter(void)
+{
+	test_cos_meter(false);
+}
+
+static void classification_test_cos_meter_hierarchy(void)
+{
+	test_cos_meter(true);
+}
+
+static int check_capa_meter(void)
+{
+	return cls_capa.meter.trtcm == ODP_SUPPORT_YES;
+}
+
+static int check_capa_meter_hierarchy(void)
+{
+	return cls_capa.meter.trtcm == ODP_SUPPORT_YES &&
+	       cls_capa.meter.srtcm == ODP_SUPPORT_YES &&
+	       cls_capa.meter.max_levels >= 2;
+}
+
 static int check_capa_tcp_dport(void)
 {
 	return cls_capa.supported_terms.bit.tcp_dport;
@@ -1983,5 +2114,9 @@ odp_testinfo_t classification_suite_pmr[] = {
 	ODP_TEST_INFO(classification_test_pmr_term_tcp_dport_multi),
 	ODP_TEST_INFO_CONDITIONAL(classification_test_pmr_marking,
 				  check_capa_pmr_marking),
+	ODP_TEST_INFO_CONDITIONAL(classification_test_cos_meter,
+				  check_capa_meter),
+	ODP_TEST_INFO_CONDITIONAL(classification_test_cos_meter_hierarchy,
+				  check_capa_meter_hierarchy),
 	ODP_TEST_INFO_NULL,
 };
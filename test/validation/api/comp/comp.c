@@ -415,6 +415,20 @@ static void comp_test_comp_decomp_alg_zlib_none(void)
 			     plaintext, PLAIN_TEXT_SIZE);
 }
 
+static int comp_check_lzs_none(void)
+{
+	return check_comp_alg_support(ODP_COMP_ALG_LZS,
+				      ODP_COMP_HASH_ALG_NONE);
+}
+
+/* Compress/Decompress content using LZS algorithm */
+static void comp_test_comp_decomp_alg_lzs_none(void)
+{
+	comp_decomp_alg_test(ODP_COMP_ALG_LZS,
+			     ODP_COMP_HASH_ALG_NONE,
+			     plaintext, PLAIN_TEXT_SIZE);
+}
+
 static int comp_suite_sync_init(void)
 {
 	suite_context.pool = odp_pool_lookup(COMP_PACKET_POOL);
@@ -452,6 +466,8 @@ static odp_testinfo_t comp_suite[] = {
 				  comp_check_deflate_none),
 	ODP_TEST_INFO_CONDITIONAL(comp_test_comp_decomp_alg_zlib_none,
 				  comp_check_zlib_none),
+	ODP_TEST_INFO_CONDITIONAL(comp_test_comp_decomp_alg_lzs_none,
+				  comp_check_lzs_none),
 	ODP_TEST_INFO_NULL,
 };
 
@@ -2503,6 +2503,100 @@ static void pktio_test_pktout_ts(void)
 	}
 }
 
+static int pktio_check_pktout_batch(void)
+{
+	odp_pktio_t pktio;
+	odp_pktio_capability_t capa;
+	odp_pktio_param_t pktio_param;
+	int ret;
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_DIRECT;
+
+	pktio = odp_pktio_open(iface_name[0], pool[0], &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID)
+		return ODP_TEST_INACTIVE;
+
+	ret = odp_pktio_capability(pktio, &capa);
+	(void)odp_pktio_close(pktio);
+
+	if (ret < 0 || capa.tx_batch.max_pkts < 2 * TX_BATCH_LEN)
+		return ODP_TEST_INACTIVE;
+
+	return ODP_TEST_ACTIVE;
+}
+
+static void pktio_test_pktout_batch(void)
+{
+	odp_packet_t pkt_tbl[TX_BATCH_LEN];
+	odp_pktio_t pktio[MAX_NUM_IFACES] = {0};
+	odp_pktout_queue_param_t queue_param;
+	odp_pktout_queue_t pktout_queue;
+	odp_pktio_t pktio_tx, pktio_rx;
+	uint32_t pkt_seq[TX_BATCH_LEN];
+	pktio_info_t pktio_rx_info;
+	int ret;
+	int i;
+
+	CU_ASSERT_FATAL(num_ifaces >= 1);
+
+	for (i = 0; i < num_ifaces; ++i) {
+		pktio[i] = create_pktio(i, ODP_PKTIN_MODE_DIRECT,
+					ODP_PKTOUT_MODE_DIRECT);
+		CU_ASSERT_FATAL(pktio[i] != ODP_PKTIO_INVALID);
+	}
+
+	pktio_tx = pktio[0];
+	pktio_rx = (num_ifaces > 1) ? pktio[1] : pktio_tx;
+
+	/* Batch is larger than the number of packets sent, and has no
+	 * timeout */
+	odp_pktout_queue_param_init(&queue_param);
+	queue_param.batch.max_pkts = 2 * TX_BATCH_LEN;
+	CU_ASSERT_FATAL(odp_pktout_queue_config(pktio_tx, &queue_param) == 0);
+
+	for (i = 0; i < num_ifaces; ++i)
+		CU_ASSERT_FATAL(odp_pktio_start(pktio[i]) == 0);
+
+	for (i = 0; i < num_ifaces; i++)
+		_pktio_wait_linkup(pktio[i]);
+
+	pktio_rx_info.id   = pktio_rx;
+	pktio_rx_info.inq  = ODP_QUEUE_INVALID;
+	pktio_rx_info.in_mode = ODP_PKTIN_MODE_DIRECT;
+
+	ret = create_packets(pkt_tbl, pkt_seq, TX_BATCH_LEN, pktio_tx,
+			     pktio_rx);
+	CU_ASSERT_FATAL(ret == TX_BATCH_LEN);
+
+	CU_ASSERT_FATAL(odp_pktout_queue(pktio_tx, &pktout_queue, 1) == 1);
+
+	CU_ASSERT(odp_pktout_free_slots(pktout_queue) >= TX_BATCH_LEN);
+
+	CU_ASSERT_FATAL(odp_pktout_send(pktout_queue, pkt_tbl,
+					TX_BATCH_LEN) == TX_BATCH_LEN);
+
+	/* Packets wait in the batch until flushed */
+	ret = wait_for_packets(&pktio_rx_info, pkt_tbl, pkt_seq, TX_BATCH_LEN,
+			       TXRX_MODE_MULTI, 100 * ODP_TIME_MSEC_IN_NS,
+			       false);
+	CU_ASSERT(ret == 0);
+
+	CU_ASSERT(odp_pktout_flush(pktout_queue) == 0);
+
+	ret = wait_for_packets(&pktio_rx_info, pkt_tbl, pkt_seq, TX_BATCH_LEN,
+			       TXRX_MODE_MULTI, ODP_TIME_SEC_IN_NS, false);
+	CU_ASSERT(ret == TX_BATCH_LEN);
+
+	for (i = 0; i < ret; i++)
+		odp_packet_free(pkt_tbl[i]);
+
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT_FATAL(odp_pktio_stop(pktio[i]) == 0);
+		CU_ASSERT_FATAL(odp_pktio_close(pktio[i]) == 0);
+	}
+}
+
 static void pktio_test_chksum(void (*config_fn)(odp_pktio_t, odp_pktio_t),
 			      void (*prep_fn)(odp_packet_t pkt),
 			      void (*test_fn)(odp_packet_t pkt))
@@ -3629,6 +3723,8 @@ odp_testinfo_t pktio_suite_unsegmented[] = {
 				  pktio_check_pktin_ts),
 	ODP_TEST_INFO_CONDITIONAL(pktio_test_pktout_ts,
 				  pktio_check_pktout_ts),
+	ODP_TEST_INFO_CONDITIONAL(pktio_test_pktout_batch,
+				  pktio_check_pktout_batch),
 	ODP_TEST_INFO_CONDITIONAL(pktio_test_chksum_in_ipv4,
 				  pktio_check_chksum_in_ipv4),
 	ODP_TEST_INFO_CONDITIONAL(pktio_test_chksum_in_udp,
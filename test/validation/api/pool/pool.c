@@ -346,6 +346,71 @@ static void pool_test_alloc_packet_subparam(void)
 	CU_ASSERT(odp_pool_destroy(pool) == 0);
 }
 
+static void pool_test_packet_subparam_info(void)
+{
+	odp_pool_t pool;
+	odp_pool_capability_t capa;
+	odp_pool_param_t param;
+	odp_pool_info_t info;
+	uint32_t i, j, num_sub, num_total, len;
+	odp_packet_t pkt;
+
+	CU_ASSERT_FATAL(odp_pool_capability(&capa) == 0);
+	num_sub = capa.pkt.max_num_subparam;
+
+	if (num_sub == 0)
+		return;
+
+	odp_pool_param_init(&param);
+
+	param.type             = ODP_POOL_PACKET;
+	param.pkt.num          = PKT_NUM;
+	param.pkt.len          = PKT_LEN;
+	param.pkt.num_subparam = num_sub;
+	num_total = PKT_NUM;
+
+	for (i = 0; i < num_sub; i++) {
+		len = PKT_LEN * (i + 2);
+
+		if (len > capa.pkt.max_len)
+			len = capa.pkt.max_len;
+
+		param.pkt.sub[i].num = PKT_NUM / 10;
+		param.pkt.sub[i].len = len;
+		num_total += PKT_NUM / 10;
+	}
+
+	pool = odp_pool_create("pool_subparam_info", &param);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	CU_ASSERT(odp_pool_lookup("pool_subparam_info") == pool);
+
+	memset(&info, 0, sizeof(info));
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	CU_ASSERT(info.params.pkt.num_subparam == num_sub);
+	CU_ASSERT(info.pkt.max_num >= num_total);
+
+	for (j = 0; j <= num_sub; j++) {
+		uintptr_t pkt_data;
+		uint32_t seg_len = 0;
+
+		len = j ? param.pkt.sub[j - 1].len : param.pkt.len;
+		pkt = odp_packet_alloc(pool, len);
+		CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+
+		CU_ASSERT(odp_packet_pool(pkt) == pool);
+		CU_ASSERT(odp_packet_len(pkt) == len);
+
+		pkt_data = (uintptr_t)odp_packet_offset(pkt, 0, &seg_len, NULL);
+		CU_ASSERT(pkt_data >= info.min_data_addr);
+		CU_ASSERT(pkt_data + seg_len - 1 <= info.max_data_addr);
+
+		odp_packet_free(pkt);
+	}
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
 static void alloc_timeout(uint32_t cache_size)
 {
 	odp_pool_t pool;
@@ -1151,6 +1216,7 @@ odp_testinfo_t pool_suite[] = {
 	ODP_TEST_INFO(pool_test_alloc_packet_min_cache),
 	ODP_TEST_INFO(pool_test_alloc_packet_max_cache),
 	ODP_TEST_INFO(pool_test_alloc_packet_subparam),
+	ODP_TEST_INFO(pool_test_packet_subparam_info),
 	ODP_TEST_INFO(pool_test_alloc_timeout),
 	ODP_TEST_INFO(pool_test_alloc_timeout_min_cache),
 	ODP_TEST_INFO(pool_test_alloc_timeout_max_cache),
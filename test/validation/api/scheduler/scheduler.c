@@ -2833,6 +2833,126 @@ static void scheduler_test_flow_aware(void)
 	CU_ASSERT(odp_pool_destroy(pool) == 0);
 }
 
+static int check_queue_vector_support(void)
+{
+	odp_schedule_capability_t sched_capa;
+	odp_pool_capability_t pool_capa;
+
+	if (odp_schedule_capability(&sched_capa) ||
+	    sched_capa.vector.supported == ODP_SUPPORT_NO)
+		return ODP_TEST_INACTIVE;
+
+	if (odp_pool_capability(&pool_capa) || pool_capa.vector.max_pools == 0)
+		return ODP_TEST_INACTIVE;
+
+	return ODP_TEST_ACTIVE;
+}
+
+static void scheduler_test_queue_vector(void)
+{
+	odp_schedule_capability_t sched_capa;
+	odp_pool_param_t pool_param;
+	odp_pool_t pool, vec_pool;
+	odp_queue_param_t queue_param;
+	odp_queue_t queue, from;
+	odp_packet_vector_t pktv;
+	odp_packet_t *pkt_tbl;
+	odp_packet_t pkt;
+	odp_event_t ev;
+	uint32_t i, j, max_size, num_vec, pkt_num, vec_num;
+	int ret;
+
+	CU_ASSERT_FATAL(odp_schedule_capability(&sched_capa) == 0);
+	CU_ASSERT(sched_capa.vector.min_size <= sched_capa.vector.max_size);
+
+	max_size = sched_capa.vector.max_size;
+	if (max_size > BUFS_PER_QUEUE / 4)
+		max_size = BUFS_PER_QUEUE / 4;
+	if (max_size < sched_capa.vector.min_size)
+		max_size = sched_capa.vector.min_size;
+
+	odp_pool_param_init(&pool_param);
+	pool_param.type    = ODP_POOL_PACKET;
+	pool_param.pkt.len = 100;
+	pool_param.pkt.num = BUFS_PER_QUEUE;
+
+	pool = odp_pool_create("test_queue_vector", &pool_param);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	odp_pool_param_init(&pool_param);
+	pool_param.type            = ODP_POOL_VECTOR;
+	pool_param.vector.num      = BUFS_PER_QUEUE;
+	pool_param.vector.max_size = max_size;
+
+	vec_pool = odp_pool_create("test_queue_vector_vec", &pool_param);
+	CU_ASSERT_FATAL(vec_pool != ODP_POOL_INVALID);
+
+	sched_queue_param_init(&queue_param);
+	queue_param.sched.sync      = ODP_SCHED_SYNC_ATOMIC;
+	queue_param.vector.enable   = 1;
+	queue_param.vector.pool     = vec_pool;
+	queue_param.vector.max_size = max_size;
+
+	queue = odp_queue_create("test_queue_vector", &queue_param);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	/* Packets are enqueued with sequence numbers, vectors must not
+	 * change the order of an atomic queue */
+	for (i = 0; i < BUFS_PER_QUEUE; i++) {
+		pkt = odp_packet_alloc(pool, 100);
+		CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+
+		odp_packet_user_ptr_set(pkt, (void *)(uintptr_t)(i + 1));
+		ret = odp_queue_enq(queue, odp_packet_to_event(pkt));
+		CU_ASSERT_FATAL(ret == 0);
+	}
+
+	pkt_num = 0;
+	num_vec = 0;
+	for (i = 0; i < 100 * BUFS_PER_QUEUE && pkt_num < BUFS_PER_QUEUE; i++) {
+		ev = odp_schedule(&from, ODP_SCHED_NO_WAIT);
+
+		if (ev == ODP_EVENT_INVALID)
+			continue;
+
+		CU_ASSERT(from == queue);
+
+		if (odp_event_type(ev) == ODP_EVENT_PACKET) {
+			pkt = odp_packet_from_event(ev);
+			CU_ASSERT((uintptr_t)odp_packet_user_ptr(pkt) == pkt_num + 1);
+			pkt_num++;
+			odp_packet_free(pkt);
+			continue;
+		}
+
+		CU_ASSERT_FATAL(odp_event_type(ev) == ODP_EVENT_PACKET_VECTOR);
+
+		pktv = odp_packet_vector_from_event(ev);
+		vec_num = odp_packet_vector_tbl(pktv, &pkt_tbl);
+		CU_ASSERT(vec_num > 0);
+		CU_ASSERT(vec_num <= max_size);
+		CU_ASSERT(odp_packet_vector_pool(pktv) == vec_pool);
+
+		for (j = 0; j < vec_num; j++) {
+			CU_ASSERT((uintptr_t)odp_packet_user_ptr(pkt_tbl[j]) == pkt_num + 1);
+			pkt_num++;
+		}
+
+		odp_packet_free_multi(pkt_tbl, vec_num);
+		odp_packet_vector_free(pktv);
+		num_vec++;
+	}
+
+	CU_ASSERT(pkt_num == BUFS_PER_QUEUE);
+	CU_ASSERT(num_vec > 0);
+
+	odp_schedule_release_atomic();
+	drain_queues();
+	CU_ASSERT_FATAL(odp_queue_destroy(queue) == 0);
+	CU_ASSERT(odp_pool_destroy(vec_pool) == 0);
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
 static int scheduler_test_global_init(void)
 {
 	odp_cpumask_t mask;
@@ -3043,6 +3163,8 @@ odp_testinfo_t scheduler_basic_suite[] = {
 	ODP_TEST_INFO(scheduler_test_ordered_lock),
 	ODP_TEST_INFO_CONDITIONAL(scheduler_test_flow_aware,
 				  check_flow_aware_support),
+	ODP_TEST_INFO_CONDITIONAL(scheduler_test_queue_vector,
+				  check_queue_vector_support),
 	ODP_TEST_INFO(scheduler_test_parallel),
 	ODP_TEST_INFO(scheduler_test_atomic),
 	ODP_TEST_INFO(scheduler_test_ordered),
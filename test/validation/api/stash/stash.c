@@ -132,6 +132,7 @@ static void stash_param_defaults(void)
 	CU_ASSERT(param.put_mode == ODP_STASH_OP_MT);
 	CU_ASSERT(param.get_mode == ODP_STASH_OP_MT);
 	CU_ASSERT(param.cache_size == 0);
+	CU_ASSERT(param.burst_size == 0);
 }
 
 static void stash_create_u64(void)
@@ -658,6 +659,14 @@ static int check_support_fifo_64(void)
 	return ODP_TEST_INACTIVE;
 }
 
+static int check_support_ptr(void)
+{
+	if (global.capa_default.max_obj_size >= sizeof(uintptr_t))
+		return ODP_TEST_ACTIVE;
+
+	return ODP_TEST_INACTIVE;
+}
+
 static int check_support_fifo(void)
 {
 	if (global.fifo_supported)
@@ -706,6 +715,109 @@ static void stash_default_put_u8_n(void)
 	stash_default_put(sizeof(uint8_t), BURST);
 }
 
+static void stash_default_put_ptr(uint32_t cache_size, uint32_t burst_size,
+				  int32_t burst)
+{
+	odp_stash_t stash;
+	odp_stash_param_t param;
+	int32_t i, ret, retry, num_left;
+	int32_t num = global.num_default.u64;
+	uintptr_t input[burst];
+	uintptr_t output[burst];
+	uint8_t seen[num];
+	uintptr_t next = 1;
+
+	memset(seen, 0, sizeof(seen));
+
+	odp_stash_param_init(&param);
+	param.num_obj    = num;
+	param.obj_size   = sizeof(uintptr_t);
+	param.cache_size = cache_size;
+	param.burst_size = burst_size;
+
+	stash = odp_stash_create("test_stash_ptr", &param);
+
+	CU_ASSERT_FATAL(stash != ODP_STASH_INVALID);
+
+	/* Stash is empty */
+	CU_ASSERT_FATAL(odp_stash_get_ptr(stash, output, 1) == 0);
+
+	retry = MAX_RETRY;
+	num_left = num;
+	while (num_left) {
+		int32_t n = num_left < burst ? num_left : burst;
+
+		for (i = 0; i < n; i++)
+			input[i] = next + i;
+
+		ret = odp_stash_put_ptr(stash, input, n);
+		CU_ASSERT_FATAL(ret >= 0);
+		CU_ASSERT_FATAL(ret <= n);
+
+		if (ret) {
+			next += ret;
+			num_left -= ret;
+			retry = MAX_RETRY;
+		} else {
+			retry--;
+			CU_ASSERT_FATAL(retry > 0);
+		}
+	}
+
+	retry = MAX_RETRY;
+	num_left = num;
+	while (num_left) {
+		ret = odp_stash_get_ptr(stash, output, burst);
+		CU_ASSERT_FATAL(ret >= 0);
+		CU_ASSERT_FATAL(ret <= burst);
+
+		if (ret) {
+			for (i = 0; i < ret; i++) {
+				CU_ASSERT_FATAL(output[i] >= 1);
+				CU_ASSERT_FATAL(output[i] <= (uintptr_t)num);
+				CU_ASSERT(seen[output[i] - 1] == 0);
+				seen[output[i] - 1] = 1;
+			}
+
+			num_left -= ret;
+			retry = MAX_RETRY;
+		} else {
+			retry--;
+			CU_ASSERT_FATAL(retry > 0);
+		}
+	}
+
+	/* Stash is empty again */
+	CU_ASSERT(odp_stash_get_ptr(stash, output, 1) == 0);
+
+	/* Handles stay available after a cache flush */
+	CU_ASSERT(odp_stash_put_ptr(stash, input, 1) == 1);
+	CU_ASSERT(odp_stash_flush_cache(stash) == 0);
+	CU_ASSERT(odp_stash_get_ptr(stash, output, 1) == 1);
+	CU_ASSERT(output[0] == input[0]);
+	CU_ASSERT(odp_stash_get_ptr(stash, output, 1) == 0);
+
+	CU_ASSERT_FATAL(odp_stash_destroy(stash) == 0);
+}
+
+static void stash_default_put_ptr_1(void)
+{
+	stash_default_put_ptr(0, 0, 1);
+}
+
+static void stash_default_put_ptr_n(void)
+{
+	stash_default_put_ptr(0, 0, BURST);
+}
+
+static void stash_default_put_ptr_cache(void)
+{
+	uint32_t cache_size = global.cache_size_default;
+
+	stash_default_put_ptr(cache_size, cache_size / 2, BURST);
+	stash_default_put_ptr(cache_size, 0, 1);
+}
+
 static void stash_fifo_put_u64_1(void)
 {
 	stash_fifo_put(sizeof(uint64_t), 1);
@@ -759,6 +871,10 @@ odp_testinfo_t stash_suite[] = {
 	ODP_TEST_INFO(stash_default_put_u16_n),
 	ODP_TEST_INFO(stash_default_put_u8_1),
 	ODP_TEST_INFO(stash_default_put_u8_n),
+	ODP_TEST_INFO_CONDITIONAL(stash_default_put_ptr_1, check_support_ptr),
+	ODP_TEST_INFO_CONDITIONAL(stash_default_put_ptr_n, check_support_ptr),
+	ODP_TEST_INFO_CONDITIONAL(stash_default_put_ptr_cache,
+				  check_support_ptr),
 	ODP_TEST_INFO_CONDITIONAL(stash_create_u64_all, check_support_64),
 	ODP_TEST_INFO(stash_create_u32_all),
 	ODP_TEST_INFO_CONDITIONAL(stash_fifo_put_u64_1, check_support_fifo_64),
@@ -4,7 +4,14 @@
  * SPDX-License-Identifier:	BSD-3-Clause
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
 #include <odp_api.h>
 #include <odp/helper/odph_api.h>
 
@@ -467,6 +474,21 @@ static void system_test_config_print(void)
 	printf("...done. ");
 }
 
+static void system_test_trace_flush(void)
+{
+	char path[] = "/tmp/odp_trace_XXXXXX.json";
+	int fd = mkstemps(path, 5);
+
+	CU_ASSERT_FATAL(fd >= 0);
+	close(fd);
+
+	/* Tracing is implementation specific and may not be supported */
+	if (odp_sys_trace_flush(path))
+		printf("\n    Tracing not supported\n");
+
+	CU_ASSERT(remove(path) == 0);
+}
+
 static void system_test_info(void)
 {
 	odp_system_info_t info;
@@ -581,6 +603,7 @@ odp_testinfo_t system_suite[] = {
 	ODP_TEST_INFO(system_test_info),
 	ODP_TEST_INFO(system_test_info_print),
 	ODP_TEST_INFO(system_test_config_print),
+	ODP_TEST_INFO(system_test_trace_flush),
 	ODP_TEST_INFO_NULL,
 };
 
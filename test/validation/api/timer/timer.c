@@ -988,6 +988,134 @@ static void timer_test_cancel(void)
 		CU_FAIL_FATAL("Failed to destroy pool");
 }
 
+static void timer_test_set_cancel_multi(void)
+{
+	odp_pool_t pool;
+	odp_pool_param_t params;
+	odp_timer_pool_param_t tparam;
+	odp_queue_param_t queue_param;
+	odp_timer_capability_t capa;
+	odp_timer_pool_t tp;
+	odp_queue_t queue;
+	odp_timeout_t tmo;
+	uint64_t tick, cur_tick;
+	int ret, i;
+	int num = 10;
+	odp_timer_t tim[num];
+	odp_event_t ev[num];
+	uint64_t tick_tbl[num];
+	int result[num];
+
+	memset(&capa, 0, sizeof(capa));
+	ret = odp_timer_capability(ODP_CLOCK_CPU, &capa);
+	CU_ASSERT_FATAL(ret == 0);
+
+	odp_pool_param_init(&params);
+	params.type    = ODP_POOL_TIMEOUT;
+	params.tmo.num = num;
+
+	pool = odp_pool_create("tmo_pool_for_multi", &params);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	memset(&tparam, 0, sizeof(odp_timer_pool_param_t));
+	tparam.res_ns	  = global_mem->param.res_ns;
+	tparam.min_tmo    = global_mem->param.min_tmo;
+	tparam.max_tmo    = global_mem->param.max_tmo;
+	tparam.num_timers = num;
+	tparam.priv       = 0;
+	tparam.clk_src    = ODP_CLOCK_CPU;
+	tp = odp_timer_pool_create(NULL, &tparam);
+	CU_ASSERT_FATAL(tp != ODP_TIMER_POOL_INVALID);
+
+	odp_timer_pool_start();
+
+	odp_queue_param_init(&queue_param);
+	if (capa.queue_type_plain) {
+		queue_param.type = ODP_QUEUE_TYPE_PLAIN;
+	} else if (capa.queue_type_sched) {
+		queue_param.type = ODP_QUEUE_TYPE_SCHED;
+		queue_param.sched.sync = ODP_SCHED_SYNC_ATOMIC;
+	}
+
+	queue = odp_queue_create("timer_queue", &queue_param);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	tick = odp_timer_ns_to_tick(tp, tparam.max_tmo / 2);
+
+	for (i = 0; i < num; i++) {
+		tim[i] = odp_timer_alloc(tp, queue, USER_PTR);
+		CU_ASSERT_FATAL(tim[i] != ODP_TIMER_INVALID);
+
+		ev[i] = odp_timeout_to_event(odp_timeout_alloc(pool));
+		CU_ASSERT_FATAL(ev[i] != ODP_EVENT_INVALID);
+
+		tick_tbl[i] = tick;
+	}
+
+	/* Set with events */
+	ret = odp_timer_set_rel_multi(tim, tick_tbl, ev, result, num);
+	CU_ASSERT(ret == num);
+
+	for (i = 0; i < num; i++) {
+		CU_ASSERT(result[i] == ODP_TIMER_SUCCESS);
+		CU_ASSERT(ev[i] == ODP_EVENT_INVALID);
+	}
+
+	/* Reset without changing events. Last one is too late. */
+	cur_tick = odp_timer_current_tick(tp);
+
+	for (i = 0; i < num; i++)
+		tick_tbl[i] = cur_tick + tick + i;
+
+	tick_tbl[num - 1] = cur_tick + odp_timer_ns_to_tick(tp, 2 * tparam.max_tmo);
+
+	ret = odp_timer_set_abs_multi(tim, tick_tbl, NULL, result, num);
+	CU_ASSERT(ret == num - 1);
+
+	for (i = 0; i < num - 1; i++)
+		CU_ASSERT(result[i] == ODP_TIMER_SUCCESS);
+
+	CU_ASSERT(result[num - 1] == ODP_TIMER_TOOLATE);
+
+	/* Cancel all */
+	for (i = 0; i < num; i++)
+		ev[i] = ODP_EVENT_INVALID;
+
+	ret = odp_timer_cancel_multi(tim, ev, num);
+	CU_ASSERT(ret == num);
+
+	for (i = 0; i < num; i++) {
+		CU_ASSERT_FATAL(ev[i] != ODP_EVENT_INVALID);
+
+		tmo = odp_timeout_from_event(ev[i]);
+		CU_ASSERT(odp_timeout_timer(tmo) == tim[i]);
+		CU_ASSERT(odp_timeout_user_ptr(tmo) == USER_PTR);
+		odp_timeout_free(tmo);
+	}
+
+	/* Inactive timers: nothing to cancel, reset fails without events */
+	ret = odp_timer_cancel_multi(tim, ev, num);
+	CU_ASSERT(ret == 0);
+
+	for (i = 0; i < num; i++) {
+		CU_ASSERT(ev[i] == ODP_EVENT_INVALID);
+		tick_tbl[i] = tick;
+	}
+
+	ret = odp_timer_set_rel_multi(tim, tick_tbl, ev, result, num);
+	CU_ASSERT(ret == 0);
+
+	for (i = 0; i < num; i++) {
+		CU_ASSERT(result[i] == ODP_TIMER_NOEVENT);
+		CU_ASSERT(odp_timer_free(tim[i]) == ODP_EVENT_INVALID);
+	}
+
+	odp_timer_pool_destroy(tp);
+
+	CU_ASSERT(odp_queue_destroy(queue) == 0);
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
 static void timer_test_tmo_limit(odp_queue_type_t queue_type,
 				 int max_res, int min)
 {
@@ -1711,6 +1839,7 @@ odp_testinfo_t timer_suite[] = {
 	ODP_TEST_INFO_CONDITIONAL(timer_test_pkt_event_sched,
 				  check_sched_queue_support),
 	ODP_TEST_INFO(timer_test_cancel),
+	ODP_TEST_INFO(timer_test_set_cancel_multi),
 	ODP_TEST_INFO_CONDITIONAL(timer_test_max_res_min_tmo_plain,
 				  check_plain_queue_support),
 	ODP_TEST_INFO_CONDITIONAL(timer_test_max_res_min_tmo_sched,